@@ -271,9 +271,7 @@ static void visible_list_dispose()
 
 static bool visible_list_sort_ride_name(const list_item& a, const list_item& b)
 {
-    auto nameA = a.repositoryItem->Name.c_str();
-    auto nameB = b.repositoryItem->Name.c_str();
-    return strcmp(nameA, nameB) < 0;
+    return a.repositoryItem->Name < b.repositoryItem->Name;
 }
 
 static bool visible_list_sort_ride_type(const list_item& a, const list_item& b)
@@ -1053,9 +1051,10 @@ static void window_editor_object_selection_paint(rct_window* w, rct_drawpixelinf
     {
         auto screenPos = w->windowPos + ScreenCoordsXY{ widget->midX() + 1, widget->bottom + 3 };
         width = w->width - w->widgets[WIDX_LIST].right - 6;
+        auto name = std::string(listItem->repositoryItem->Name);
         auto ft = Formatter();
         ft.Add<rct_string_id>(STR_STRING);
-        ft.Add<const char*>(listItem->repositoryItem->Name.c_str());
+        ft.Add<const char*>(name.c_str());
         DrawTextEllipsised(dpi, screenPos, width, STR_WINDOW_COLOUR_2_STRINGID, ft, { TextAlignment::CENTRE });
     }
 
@@ -1091,7 +1090,8 @@ static void window_editor_object_selection_paint(rct_window* w, rct_drawpixelinf
 
     // Draw object dat name
     {
-        const char* path = path_get_filename(listItem->repositoryItem->Path.c_str());
+        auto fullPath = std::string(listItem->repositoryItem->Path);
+        const char* path = path_get_filename(fullPath.c_str());
         auto ft = Formatter();
         ft.Add<rct_string_id>(STR_STRING);
         ft.Add<const char*>(path);
@@ -1105,13 +1105,14 @@ static void window_editor_object_selection_paint(rct_window* w, rct_drawpixelinf
     {
         auto ft = Formatter();
         std::string authorsString;
-        for (size_t i = 0; i < listItem->repositoryItem->Authors.size(); i++)
+        size_t authorIndex = 0;
+        for (auto author : listItem->repositoryItem->Authors)
         {
-            if (i > 0)
+            if (authorIndex++ > 0)
             {
                 authorsString.append(", ");
             }
-            authorsString.append(listItem->repositoryItem->Authors[i]);
+            authorsString.append(author);
         }
         ft.Add<rct_string_id>(STR_STRING);
         ft.Add<const char*>(authorsString.c_str());
@@ -1192,7 +1193,8 @@ static void window_editor_object_selection_scrollpaint(rct_window* w, rct_drawpi
             }
 
             // Draw text
-            safe_strcpy(buffer, listItem.repositoryItem->Name.c_str(), 256 - (buffer - bufferWithColour));
+            const auto& name = listItem.repositoryItem->Name;
+            String::Set(buffer, 256 - (buffer - bufferWithColour), name.data(), name.size());
             if (gScreenFlags & SCREEN_FLAGS_TRACK_MANAGER)
             {
                 while (*buffer != 0 && *buffer != 9)
@@ -1411,9 +1413,9 @@ static bool filter_string(const ObjectRepositoryItem* item)
     char type_lower[MAX_PATH];
     char object_path[MAX_PATH];
     char filter_lower[sizeof(_filter_string)];
-    safe_strcpy(name_lower, item->Name.c_str(), MAX_PATH);
+    String::Set(name_lower, MAX_PATH, item->Name.data(), item->Name.size());
     safe_strcpy(type_lower, rideTypeName, MAX_PATH);
-    safe_strcpy(object_path, item->Path.c_str(), MAX_PATH);
+    String::Set(object_path, MAX_PATH, item->Path.data(), item->Path.size());
     safe_strcpy(filter_lower, _filter_string, sizeof(_filter_string));
 
     // Make use of lowercase characters only
@@ -136,11 +136,11 @@ rct_window* window_sign_open(rct_windownumber number)
                     break;
             }
         }
-        tile_element++;
-        if (tile_element >= &gTileElements[std::size(gTileElements)])
+        if (tile_element->IsLastForTile())
         {
             return nullptr;
         }
+        tile_element++;
     }
 
     int32_t view_z = tile_element->GetBaseZ();
@@ -192,11 +192,11 @@ static void window_sign_mouseup(rct_window* w, rct_widgetindex widgetIndex)
                             break;
                     }
                 }
-                tile_element++;
-                if (tile_element >= &gTileElements[std::size(gTileElements)])
+                if (tile_element->IsLastForTile())
                 {
                     return;
                 }
+                tile_element++;
             }
 
             auto sceneryRemoveAction = LargeSceneryRemoveAction(
@@ -37,6 +37,7 @@
 #include "core/MemoryStream.h"
 #include "core/Path.hpp"
 #include "core/String.hpp"
+#include "core/TaskScheduler.h"
 #include "drawing/IDrawingEngine.h"
 #include "drawing/LightFX.h"
 #include "interface/Chat.h"
@@ -347,6 +348,10 @@ namespace OpenRCT2
 
             crash_init();
 
+            TaskSchedulerOptions schedulerOptions;
+            schedulerOptions.PinThreads = gConfigGeneral.multithreading_pin_threads;
+            TaskScheduler::SetDefaultOptions(schedulerOptions);
+
             if (gConfigGeneral.last_run_version != nullptr && String::Equals(gConfigGeneral.last_run_version, OPENRCT2_VERSION))
             {
                 gOpenRCT2ShowChangelog = false;
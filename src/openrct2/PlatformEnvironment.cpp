@@ -85,6 +85,8 @@ private:
             case PATHID::CONFIG_SHORTCUTS:
                 return DIRBASE::CONFIG;
             case PATHID::CACHE_OBJECTS:
+            case PATHID::CACHE_OBJECTS_FLAT:
+            case PATHID::CACHE_OBJECT_IMAGES:
             case PATHID::CACHE_TRACKS:
             case PATHID::CACHE_SCENARIOS:
                 return DIRBASE::CACHE;
@@ -236,6 +238,8 @@ const char * PlatformEnvironment::FileNames[] =
     "hotkeys.dat",          // CONFIG_SHORTCUTS_LEGACY
     "shortcuts.json",       // CONFIG_SHORTCUTS
     "objects.idx",          // CACHE_OBJECTS
+    "objects.flat",         // CACHE_OBJECTS_FLAT
+    "object_images",        // CACHE_OBJECT_IMAGES
     "tracks.idx",           // CACHE_TRACKS
     "scenarios.idx",        // CACHE_SCENARIOS
     "Data" PATH_SEPARATOR "mp.dat", // MP_DAT
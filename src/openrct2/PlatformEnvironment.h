@@ -57,6 +57,8 @@ namespace OpenRCT2
         CONFIG_SHORTCUTS_LEGACY, // Old keyboard shortcuts (hotkeys.cfg)
         CONFIG_SHORTCUTS,        // Shortcut bindings (shortcuts.json)
         CACHE_OBJECTS,           // Object repository cache (objects.idx).
+        CACHE_OBJECTS_FLAT,      // Object repository as it is mapped into memory (objects.flat).
+        CACHE_OBJECT_IMAGES,     // Images imported by JSON objects, a file for each object (object_images).
         CACHE_TRACKS,            // Track repository cache (tracks.idx).
         CACHE_SCENARIOS,         // Scenario repository cache (scenarios.idx).
         MP_DAT,                  // Mega Park data, Steam RCT1 only (\RCTdeluxe_install\Data\mp.dat)
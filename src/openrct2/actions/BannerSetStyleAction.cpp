@@ -14,6 +14,7 @@
 #include "../util/Util.h"
 #include "../windows/Intent.h"
 #include "../world/Banner.h"
+#include "../world/FootpathGraph.h"
 #include "GameAction.h"
 
 BannerSetStyleAction::BannerSetStyleAction(BannerSetStyleType type, uint8_t bannerIndex, uint8_t parameter)
@@ -139,6 +140,7 @@ GameActions::Result::Ptr BannerSetStyleAction::Execute() const
                 allowedEdges &= ~(1 << bannerElement->GetPosition());
             }
             bannerElement->SetAllowedEdges(allowedEdges);
+            footpath_graph_invalidate_tile(location);
             break;
         }
         default:
@@ -15,6 +15,7 @@
 #include "../interface/Window.h"
 #include "../localisation/StringIds.h"
 #include "../management/Finance.h"
+#include "../peep/GuestSurroundings.h"
 #include "../world/Footpath.h"
 #include "../world/Location.hpp"
 #include "../world/Park.h"
@@ -106,6 +107,7 @@ GameActions::Result::Ptr FootpathAdditionRemoveAction::Execute() const
     }
 
     pathElement->SetAddition(0);
+    surroundings_invalidate_tile(_loc);
     map_invalidate_tile_full(_loc);
 
     auto res = MakeResult();
@@ -15,7 +15,9 @@
 #include "../interface/Window.h"
 #include "../localisation/StringIds.h"
 #include "../management/Finance.h"
+#include "../peep/GuestSurroundings.h"
 #include "../world/Footpath.h"
+#include "../world/FootpathGraph.h"
 #include "../world/Location.hpp"
 #include "../world/Park.h"
 #include "../world/Scenery.h"
@@ -184,6 +186,7 @@ GameActions::Result::Ptr FootpathPlaceAction::ElementUpdateExecute(PathElement*
     pathElement->SetSurfaceEntryIndex(_type & ~FOOTPATH_ELEMENT_INSERT_QUEUE);
     bool isQueue = _type & FOOTPATH_ELEMENT_INSERT_QUEUE;
     pathElement->SetIsQueue(isQueue);
+    footpath_graph_invalidate_tile(_loc);
 
     rct_scenery_entry* elem = pathElement->GetAdditionEntry();
     if (elem != nullptr)
@@ -195,6 +198,7 @@ GameActions::Result::Ptr FootpathPlaceAction::ElementUpdateExecute(PathElement*
             {
                 pathElement->SetIsBroken(false);
                 pathElement->SetAddition(0);
+                surroundings_invalidate_tile(_loc);
             }
         }
         else
@@ -204,6 +208,7 @@ GameActions::Result::Ptr FootpathPlaceAction::ElementUpdateExecute(PathElement*
             {
                 pathElement->SetIsBroken(false);
                 pathElement->SetAddition(0);
+                surroundings_invalidate_tile(_loc);
             }
         }
     }
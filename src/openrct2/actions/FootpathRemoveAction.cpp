@@ -95,7 +95,7 @@ GameActions::Result::Ptr FootpathRemoveAction::Execute() const
         }
         footpath_remove_edges_at(_loc, footpathElement);
         map_invalidate_tile_full(_loc);
-        tile_element_remove(footpathElement);
+        tile_element_remove(_loc, footpathElement);
         footpath_update_queue_chains();
 
         // Remove the spawn point (if there is one in the current tile)
@@ -176,7 +176,7 @@ GameActions::Result::Ptr LargeSceneryRemoveAction::Execute() const
         if (sceneryElement != nullptr)
         {
             map_invalidate_tile_full(currentTile);
-            tile_element_remove(sceneryElement);
+            tile_element_remove(currentTile, sceneryElement);
         }
         else
         {
@@ -295,7 +295,7 @@ GameActions::Result::Ptr MazeSetTrackAction::Execute() const
 
     if ((tileElement->AsTrack()->GetMazeEntry() & 0x8888) == 0x8888)
     {
-        tile_element_remove(tileElement);
+        tile_element_remove(_loc, tileElement);
         sub_6CB945(ride);
         ride->maze_tiles--;
     }
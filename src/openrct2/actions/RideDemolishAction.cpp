@@ -310,7 +310,7 @@ money32 RideDemolishAction::DemolishTracks() const
 
             if (removRes->Error != GameActions::Status::Ok)
             {
-                tile_element_remove(it.element);
+                tile_element_remove(location, it.element);
             }
             else
             {
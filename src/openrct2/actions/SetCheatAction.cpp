@@ -18,6 +18,7 @@
 #include "../localisation/Localisation.h"
 #include "../localisation/StringIds.h"
 #include "../network/network.h"
+#include "../peep/GuestSurroundings.h"
 #include "../ride/Ride.h"
 #include "../scenario/Scenario.h"
 #include "../ui/UiContext.h"
@@ -404,6 +405,7 @@ void SetCheatAction::FixVandalism() const
 
         it.element->AsPath()->SetIsBroken(false);
     } while (tile_element_iterator_next(&it));
+    surroundings_invalidate_all();
 
     gfx_invalidate_screen();
 }
@@ -128,7 +128,7 @@ GameActions::Result::Ptr SmallSceneryRemoveAction::Execute() const
     res->Position.z = tile_element_height(res->Position);
 
     map_invalidate_tile_full(_loc);
-    tile_element_remove(tileElement);
+    tile_element_remove(_loc, tileElement);
 
     return res;
 }
@@ -9,6 +9,7 @@
 
 #include "TileModifyAction.h"
 
+#include "../world/FootpathGraph.h"
 #include "../world/TileInspector.h"
 
 using namespace OpenRCT2;
@@ -42,6 +43,8 @@ GameActions::Result::Ptr TileModifyAction::Query() const
 
 GameActions::Result::Ptr TileModifyAction::Execute() const
 {
+    // Any element on the tile may be changed, including the paths and banners the footpath graph is compiled from.
+    footpath_graph_invalidate_tile(_loc);
     return QueryExecute(true);
 }
 
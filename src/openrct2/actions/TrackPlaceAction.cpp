@@ -10,6 +10,7 @@
 #include "TrackPlaceAction.h"
 
 #include "../management/Finance.h"
+#include "../peep/GuestSurroundings.h"
 #include "../ride/RideData.h"
 #include "../ride/Track.h"
 #include "../ride/TrackData.h"
@@ -246,6 +247,7 @@ GameActions::Result::Ptr TrackPlaceAction::Query() const
             if (footpathElement != nullptr && footpathElement->AsPath()->HasAddition())
             {
                 footpathElement->AsPath()->SetAddition(0);
+                surroundings_invalidate_tile(mapLoc);
             }
         }
 
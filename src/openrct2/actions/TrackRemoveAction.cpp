@@ -421,7 +421,7 @@ GameActions::Result::Ptr TrackRemoveAction::Execute() const
         {
             footpath_remove_edges_at(mapLoc, tileElement);
         }
-        tile_element_remove(tileElement);
+        tile_element_remove(mapLoc, tileElement);
         sub_6CB945(ride);
         if (!(GetFlags() & GAME_COMMAND_FLAG_GHOST))
         {
@@ -89,7 +89,7 @@ GameActions::Result::Ptr WallRemoveAction::Execute() const
 
     wallElement->RemoveBannerEntry();
     map_invalidate_tile_zoom1({ _loc, wallElement->GetBaseZ(), (wallElement->GetBaseZ()) + 72 });
-    tile_element_remove(wallElement);
+    tile_element_remove(_loc, wallElement);
 
     return res;
 }
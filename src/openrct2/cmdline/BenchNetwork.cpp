@@ -0,0 +1,228 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "CommandLine.hpp"
+
+#if defined(USE_BENCHMARK) && !defined(DISABLE_NETWORK)
+
+#    include "../core/Console.hpp"
+#    include "../network/NetworkConnection.h"
+#    include "../network/NetworkPacket.h"
+#    include "../network/Socket.h"
+#    include "../network/network.h"
+
+#    include <benchmark/benchmark.h>
+#    include <chrono>
+#    include <memory>
+#    include <thread>
+#    include <vector>
+
+// Ports tried for the loopback listener, starting one above the default so a running server is not in the way.
+constexpr uint16_t FirstBenchmarkPort = NETWORK_DEFAULT_PORT + 1;
+constexpr uint16_t BenchmarkPortCount = 100;
+
+struct LoopbackClient
+{
+    std::unique_ptr<NetworkConnection> ServerSide;
+    std::unique_ptr<ITcpSocket> ClientSide;
+    size_t BytesReceived = 0;
+};
+
+static std::unique_ptr<ITcpSocket> ListenOnLoopback(uint16_t& port)
+{
+    for (uint16_t i = 0; i < BenchmarkPortCount; i++)
+    {
+        try
+        {
+            auto listener = CreateTcpSocket();
+            listener->Listen("127.0.0.1", FirstBenchmarkPort + i);
+            port = FirstBenchmarkPort + i;
+            return listener;
+        }
+        catch (const std::exception&)
+        {
+        }
+    }
+    throw std::runtime_error("Unable to listen on a loopback port.");
+}
+
+// Connects the clients the way a server sees them, with every connection authenticated.
+static std::vector<LoopbackClient> ConnectClients(ITcpSocket& listener, uint16_t port, int32_t count)
+{
+    std::vector<LoopbackClient> clients(count);
+    for (auto& client : clients)
+    {
+        client.ClientSide = CreateTcpSocket();
+        client.ClientSide->Connect("127.0.0.1", port);
+
+        std::unique_ptr<ITcpSocket> accepted;
+        while ((accepted = listener.Accept()) == nullptr)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        client.ServerSide = std::make_unique<NetworkConnection>();
+        client.ServerSide->Socket = std::move(accepted);
+        client.ServerSide->AuthStatus = NetworkAuth::Ok;
+    }
+    return clients;
+}
+
+static void ReceiveAll(std::vector<LoopbackClient>& clients)
+{
+    uint8_t buffer[64 * 1024];
+    for (auto& client : clients)
+    {
+        size_t received = 0;
+        while (client.ClientSide->ReceiveData(buffer, sizeof(buffer), &received) == NetworkReadPacket::Success)
+        {
+            client.BytesReceived += received;
+        }
+    }
+}
+
+/**
+ * Sends a packet to every client like NetworkBase::SendPacketToClients, either from one shared buffer or from a copy
+ * for each client as it used to. Only queueing and sending are timed, not the clients receiving.
+ */
+static void BM_packet_fan_out(benchmark::State& state)
+{
+    const auto numClients = static_cast<int32_t>(state.range(0));
+    const auto payloadSize = static_cast<size_t>(state.range(1));
+    const bool shared = state.range(2) != 0;
+
+    uint16_t port = 0;
+    auto listener = ListenOnLoopback(port);
+    auto clients = ConnectClients(*listener, port, numClients);
+
+    NetworkPacket packet(NetworkCommand::Map);
+    std::vector<uint8_t> payload(payloadSize, 0xA5);
+    packet.Write(payload.data(), payload.size());
+    const auto packetSize = packet.CreateSendBuffer()->Bytes.size();
+
+    size_t expectedBytes = 0;
+    for (auto _ : state)
+    {
+        if (shared)
+        {
+            auto buffer = packet.CreateSendBuffer();
+            for (auto& client : clients)
+            {
+                client.ServerSide->QueuePacket(buffer);
+            }
+        }
+        else
+        {
+            for (auto& client : clients)
+            {
+                client.ServerSide->QueuePacket(packet);
+            }
+        }
+        expectedBytes += packetSize;
+
+        bool allReceived;
+        do
+        {
+            for (auto& client : clients)
+            {
+                client.ServerSide->SendQueuedPackets();
+            }
+
+            state.PauseTiming();
+            ReceiveAll(clients);
+            allReceived = true;
+            for (const auto& client : clients)
+            {
+                allReceived &= client.BytesReceived == expectedBytes;
+            }
+            state.ResumeTiming();
+        } while (!allReceived);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * packetSize * numClients));
+    state.counters["clients"] = numClients;
+}
+
+static int cmdline_for_bench_network(int argc, const char* const* argv)
+{
+    for (int64_t shared : { 0, 1 })
+    {
+        const char* name = shared != 0 ? "PacketFanOut/shared" : "PacketFanOut/copied";
+        auto benchmark = benchmark::RegisterBenchmark(name, BM_packet_fan_out);
+        benchmark->ArgNames({ "clients", "payload", "shared" });
+        for (int64_t clients : { 1, 8, 40 })
+        {
+            // A game action and a map chunk
+            for (int64_t payload : { 64, 1024 * 63 })
+            {
+                benchmark->Args({ clients, payload, shared });
+            }
+        }
+        benchmark->Unit(benchmark::kMicrosecond);
+    }
+
+    // Google benchmark does stuff to argv. It doesn't modify the pointees,
+    // but it wants to reorder the pointers, so present a copy of them.
+    std::vector<char*> argv_for_benchmark;
+
+    // argv[0] is expected to contain the binary name. It's only for logging purposes, don't bother.
+    argv_for_benchmark.push_back(nullptr);
+    for (int i = 0; i < argc; i++)
+    {
+        argv_for_benchmark.push_back(const_cast<char*>(argv[i]));
+    }
+    argc = static_cast<int>(argv_for_benchmark.size());
+    ::benchmark::Initialize(&argc, &argv_for_benchmark[0]);
+    if (::benchmark::ReportUnrecognizedArguments(argc, &argv_for_benchmark[0]))
+        return -1;
+
+    try
+    {
+        ::benchmark::RunSpecifiedBenchmarks();
+    }
+    catch (const std::exception& e)
+    {
+        Console::Error::WriteLine("%s", e.what());
+        return -1;
+    }
+    return 0;
+}
+
+static exitcode_t HandleBenchNetwork(CommandLineArgEnumerator* argEnumerator)
+{
+    const char* const* argv = static_cast<const char* const*>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = cmdline_for_bench_network(argc, argv);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+#else
+static exitcode_t HandleBenchNetwork(CommandLineArgEnumerator* argEnumerator)
+{
+    log_error("Sorry, Google benchmark or networking not enabled in this build");
+    return EXITCODE_FAIL;
+}
+#endif // USE_BENCHMARK && !DISABLE_NETWORK
+
+const CommandLineCommand CommandLine::BenchNetworkCommands[]{
+#if defined(USE_BENCHMARK) && !defined(DISABLE_NETWORK)
+    DefineCommand(
+        "",
+        "[--benchmark_list_tests={true|false}] [--benchmark_filter=<regex>] [--benchmark_min_time=<min_time>] "
+        "[--benchmark_repetitions=<num_repetitions>] [--benchmark_report_aggregates_only={true|false}] "
+        "[--benchmark_format=<console|json|csv>] [--benchmark_out=<filename>] [--benchmark_out_format=<json|console|csv>] "
+        "[--benchmark_color={auto|true|false}] [--benchmark_counters_tabular={true|false}] [--v=<verbosity>]",
+        nullptr, HandleBenchNetwork),
+    CommandTableEnd
+#else
+    DefineCommand("", "*** SORRY NOT ENABLED IN THIS BUILD ***", nullptr, HandleBenchNetwork), CommandTableEnd
+#endif // USE_BENCHMARK && !DISABLE_NETWORK
+};
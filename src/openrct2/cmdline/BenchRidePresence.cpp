@@ -0,0 +1,169 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "CommandLine.hpp"
+
+#ifdef USE_BENCHMARK
+
+#    include "../Context.h"
+#    include "../OpenRCT2.h"
+#    include "../platform/Platform2.h"
+#    include "../world/EntityList.h"
+#    include "../world/RidePresence.h"
+#    include "../world/Sprite.h"
+
+#    include <benchmark/benchmark.h>
+#    include <memory>
+#    include <vector>
+
+using namespace OpenRCT2;
+
+// Locations of all guests in the loaded park, one nearby-ride query is made for each of them.
+static std::vector<CoordsXY> GetQueryLocations()
+{
+    std::vector<CoordsXY> locations;
+    for (auto guest : EntityList<Guest>())
+    {
+        if (guest->x != LOCATION_NULL)
+        {
+            locations.emplace_back(guest->x, guest->y);
+        }
+    }
+    return locations;
+}
+
+static void BM_ride_presence_scan(benchmark::State& state, const std::vector<CoordsXY>& locations)
+{
+    for (auto _ : state)
+    {
+        for (const auto& loc : locations)
+        {
+            benchmark::DoNotOptimize(ride_presence_scan_nearby(loc));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * locations.size());
+}
+
+static void BM_ride_presence_index(benchmark::State& state, const std::vector<CoordsXY>& locations)
+{
+    ride_presence_update();
+    for (auto _ : state)
+    {
+        for (const auto& loc : locations)
+        {
+            benchmark::DoNotOptimize(ride_presence_get_nearby(loc) | ride_presence_get_tall_rides());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * locations.size());
+}
+
+static void BM_ride_presence_rebuild(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        ride_presence_invalidate_all();
+        ride_presence_update();
+    }
+}
+
+static int cmdline_for_bench_ride_presence(int argc, const char* const* argv)
+{
+    // Google benchmark does stuff to argv. It doesn't modify the pointees,
+    // but it wants to reorder the pointers, so present a copy of them.
+    std::vector<char*> argv_for_benchmark;
+
+    // argv[0] is expected to contain the binary name. It's only for logging purposes, don't bother.
+    argv_for_benchmark.push_back(nullptr);
+
+    // The park stays loaded while the benchmarks run, so only the first one given is used.
+    const char* parkPath = nullptr;
+    for (int i = 0; i < argc; i++)
+    {
+        if (parkPath == nullptr && Platform::FileExists(argv[i]))
+        {
+            parkPath = argv[i];
+        }
+        else
+        {
+            argv_for_benchmark.push_back(const_cast<char*>(argv[i]));
+        }
+    }
+
+    if (parkPath == nullptr)
+    {
+        log_error("No park given");
+        return -1;
+    }
+
+    core_init();
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+    auto context = CreateContext();
+    if (!context->Initialise() || !context->LoadParkFromFile(parkPath))
+    {
+        log_error("Failed to load park!");
+        return -1;
+    }
+
+    auto locations = GetQueryLocations();
+    if (locations.empty())
+    {
+        log_error("Park has no guests to query rides for");
+        return -1;
+    }
+    log_info("Querying nearby rides for %u guests.", static_cast<uint32_t>(locations.size()));
+
+    benchmark::RegisterBenchmark("RidePresence/Scan", BM_ride_presence_scan, locations);
+    benchmark::RegisterBenchmark("RidePresence/Index", BM_ride_presence_index, locations);
+    benchmark::RegisterBenchmark("RidePresence/Rebuild", BM_ride_presence_rebuild);
+
+    // Update argc with all the changes made
+    argc = static_cast<int>(argv_for_benchmark.size());
+    ::benchmark::Initialize(&argc, &argv_for_benchmark[0]);
+    if (::benchmark::ReportUnrecognizedArguments(argc, &argv_for_benchmark[0]))
+        return -1;
+
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
+
+static exitcode_t HandleBenchRidePresence(CommandLineArgEnumerator* argEnumerator)
+{
+    const char* const* argv = static_cast<const char* const*>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = cmdline_for_bench_ride_presence(argc, argv);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+#else
+static exitcode_t HandleBenchRidePresence(CommandLineArgEnumerator* argEnumerator)
+{
+    log_error("Sorry, Google benchmark not enabled in this build");
+    return EXITCODE_FAIL;
+}
+#endif // USE_BENCHMARK
+
+const CommandLineCommand CommandLine::BenchRidePresenceCommands[]{
+#ifdef USE_BENCHMARK
+    DefineCommand(
+        "",
+        "<file> [--benchmark_list_tests={true|false}] [--benchmark_filter=<regex>] [--benchmark_min_time=<min_time>] "
+        "[--benchmark_repetitions=<num_repetitions>] [--benchmark_report_aggregates_only={true|false}] "
+        "[--benchmark_format=<console|json|csv>] [--benchmark_out=<filename>] [--benchmark_out_format=<json|console|csv>] "
+        "[--benchmark_color={auto|true|false}] [--benchmark_counters_tabular={true|false}] [--v=<verbosity>]",
+        nullptr, HandleBenchRidePresence),
+    CommandTableEnd
+#else
+    DefineCommand("", "*** SORRY NOT ENABLED IN THIS BUILD ***", nullptr, HandleBenchRidePresence), CommandTableEnd
+#endif // USE_BENCHMARK
+};
@@ -0,0 +1,166 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "CommandLine.hpp"
+
+#ifdef USE_BENCHMARK
+
+#    include "../core/JobPool.h"
+#    include "../core/TaskScheduler.h"
+
+#    include <atomic>
+#    include <benchmark/benchmark.h>
+#    include <cstdint>
+#    include <vector>
+
+using namespace OpenRCT2;
+
+// Simulates the work of one column, enough to make the queue overhead visible without hiding it.
+static uint32_t BenchWork(uint32_t seed, int32_t iterations)
+{
+    uint32_t value = seed;
+    for (int32_t i = 0; i < iterations; i++)
+    {
+        value = value * 1664525u + 1013904223u;
+    }
+    return value;
+}
+
+static void BM_jobpool(benchmark::State& state)
+{
+    const auto taskCount = static_cast<size_t>(state.range(0));
+    const auto workSize = static_cast<int32_t>(state.range(1));
+    std::vector<uint32_t> results(taskCount);
+
+    JobPool jobPool;
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < taskCount; i++)
+        {
+            jobPool.AddTask([&results, i, workSize]() { results[i] = BenchWork(static_cast<uint32_t>(i), workSize); });
+        }
+        jobPool.Join();
+        benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * taskCount);
+}
+
+static void BM_taskscheduler(benchmark::State& state)
+{
+    const auto taskCount = static_cast<size_t>(state.range(0));
+    const auto workSize = static_cast<int32_t>(state.range(1));
+    std::vector<uint32_t> results(taskCount);
+
+    TaskScheduler scheduler;
+    for (auto _ : state)
+    {
+        TaskGroup group(scheduler);
+        for (size_t i = 0; i < taskCount; i++)
+        {
+            group.Run([&results, i, workSize]() { results[i] = BenchWork(static_cast<uint32_t>(i), workSize); });
+        }
+        group.Wait();
+        benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * taskCount);
+}
+
+static void BM_taskscheduler_parallel_for(benchmark::State& state)
+{
+    const auto taskCount = static_cast<size_t>(state.range(0));
+    const auto workSize = static_cast<int32_t>(state.range(1));
+    std::vector<uint32_t> results(taskCount);
+
+    TaskScheduler scheduler;
+    for (auto _ : state)
+    {
+        scheduler.ParallelFor(0, taskCount, 1, [&results, workSize](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+            {
+                results[i] = BenchWork(static_cast<uint32_t>(i), workSize);
+            }
+        });
+        benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * taskCount);
+}
+
+static void BenchSchedulerArguments(benchmark::internal::Benchmark* bench)
+{
+    // Task counts roughly match the number of 32px paint columns from a small window up to a 4K screen,
+    // and the FileIndex batch count for a large object folder.
+    for (int64_t taskCount : { 16, 64, 256 })
+    {
+        for (int64_t workSize : { 100, 10000 })
+        {
+            bench->Args({ taskCount, workSize });
+        }
+    }
+    bench->UseRealTime();
+}
+
+static int cmdline_for_bench_scheduler(int argc, const char* const* argv)
+{
+    benchmark::RegisterBenchmark("JobPool", BM_jobpool)->Apply(BenchSchedulerArguments);
+    benchmark::RegisterBenchmark("TaskScheduler", BM_taskscheduler)->Apply(BenchSchedulerArguments);
+    benchmark::RegisterBenchmark("TaskScheduler/ParallelFor", BM_taskscheduler_parallel_for)->Apply(BenchSchedulerArguments);
+
+    // Google benchmark does stuff to argv. It doesn't modify the pointees,
+    // but it wants to reorder the pointers, so present a copy of them.
+    std::vector<char*> argv_for_benchmark;
+
+    // argv[0] is expected to contain the binary name. It's only for logging purposes, don't bother.
+    argv_for_benchmark.push_back(nullptr);
+    for (int i = 0; i < argc; i++)
+    {
+        argv_for_benchmark.push_back(const_cast<char*>(argv[i]));
+    }
+    argc = static_cast<int>(argv_for_benchmark.size());
+    ::benchmark::Initialize(&argc, &argv_for_benchmark[0]);
+    if (::benchmark::ReportUnrecognizedArguments(argc, &argv_for_benchmark[0]))
+        return -1;
+
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
+
+static exitcode_t HandleBenchScheduler(CommandLineArgEnumerator* argEnumerator)
+{
+    const char* const* argv = static_cast<const char* const*>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = cmdline_for_bench_scheduler(argc, argv);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+#else
+static exitcode_t HandleBenchScheduler(CommandLineArgEnumerator* argEnumerator)
+{
+    log_error("Sorry, Google benchmark not enabled in this build");
+    return EXITCODE_FAIL;
+}
+#endif // USE_BENCHMARK
+
+const CommandLineCommand CommandLine::BenchSchedulerCommands[]{
+#ifdef USE_BENCHMARK
+    DefineCommand(
+        "",
+        "[--benchmark_list_tests={true|false}] [--benchmark_filter=<regex>] [--benchmark_min_time=<min_time>] "
+        "[--benchmark_repetitions=<num_repetitions>] [--benchmark_report_aggregates_only={true|false}] "
+        "[--benchmark_format=<console|json|csv>] [--benchmark_out=<filename>] [--benchmark_out_format=<json|console|csv>] "
+        "[--benchmark_color={auto|true|false}] [--benchmark_counters_tabular={true|false}] [--v=<verbosity>]",
+        nullptr, HandleBenchScheduler),
+    CommandTableEnd
+#else
+    DefineCommand("", "*** SORRY NOT ENABLED IN THIS BUILD ***", nullptr, HandleBenchScheduler), CommandTableEnd
+#endif // USE_BENCHMARK
+};
@@ -0,0 +1,186 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "CommandLine.hpp"
+
+#ifdef USE_BENCHMARK
+
+#    include "../Context.h"
+#    include "../OpenRCT2.h"
+#    include "../PlatformEnvironment.h"
+#    include "../config/Config.h"
+#    include "../drawing/Drawing.h"
+#    include "../platform/platform.h"
+#    include "../sprites.h"
+
+#    include <benchmark/benchmark.h>
+#    include <cstdint>
+#    include <fstream>
+#    include <memory>
+#    include <string>
+#    include <vector>
+
+using namespace OpenRCT2;
+
+struct ResidentMemory
+{
+    int64_t AnonymousKiB = 0;
+    int64_t FileKiB = 0;
+};
+
+// Memory of the process that is in RAM, split into private memory and pages shared through the page cache. Only
+// available on Linux, other platforms report zero.
+static ResidentMemory GetResidentMemory()
+{
+    ResidentMemory result;
+#    ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string key;
+    while (status >> key)
+    {
+        if (key == "RssAnon:")
+            status >> result.AnonymousKiB;
+        else if (key == "RssFile:")
+            status >> result.FileKiB;
+        status.ignore(256, '\n');
+    }
+#    endif
+    return result;
+}
+
+static std::unique_ptr<IContext> _context;
+
+static void LoadSprites()
+{
+    gfx_load_g1(*_context->GetPlatformEnvironment());
+    gfx_load_g2();
+    gfx_load_csg();
+}
+
+static void UnloadSprites()
+{
+    gfx_unload_csg();
+    gfx_unload_g2();
+    gfx_unload_g1();
+}
+
+// Loads g1, g2 and csg the way a starting process does. The second argument also reads every element header once,
+// which is where mapped files pay for decoding them lazily.
+static void BM_sprite_load(benchmark::State& state)
+{
+    const bool mapped = state.range(0) != 0;
+    const bool readHeaders = state.range(1) != 0;
+    const auto savedMapSpriteFiles = gConfigGeneral.map_sprite_files;
+    gConfigGeneral.map_sprite_files = mapped;
+
+    ResidentMemory before;
+    ResidentMemory after;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        UnloadSprites();
+        before = GetResidentMemory();
+        state.ResumeTiming();
+
+        LoadSprites();
+        if (readHeaders)
+        {
+            for (int32_t i = 0; i < SPR_G1_END; i++)
+            {
+                benchmark::DoNotOptimize(gfx_get_g1_element(i));
+            }
+            for (int32_t i = SPR_CSG_BEGIN; i < SPR_CSG_END; i++)
+            {
+                benchmark::DoNotOptimize(gfx_get_g1_element(i));
+            }
+        }
+
+        state.PauseTiming();
+        after = GetResidentMemory();
+        state.ResumeTiming();
+    }
+    state.counters["rss_anon_kib"] = static_cast<double>(after.AnonymousKiB - before.AnonymousKiB);
+    state.counters["rss_file_kib"] = static_cast<double>(after.FileKiB - before.FileKiB);
+
+    gConfigGeneral.map_sprite_files = savedMapSpriteFiles;
+    UnloadSprites();
+    LoadSprites();
+}
+
+static int cmdline_for_bench_sprite_load(int argc, const char* const* argv)
+{
+    core_init();
+    gOpenRCT2Headless = true;
+    _context = CreateContext();
+    if (!_context->Initialise())
+    {
+        log_error("Failed to initialise context");
+        _context = nullptr;
+        return -1;
+    }
+
+    benchmark::RegisterBenchmark("SpriteLoad/read", BM_sprite_load)->Args({ 0, 0 })->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark("SpriteLoad/mapped", BM_sprite_load)->Args({ 1, 0 })->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark("SpriteLoad/read/headers", BM_sprite_load)->Args({ 0, 1 })->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark("SpriteLoad/mapped/headers", BM_sprite_load)->Args({ 1, 1 })->Unit(benchmark::kMillisecond);
+
+    // Google benchmark does stuff to argv. It doesn't modify the pointees,
+    // but it wants to reorder the pointers, so present a copy of them.
+    std::vector<char*> argv_for_benchmark;
+
+    // argv[0] is expected to contain the binary name. It's only for logging purposes, don't bother.
+    argv_for_benchmark.push_back(nullptr);
+    for (int i = 0; i < argc; i++)
+    {
+        argv_for_benchmark.push_back(const_cast<char*>(argv[i]));
+    }
+    argc = static_cast<int>(argv_for_benchmark.size());
+    ::benchmark::Initialize(&argc, &argv_for_benchmark[0]);
+    if (::benchmark::ReportUnrecognizedArguments(argc, &argv_for_benchmark[0]))
+        return -1;
+
+    ::benchmark::RunSpecifiedBenchmarks();
+    _context = nullptr;
+    return 0;
+}
+
+static exitcode_t HandleBenchSpriteLoad(CommandLineArgEnumerator* argEnumerator)
+{
+    const char* const* argv = static_cast<const char* const*>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = cmdline_for_bench_sprite_load(argc, argv);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+#else
+static exitcode_t HandleBenchSpriteLoad(CommandLineArgEnumerator* argEnumerator)
+{
+    log_error("Sorry, Google benchmark not enabled in this build");
+    return EXITCODE_FAIL;
+}
+#endif // USE_BENCHMARK
+
+const CommandLineCommand CommandLine::BenchSpriteLoadCommands[]{
+#ifdef USE_BENCHMARK
+    DefineCommand(
+        "",
+        "[--benchmark_list_tests={true|false}] [--benchmark_filter=<regex>] [--benchmark_min_time=<min_time>] "
+        "[--benchmark_repetitions=<num_repetitions>] [--benchmark_report_aggregates_only={true|false}] "
+        "[--benchmark_format=<console|json|csv>] [--benchmark_out=<filename>] [--benchmark_out_format=<json|console|csv>] "
+        "[--benchmark_color={auto|true|false}] [--benchmark_counters_tabular={true|false}] [--v=<verbosity>]",
+        nullptr, HandleBenchSpriteLoad),
+    CommandTableEnd
+#else
+    DefineCommand("", "*** SORRY NOT ENABLED IN THIS BUILD ***", nullptr, HandleBenchSpriteLoad), CommandTableEnd
+#endif // USE_BENCHMARK
+};
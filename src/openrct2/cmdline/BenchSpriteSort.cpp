@@ -32,12 +32,14 @@
 #    include <benchmark/benchmark.h>
 #    include <cstdint>
 #    include <iterator>
+#    include <string>
 #    include <vector>
 
-static void fixup_pointers(paint_session* s, size_t paint_session_entries, size_t paint_struct_entries, size_t quadrant_entries)
+static void fixup_pointers(paint_session* s, size_t paint_session_entries, size_t quadrant_entries)
 {
     for (size_t i = 0; i < paint_session_entries; i++)
     {
+        const size_t paint_struct_entries = std::size(s[i].PaintStructs);
         for (size_t j = 0; j < paint_struct_entries; j++)
         {
             if (s[i].PaintStructs[j].basic.next_quadrant_ps == reinterpret_cast<paint_struct*>(paint_struct_entries))
@@ -132,22 +134,67 @@ static std::vector<paint_session> extract_paint_session(const std::string parkFi
     return sessions;
 }
 
+// Walks the arranged drawing order of a session as positions in its paint entry pool.
+static std::vector<size_t> get_arranged_order(const paint_session& session)
+{
+    std::vector<size_t> order;
+    for (auto* ps = session.PaintHead.next_quadrant_ps; ps != nullptr; ps = ps->next_quadrant_ps)
+    {
+        order.push_back(session.PaintStructs.IndexOf(reinterpret_cast<const paint_entry*>(ps)));
+    }
+    return order;
+}
+
+/**
+ * Arranges every session with both arrange engines and checks they produce the same drawing order and quadrant flags.
+ */
+static bool verify_paint_session_arrange(const std::vector<paint_session>& inputSessions)
+{
+    std::vector<paint_session> linkedSessions = inputSessions;
+    std::vector<paint_session> arrayedSessions = inputSessions;
+    fixup_pointers(&linkedSessions[0], std::size(linkedSessions), std::size(linkedSessions[0].Quadrants));
+    fixup_pointers(&arrayedSessions[0], std::size(arrayedSessions), std::size(arrayedSessions[0].Quadrants));
+    for (size_t i = 0; i < std::size(inputSessions); i++)
+    {
+        auto& linked = linkedSessions[i];
+        auto& arrayed = arrayedSessions[i];
+        PaintSessionArrangeLinked(&linked);
+        PaintSessionArrange(&arrayed);
+        if (get_arranged_order(linked) != get_arranged_order(arrayed))
+        {
+            log_error("Paint session %zu is drawn in a different order by the two arrange engines.", i);
+            return false;
+        }
+        for (size_t j = 0; j < linked.PaintStructs.size(); j++)
+        {
+            if (linked.PaintStructs[j].basic.quadrant_flags != arrayed.PaintStructs[j].basic.quadrant_flags)
+            {
+                log_error("Paint session %zu has different quadrant flags after arranging with the two engines.", i);
+                return false;
+            }
+        }
+    }
+    log_info("Both arrange engines produce identical results for %zu paint sessions.", std::size(inputSessions));
+    return true;
+}
+
 // This function is based on benchgfx_render_screenshots
-static void BM_paint_session_arrange(benchmark::State& state, const std::vector<paint_session> inputSessions)
+static void BM_paint_session_arrange(
+    benchmark::State& state, const std::vector<paint_session> inputSessions, void (*arrange)(paint_session*))
 {
     std::vector<paint_session> sessions = inputSessions;
     // Fixing up the pointers continuously is wasteful. Fix it up once for `sessions` and store a copy.
     // Keep in mind we need bit-exact copy, as the lists use pointers.
     // Once sorted, just restore the copy with the original fixed-up version.
     paint_session* local_s = new paint_session[std::size(sessions)];
-    fixup_pointers(&sessions[0], std::size(sessions), std::size(local_s->PaintStructs), std::size(local_s->Quadrants));
+    fixup_pointers(&sessions[0], std::size(sessions), std::size(local_s->Quadrants));
     std::copy_n(sessions.cbegin(), std::size(sessions), local_s);
     for (auto _ : state)
     {
         state.PauseTiming();
         std::copy_n(local_s, std::size(sessions), sessions.begin());
         state.ResumeTiming();
-        PaintSessionArrange(&sessions[0]);
+        arrange(&sessions[0]);
         benchmark::DoNotOptimize(sessions);
     }
     state.SetItemsProcessed(state.iterations() * std::size(sessions));
@@ -167,7 +214,7 @@ static int cmdline_for_bench_sprite_sort(int argc, const char** argv)
         {
             quad = reinterpret_cast<paint_struct*>((std::size(sessions[0].Quadrants)));
         }
-        benchmark::RegisterBenchmark("baseline", BM_paint_session_arrange, sessions);
+        benchmark::RegisterBenchmark("baseline", BM_paint_session_arrange, sessions, PaintSessionArrange);
     }
 
     // Google benchmark does stuff to argv. It doesn't modify the pointees,
@@ -185,7 +232,14 @@ static int cmdline_for_bench_sprite_sort(int argc, const char** argv)
             // Register benchmark for sv6 if valid
             std::vector<paint_session> sessions = extract_paint_session(argv[i]);
             if (!sessions.empty())
-                benchmark::RegisterBenchmark(argv[i], BM_paint_session_arrange, sessions);
+            {
+                if (!verify_paint_session_arrange(sessions))
+                    return -1;
+                benchmark::RegisterBenchmark(argv[i], BM_paint_session_arrange, sessions, PaintSessionArrange);
+                benchmark::RegisterBenchmark(
+                    (std::string(argv[i]) + " (linked)").c_str(), BM_paint_session_arrange, sessions,
+                    PaintSessionArrangeLinked);
+            }
         }
         else
         {
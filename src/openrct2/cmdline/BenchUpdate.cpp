@@ -12,85 +12,586 @@
 #ifdef USE_BENCHMARK
 
 #    include "../Context.h"
+#    include "../Game.h"
 #    include "../GameState.h"
 #    include "../OpenRCT2.h"
+#    include "../actions/FootpathPlaceAction.h"
+#    include "../actions/RideCreateAction.h"
+#    include "../actions/RideSetStatusAction.h"
+#    include "../actions/TrackPlaceAction.h"
+#    include "../core/Console.hpp"
+#    include "../core/Json.hpp"
+#    include "../object/ObjectManager.h"
+#    include "../peep/GuestPathfindingCache.h"
+#    include "../peep/GuestSurroundings.h"
+#    include "../peep/Peep.h"
 #    include "../platform/Platform2.h"
 #    include "../platform/platform.h"
+#    include "../ride/Ride.h"
+#    include "../ride/Track.h"
+#    include "../scenario/Scenario.h"
+#    include "../world/Map.h"
+#    include "../world/Park.h"
+#    include "../world/Surface.h"
 
+#    include <algorithm>
+#    include <array>
+#    include <atomic>
 #    include <benchmark/benchmark.h>
+#    include <cmath>
 #    include <cstdint>
+#    include <cstdlib>
 #    include <iterator>
-#    include <numeric>
+#    include <map>
+#    include <new>
+#    include <optional>
+#    include <string>
 #    include <vector>
 
 using namespace OpenRCT2;
 
-static void BM_update(benchmark::State& state, const std::string& filename)
+#    ifdef ENABLE_BENCHMARK_ALLOCATIONS
+// Allocations made by the whole program, the update benchmark reports the ones made while updating the game. Replacing
+// the global allocation functions slows every allocation down, so this is only built in when asked for.
+static std::atomic<uint64_t> _allocationCount{ 0 };
+static std::atomic<uint64_t> _allocationBytes{ 0 };
+
+static void* bench_allocate(std::size_t size)
+{
+    _allocationCount.fetch_add(1, std::memory_order_relaxed);
+    _allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new(std::size_t size)
+{
+    void* ptr = bench_allocate(size);
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+    void* ptr = bench_allocate(size);
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return bench_allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return bench_allocate(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+#    endif
+
+static constexpr std::pair<LogicTimePart, const char*> LogicTimePartNames[] = {
+    { LogicTimePart::NetworkUpdate, "NetworkUpdate" },
+    { LogicTimePart::Date, "Date" },
+    { LogicTimePart::Scenario, "Scenario" },
+    { LogicTimePart::Climate, "Climate" },
+    { LogicTimePart::MapTiles, "MapTiles" },
+    { LogicTimePart::MapStashProvisionalElements, "MapStashProvisionalElements" },
+    { LogicTimePart::MapPathWideFlags, "MapPathWideFlags" },
+    { LogicTimePart::Peep, "Peep" },
+    { LogicTimePart::MapRestoreProvisionalElements, "MapRestoreProvisionalElements" },
+    { LogicTimePart::Vehicle, "Vehicle" },
+    { LogicTimePart::Misc, "Misc" },
+    { LogicTimePart::Ride, "Ride" },
+    { LogicTimePart::Park, "Park" },
+    { LogicTimePart::Research, "Research" },
+    { LogicTimePart::RideRatings, "RideRatings" },
+    { LogicTimePart::RideMeasurments, "RideMeasurments" },
+    { LogicTimePart::News, "News" },
+    { LogicTimePart::MapAnimation, "MapAnimation" },
+    { LogicTimePart::Sounds, "Sounds" },
+    { LogicTimePart::GameActions, "GameActions" },
+    { LogicTimePart::NetworkFlush, "NetworkFlush" },
+    { LogicTimePart::Scripts, "Scripts" },
+};
+static constexpr size_t LogicTimePartCount = std::size(LogicTimePartNames);
+
+// Default regression threshold for --compare, in percent.
+static constexpr double DefaultRegressionThreshold = 10.0;
+// Parts taking only a few microseconds vary more than any sensible threshold, changes below this are ignored.
+static constexpr double RegressionNoiseFloorUs = 5.0;
+
+/**
+ * A park generated for the benchmark: a grid of footpaths over flat land with food stalls along the paths and
+ * guests spread over them, so the update cost can be measured against each of the three on its own.
+ */
+struct SyntheticParkSpec
+{
+    int32_t MapSize;
+    int32_t Rides;
+    int32_t Guests;
+};
+
+static constexpr SyntheticParkSpec SyntheticParks[] = {
+    // Map size
+    { 64, 8, 250 },
+    { 128, 8, 250 },
+    { 256, 8, 250 },
+    // Rides
+    { 128, 32, 250 },
+    { 128, 128, 250 },
+    // Guests
+    { 128, 8, 2000 },
+    { 128, 8, 8000 },
+};
+
+struct BenchUpdatePark
+{
+    std::string File;
+    std::optional<SyntheticParkSpec> Synthetic;
+};
+
+struct BenchUpdatePartResult
+{
+    double P50Us = 0;
+    double P99Us = 0;
+    double TotalMs = 0;
+};
+
+struct BenchUpdateResult
+{
+    uint64_t Ticks = 0;
+    std::array<std::optional<BenchUpdatePartResult>, LogicTimePartCount> Parts;
+    BenchUpdatePartResult Tick;
+    double AllocationsPerTick = 0;
+    double BytesAllocatedPerTick = 0;
+};
+
+// Results of the last run of each benchmark, by benchmark name.
+static std::map<std::string, BenchUpdateResult> _results;
+
+static bool bench_place_shop(ObjectEntryIndex stallEntryIndex, const CoordsXYZ& loc, Direction direction)
+{
+    auto rideCreateAction = RideCreateAction(RIDE_TYPE_FOOD_STALL, stallEntryIndex, 0, 0);
+    auto rideCreateResult = GameActions::Execute(&rideCreateAction);
+    if (rideCreateResult->Error != GameActions::Status::Ok)
+        return false;
+
+    const auto rideIndex = static_cast<const RideCreateGameActionResult*>(rideCreateResult.get())->rideIndex;
+    auto trackPlaceAction = TrackPlaceAction(
+        rideIndex, TrackElemType::FlatTrack1x1A, CoordsXYZD(loc, direction), 0, 0, 4, 0, false);
+    if (GameActions::Execute(&trackPlaceAction)->Error != GameActions::Status::Ok)
+        return false;
+
+    auto rideSetStatusAction = RideSetStatusAction(rideIndex, RIDE_STATUS_OPEN);
+    GameActions::Execute(&rideSetStatusAction);
+    return true;
+}
+
+/**
+ * Builds the park on a new map: a path along the west edge with a street leading off it every third row, and a
+ * stall facing each street from the row south of it. Stalls and guests are spread evenly over the streets.
+ */
+static bool bench_generate_synthetic_park(IContext& context, const SyntheticParkSpec& spec)
+{
+    auto& objManager = context.GetObjectManager();
+    objManager.UnloadAll();
+    objManager.LoadDefaultObjects();
+    auto pathObject = objManager.LoadObject("rct2.tarmac");
+    auto stallObject = objManager.LoadObject("rct2.burgb");
+    if (pathObject == nullptr || stallObject == nullptr)
+    {
+        log_error("Objects for the synthetic park are missing.");
+        return false;
+    }
+    const auto pathEntryIndex = objManager.GetLoadedObjectEntryIndex(pathObject);
+    const auto stallEntryIndex = objManager.GetLoadedObjectEntryIndex(stallObject);
+
+    context.GetGameState()->InitAll(spec.MapSize);
+    gScreenFlags = SCREEN_FLAGS_PLAYING;
+    gParkFlags |= PARK_FLAGS_NO_MONEY | PARK_FLAGS_PARK_OPEN;
+
+    // Keep clear of the map edge, which cannot be built on.
+    const int32_t first = 2;
+    const int32_t last = spec.MapSize - 3;
+    for (int32_t y = first; y <= last; y++)
+    {
+        for (int32_t x = first; x <= last; x++)
+        {
+            auto surfaceElement = map_get_surface_element_at(TileCoordsXY{ x, y }.ToCoordsXY());
+            if (surfaceElement != nullptr)
+            {
+                surfaceElement->SetOwnership(OWNERSHIP_OWNED);
+            }
+        }
+    }
+
+    std::vector<TileCoordsXY> pathTiles;
+    std::vector<TileCoordsXY> shopTiles;
+    for (int32_t y = first; y <= last; y++)
+    {
+        const bool isStreet = (y - first) % 3 == 0;
+        for (int32_t x = first; x <= last; x++)
+        {
+            if (x == first || isStreet)
+            {
+                pathTiles.emplace_back(x, y);
+            }
+            else if ((y - first) % 3 == 1)
+            {
+                shopTiles.emplace_back(x, y);
+            }
+        }
+    }
+    if (spec.Rides > static_cast<int32_t>(shopTiles.size()) || spec.Guests > static_cast<int32_t>(pathTiles.size()))
+    {
+        log_error("Synthetic park does not fit on the map.");
+        return false;
+    }
+
+    // Stalls first so the paths placed next to them connect to them. The street is north of each stall.
+    for (int32_t i = 0; i < spec.Rides; i++)
+    {
+        const auto& tile = shopTiles[i * shopTiles.size() / spec.Rides];
+        const auto loc = tile.ToCoordsXY();
+        if (!bench_place_shop(stallEntryIndex, { loc, tile_element_height(loc) }, 3))
+        {
+            log_error("Failed to place a stall for the synthetic park.");
+            return false;
+        }
+    }
+
+    for (const auto& tile : pathTiles)
+    {
+        const auto loc = tile.ToCoordsXY();
+        auto footpathPlaceAction = FootpathPlaceAction({ loc, tile_element_height(loc) }, 0, pathEntryIndex);
+        if (GameActions::Execute(&footpathPlaceAction)->Error != GameActions::Status::Ok)
+        {
+            log_error("Failed to place a path for the synthetic park.");
+            return false;
+        }
+    }
+
+    for (int32_t i = 0; i < spec.Guests; i++)
+    {
+        const auto loc = pathTiles[i * pathTiles.size() / spec.Guests].ToCoordsXY().ToTileCentre();
+        auto peep = Peep::Generate({ loc, tile_element_height(loc) });
+        auto guest = peep != nullptr ? peep->As<Guest>() : nullptr;
+        if (guest == nullptr)
+        {
+            log_error("Failed to create a guest for the synthetic park.");
+            return false;
+        }
+        guest->OutsideOfPark = false;
+        guest->SetParkEntryTime(gScenarioTicks);
+        increment_guests_in_park();
+    }
+    return true;
+}
+
+static double bench_percentile(std::vector<double>& samples, double fraction)
+{
+    if (samples.empty())
+        return 0;
+
+    // Nearest rank
+    auto rank = static_cast<size_t>(std::ceil(fraction * samples.size()));
+    auto nth = samples.begin() + (std::max<size_t>(rank, 1) - 1);
+    std::nth_element(samples.begin(), nth, samples.end());
+    return *nth;
+}
+
+static BenchUpdatePartResult bench_summarise(std::vector<double>& samplesUs)
+{
+    BenchUpdatePartResult result;
+    for (auto sample : samplesUs)
+    {
+        result.TotalMs += sample / 1000.0;
+    }
+    result.P50Us = bench_percentile(samplesUs, 0.50);
+    result.P99Us = bench_percentile(samplesUs, 0.99);
+    return result;
+}
+
+static void BM_update(benchmark::State& state, const std::string& name, const BenchUpdatePark& park)
 {
     std::unique_ptr<IContext> context(CreateContext());
     if (context->Initialise())
     {
-        if (!filename.empty() && !context->LoadParkFromFile(filename))
+        if (park.Synthetic.has_value())
+        {
+            if (!bench_generate_synthetic_park(*context, *park.Synthetic))
+            {
+                state.SkipWithError("Failed to generate park!");
+                return;
+            }
+        }
+        else if (!park.File.empty() && !context->LoadParkFromFile(park.File))
         {
             state.SkipWithError("Failed to load file!");
         }
 
-        std::vector<LogicTimings> timings(1);
-        timings.reserve(100);
-        int currentTimingIdx = 0;
+        // LogicTimings holds the time from the start of the tick to the end of each part, per tick the time of
+        // each part is taken out of it right away.
+        LogicTimings timings;
+        std::array<std::vector<double>, LogicTimePartCount> partSamples;
+        std::vector<double> tickSamples;
+        for (auto& samples : partSamples)
+        {
+            samples.reserve(state.max_iterations);
+        }
+        tickSamples.reserve(state.max_iterations);
+
+        [[maybe_unused]] uint64_t allocations = 0;
+        [[maybe_unused]] uint64_t allocationBytes = 0;
+        surroundings_reset_stats();
+        pathfinding_cache_reset_stats();
         for (auto _ : state)
         {
-            if (timings[currentTimingIdx].CurrentIdx == (LOGIC_UPDATE_MEASUREMENTS_COUNT - 1))
+            const auto timingIdx = timings.CurrentIdx;
+#    ifdef ENABLE_BENCHMARK_ALLOCATIONS
+            const auto allocationsBefore = _allocationCount.load(std::memory_order_relaxed);
+            const auto allocationBytesBefore = _allocationBytes.load(std::memory_order_relaxed);
+            context->GetGameState()->UpdateLogic(&timings);
+            allocations += _allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+            allocationBytes += _allocationBytes.load(std::memory_order_relaxed) - allocationBytesBefore;
+#    else
+            context->GetGameState()->UpdateLogic(&timings);
+#    endif
+
+            std::chrono::duration<double> previous{};
+            for (size_t i = 0; i < LogicTimePartCount; i++)
             {
-                timings.resize(timings.size() + 1);
-                currentTimingIdx++;
+                auto it = timings.TimingInfo.find(LogicTimePartNames[i].first);
+                if (it == timings.TimingInfo.end())
+                    continue;
+
+                const auto elapsed = it->second[timingIdx];
+                partSamples[i].push_back(std::chrono::duration<double, std::micro>(elapsed - previous).count());
+                previous = elapsed;
             }
-            LogicTimings* timingToUse = &timings[currentTimingIdx];
-            context->GetGameState()->UpdateLogic(timingToUse);
+            tickSamples.push_back(std::chrono::duration<double, std::micro>(previous).count());
         }
         state.SetItemsProcessed(state.iterations());
-        auto accumulator = [timings](LogicTimePart part) -> double {
-            std::chrono::duration<double> timesum;
-            for (const auto& timing : timings)
+
+        BenchUpdateResult result;
+        result.Ticks = state.iterations();
+        for (size_t i = 0; i < LogicTimePartCount; i++)
+        {
+            if (partSamples[i].empty())
+                continue;
+
+            const std::string partName = LogicTimePartNames[i].second;
+            const auto partResult = bench_summarise(partSamples[i]);
+            state.counters[partName + "Acc_ms"] = partResult.TotalMs;
+            state.counters[partName + "_p50_us"] = partResult.P50Us;
+            state.counters[partName + "_p99_us"] = partResult.P99Us;
+            result.Parts[i] = partResult;
+        }
+        result.Tick = bench_summarise(tickSamples);
+        state.counters["Tick_p50_us"] = result.Tick.P50Us;
+        state.counters["Tick_p99_us"] = result.Tick.P99Us;
+
+#    ifdef ENABLE_BENCHMARK_ALLOCATIONS
+        if (result.Ticks > 0)
+        {
+            result.AllocationsPerTick = static_cast<double>(allocations) / result.Ticks;
+            result.BytesAllocatedPerTick = static_cast<double>(allocationBytes) / result.Ticks;
+        }
+        state.counters["AllocationsPerTick"] = result.AllocationsPerTick;
+        state.counters["BytesAllocatedPerTick"] = result.BytesAllocatedPerTick;
+#    endif
+        _results[name] = result;
+
+        const auto surroundingsStats = surroundings_get_stats();
+        state.counters["SurroundingsHits"] = static_cast<double>(surroundingsStats.Hits);
+        state.counters["SurroundingsMisses"] = static_cast<double>(surroundingsStats.Misses);
+        const auto pathfindingStats = pathfinding_cache_get_stats();
+        state.counters["PathfindingFieldsBuilt"] = static_cast<double>(pathfindingStats.FieldsBuilt);
+        state.counters["PathfindingHits"] = static_cast<double>(pathfindingStats.Hits);
+        state.counters["PathfindingMisses"] = static_cast<double>(pathfindingStats.Misses);
+    }
+    else
+    {
+        state.SkipWithError("Context initialization failed.");
+    }
+}
+
+static void RegisterUpdateBenchmark(const std::string& name, const BenchUpdatePark& park)
+{
+    benchmark::RegisterBenchmark(name.c_str(), BM_update, name, park);
+}
+
+static json_t BenchResultsToJson()
+{
+    auto benchmarks = json_t::object();
+    for (const auto& [name, result] : _results)
+    {
+        auto parts = json_t::object();
+        for (size_t i = 0; i < LogicTimePartCount; i++)
+        {
+            if (const auto& part = result.Parts[i])
             {
-                timesum = std::accumulate(
-                    timing.TimingInfo.at(part).begin(), timing.TimingInfo.at(part).end(), std::chrono::duration<double>());
+                parts[LogicTimePartNames[i].second] = {
+                    { "p50_us", part->P50Us },
+                    { "p99_us", part->P99Us },
+                    { "total_ms", part->TotalMs },
+                };
             }
-            return std::chrono::duration_cast<std::chrono::milliseconds>(timesum).count();
+        }
+        benchmarks[name] = {
+            { "ticks", result.Ticks },
+            { "tick", { { "p50_us", result.Tick.P50Us }, { "p99_us", result.Tick.P99Us } } },
+            { "parts", parts },
         };
-        state.counters["NetworkUpdateAcc_ms"] = accumulator(LogicTimePart::NetworkUpdate);
-        state.counters["DateAcc_ms"] = accumulator(LogicTimePart::Date);
-        state.counters["ScenarioAcc_ms"] = accumulator(LogicTimePart::Scenario);
-        state.counters["ClimateAcc_ms"] = accumulator(LogicTimePart::Climate);
-        state.counters["MapTilesAcc_ms"] = accumulator(LogicTimePart::MapTiles);
-        state.counters["MapStashProvisionalElementsAcc_ms"] = accumulator(LogicTimePart::MapStashProvisionalElements);
-        state.counters["MapPathWideFlagsAcc_ms"] = accumulator(LogicTimePart::MapPathWideFlags);
-        state.counters["PeepAcc_ms"] = accumulator(LogicTimePart::Peep);
-        state.counters["MapRestoreProvisionalElementsAcc_ms"] = accumulator(LogicTimePart::MapRestoreProvisionalElements);
-        state.counters["VehicleAcc_ms"] = accumulator(LogicTimePart::Vehicle);
-        state.counters["MiscAcc_ms"] = accumulator(LogicTimePart::Misc);
-        state.counters["RideAcc_ms"] = accumulator(LogicTimePart::Ride);
-        state.counters["ParkAcc_ms"] = accumulator(LogicTimePart::Park);
-        state.counters["ResearchAcc_ms"] = accumulator(LogicTimePart::Research);
-        state.counters["RideRatingsAcc_ms"] = accumulator(LogicTimePart::RideRatings);
-        state.counters["RideMeasurmentsAcc_ms"] = accumulator(LogicTimePart::RideMeasurments);
-        state.counters["NewsAcc_ms"] = accumulator(LogicTimePart::News);
-        state.counters["MapAnimationAcc_ms"] = accumulator(LogicTimePart::MapAnimation);
-        state.counters["SoundsAcc_ms"] = accumulator(LogicTimePart::Sounds);
-        state.counters["GameActionsAcc_ms"] = accumulator(LogicTimePart::GameActions);
-        state.counters["NetworkFlushAcc_ms"] = accumulator(LogicTimePart::NetworkFlush);
-        state.counters["ScriptsAcc_ms"] = accumulator(LogicTimePart::Scripts);
+#    ifdef ENABLE_BENCHMARK_ALLOCATIONS
+        benchmarks[name]["allocations_per_tick"] = result.AllocationsPerTick;
+        benchmarks[name]["bytes_allocated_per_tick"] = result.BytesAllocatedPerTick;
+#    endif
     }
-    else
+    return { { "benchmarks", benchmarks } };
+}
+
+static bool BenchIsRegression(double baseline, double current, double threshold, double noiseFloor)
+{
+    return current - baseline > noiseFloor && current > baseline * (1.0 + threshold / 100.0);
+}
+
+/**
+ * Compares the median time of each part and of the whole tick and, when counted, the allocations per tick with the
+ * baseline, prints every regression past the threshold and returns how many there were.
+ */
+static int32_t BenchCompareResults(const json_t& baseline, const json_t& current, double threshold)
+{
+    int32_t regressions = 0;
+    auto check = [&](const std::string& what, double baselineValue, double currentValue, double noiseFloor) {
+        if (BenchIsRegression(baselineValue, currentValue, threshold, noiseFloor))
+        {
+            Console::Error::WriteLine(
+                "REGRESSION %s: %.2f -> %.2f (+%.1f%%)", what.c_str(), baselineValue, currentValue,
+                (currentValue / baselineValue - 1.0) * 100.0);
+            regressions++;
+        }
+    };
+
+    const auto& baselineBenchmarks = baseline["benchmarks"];
+    for (const auto& [name, result] : current["benchmarks"].items())
     {
-        state.SkipWithError("Context initialization failed.");
+        if (!baselineBenchmarks.contains(name))
+        {
+            Console::WriteLine("%s: not in baseline, skipped", name.c_str());
+            continue;
+        }
+
+        const auto& baselineResult = baselineBenchmarks[name];
+        check(
+            name + " tick p50_us", Json::GetNumber<double>(baselineResult["tick"]["p50_us"]),
+            Json::GetNumber<double>(result["tick"]["p50_us"]), RegressionNoiseFloorUs);
+        for (const auto& [partName, part] : result["parts"].items())
+        {
+            if (baselineResult["parts"].contains(partName))
+            {
+                check(
+                    name + " " + partName + " p50_us", Json::GetNumber<double>(baselineResult["parts"][partName]["p50_us"]),
+                    Json::GetNumber<double>(part["p50_us"]), RegressionNoiseFloorUs);
+            }
+        }
+        // Allocations are only counted in builds with ENABLE_BENCHMARK_ALLOCATIONS
+        if (baselineResult.contains("allocations_per_tick") && result.contains("allocations_per_tick"))
+        {
+            check(
+                name + " allocations_per_tick", Json::GetNumber<double>(baselineResult["allocations_per_tick"]),
+                Json::GetNumber<double>(result["allocations_per_tick"]), 1.0);
+        }
+    }
+    return regressions;
+}
+
+/**
+ * Takes the value of an option given either as --name=value or as --name value out of the arguments.
+ */
+static std::optional<std::string> BenchTakeOption(std::vector<const char*>& args, std::string_view option)
+{
+    for (auto it = args.begin(); it != args.end(); it++)
+    {
+        std::string_view arg = *it;
+        if (arg == option && std::next(it) != args.end())
+        {
+            std::string value = *std::next(it);
+            args.erase(it, it + 2);
+            return value;
+        }
+        if (arg.size() > option.size() && arg.substr(0, option.size()) == option && arg[option.size()] == '=')
+        {
+            std::string value(arg.substr(option.size() + 1));
+            args.erase(it);
+            return value;
+        }
     }
+    return std::nullopt;
 }
 
 static int CmdlineForBenchSpriteSort(int argc, const char* const* argv)
 {
+    std::vector<const char*> args(argv, argv + argc);
+    const auto jsonPath = BenchTakeOption(args, "--json");
+    const auto comparePath = BenchTakeOption(args, "--compare");
+    const auto thresholdArg = BenchTakeOption(args, "--threshold");
+    const double threshold = thresholdArg.has_value() ? std::atof(thresholdArg->c_str()) : DefaultRegressionThreshold;
+
+    json_t baseline;
+    if (comparePath.has_value())
+    {
+        try
+        {
+            baseline = Json::ReadFromFile(comparePath->c_str());
+        }
+        catch (const std::exception& e)
+        {
+            Console::Error::WriteLine("Unable to read baseline %s: %s", comparePath->c_str(), e.what());
+            return -1;
+        }
+    }
+
     // Add a baseline test on an empty park
-    benchmark::RegisterBenchmark("baseline", BM_update, std::string{});
+    RegisterUpdateBenchmark("baseline", {});
+    for (const auto& spec : SyntheticParks)
+    {
+        RegisterUpdateBenchmark(
+            "synthetic/map:" + std::to_string(spec.MapSize) + "/rides:" + std::to_string(spec.Rides)
+                + "/guests:" + std::to_string(spec.Guests),
+            { {}, spec });
+    }
 
     // Google benchmark does stuff to argv. It doesn't modify the pointees,
     // but it wants to reorder the pointers, so present a copy of them.
@@ -100,16 +601,16 @@ static int CmdlineForBenchSpriteSort(int argc, const char* const* argv)
     argv_for_benchmark.push_back(nullptr);
 
     // Extract file names from argument list. If there is no such file, consider it benchmark option.
-    for (int i = 0; i < argc; i++)
+    for (const auto* arg : args)
     {
-        if (Platform::FileExists(argv[i]))
+        if (Platform::FileExists(arg))
         {
             // Register benchmark for sv6 if valid
-            benchmark::RegisterBenchmark(argv[i], BM_update, argv[i]);
+            RegisterUpdateBenchmark(arg, { arg, std::nullopt });
         }
         else
         {
-            argv_for_benchmark.push_back(const_cast<char*>(argv[i]));
+            argv_for_benchmark.push_back(const_cast<char*>(arg));
         }
     }
     // Update argc with all the changes made
@@ -122,6 +623,32 @@ static int CmdlineForBenchSpriteSort(int argc, const char* const* argv)
     gOpenRCT2Headless = true;
 
     ::benchmark::RunSpecifiedBenchmarks();
+
+    const auto results = BenchResultsToJson();
+    if (jsonPath.has_value())
+    {
+        try
+        {
+            Json::WriteToFile(jsonPath->c_str(), results);
+        }
+        catch (const std::exception& e)
+        {
+            Console::Error::WriteLine("Unable to write %s: %s", jsonPath->c_str(), e.what());
+            return -1;
+        }
+    }
+
+    if (comparePath.has_value())
+    {
+        const auto regressions = BenchCompareResults(baseline, results, threshold);
+        if (regressions > 0)
+        {
+            Console::Error::WriteLine(
+                "%d regression(s) past %.1f%% compared to %s", regressions, threshold, comparePath->c_str());
+            return -1;
+        }
+        Console::WriteLine("No regressions past %.1f%% compared to %s", threshold, comparePath->c_str());
+    }
     return 0;
 }
 
@@ -149,7 +676,8 @@ const CommandLineCommand CommandLine::BenchUpdateCommands[]{
 #ifdef USE_BENCHMARK
     DefineCommand(
         "",
-        "<file>... [--benchmark_list_tests={true|false}] [--benchmark_filter=<regex>] [--benchmark_min_time=<min_time>] "
+        "<file>... [--json=<file>] [--compare=<baseline.json>] [--threshold=<percent>] "
+        "[--benchmark_list_tests={true|false}] [--benchmark_filter=<regex>] [--benchmark_min_time=<min_time>] "
         "[--benchmark_repetitions=<num_repetitions>] [--benchmark_report_aggregates_only={true|false}] "
         "[--benchmark_format=<console|json|csv>] [--benchmark_out=<filename>] [--benchmark_out_format=<json|console|csv>] "
         "[--benchmark_color={auto|true|false}] [--benchmark_counters_tabular={true|false}] [--v=<verbosity>]",
@@ -119,6 +119,10 @@ namespace CommandLine
     extern const CommandLineCommand BenchGfxCommands[];
     extern const CommandLineCommand BenchSpriteSortCommands[];
     extern const CommandLineCommand BenchUpdateCommands[];
+    extern const CommandLineCommand BenchSchedulerCommands[];
+    extern const CommandLineCommand BenchRidePresenceCommands[];
+    extern const CommandLineCommand BenchSpriteLoadCommands[];
+    extern const CommandLineCommand BenchNetworkCommands[];
     extern const CommandLineCommand SimulateCommands[];
 
     extern const CommandLineExample RootExamples[];
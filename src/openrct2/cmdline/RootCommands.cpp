@@ -141,6 +141,10 @@ const CommandLineCommand CommandLine::RootCommands[]
     DefineSubCommand("benchgfx",        CommandLine::BenchGfxCommands         ),
     DefineSubCommand("benchspritesort", CommandLine::BenchSpriteSortCommands  ),
     DefineSubCommand("benchsimulate",   CommandLine::BenchUpdateCommands      ),
+    DefineSubCommand("benchscheduler",  CommandLine::BenchSchedulerCommands   ),
+    DefineSubCommand("benchridepresence", CommandLine::BenchRidePresenceCommands),
+    DefineSubCommand("benchspriteload", CommandLine::BenchSpriteLoadCommands  ),
+    DefineSubCommand("benchnetwork",    CommandLine::BenchNetworkCommands     ),
     DefineSubCommand("simulate",        CommandLine::SimulateCommands         ),
     CommandTableEnd
 };
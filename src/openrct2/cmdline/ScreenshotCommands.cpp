@@ -25,16 +25,19 @@ static constexpr const CommandLineOptionDefinition ScreenshotOptionsDef[]
     { CMDLINE_TYPE_SWITCH,  &_options.remove_litter, NAC, "remove-litter", "remove litter for the screenshot" },
     { CMDLINE_TYPE_SWITCH,  &_options.tidy_up_park,  NAC, "tidy-up-park",  "clear grass, water plants, fix vandalism and remove litter" },
     { CMDLINE_TYPE_SWITCH,  &_options.transparent,   NAC, "transparent",   "make the background transparent" },
+    { CMDLINE_TYPE_INTEGER, &_options.tile_size,     NAC, "tile-size",     "render giant screenshots in bands of this many rows" },
     OptionTableEnd
 };
 
 static exitcode_t HandleScreenshot(CommandLineArgEnumerator *argEnumerator);
+static exitcode_t HandleScreenshotServe(CommandLineArgEnumerator *argEnumerator);
 
 const CommandLineCommand CommandLine::ScreenshotCommands[]
 {
     // Main commands
     DefineCommand("", "<file> <output_image> <width> <height> [<x> <y> <zoom> <rotation>]", ScreenshotOptionsDef, HandleScreenshot),
     DefineCommand("", "<file> <output_image> giant <zoom> <rotation>",                      ScreenshotOptionsDef, HandleScreenshot),
+    DefineCommand("serve", "",                                                              ScreenshotOptionsDef, HandleScreenshotServe),
     CommandTableEnd
 };
 // clang-format on
@@ -50,3 +53,13 @@ static exitcode_t HandleScreenshot(CommandLineArgEnumerator* argEnumerator)
     }
     return EXITCODE_OK;
 }
+
+static exitcode_t HandleScreenshotServe([[maybe_unused]] CommandLineArgEnumerator* argEnumerator)
+{
+    int32_t result = cmdline_for_screenshot_server(&_options);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
@@ -209,6 +209,14 @@ namespace Config
                 "scale_quality", ScaleQuality::SmoothNearestNeighbour, Enum_ScaleQuality);
             model->show_fps = reader->GetBoolean("show_fps", false);
             model->multithreading = reader->GetBoolean("multi_threading", false);
+            model->multithreading_pin_threads = reader->GetBoolean("multi_threading_pin_threads", false);
+            model->multithreading_guest_update = reader->GetBoolean("multi_threading_guest_update", false);
+            model->multithreading_viewport_drawing = reader->GetBoolean("multi_threading_viewport_drawing", false);
+            model->guest_pathfinding_distance_fields = reader->GetBoolean("guest_pathfinding_distance_fields", false);
+            model->incremental_wide_path_flags = reader->GetBoolean("incremental_wide_path_flags", false);
+            model->paint_tile_cache = reader->GetBoolean("paint_tile_cache", false);
+            model->map_sprite_files = reader->GetBoolean("map_sprite_files", true);
+            model->zoomed_sprite_cache = reader->GetBoolean("zoomed_sprite_cache", true);
             model->trap_cursor = reader->GetBoolean("trap_cursor", false);
             model->auto_open_shops = reader->GetBoolean("auto_open_shops", false);
             model->scenario_select_mode = reader->GetInt32("scenario_select_mode", SCENARIO_SELECT_MODE_ORIGIN);
@@ -285,6 +293,14 @@ namespace Config
         writer->WriteEnum<ScaleQuality>("scale_quality", model->scale_quality, Enum_ScaleQuality);
         writer->WriteBoolean("show_fps", model->show_fps);
         writer->WriteBoolean("multi_threading", model->multithreading);
+        writer->WriteBoolean("multi_threading_pin_threads", model->multithreading_pin_threads);
+        writer->WriteBoolean("multi_threading_guest_update", model->multithreading_guest_update);
+        writer->WriteBoolean("multi_threading_viewport_drawing", model->multithreading_viewport_drawing);
+        writer->WriteBoolean("guest_pathfinding_distance_fields", model->guest_pathfinding_distance_fields);
+        writer->WriteBoolean("incremental_wide_path_flags", model->incremental_wide_path_flags);
+        writer->WriteBoolean("paint_tile_cache", model->paint_tile_cache);
+        writer->WriteBoolean("map_sprite_files", model->map_sprite_files);
+        writer->WriteBoolean("zoomed_sprite_cache", model->zoomed_sprite_cache);
         writer->WriteBoolean("trap_cursor", model->trap_cursor);
         writer->WriteBoolean("auto_open_shops", model->auto_open_shops);
         writer->WriteInt32("scenario_select_mode", model->scenario_select_mode);
@@ -42,6 +42,14 @@ struct GeneralConfiguration
     bool use_vsync;
     bool show_fps;
     bool multithreading;
+    bool multithreading_pin_threads;
+    bool multithreading_guest_update;
+    bool multithreading_viewport_drawing;
+    bool guest_pathfinding_distance_fields;
+    bool incremental_wide_path_flags;
+    bool paint_tile_cache;
+    bool map_sprite_files;
+    bool zoomed_sprite_cache;
     bool minimize_fullscreen_focus_loss;
     bool disable_screensaver;
 
@@ -17,6 +17,8 @@
 #include "../util/Util.h"
 #include "File.h"
 #include "FileStream.h"
+#include "Hash.hpp"
+#include "MemoryMappedFile.h"
 #include "String.hpp"
 
 #include <fstream>
@@ -119,10 +121,38 @@ namespace File
         fs.Write(buffer, length);
     }
 
+    void WriteAllBytesAtomic(const std::string& path, const void* buffer, size_t length)
+    {
+        // Objects are loaded on several threads and processes share the cache, so each writer needs its own file
+        auto tempPath = String::StdFormat("%s.%08x%08x.tmp", path.c_str(), util_rand(), util_rand());
+        try
+        {
+            WriteAllBytes(tempPath, buffer, length);
+        }
+        catch (const std::exception&)
+        {
+            Delete(tempPath);
+            throw;
+        }
+
+        // Moving onto an existing file fails on some platforms
+        if (!Move(tempPath, path) && !(Delete(path) && Move(tempPath, path)))
+        {
+            Delete(tempPath);
+            throw IOException("Unable to replace " + path);
+        }
+    }
+
     uint64_t GetLastModified(const std::string& path)
     {
         return Platform::GetLastModified(path);
     }
+
+    uint64_t GetContentHash(const std::string& path)
+    {
+        OpenRCT2::MemoryMappedFile file(path);
+        return Hash::FNV1a<uint64_t>(file.GetData(), static_cast<size_t>(file.GetLength()));
+    }
 } // namespace File
 
 bool writeentirefile(const utf8* path, const void* buffer, size_t length)
@@ -25,5 +25,18 @@ namespace File
     std::string ReadAllText(std::string_view path);
     std::vector<std::string> ReadAllLines(std::string_view path);
     void WriteAllBytes(const std::string& path, const void* buffer, size_t length);
+
+    /**
+     * Writes the file under a unique name next to the given path and moves it over that, so the file is never seen
+     * partly written, concurrent writers do not mix their data and processes that have the old file mapped keep their
+     * copy. Throws an IOException if the file can not be written.
+     */
+    void WriteAllBytesAtomic(const std::string& path, const void* buffer, size_t length);
     uint64_t GetLastModified(const std::string& path);
+
+    /**
+     * Returns a 64-bit FNV-1a hash of the contents of the file, for telling whether a file has changed. Throws an
+     * IOException if the file can not be read.
+     */
+    uint64_t GetContentHash(const std::string& path);
 } // namespace File
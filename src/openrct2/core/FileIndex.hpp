@@ -15,36 +15,49 @@
 #include "File.h"
 #include "FileScanner.h"
 #include "FileStream.h"
-#include "JobPool.h"
+#include "Hash.hpp"
 #include "Path.hpp"
+#include "TaskScheduler.h"
 
+#include <atomic>
 #include <chrono>
-#include <list>
+#include <mutex>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 template<typename TItem> class FileIndex
 {
-private:
-    struct DirectoryStats
+public:
+    struct ScannedFile
     {
-        uint32_t TotalFiles = 0;
-        uint64_t TotalFileSize = 0;
-        uint32_t FileDateModifiedChecksum = 0;
-        uint32_t PathChecksum = 0;
+        std::string Path;
+        uint64_t Size = 0;
+        uint64_t LastModified = 0;
     };
 
-    struct ScanResult
+private:
+    /**
+     * What the index holds for a file. The item is kept for as long as the size and modification time of the file stay
+     * the same, or its contents do when they do not.
+     */
+    struct IndexEntry
     {
-        DirectoryStats const Stats;
-        std::vector<std::string> const Files;
+        std::string Path;
+        uint64_t Size = 0;
+        uint64_t LastModified = 0;
+        uint64_t ContentHash = 0;
+        bool HasItem = false;
+        TItem Item{};
+    };
 
-        ScanResult(DirectoryStats stats, std::vector<std::string> files)
-            : Stats(stats)
-            , Files(files)
-        {
-        }
+    // A file that is new or has changed since the index was written, along with the index of its entry.
+    struct PendingFile
+    {
+        const ScannedFile* File = nullptr;
+        size_t Index = 0;
+        bool WasIndexed = false;
     };
 
     struct FileIndexHeader
@@ -54,12 +67,11 @@ private:
         uint8_t VersionA = 0;
         uint8_t VersionB = 0;
         uint16_t LanguageId = 0;
-        DirectoryStats Stats;
-        uint32_t NumItems = 0;
+        uint32_t NumEntries = 0;
     };
 
     // Index file format version which when incremented forces a rebuild
-    static constexpr uint8_t FILE_INDEX_VERSION = 4;
+    static constexpr uint8_t FILE_INDEX_VERSION = 5;
 
     std::string const _name;
     uint32_t const _magicNumber;
@@ -95,51 +107,38 @@ public:
     virtual ~FileIndex() = default;
 
     /**
-     * Queries and directories and loads the index header. If the index is up to date,
-     * the items are loaded from the index and returned, otherwise the index is rebuilt.
+     * Queries the directories and loads the index. Items of files that have not changed are taken from the index, the
+     * ones of new and changed files are created again and the index is updated.
      */
     std::vector<TItem> LoadOrBuild(int32_t language) const
     {
-        std::vector<TItem> items;
-        auto scanResult = Scan();
-        auto readIndexResult = ReadIndexFile(language, scanResult.Stats);
-        if (std::get<0>(readIndexResult))
-        {
-            // Index was loaded
-            items = std::get<1>(readIndexResult);
-        }
-        else
-        {
-            // Index was not loaded
-            items = Build(language, scanResult);
-        }
-        return items;
+        return LoadOrBuild(language, Scan());
     }
 
-    std::vector<TItem> Rebuild(int32_t language) const
+    /**
+     * As above for the given files, also adds the content hash of each file to contentHashes if given.
+     */
+    std::vector<TItem> LoadOrBuild(
+        int32_t language, const std::vector<ScannedFile>& files, std::vector<uint64_t>* contentHashes = nullptr) const
     {
-        auto scanResult = Scan();
-        auto items = Build(language, scanResult);
-        return items;
+        auto indexedEntries = ReadIndexFile(language);
+        return Build(language, files, std::move(indexedEntries), contentHashes);
     }
 
-protected:
-    /**
-     * Loads the given file and creates the item representing the data to store in the index.
-     * TODO Use std::optional when C++17 is available.
-     */
-    virtual std::tuple<bool, TItem> Create(int32_t language, const std::string& path) const abstract;
+    std::vector<TItem> Rebuild(int32_t language) const
+    {
+        return Rebuild(language, Scan());
+    }
 
-    /**
-     * Serialises/DeSerialises an index item to/from the given stream.
-     */
-    virtual void Serialise(DataSerialiser& ds, TItem& item) const abstract;
+    std::vector<TItem> Rebuild(
+        int32_t language, const std::vector<ScannedFile>& files, std::vector<uint64_t>* contentHashes = nullptr) const
+    {
+        return Build(language, files, {}, contentHashes);
+    }
 
-private:
-    ScanResult Scan() const
+    std::vector<ScannedFile> Scan() const
     {
-        DirectoryStats stats{};
-        std::vector<std::string> files;
+        std::vector<ScannedFile> files;
         for (const auto& directory : SearchPaths)
         {
             auto absoluteDirectory = Path::GetAbsolute(directory);
@@ -150,108 +149,206 @@ private:
             while (scanner->Next())
             {
                 auto fileInfo = scanner->GetFileInfo();
-                auto path = std::string(scanner->GetPath());
-
-                stats.TotalFiles++;
-                stats.TotalFileSize += fileInfo->Size;
-                stats.FileDateModifiedChecksum ^= static_cast<uint32_t>(fileInfo->LastModified >> 32)
-                    ^ static_cast<uint32_t>(fileInfo->LastModified & 0xFFFFFFFF);
-                stats.FileDateModifiedChecksum = ror32(stats.FileDateModifiedChecksum, 5);
-                stats.PathChecksum += GetPathChecksum(path);
-
-                files.push_back(std::move(path));
+                files.push_back({ std::string(scanner->GetPath()), fileInfo->Size, fileInfo->LastModified });
             }
             delete scanner;
         }
-        return ScanResult(stats, files);
+        return files;
     }
 
-    void BuildRange(
-        int32_t language, const ScanResult& scanResult, size_t rangeStart, size_t rangeEnd, std::vector<TItem>& items,
-        std::atomic<size_t>& processed, std::mutex& printLock) const
+    /**
+     * Returns the version of the index format and of the specialised index together, which changes whenever the items
+     * created for the same files may differ.
+     */
+    uint16_t GetVersion() const
+    {
+        return static_cast<uint16_t>((FILE_INDEX_VERSION << 8) | _version);
+    }
+
+    /**
+     * Returns a 64-bit FNV-1a hash of the paths, sizes and modification times of the files, which changes whenever a file
+     * is added, removed or modified.
+     */
+    static uint64_t GetFilesHash(const std::vector<ScannedFile>& files)
+    {
+        auto hash = Hash::FNV1aParameters<uint64_t>::OffsetBasis;
+        for (const auto& file : files)
+        {
+            hash = Hash::FNV1a(file.Path.c_str(), file.Path.size() + 1, hash);
+            hash = Hash::FNV1a(&file.Size, sizeof(file.Size), hash);
+            hash = Hash::FNV1a(&file.LastModified, sizeof(file.LastModified), hash);
+        }
+        return hash;
+    }
+
+protected:
+    /**
+     * Loads the given file and creates the item representing the data to store in the index.
+     * TODO Use std::optional when C++17 is available.
+     */
+    virtual std::tuple<bool, TItem> Create(int32_t language, const std::string& path) const abstract;
+
+    /**
+     * Serialises/DeSerialises an index item to/from the given stream.
+     */
+    virtual void Serialise(DataSerialiser& ds, TItem& item) const abstract;
+
+private:
+    void UpdateRange(
+        int32_t language, const std::vector<PendingFile>& pendingFiles, size_t rangeStart, size_t rangeEnd,
+        std::vector<IndexEntry>& entries, std::atomic<size_t>& processed, std::mutex& printLock) const
     {
-        items.reserve(rangeEnd - rangeStart);
         for (size_t i = rangeStart; i < rangeEnd; i++)
         {
-            const auto& filePath = scanResult.Files.at(i);
+            const auto& pendingFile = pendingFiles[i];
+            const auto& file = *pendingFile.File;
+            auto& entry = entries[pendingFile.Index];
 
-            if (_log_levels[static_cast<uint8_t>(DiagnosticLevel::Verbose)])
+            // Files that were only touched or copied keep their item
+            uint64_t contentHash = 0;
+            try
+            {
+                contentHash = File::GetContentHash(file.Path);
+            }
+            catch (const std::exception&)
             {
-                std::lock_guard<std::mutex> lock(printLock);
-                log_verbose("FileIndex:Indexing '%s'", filePath.c_str());
             }
 
-            auto item = Create(language, filePath);
-            if (std::get<0>(item))
+            if (!pendingFile.WasIndexed || entry.Size != file.Size || entry.ContentHash != contentHash)
             {
-                items.push_back(std::get<1>(item));
+                if (_log_levels[static_cast<uint8_t>(DiagnosticLevel::Verbose)])
+                {
+                    std::lock_guard<std::mutex> lock(printLock);
+                    log_verbose("FileIndex:Indexing '%s'", file.Path.c_str());
+                }
+
+                auto item = Create(language, file.Path);
+                entry.HasItem = std::get<0>(item);
+                entry.Item = entry.HasItem ? std::move(std::get<1>(item)) : TItem{};
             }
+            entry.Path = file.Path;
+            entry.Size = file.Size;
+            entry.LastModified = file.LastModified;
+            entry.ContentHash = contentHash;
 
             processed++;
         }
     }
 
-    std::vector<TItem> Build(int32_t language, const ScanResult& scanResult) const
+    std::vector<TItem> Build(
+        int32_t language, const std::vector<ScannedFile>& files, std::unordered_map<std::string, IndexEntry> indexedEntries,
+        std::vector<uint64_t>* contentHashes) const
     {
-        std::vector<TItem> allItems;
-        Console::WriteLine("Building %s (%zu items)", _name.c_str(), scanResult.Files.size());
-
         auto startTime = std::chrono::high_resolution_clock::now();
 
-        const size_t totalCount = scanResult.Files.size();
-        if (totalCount > 0)
+        // Entries of unchanged files are used as they are, the others are updated below
+        std::vector<IndexEntry> entries(files.size());
+        std::vector<PendingFile> pendingFiles;
+        for (size_t i = 0; i < files.size(); i++)
         {
-            JobPool jobPool;
-            std::mutex printLock; // For verbose prints.
+            const auto& file = files[i];
+            auto indexedEntry = indexedEntries.find(file.Path);
+            if (indexedEntry == indexedEntries.end())
+            {
+                pendingFiles.push_back({ &file, i, false });
+                continue;
+            }
+
+            entries[i] = std::move(indexedEntry->second);
+            indexedEntries.erase(indexedEntry);
+            if (entries[i].Size != file.Size || entries[i].LastModified != file.LastModified)
+            {
+                pendingFiles.push_back({ &file, i, true });
+            }
+        }
+
+        // Whatever is left belongs to files that have been removed
+        const size_t numRemoved = indexedEntries.size();
+        if (!pendingFiles.empty() || numRemoved != 0)
+        {
+            if (pendingFiles.size() == files.size())
+            {
+                Console::WriteLine("Building %s (%zu items)", _name.c_str(), files.size());
+            }
+            else
+            {
+                Console::WriteLine(
+                    "Updating %s (%zu new or changed files, %zu removed)", _name.c_str(), pendingFiles.size(), numRemoved);
+            }
 
-            std::list<std::vector<TItem>> containers;
+            const size_t totalCount = pendingFiles.size();
+            if (totalCount > 0)
+            {
+                OpenRCT2::TaskGroup jobs;
+                std::mutex printLock; // For verbose prints.
 
-            size_t stepSize = 100; // Handpicked, seems to work well with 4/8 cores.
+                size_t stepSize = 100; // Handpicked, seems to work well with 4/8 cores.
 
-            std::atomic<size_t> processed = ATOMIC_VAR_INIT(0);
+                std::atomic<size_t> processed = ATOMIC_VAR_INIT(0);
 
-            auto reportProgress = [&]() {
-                const size_t completed = processed;
-                Console::WriteFormat("File %5zu of %zu, done %3d%%\r", completed, totalCount, completed * 100 / totalCount);
-            };
+                auto reportProgress = [&]() {
+                    const size_t completed = processed;
+                    Console::WriteFormat(
+                        "File %5zu of %zu, done %3d%%\r", completed, totalCount, completed * 100 / totalCount);
+                };
 
-            for (size_t rangeStart = 0; rangeStart < totalCount; rangeStart += stepSize)
-            {
-                if (rangeStart + stepSize > totalCount)
+                for (size_t rangeStart = 0; rangeStart < totalCount; rangeStart += stepSize)
                 {
-                    stepSize = totalCount - rangeStart;
-                }
+                    if (rangeStart + stepSize > totalCount)
+                    {
+                        stepSize = totalCount - rangeStart;
+                    }
 
-                auto& items = containers.emplace_back();
+                    const size_t rangeEnd = rangeStart + stepSize;
+                    jobs.Run([this, language, &pendingFiles, rangeStart, rangeEnd, &entries, &processed, &printLock]() {
+                        UpdateRange(language, pendingFiles, rangeStart, rangeEnd, entries, processed, printLock);
+                    });
 
-                jobPool.AddTask(std::bind(
-                    &FileIndex<TItem>::BuildRange, this, language, std::cref(scanResult), rangeStart, rangeStart + stepSize,
-                    std::ref(items), std::ref(processed), std::ref(printLock)));
+                    reportProgress();
+                }
 
-                reportProgress();
+                jobs.Wait(reportProgress);
             }
 
-            jobPool.Join(reportProgress);
+            WriteIndexFile(language, entries);
 
-            for (const auto& itr : containers)
+            auto endTime = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration<float>(endTime - startTime);
+            Console::WriteLine("Finished building %s in %.2f seconds.", _name.c_str(), duration.count());
+        }
+
+        std::vector<TItem> items;
+        items.reserve(entries.size());
+        for (auto& entry : entries)
+        {
+            if (contentHashes != nullptr)
             {
-                allItems.insert(allItems.end(), itr.begin(), itr.end());
+                contentHashes->push_back(entry.ContentHash);
+            }
+            if (entry.HasItem)
+            {
+                items.push_back(std::move(entry.Item));
             }
         }
+        return items;
+    }
 
-        WriteIndexFile(language, scanResult.Stats, allItems);
-
-        auto endTime = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration<float>(endTime - startTime);
-        Console::WriteLine("Finished building %s in %.2f seconds.", _name.c_str(), duration.count());
-
-        return allItems;
+    void SerialiseEntry(DataSerialiser& ds, IndexEntry& entry) const
+    {
+        ds << entry.Path;
+        ds << entry.Size;
+        ds << entry.LastModified;
+        ds << entry.ContentHash;
+        ds << entry.HasItem;
+        if (entry.HasItem)
+        {
+            Serialise(ds, entry.Item);
+        }
     }
 
-    std::tuple<bool, std::vector<TItem>> ReadIndexFile(int32_t language, const DirectoryStats& stats) const
+    std::unordered_map<std::string, IndexEntry> ReadIndexFile(int32_t language) const
     {
-        bool loadedItems = false;
-        std::vector<TItem> items;
+        std::unordered_map<std::string, IndexEntry> entries;
         if (File::Exists(_indexPath))
         {
             try
@@ -259,24 +356,20 @@ private:
                 log_verbose("FileIndex:Loading index: '%s'", _indexPath.c_str());
                 auto fs = OpenRCT2::FileStream(_indexPath, OpenRCT2::FILE_MODE_OPEN);
 
-                // Read header, check if we need to re-scan
+                // Read header, the items can only be used for the same kind of index and language
                 auto header = fs.ReadValue<FileIndexHeader>();
                 if (header.HeaderSize == sizeof(FileIndexHeader) && header.MagicNumber == _magicNumber
-                    && header.VersionA == FILE_INDEX_VERSION && header.VersionB == _version && header.LanguageId == language
-                    && header.Stats.TotalFiles == stats.TotalFiles && header.Stats.TotalFileSize == stats.TotalFileSize
-                    && header.Stats.FileDateModifiedChecksum == stats.FileDateModifiedChecksum
-                    && header.Stats.PathChecksum == stats.PathChecksum)
+                    && header.VersionA == FILE_INDEX_VERSION && header.VersionB == _version && header.LanguageId == language)
                 {
-                    items.reserve(header.NumItems);
+                    entries.reserve(header.NumEntries);
                     DataSerialiser ds(false, fs);
-                    // Directory is the same, just read the saved items
-                    for (uint32_t i = 0; i < header.NumItems; i++)
+                    for (uint32_t i = 0; i < header.NumEntries; i++)
                     {
-                        TItem item;
-                        Serialise(ds, item);
-                        items.emplace_back(std::move(item));
+                        IndexEntry entry;
+                        SerialiseEntry(ds, entry);
+                        auto path = entry.Path;
+                        entries.emplace(std::move(path), std::move(entry));
                     }
-                    loadedItems = true;
                 }
                 else
                 {
@@ -287,12 +380,13 @@ private:
             {
                 Console::Error::WriteLine("Unable to load index: '%s'.", _indexPath.c_str());
                 Console::Error::WriteLine("%s", e.what());
+                entries.clear();
             }
         }
-        return std::make_tuple(loadedItems, std::move(items));
+        return entries;
     }
 
-    void WriteIndexFile(int32_t language, const DirectoryStats& stats, std::vector<TItem>& items) const
+    void WriteIndexFile(int32_t language, std::vector<IndexEntry>& entries) const
     {
         try
         {
@@ -306,15 +400,14 @@ private:
             header.VersionA = FILE_INDEX_VERSION;
             header.VersionB = _version;
             header.LanguageId = language;
-            header.Stats = stats;
-            header.NumItems = static_cast<uint32_t>(items.size());
+            header.NumEntries = static_cast<uint32_t>(entries.size());
             fs.WriteValue(header);
 
             DataSerialiser ds(true, fs);
-            // Write items
-            for (auto& item : items)
+            // Write entries
+            for (auto& entry : entries)
             {
-                Serialise(ds, item);
+                SerialiseEntry(ds, entry);
             }
         }
         catch (const std::exception& e)
@@ -323,19 +416,4 @@ private:
             Console::Error::WriteLine("%s", e.what());
         }
     }
-
-    static uint32_t GetPathChecksum(const std::string& path)
-    {
-        uint32_t hash = 0xD8430DED;
-        for (const utf8* ch = path.c_str(); *ch != '\0'; ch++)
-        {
-            hash += (*ch);
-            hash += (hash << 10);
-            hash ^= (hash >> 6);
-        }
-        hash += (hash << 3);
-        hash ^= (hash >> 11);
-        hash += (hash << 15);
-        return hash;
-    }
 };
@@ -0,0 +1,46 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Hash
+{
+    template<typename T> struct FNV1aParameters;
+
+    template<> struct FNV1aParameters<uint32_t>
+    {
+        static constexpr uint32_t OffsetBasis = 0x811C9DC5;
+        static constexpr uint32_t Prime = 0x01000193;
+    };
+
+    template<> struct FNV1aParameters<uint64_t>
+    {
+        static constexpr uint64_t OffsetBasis = 0xCBF29CE484222325;
+        static constexpr uint64_t Prime = 0x100000001B3;
+    };
+
+    /**
+     * FNV-1a hash of the given bytes, which is the same on every platform so it can be written to files. Pass the hash
+     * of the previous bytes to continue it over more data.
+     * @tparam T uint32_t or uint64_t
+     */
+    template<typename T> T FNV1a(const void* data, size_t length, T hash = FNV1aParameters<T>::OffsetBasis)
+    {
+        auto bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < length; i++)
+        {
+            hash ^= bytes[i];
+            hash *= FNV1aParameters<T>::Prime;
+        }
+        return hash;
+    }
+} // namespace Hash
@@ -251,6 +251,133 @@ namespace Imaging
         }
     }
 
+    static std::ofstream OpenOutputFile(std::string_view path)
+    {
+#if defined(_WIN32) && !defined(__MINGW32__)
+        auto pathW = String::ToWideChar(path);
+        return std::ofstream(pathW, std::ios::binary);
+#else
+        return std::ofstream(std::string(path), std::ios::binary);
+#endif
+    }
+
+    struct PngRowWriter::Impl
+    {
+        std::ofstream Stream;
+        png_structp Png = nullptr;
+        png_infop Info = nullptr;
+        png_colorp Palette = nullptr;
+        uint32_t Height{};
+        uint32_t RowsWritten{};
+        bool Finished{};
+
+        ~Impl()
+        {
+            if (Png != nullptr)
+            {
+                png_free(Png, Palette);
+                png_destroy_write_struct(&Png, &Info);
+            }
+        }
+    };
+
+    PngRowWriter::PngRowWriter(std::string_view path, uint32_t width, uint32_t height, const GamePalette& palette)
+        : _impl(std::make_unique<Impl>())
+    {
+        auto& impl = *_impl;
+        impl.Stream = OpenOutputFile(path);
+        if (!impl.Stream.is_open())
+        {
+            throw std::runtime_error("Unable to open " + std::string(path) + " for writing.");
+        }
+        impl.Height = height;
+
+        impl.Png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, PngError, PngWarning);
+        if (impl.Png == nullptr)
+        {
+            throw std::runtime_error("png_create_write_struct failed.");
+        }
+        impl.Info = png_create_info_struct(impl.Png);
+        if (impl.Info == nullptr)
+        {
+            throw std::runtime_error("png_create_info_struct failed.");
+        }
+
+        impl.Palette = static_cast<png_colorp>(png_malloc(impl.Png, PNG_MAX_PALETTE_LENGTH * sizeof(png_color)));
+        if (impl.Palette == nullptr)
+        {
+            throw std::runtime_error("png_malloc failed.");
+        }
+        for (size_t i = 0; i < PNG_MAX_PALETTE_LENGTH; i++)
+        {
+            const auto& entry = palette[static_cast<uint16_t>(i)];
+            impl.Palette[i].blue = entry.Blue;
+            impl.Palette[i].green = entry.Green;
+            impl.Palette[i].red = entry.Red;
+        }
+        png_set_PLTE(impl.Png, impl.Info, impl.Palette, PNG_MAX_PALETTE_LENGTH);
+
+        png_set_write_fn(impl.Png, &impl.Stream, PngWriteData, PngFlush);
+
+        // Set error handler
+        if (setjmp(png_jmpbuf(impl.Png)))
+        {
+            throw std::runtime_error("PNG ERROR");
+        }
+
+        png_text text_ptr[1];
+        text_ptr[0].key = const_cast<char*>("Software");
+        text_ptr[0].text = const_cast<char*>(gVersionInfoFull);
+        text_ptr[0].compression = PNG_TEXT_COMPRESSION_zTXt;
+
+        png_byte transparentIndex = 0;
+        png_set_tRNS(impl.Png, impl.Info, &transparentIndex, 1, nullptr);
+        png_set_text(impl.Png, impl.Info, text_ptr, 1);
+        png_set_IHDR(
+            impl.Png, impl.Info, width, height, 8, PNG_COLOR_TYPE_PALETTE, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
+            PNG_FILTER_TYPE_DEFAULT);
+        png_write_info(impl.Png, impl.Info);
+    }
+
+    PngRowWriter::~PngRowWriter() = default;
+
+    void PngRowWriter::WriteRow(const uint8_t* pixels)
+    {
+        auto& impl = *_impl;
+        Guard::Assert(impl.RowsWritten < impl.Height, "Too many rows written to PNG");
+
+        // libpng jumps back here on errors, so every call into it needs its own handler
+        if (setjmp(png_jmpbuf(impl.Png)))
+        {
+            throw std::runtime_error("PNG ERROR");
+        }
+        png_write_row(impl.Png, const_cast<png_byte*>(pixels));
+        impl.RowsWritten++;
+    }
+
+    void PngRowWriter::Finish()
+    {
+        auto& impl = *_impl;
+        if (impl.Finished)
+            return;
+        if (impl.RowsWritten != impl.Height)
+        {
+            throw std::runtime_error("PNG is missing rows.");
+        }
+
+        if (setjmp(png_jmpbuf(impl.Png)))
+        {
+            throw std::runtime_error("PNG ERROR");
+        }
+        png_write_end(impl.Png, nullptr);
+        impl.Stream.flush();
+        if (!impl.Stream)
+        {
+            throw std::runtime_error("Unable to write PNG.");
+        }
+        impl.Finished = true;
+    }
+
     IMAGE_FORMAT GetImageFormatFromPath(std::string_view path)
     {
         if (String::EndsWith(path, ".png", true))
@@ -338,12 +465,7 @@ namespace Imaging
                 break;
             case IMAGE_FORMAT::PNG:
             {
-#if defined(_WIN32) && !defined(__MINGW32__)
-                auto pathW = String::ToWideChar(path);
-                std::ofstream fs(pathW, std::ios::binary);
-#else
-                std::ofstream fs(std::string(path), std::ios::binary);
-#endif
+                auto fs = OpenOutputFile(path);
                 WritePng(fs, image);
                 break;
             }
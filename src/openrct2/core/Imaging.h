@@ -52,4 +52,25 @@ namespace Imaging
     void WriteToFile(std::string_view path, const Image& image, IMAGE_FORMAT format = IMAGE_FORMAT::AUTOMATIC);
 
     void SetReader(IMAGE_FORMAT format, ImageReaderFunc impl);
+
+    /**
+     * Encodes an 8-bit paletted PNG one row at a time, so images too large to keep in memory can be written while they
+     * are being rendered. Rows must be written top to bottom and the image completed with Finish.
+     */
+    class PngRowWriter
+    {
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> _impl;
+
+    public:
+        PngRowWriter(std::string_view path, uint32_t width, uint32_t height, const GamePalette& palette);
+        ~PngRowWriter();
+
+        PngRowWriter(const PngRowWriter&) = delete;
+        PngRowWriter& operator=(const PngRowWriter&) = delete;
+
+        void WriteRow(const uint8_t* pixels);
+        void Finish();
+    };
 } // namespace Imaging
@@ -0,0 +1,108 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "MemoryMappedFile.h"
+
+#include "IStream.hpp"
+#include "String.hpp"
+
+#ifdef _WIN32
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace OpenRCT2
+{
+    MemoryMappedFile::MemoryMappedFile(const fs::path& path)
+        : MemoryMappedFile(path.u8string())
+    {
+    }
+
+    MemoryMappedFile::MemoryMappedFile(const std::string& path)
+    {
+#ifdef _WIN32
+        auto pathW = String::ToWideChar(path);
+        auto file = CreateFileW(
+            pathW.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            throw IOException(String::StdFormat("Unable to open '%s'", path.c_str()));
+        }
+        _file = file;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size))
+        {
+            CloseHandle(file);
+            throw IOException(String::StdFormat("Unable to get the size of '%s'", path.c_str()));
+        }
+        _length = static_cast<uint64_t>(size.QuadPart);
+        if (_length != 0)
+        {
+            _mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (_mapping != nullptr)
+            {
+                _data = static_cast<const uint8_t*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+            }
+            if (_data == nullptr)
+            {
+                if (_mapping != nullptr)
+                    CloseHandle(_mapping);
+                CloseHandle(file);
+                throw IOException(String::StdFormat("Unable to map '%s'", path.c_str()));
+            }
+        }
+#else
+        auto fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+        {
+            throw IOException(String::StdFormat("Unable to open '%s'", path.c_str()));
+        }
+
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+        {
+            close(fd);
+            throw IOException(String::StdFormat("Unable to open '%s'", path.c_str()));
+        }
+        _length = static_cast<uint64_t>(fileStat.st_size);
+        if (_length != 0)
+        {
+            auto data = mmap(nullptr, static_cast<size_t>(_length), PROT_READ, MAP_SHARED, fd, 0);
+            if (data == MAP_FAILED)
+            {
+                close(fd);
+                throw IOException(String::StdFormat("Unable to map '%s'", path.c_str()));
+            }
+            _data = static_cast<const uint8_t*>(data);
+        }
+        // The mapping keeps its own reference to the file
+        close(fd);
+#endif
+    }
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+#ifdef _WIN32
+        if (_data != nullptr)
+            UnmapViewOfFile(_data);
+        if (_mapping != nullptr)
+            CloseHandle(_mapping);
+        if (_file != nullptr)
+            CloseHandle(_file);
+#else
+        if (_data != nullptr)
+            munmap(const_cast<uint8_t*>(_data), static_cast<size_t>(_length));
+#endif
+    }
+} // namespace OpenRCT2
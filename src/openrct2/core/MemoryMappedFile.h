@@ -0,0 +1,50 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "FileSystem.hpp"
+
+#include <string>
+
+namespace OpenRCT2
+{
+    /**
+     * Maps a whole file read-only into memory. Pages are loaded from the page cache as they are touched and are shared
+     * with every other process mapping the same file.
+     */
+    class MemoryMappedFile final
+    {
+    private:
+        const uint8_t* _data = nullptr;
+        uint64_t _length = 0;
+#ifdef _WIN32
+        void* _file = nullptr;
+        void* _mapping = nullptr;
+#endif
+
+    public:
+        explicit MemoryMappedFile(const fs::path& path);
+        explicit MemoryMappedFile(const std::string& path);
+        ~MemoryMappedFile();
+
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+        const uint8_t* GetData() const
+        {
+            return _data;
+        }
+        uint64_t GetLength() const
+        {
+            return _length;
+        }
+    };
+} // namespace OpenRCT2
@@ -0,0 +1,422 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TaskScheduler.h"
+
+#include "../platform/Platform2.h"
+
+#include <array>
+#include <cassert>
+
+using namespace OpenRCT2;
+
+// Number of empty scans over all deques before an idle worker goes to sleep.
+static constexpr int32_t WORKER_SPIN_COUNT = 64;
+
+struct alignas(64) TaskScheduler::Slot
+{
+    TaskDeque Deque;
+    std::array<Task, TaskDeque::Capacity> Tasks;
+    size_t NextTask = 0;
+    size_t StealIndex = 0;
+    std::atomic_bool Claimed = { false };
+};
+
+namespace
+{
+    struct ThreadSlotCache
+    {
+        struct Entry
+        {
+            uint32_t Serial = 0;
+            TaskScheduler::Slot* Slot = nullptr;
+        };
+
+        std::array<Entry, 4> Entries;
+        size_t NextEntry = 0;
+
+        ~ThreadSlotCache();
+    };
+
+    // Schedulers that are still alive, used to return external slots when a thread exits.
+    struct SchedulerRegistry
+    {
+        std::mutex Mutex;
+        std::vector<std::pair<uint32_t, TaskScheduler*>> Schedulers;
+    };
+} // namespace
+
+static std::atomic<uint32_t> _nextSchedulerSerial = { 1 };
+static thread_local ThreadSlotCache _threadSlots;
+static std::mutex _defaultOptionsMutex;
+static TaskSchedulerOptions _defaultOptions;
+
+static SchedulerRegistry& GetSchedulerRegistry()
+{
+    static SchedulerRegistry registry;
+    return registry;
+}
+
+#pragma region TaskDeque
+
+bool TaskDeque::Push(Task* task)
+{
+    auto b = _bottom.load(std::memory_order_relaxed);
+    auto t = _top.load(std::memory_order_acquire);
+    if (b - t >= static_cast<int64_t>(Capacity))
+    {
+        return false;
+    }
+    _items[b & Mask].store(task, std::memory_order_relaxed);
+    _bottom.store(b + 1, std::memory_order_release);
+    return true;
+}
+
+Task* TaskDeque::Pop()
+{
+    auto b = _bottom.load(std::memory_order_relaxed) - 1;
+    _bottom.store(b, std::memory_order_seq_cst);
+    auto t = _top.load(std::memory_order_seq_cst);
+    if (t > b)
+    {
+        // Deque was already empty
+        _bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    auto task = _items[b & Mask].load(std::memory_order_relaxed);
+    if (t == b)
+    {
+        // Last item, race against thieves for it
+        if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            task = nullptr;
+        }
+        _bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return task;
+}
+
+Task* TaskDeque::Steal()
+{
+    auto t = _top.load(std::memory_order_seq_cst);
+    auto b = _bottom.load(std::memory_order_seq_cst);
+    if (t >= b)
+    {
+        return nullptr;
+    }
+
+    auto task = _items[t & Mask].load(std::memory_order_relaxed);
+    if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        // Lost the race to another thief or the owner
+        return nullptr;
+    }
+    return task;
+}
+
+bool TaskDeque::IsEmpty() const
+{
+    return _top.load(std::memory_order_acquire) >= _bottom.load(std::memory_order_acquire);
+}
+
+#pragma endregion
+
+#pragma region TaskScheduler
+
+TaskScheduler::TaskScheduler(const TaskSchedulerOptions& options)
+    : _serial(_nextSchedulerSerial++)
+    , _options(options)
+{
+    const size_t workerCount = options.WorkerCount;
+    for (size_t i = 0; i < workerCount + MaxExternalThreads; i++)
+    {
+        _slots.push_back(std::make_unique<Slot>());
+    }
+
+    {
+        auto& registry = GetSchedulerRegistry();
+        std::lock_guard<std::mutex> lock(registry.Mutex);
+        registry.Schedulers.emplace_back(_serial, this);
+    }
+
+    for (size_t i = 0; i < workerCount; i++)
+    {
+        _slots[i]->Claimed = true;
+        _threads.emplace_back(&TaskScheduler::WorkerMain, this, i);
+    }
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        auto& registry = GetSchedulerRegistry();
+        std::lock_guard<std::mutex> lock(registry.Mutex);
+        auto& schedulers = registry.Schedulers;
+        schedulers.erase(
+            std::remove_if(schedulers.begin(), schedulers.end(), [this](const auto& entry) { return entry.second == this; }),
+            schedulers.end());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _shouldStop = true;
+        _sleepCondition.notify_all();
+    }
+
+    for (auto& th : _threads)
+    {
+        assert(th.joinable() != false);
+        th.join();
+    }
+}
+
+TaskScheduler& TaskScheduler::GetDefault()
+{
+    static TaskScheduler scheduler([]() {
+        std::lock_guard<std::mutex> lock(_defaultOptionsMutex);
+        return _defaultOptions;
+    }());
+    return scheduler;
+}
+
+void TaskScheduler::SetDefaultOptions(const TaskSchedulerOptions& options)
+{
+    std::lock_guard<std::mutex> lock(_defaultOptionsMutex);
+    _defaultOptions = options;
+}
+
+TaskScheduler::Slot* TaskScheduler::GetCurrentSlot()
+{
+    for (const auto& entry : _threadSlots.Entries)
+    {
+        if (entry.Serial == _serial)
+        {
+            return entry.Slot;
+        }
+    }
+
+    // First submission from a thread that is not one of our workers
+    Slot* slot = nullptr;
+    if (_externalSlotsClaimed.load(std::memory_order_relaxed) < MaxExternalThreads)
+    {
+        for (size_t i = _threads.size(); i < _slots.size(); i++)
+        {
+            bool expected = false;
+            if (_slots[i]->Claimed.compare_exchange_strong(expected, true))
+            {
+                _externalSlotsClaimed++;
+                slot = _slots[i].get();
+                break;
+            }
+        }
+    }
+
+    auto& entry = _threadSlots.Entries[_threadSlots.NextEntry];
+    if (entry.Slot != nullptr)
+    {
+        // Evicting a cached slot of another scheduler, hand it back so it can be reused.
+        std::lock_guard<std::mutex> lock(GetSchedulerRegistry().Mutex);
+        for (const auto& [serial, scheduler] : GetSchedulerRegistry().Schedulers)
+        {
+            if (serial == entry.Serial)
+            {
+                scheduler->ReleaseExternalSlot(entry.Slot);
+            }
+        }
+    }
+    entry.Serial = _serial;
+    entry.Slot = slot;
+    _threadSlots.NextEntry = (_threadSlots.NextEntry + 1) % _threadSlots.Entries.size();
+    return slot;
+}
+
+void TaskScheduler::ReleaseExternalSlot(Slot* slot)
+{
+    if (slot != nullptr)
+    {
+        assert(slot->Deque.IsEmpty());
+        slot->Claimed = false;
+        _externalSlotsClaimed--;
+    }
+}
+
+void TaskScheduler::ReleaseThreadSlots()
+{
+    auto& registry = GetSchedulerRegistry();
+    std::lock_guard<std::mutex> lock(registry.Mutex);
+    for (auto& entry : _threadSlots.Entries)
+    {
+        for (const auto& [serial, scheduler] : registry.Schedulers)
+        {
+            if (serial == entry.Serial)
+            {
+                scheduler->ReleaseExternalSlot(entry.Slot);
+            }
+        }
+        entry = {};
+    }
+}
+
+ThreadSlotCache::~ThreadSlotCache()
+{
+    TaskScheduler::ReleaseThreadSlots();
+}
+
+Task* TaskScheduler::AllocateTask(Slot* slot)
+{
+    auto& task = slot->Tasks[slot->NextTask];
+    if (task.InUse.load(std::memory_order_acquire))
+    {
+        return nullptr;
+    }
+    task.InUse.store(true, std::memory_order_relaxed);
+    slot->NextTask = (slot->NextTask + 1) % slot->Tasks.size();
+    return &task;
+}
+
+void TaskScheduler::Enqueue(Slot* slot, Task* task)
+{
+    if (!slot->Deque.Push(task))
+    {
+        Execute(*task);
+        return;
+    }
+    NotifyWork();
+}
+
+void TaskScheduler::NotifyWork()
+{
+    _workEpoch.fetch_add(1, std::memory_order_seq_cst);
+    if (_sleeping.load(std::memory_order_seq_cst) > 0)
+    {
+        // Taking the lock guarantees the sleeper is either waiting or will see the new epoch.
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _sleepCondition.notify_one();
+    }
+}
+
+Task* TaskScheduler::FindWork(Slot* slot)
+{
+    if (slot != nullptr)
+    {
+        auto task = slot->Deque.Pop();
+        if (task != nullptr)
+        {
+            return task;
+        }
+    }
+
+    // Steal from the others, starting where we last found something.
+    const size_t slotCount = _slots.size();
+    const size_t start = slot != nullptr ? slot->StealIndex : 0;
+    for (size_t i = 0; i < slotCount; i++)
+    {
+        const size_t victimIndex = (start + i) % slotCount;
+        auto& victim = *_slots[victimIndex];
+        if (&victim == slot)
+        {
+            continue;
+        }
+        auto task = victim.Deque.Steal();
+        if (task != nullptr)
+        {
+            if (slot != nullptr)
+            {
+                slot->StealIndex = victimIndex;
+            }
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+void TaskScheduler::Execute(Task& task)
+{
+    auto group = task.Group;
+    task.Invoke(task);
+    task.InUse.store(false, std::memory_order_release);
+    // The group may be destroyed as soon as the counter hits zero, it must not be touched afterwards.
+    group->_pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void TaskScheduler::WorkerMain(size_t index)
+{
+    if (_options.PinThreads)
+    {
+        const size_t processorCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        Platform::SetCurrentThreadAffinity((index + 1) % processorCount);
+    }
+
+    auto slot = _slots[index].get();
+    _threadSlots.Entries[0] = { _serial, slot };
+
+    int32_t spinCount = 0;
+    while (!_shouldStop.load(std::memory_order_relaxed))
+    {
+        // Read the epoch before looking for work so a submission after the scan is never missed.
+        const auto epoch = _workEpoch.load(std::memory_order_seq_cst);
+
+        auto task = FindWork(slot);
+        if (task != nullptr)
+        {
+            Execute(*task);
+            spinCount = 0;
+            continue;
+        }
+
+        if (spinCount < WORKER_SPIN_COUNT)
+        {
+            spinCount++;
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _sleeping++;
+        _sleepCondition.wait(lock, [this, epoch]() {
+            return _shouldStop.load(std::memory_order_relaxed) || _workEpoch.load(std::memory_order_seq_cst) != epoch;
+        });
+        _sleeping--;
+        spinCount = 0;
+    }
+
+    _threadSlots.Entries[0] = {};
+}
+
+#pragma endregion
+
+#pragma region TaskGroup
+
+void TaskGroup::Wait(const std::function<void()>& progressFn)
+{
+    auto slot = _scheduler.GetCurrentSlot();
+    auto lastPending = _pending.load(std::memory_order_acquire);
+    while (lastPending != 0)
+    {
+        auto task = _scheduler.FindWork(slot);
+        if (task != nullptr)
+        {
+            _scheduler.Execute(*task);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+
+        const auto pending = _pending.load(std::memory_order_acquire);
+        if (progressFn && pending != lastPending)
+        {
+            progressFn();
+        }
+        lastPending = pending;
+    }
+}
+
+#pragma endregion
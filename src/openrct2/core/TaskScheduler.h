@@ -0,0 +1,228 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace OpenRCT2
+{
+    class TaskGroup;
+    class TaskScheduler;
+
+    /**
+     * A unit of work queued on the scheduler. The callable is constructed in-place inside the task so that submitting
+     * work never allocates, tasks themselves are recycled from a per-thread ring.
+     */
+    struct Task
+    {
+        static constexpr size_t StorageSize = 64;
+
+        void (*Invoke)(Task& task) = nullptr;
+        TaskGroup* Group = nullptr;
+        std::atomic_bool InUse = { false };
+        alignas(std::max_align_t) std::byte Storage[StorageSize];
+    };
+
+    /**
+     * Fixed capacity Chase-Lev work-stealing deque. Only the owning thread may push and pop,
+     * any thread may steal from the other end.
+     */
+    class TaskDeque
+    {
+    public:
+        static constexpr size_t Capacity = 1024;
+
+    private:
+        static constexpr size_t Mask = Capacity - 1;
+        static_assert((Capacity & Mask) == 0, "Capacity must be a power of two");
+
+        alignas(64) std::atomic<int64_t> _top = { 0 };
+        alignas(64) std::atomic<int64_t> _bottom = { 0 };
+        std::atomic<Task*> _items[Capacity] = {};
+
+    public:
+        bool Push(Task* task);
+        Task* Pop();
+        Task* Steal();
+        bool IsEmpty() const;
+    };
+
+    struct TaskSchedulerOptions
+    {
+        // Number of worker threads, the thread waiting on a group also executes tasks.
+        size_t WorkerCount = std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1;
+        // Pin each worker to its own logical processor, leaving the first one to the main thread.
+        bool PinThreads = false;
+    };
+
+    /**
+     * Process-wide work-stealing scheduler. Every worker owns a deque, idle workers steal from the others
+     * and only go to sleep when there is nothing left to steal.
+     */
+    class TaskScheduler
+    {
+        friend class TaskGroup;
+
+    public:
+        // Maximum number of non-worker threads that get their own deque, others run submitted tasks inline.
+        static constexpr size_t MaxExternalThreads = 8;
+
+        struct Slot;
+
+    private:
+        const uint32_t _serial;
+        const TaskSchedulerOptions _options;
+        std::vector<std::unique_ptr<Slot>> _slots;
+        std::atomic<size_t> _externalSlotsClaimed = { 0 };
+        std::vector<std::thread> _threads;
+
+        std::atomic_bool _shouldStop = { false };
+        std::atomic<uint64_t> _workEpoch = { 0 };
+        std::atomic<size_t> _sleeping = { 0 };
+        std::mutex _sleepMutex;
+        std::condition_variable _sleepCondition;
+
+    public:
+        explicit TaskScheduler(const TaskSchedulerOptions& options = {});
+        ~TaskScheduler();
+
+        TaskScheduler(const TaskScheduler&) = delete;
+        TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+        /**
+         * The shared scheduler, created on first use with the options last passed to SetDefaultOptions.
+         */
+        static TaskScheduler& GetDefault();
+        static void SetDefaultOptions(const TaskSchedulerOptions& options);
+
+        /**
+         * Hands the deques claimed by the calling thread back to their schedulers, called on thread exit.
+         */
+        static void ReleaseThreadSlots();
+
+        size_t GetWorkerCount() const
+        {
+            return _threads.size();
+        }
+
+        /**
+         * Splits [begin, end) into chunks of grainSize and calls fn(chunkBegin, chunkEnd) for each of them,
+         * returns once all chunks have been processed.
+         */
+        template<typename TFn> void ParallelFor(size_t begin, size_t end, size_t grainSize, TFn&& fn);
+
+    private:
+        template<typename TFn> void Submit(TaskGroup& group, TFn&& fn);
+
+        Slot* GetCurrentSlot();
+        Task* AllocateTask(Slot* slot);
+        void Enqueue(Slot* slot, Task* task);
+        Task* FindWork(Slot* slot);
+        void Execute(Task& task);
+        void WorkerMain(size_t index);
+        void NotifyWork();
+        void ReleaseExternalSlot(Slot* slot);
+    };
+
+    /**
+     * A set of tasks that can be waited on together. The waiting thread helps executing queued work
+     * instead of blocking.
+     */
+    class TaskGroup
+    {
+        friend class TaskScheduler;
+
+    private:
+        TaskScheduler& _scheduler;
+        std::atomic<size_t> _pending = { 0 };
+
+    public:
+        explicit TaskGroup(TaskScheduler& scheduler = TaskScheduler::GetDefault())
+            : _scheduler(scheduler)
+        {
+        }
+
+        ~TaskGroup()
+        {
+            Wait();
+        }
+
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        template<typename TFn> void Run(TFn&& fn)
+        {
+            _scheduler.Submit(*this, std::forward<TFn>(fn));
+        }
+
+        /**
+         * Blocks until every task of the group has completed. The optional progress function is called
+         * from the waiting thread whenever the number of pending tasks changed.
+         */
+        void Wait(const std::function<void()>& progressFn = nullptr);
+
+        size_t CountPending() const
+        {
+            return _pending.load(std::memory_order_relaxed);
+        }
+    };
+
+    template<typename TFn> void TaskScheduler::Submit(TaskGroup& group, TFn&& fn)
+    {
+        using TCallable = std::decay_t<TFn>;
+        static_assert(sizeof(TCallable) <= Task::StorageSize, "Task callable too large, capture by reference instead.");
+        static_assert(alignof(TCallable) <= alignof(std::max_align_t), "Task callable is over-aligned.");
+
+        auto slot = GetCurrentSlot();
+        auto task = slot != nullptr ? AllocateTask(slot) : nullptr;
+        if (task == nullptr)
+        {
+            // Either all tasks of this thread are in flight or it has no deque, run it right away.
+            TCallable callable(std::forward<TFn>(fn));
+            callable();
+            return;
+        }
+
+        new (task->Storage) TCallable(std::forward<TFn>(fn));
+        task->Invoke = [](Task& t) {
+            auto callable = std::launder(reinterpret_cast<TCallable*>(t.Storage));
+            (*callable)();
+            callable->~TCallable();
+        };
+        task->Group = &group;
+        group._pending.fetch_add(1, std::memory_order_relaxed);
+        Enqueue(slot, task);
+    }
+
+    template<typename TFn> void TaskScheduler::ParallelFor(size_t begin, size_t end, size_t grainSize, TFn&& fn)
+    {
+        grainSize = std::max<size_t>(grainSize, 1);
+
+        TaskGroup group(*this);
+        for (size_t chunkBegin = begin; chunkBegin < end; chunkBegin += grainSize)
+        {
+            const size_t chunkEnd = std::min(end, chunkBegin + grainSize);
+            group.Run([&fn, chunkBegin, chunkEnd]() { fn(chunkBegin, chunkEnd); });
+        }
+        group.Wait();
+    }
+} // namespace OpenRCT2
@@ -11,6 +11,8 @@
 #include "../core/Guard.hpp"
 #include "Drawing.h"
 
+#include <cstring>
+
 #ifdef __AVX2__
 
 #    include <immintrin.h>
@@ -42,6 +44,132 @@ void mask_avx2(
     }
 }
 
+// Looks 32 indices up in a 256 entry table, one vpshufb for every 16 entries.
+static inline __m256i rle_lookup_avx2(const uint8_t* RESTRICT map, __m256i indices)
+{
+    const __m256i lowMask = _mm256_set1_epi8(0x0F);
+    const __m256i low = _mm256_and_si256(indices, lowMask);
+    const __m256i high = _mm256_and_si256(_mm256_srli_epi16(indices, 4), lowMask);
+    __m256i result = _mm256_setzero_si256();
+    for (int32_t i = 0; i < 16; i++)
+    {
+        // vpshufb looks up within each 128 bit lane, so both lanes get the same 16 entries
+        const __m256i entries = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(map + i * 16)));
+        const __m256i inSlice = _mm256_cmpeq_epi8(high, _mm256_set1_epi8(static_cast<char>(i)));
+        result = _mm256_or_si256(result, _mm256_and_si256(_mm256_shuffle_epi8(entries, low), inSlice));
+    }
+    return result;
+}
+
+// Writes the looked up pixels, except where the source or the looked up pixel is 0.
+static inline void rle_store_avx2(uint8_t* RESTRICT dst, __m256i source, __m256i current, __m256i pixels)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i keep = _mm256_or_si256(_mm256_cmpeq_epi8(source, zero), _mm256_cmpeq_epi8(pixels, zero));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_blendv_epi8(pixels, current, keep));
+}
+
+// Draws 32 pixels of a remap run, or of a glass run which looks up the destination pixels instead.
+template<bool TGlass>
+static inline void rle_run32_avx2(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT map)
+{
+    const __m256i source = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    const __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst));
+    rle_store_avx2(dst, source, current, rle_lookup_avx2(map, TGlass ? current : source));
+}
+
+template<bool TGlass>
+static void rle_run_avx2(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map)
+{
+    int32_t i = 0;
+    for (; i + 32 <= count; i += 32)
+    {
+        rle_run32_avx2<TGlass>(src + i, dst + i, map);
+    }
+
+    // Runs are mostly shorter than a vector, so the rest goes through a padded copy rather than one pixel at a time.
+    // Padding source pixels are 0 and leave their destination unchanged.
+    if (i < count)
+    {
+        const auto rest = static_cast<size_t>(count - i);
+        uint8_t source[32]{};
+        uint8_t current[32]{};
+        std::memcpy(source, src + i, rest);
+        std::memcpy(current, dst + i, rest);
+        rle_run32_avx2<TGlass>(source, current, map);
+        std::memcpy(dst + i, current, rest);
+    }
+}
+
+void rle_remap_avx2(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map,
+    [[maybe_unused]] size_t mapLength)
+{
+    rle_run_avx2<false>(src, dst, count, map);
+}
+
+void rle_glass_avx2(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map,
+    [[maybe_unused]] size_t mapLength)
+{
+    rle_run_avx2<true>(src, dst, count, map);
+}
+
+// Looks up 8 blend map entries, each lane gathers the 4 bytes starting at its index and keeps the first.
+static inline __m256i rle_blend_gather8_avx2(
+    const uint8_t* RESTRICT src, const uint8_t* RESTRICT dst, const uint8_t* RESTRICT map, __m256i gatherLimit,
+    __m256i& edgeLanes)
+{
+    const __m256i source = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src)));
+    const __m256i current = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(dst)));
+    const __m256i index = _mm256_add_epi32(_mm256_slli_epi32(_mm256_sub_epi32(source, _mm256_set1_epi32(1)), 8), current);
+
+    // Lanes with a transparent source or an index past the map are left as 0. Indices within the last 3 bytes of the
+    // map cannot be gathered without reading past it, so are reported for the caller to draw one pixel at a time.
+    const __m256i opaque = _mm256_xor_si256(_mm256_cmpeq_epi32(source, _mm256_setzero_si256()), _mm256_set1_epi32(-1));
+    const __m256i mapLimit = _mm256_add_epi32(gatherLimit, _mm256_set1_epi32(3));
+    const __m256i gatherable = _mm256_and_si256(opaque, _mm256_cmpgt_epi32(gatherLimit, index));
+    const __m256i inMap = _mm256_and_si256(opaque, _mm256_cmpgt_epi32(mapLimit, index));
+    edgeLanes = _mm256_or_si256(edgeLanes, _mm256_andnot_si256(gatherable, inMap));
+
+    const __m256i gathered = _mm256_mask_i32gather_epi32(
+        _mm256_setzero_si256(), reinterpret_cast<const int*>(map), index, gatherable, 1);
+    return _mm256_and_si256(gathered, _mm256_set1_epi32(0xFF));
+}
+
+void rle_blend_avx2(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map, size_t mapLength)
+{
+    int32_t i = 0;
+    if (mapLength >= 4 && mapLength <= INT32_MAX)
+    {
+        const __m256i gatherLimit = _mm256_set1_epi32(static_cast<int32_t>(mapLength - 3));
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        for (; i + 32 <= count; i += 32)
+        {
+            __m256i edgeLanes = _mm256_setzero_si256();
+            const __m256i p0 = rle_blend_gather8_avx2(src + i, dst + i, map, gatherLimit, edgeLanes);
+            const __m256i p1 = rle_blend_gather8_avx2(src + i + 8, dst + i + 8, map, gatherLimit, edgeLanes);
+            const __m256i p2 = rle_blend_gather8_avx2(src + i + 16, dst + i + 16, map, gatherLimit, edgeLanes);
+            const __m256i p3 = rle_blend_gather8_avx2(src + i + 24, dst + i + 24, map, gatherLimit, edgeLanes);
+            if (!_mm256_testz_si256(edgeLanes, edgeLanes))
+            {
+                rle_blend_scalar(src + i, dst + i, 32, map, mapLength);
+                continue;
+            }
+
+            // Packing works within 128 bit lanes, the permute puts the four groups of 8 back in order
+            const __m256i packed = _mm256_packus_epi16(_mm256_packus_epi32(p0, p1), _mm256_packus_epi32(p2, p3));
+            const __m256i pixels = _mm256_permutevar8x32_epi32(packed, order);
+
+            const __m256i source = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            const __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            rle_store_avx2(dst + i, source, current, pixels);
+        }
+    }
+    rle_blend_scalar(src + i, dst + i, count - i, map, mapLength);
+}
+
 #else
 
 #    ifdef OPENRCT2_X86
@@ -55,4 +183,22 @@ void mask_avx2(
     openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
 }
 
+void rle_remap_avx2(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map, size_t mapLength)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
+void rle_glass_avx2(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map, size_t mapLength)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
+void rle_blend_avx2(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map, size_t mapLength)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
 #endif // __AVX2__
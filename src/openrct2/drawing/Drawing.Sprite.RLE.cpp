@@ -8,8 +8,10 @@
  *****************************************************************************/
 
 #include "Drawing.h"
+#include "SpriteCache.h"
 
 #include <algorithm>
+#include <array>
 #include <cstring>
 
 template<DrawBlendOp TBlendOp, size_t TZoom> static void FASTCALL DrawRLESpriteMagnify(DrawSpriteArgs& args)
@@ -83,6 +85,73 @@ template<DrawBlendOp TBlendOp, size_t TZoom> static void FASTCALL DrawRLESpriteM
     }
 }
 
+void rle_remap_scalar(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map,
+    [[maybe_unused]] size_t mapLength)
+{
+    for (int32_t i = 0; i < count; i++)
+    {
+        if (src[i] != 0)
+        {
+            auto pixel = map[src[i]];
+            if (pixel != 0)
+            {
+                dst[i] = pixel;
+            }
+        }
+    }
+}
+
+void rle_glass_scalar(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map,
+    [[maybe_unused]] size_t mapLength)
+{
+    for (int32_t i = 0; i < count; i++)
+    {
+        if (src[i] != 0)
+        {
+            auto pixel = map[dst[i]];
+            if (pixel != 0)
+            {
+                dst[i] = pixel;
+            }
+        }
+    }
+}
+
+void rle_blend_scalar(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map, size_t mapLength)
+{
+    for (int32_t i = 0; i < count; i++)
+    {
+        if (src[i] != 0)
+        {
+            auto index = ((src[i] - 1) * 256) + dst[i];
+            auto pixel = static_cast<size_t>(index) < mapLength ? map[index] : 0;
+            if (pixel != 0)
+            {
+                dst[i] = pixel;
+            }
+        }
+    }
+}
+
+// The vectorised run function for a blend op, if the CPU has one. The run functions skip transparent source pixels and
+// palette entries, so there are none for blend ops without BLEND_TRANSPARENT.
+template<DrawBlendOp TBlendOp> static RLERunFunc GetRLERunFunc()
+{
+    if constexpr ((TBlendOp & BLEND_TRANSPARENT) == 0)
+        return nullptr;
+    else if constexpr (((TBlendOp & BLEND_SRC) != 0) && ((TBlendOp & BLEND_DST) != 0))
+        return rle_blend_fn;
+    else if constexpr ((TBlendOp & BLEND_SRC) != 0)
+        return rle_remap_fn;
+    else if constexpr ((TBlendOp & BLEND_DST) != 0)
+        return rle_glass_fn;
+    else
+        return nullptr;
+}
+
 template<DrawBlendOp TBlendOp, size_t TZoom> static void FASTCALL DrawRLESpriteMinify(DrawSpriteArgs& args)
 {
     auto dpi = args.DPI;
@@ -95,6 +164,30 @@ template<DrawBlendOp TBlendOp, size_t TZoom> static void FASTCALL DrawRLESpriteM
     auto zoom = 1 << TZoom;
     auto dstLineWidth = (static_cast<size_t>(dpi->width) >> TZoom) + dpi->pitch;
 
+    // Runs are drawn by the vectorised run functions at zoom level 0. Remap and glass maps shorter than a full palette
+    // are padded, as looking past their end gives 0.
+    RLERunFunc runFunc = nullptr;
+    const uint8_t* runMap = nullptr;
+    size_t runMapLength = 0;
+    std::array<uint8_t, 256> paddedMap;
+    if constexpr (TZoom == 0)
+    {
+        runFunc = GetRLERunFunc<TBlendOp>();
+        if (runFunc != nullptr)
+        {
+            runMap = args.PalMap.GetData();
+            runMapLength = args.PalMap.GetLength();
+            constexpr bool isBlend = (TBlendOp & BLEND_SRC) != 0 && (TBlendOp & BLEND_DST) != 0;
+            if (!isBlend && runMapLength < paddedMap.size())
+            {
+                paddedMap.fill(0);
+                std::copy_n(runMap, runMapLength, paddedMap.begin());
+                runMap = paddedMap.data();
+                runMapLength = paddedMap.size();
+            }
+        }
+    }
+
     // Move up to the first line of the image if source_y_start is negative. Why does this even occur?
     if (srcY < 0)
     {
@@ -163,6 +256,13 @@ template<DrawBlendOp TBlendOp, size_t TZoom> static void FASTCALL DrawRLESpriteM
                     std::memcpy(dst, src, numPixels);
                 }
             }
+            else if (runFunc != nullptr)
+            {
+                if (numPixels > 0)
+                {
+                    runFunc(src, dst, numPixels, runMap, runMapLength);
+                }
+            }
             else
             {
                 auto& paletteMap = args.PalMap;
@@ -178,9 +278,39 @@ template<DrawBlendOp TBlendOp, size_t TZoom> static void FASTCALL DrawRLESpriteM
     }
 }
 
+/**
+ * Draws a zoomed out sprite from the sprite cache, where it only has the pixels sampled at this zoom level and sampling
+ * phase. Drawing that at zoom level 0 onto the same destination gives the same pixels.
+ */
+template<DrawBlendOp TBlendOp> static bool DrawRLESpriteFromCache(DrawSpriteArgs& args, int32_t zoom)
+{
+    auto zoomMask = (1 << zoom) - 1;
+    auto phaseX = args.SrcX & zoomMask;
+    auto phaseY = args.SrcY & zoomMask;
+    auto minified = SpriteCacheGetMinified(args.Image.GetIndex(), args.SourceImage, zoom, phaseX, phaseY);
+    if (minified == nullptr)
+    {
+        return false;
+    }
+
+    auto dpi = *args.DPI;
+    dpi.width = args.DPI->width >> zoom;
+    dpi.zoom_level = 0;
+    DrawSpriteArgs minifiedArgs(
+        &dpi, args.Image, args.PalMap, *minified, (args.SrcX - phaseX) >> zoom, (args.SrcY - phaseY) >> zoom,
+        (args.Width + zoomMask) >> zoom, (args.Height + zoomMask) >> zoom, args.DestinationBits);
+    DrawRLESpriteMinify<TBlendOp, 0>(minifiedArgs);
+    return true;
+}
+
 template<DrawBlendOp TBlendOp> static void FASTCALL DrawRLESprite(DrawSpriteArgs& args)
 {
     auto zoom_level = static_cast<int8_t>(args.DPI->zoom_level);
+    if (zoom_level > 0 && DrawRLESpriteFromCache<TBlendOp>(args, zoom_level))
+    {
+        return;
+    }
+
     switch (zoom_level)
     {
         case -2:
@@ -12,6 +12,7 @@
 #include "../PlatformEnvironment.h"
 #include "../config/Config.h"
 #include "../core/FileStream.h"
+#include "../core/MemoryMappedFile.h"
 #include "../core/Path.hpp"
 #include "../platform/platform.h"
 #include "../sprites.h"
@@ -19,10 +20,16 @@
 #include "../util/Util.h"
 #include "Drawing.h"
 #include "ScrollingText.h"
+#include "SpriteCache.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <iterator>
 #include <memory>
 #include <stdexcept>
+#include <thread>
 #include <vector>
 
 using namespace OpenRCT2;
@@ -68,90 +75,221 @@ static inline uint32_t rctc_to_rct2_index(uint32_t image)
 }
 // clang-format on
 
-static void read_and_convert_gxdat(IStream* stream, size_t count, bool is_rctc, rct_g1_element* elements)
+// Index of a RCT2 element in RCTC's g1.dat, which has a number of additional elements added between the RCT2 elements.
+static inline size_t rct2_to_rctc_index(size_t index)
 {
-    auto g1Elements32 = std::make_unique<rct_g1_element_32bit[]>(count);
-    stream->Read(g1Elements32.get(), count * sizeof(rct_g1_element_32bit));
-    if (is_rctc)
+    size_t rctc = index;
+    if (index >= 1542)
+        rctc += 32;
+    if (index >= 4951)
+        rctc += 3;
+    if (index >= 17154)
+        rctc += 2;
+    if (index >= 18084)
+        rctc += 2;
+    if (index >= 23761)
+        rctc += 4;
+    if (index >= 24627)
+        rctc += 4;
+    if (index >= 28197)
+        rctc += 2;
+    return rctc;
+}
+
+enum class GxFileKind : uint8_t
+{
+    RCT2,
+    RCTC,
+    CSG,
+};
+
+enum : uint8_t
+{
+    GX_ELEMENT_UNDECODED,
+    GX_ELEMENT_DECODING,
+    GX_ELEMENT_DECODED,
+};
+
+/**
+ * Where the element headers and pixel data of a sprite file are. Mapped files keep their headers in the file format and
+ * decode each one the first time it is requested, files that are read are decoded all at once.
+ */
+struct GxSource
+{
+    GxFileKind Kind = GxFileKind::RCT2;
+    std::unique_ptr<MemoryMappedFile> File;
+    std::unique_ptr<MemoryMappedFile> DataFile;
+    std::unique_ptr<uint8_t[]> Headers;
+    const uint8_t* HeaderBase = nullptr;
+    const uint8_t* DataBase = nullptr;
+    std::unique_ptr<std::atomic<uint8_t>[]> States;
+};
+
+static void gx_decode_element(const GxSource& source, size_t index, rct_g1_element& dst)
+{
+    size_t srcIndex = source.Kind == GxFileKind::RCTC ? rct2_to_rctc_index(index) : index;
+
+    rct_g1_element_32bit src;
+    std::memcpy(&src, source.HeaderBase + srcIndex * sizeof(rct_g1_element_32bit), sizeof(src));
+
+    dst.offset = const_cast<uint8_t*>(source.DataBase + src.offset);
+    dst.width = src.width;
+    dst.height = src.height;
+    dst.x_offset = src.x_offset;
+    dst.y_offset = src.y_offset;
+    dst.flags = src.flags;
+    dst.zoomed_offset = src.zoomed_offset;
+
+    if (source.Kind == GxFileKind::RCTC)
     {
-        // Process RCTC's g1.dat file
-        uint32_t rctc = 0;
-        for (size_t i = 0; i < SPR_G1_END; ++i)
+        if (src.flags & G1_FLAG_HAS_ZOOM_SPRITE)
+        {
+            auto zoomedIndex = rctc_to_rct2_index(static_cast<uint32_t>(srcIndex) - src.zoomed_offset);
+            dst.zoomed_offset = static_cast<int32_t>(index - zoomedIndex);
+        }
+
+        // The pincer graphic for picking up peeps is different in
+        // RCTC, and the sprites have different offsets to accommodate
+        // the change. This reverts the offsets to their RCT2 values.
+        for (const auto& animation : sprite_peep_pickup_starts)
         {
-            // RCTC's g1.dat has a number of additional elements
-            // added between the RCT2 elements. This switch
-            // statement skips over the elements we don't want.
-            switch (i)
+            auto start = static_cast<size_t>(animation.start);
+            if (index >= start && index < start + SPR_PEEP_PICKUP_COUNT)
             {
-                case 1542:
-                    rctc += 32;
-                    break;
-                case 23761:
-                case 24627:
-                    rctc += 4;
-                    break;
-                case 4951:
-                    rctc += 3;
-                    break;
-                case 17154:
-                case 18084:
-                case 28197:
-                    rctc += 2;
-                    break;
+                dst.x_offset -= animation.x_offset;
+                dst.y_offset -= animation.y_offset;
             }
+        }
+    }
+    else if (source.Kind == GxFileKind::CSG)
+    {
+        // RCT1 used zoomed offsets that counted from the beginning of the file, rather than from the current sprite.
+        if (src.flags & G1_FLAG_HAS_ZOOM_SPRITE)
+        {
+            dst.zoomed_offset = static_cast<int32_t>(index) - dst.zoomed_offset;
+        }
+    }
+}
 
-            const rct_g1_element_32bit& src = g1Elements32[rctc];
+// Element count exposed for a file, RCTC's additional elements are skipped.
+static size_t gx_decoded_count(const GxSource& source, size_t count)
+{
+    return source.Kind == GxFileKind::RCTC ? std::min<size_t>(count, SPR_G1_END) : count;
+}
 
-            // Double cast to silence compiler warning about casting to
-            // pointer from integer of mismatched length.
-            elements[i].offset = reinterpret_cast<uint8_t*>(static_cast<uintptr_t>(src.offset));
-            elements[i].width = src.width;
-            elements[i].height = src.height;
-            elements[i].x_offset = src.x_offset;
-            elements[i].y_offset = src.y_offset;
-            elements[i].flags = src.flags;
+static void gx_decode_all(rct_gx& gx, const GxSource& source)
+{
+    auto count = gx_decoded_count(source, gx.header.num_entries);
+    for (size_t i = 0; i < count; i++)
+    {
+        gx_decode_element(source, i, gx.elements[i]);
+    }
+}
 
-            if (src.flags & G1_FLAG_HAS_ZOOM_SPRITE)
+static rct_g1_element* gx_get_element(rct_gx& gx, GxSource& source, size_t index)
+{
+    if (source.States != nullptr)
+    {
+        // Sprites are drawn from several threads, the first to ask decodes the header and the others wait for it.
+        auto& state = source.States[index];
+        if (state.load(std::memory_order_acquire) != GX_ELEMENT_DECODED)
+        {
+            uint8_t expected = GX_ELEMENT_UNDECODED;
+            if (state.compare_exchange_strong(expected, GX_ELEMENT_DECODING, std::memory_order_acquire))
             {
-                elements[i].zoomed_offset = static_cast<int32_t>(i - rctc_to_rct2_index(rctc - src.zoomed_offset));
+                if (index < gx_decoded_count(source, gx.header.num_entries))
+                {
+                    gx_decode_element(source, index, gx.elements[index]);
+                }
+                state.store(GX_ELEMENT_DECODED, std::memory_order_release);
             }
             else
             {
-                elements[i].zoomed_offset = src.zoomed_offset;
+                while (state.load(std::memory_order_acquire) != GX_ELEMENT_DECODED)
+                {
+                    std::this_thread::yield();
+                }
             }
-
-            ++rctc;
         }
+    }
+    return &gx.elements[index];
+}
 
-        // The pincer graphic for picking up peeps is different in
-        // RCTC, and the sprites have different offsets to accommodate
-        // the change. This reverts the offsets to their RCT2 values.
-        for (const auto& animation : sprite_peep_pickup_starts)
+static void gx_unload(rct_gx& gx, GxSource& source)
+{
+    SpriteCacheInvalidateAll();
+    gx.data.reset();
+    gx.elements.clear();
+    gx.elements.shrink_to_fit();
+    source = {};
+}
+
+/**
+ * Maps a sprite file when enabled, its headers start at headerOffset of headerPath and its pixels at the end of the
+ * headers or at the start of dataPath. Falls back to reading the file, in which case every header is decoded now.
+ */
+static void gx_load(
+    rct_gx& gx, GxSource& source, GxFileKind kind, const std::string& headerPath, size_t headerOffset,
+    const std::string& dataPath)
+{
+    source = {};
+    source.Kind = kind;
+    gx.elements.clear();
+    gx.elements.resize(gx.header.num_entries);
+
+    const auto headersSize = static_cast<uint64_t>(gx.header.num_entries) * sizeof(rct_g1_element_32bit);
+    if (gConfigGeneral.map_sprite_files)
+    {
+        try
         {
-            for (int i = 0; i < SPR_PEEP_PICKUP_COUNT; ++i)
+            source.File = std::make_unique<MemoryMappedFile>(headerPath);
+            if (!dataPath.empty())
             {
-                elements[animation.start + i].x_offset -= animation.x_offset;
-                elements[animation.start + i].y_offset -= animation.y_offset;
+                source.DataFile = std::make_unique<MemoryMappedFile>(dataPath);
             }
         }
+        catch (const IOException& e)
+        {
+            log_verbose("%s, reading the file instead", e.what());
+            source.File = nullptr;
+            source.DataFile = nullptr;
+        }
     }
-    else
+
+    if (source.File != nullptr)
     {
-        for (size_t i = 0; i < count; i++)
+        const auto dataOffset = dataPath.empty() ? headerOffset + headersSize : 0;
+        const auto& dataFile = dataPath.empty() ? *source.File : *source.DataFile;
+        if (source.File->GetLength() < headerOffset + headersSize || dataFile.GetLength() < dataOffset + gx.header.total_size)
         {
-            const rct_g1_element_32bit& src = g1Elements32[i];
-
-            // Double cast to silence compiler warning about casting to
-            // pointer from integer of mismatched length.
-            elements[i].offset = reinterpret_cast<uint8_t*>(static_cast<uintptr_t>(src.offset));
-            elements[i].width = src.width;
-            elements[i].height = src.height;
-            elements[i].x_offset = src.x_offset;
-            elements[i].y_offset = src.y_offset;
-            elements[i].flags = src.flags;
-            elements[i].zoomed_offset = src.zoomed_offset;
+            throw IOException("Sprite file is truncated");
         }
+        source.HeaderBase = source.File->GetData() + headerOffset;
+        source.DataBase = dataFile.GetData() + dataOffset;
+        source.States = std::make_unique<std::atomic<uint8_t>[]>(gx.header.num_entries);
+        for (size_t i = 0; i < gx.header.num_entries; i++)
+        {
+            source.States[i].store(GX_ELEMENT_UNDECODED, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    auto fs = FileStream(headerPath, FILE_MODE_OPEN);
+    fs.SetPosition(headerOffset);
+    source.Headers = fs.ReadArray<uint8_t>(headersSize);
+    if (dataPath.empty())
+    {
+        gx.data = fs.ReadArray<uint8_t>(gx.header.total_size);
+    }
+    else
+    {
+        auto fileData = FileStream(dataPath, FILE_MODE_OPEN);
+        gx.data = fileData.ReadArray<uint8_t>(gx.header.total_size);
     }
+    source.HeaderBase = source.Headers.get();
+    source.DataBase = gx.data.get();
+    gx_decode_all(gx, source);
+    source.Headers.reset();
 }
 
 void mask_scalar(
@@ -181,6 +319,9 @@ void mask_scalar(
 static rct_gx _g1 = {};
 static rct_gx _g2 = {};
 static rct_gx _csg = {};
+static GxSource _g1Source;
+static GxSource _g2Source;
+static GxSource _csgSource;
 static rct_g1_element _scrollingText[MaxScrollingTextEntries]{};
 static bool _csgLoaded = false;
 
@@ -198,8 +339,10 @@ bool gfx_load_g1(const IPlatformEnvironment& env)
     try
     {
         auto path = Path::Combine(env.GetDirectoryPath(DIRBASE::RCT2, DIRID::DATA), "g1.dat");
-        auto fs = FileStream(path, FILE_MODE_OPEN);
-        _g1.header = fs.ReadValue<rct_g1_header>();
+        {
+            auto fs = FileStream(path, FILE_MODE_OPEN);
+            _g1.header = fs.ReadValue<rct_g1_header>();
+        }
 
         log_verbose("g1.dat, number of entries: %u", _g1.header.num_entries);
 
@@ -208,26 +351,14 @@ bool gfx_load_g1(const IPlatformEnvironment& env)
             throw std::runtime_error("Not enough elements in g1.dat");
         }
 
-        // Read element headers
         bool is_rctc = _g1.header.num_entries == SPR_RCTC_G1_END;
-        _g1.elements.resize(_g1.header.num_entries);
-        read_and_convert_gxdat(&fs, _g1.header.num_entries, is_rctc, _g1.elements.data());
+        gx_load(_g1, _g1Source, is_rctc ? GxFileKind::RCTC : GxFileKind::RCT2, path, sizeof(rct_g1_header), {});
         gTinyFontAntiAliased = is_rctc;
-
-        // Read element data
-        _g1.data = fs.ReadArray<uint8_t>(_g1.header.total_size);
-
-        // Fix entry data offsets
-        for (uint32_t i = 0; i < _g1.header.num_entries; i++)
-        {
-            _g1.elements[i].offset += reinterpret_cast<uintptr_t>(_g1.data.get());
-        }
         return true;
     }
     catch (const std::exception&)
     {
-        _g1.elements.clear();
-        _g1.elements.shrink_to_fit();
+        gx_unload(_g1, _g1Source);
 
         log_fatal("Unable to load g1 graphics");
         if (!gOpenRCT2Headless)
@@ -241,23 +372,17 @@ bool gfx_load_g1(const IPlatformEnvironment& env)
 
 void gfx_unload_g1()
 {
-    _g1.data.reset();
-    _g1.elements.clear();
-    _g1.elements.shrink_to_fit();
+    gx_unload(_g1, _g1Source);
 }
 
 void gfx_unload_g2()
 {
-    _g2.data.reset();
-    _g2.elements.clear();
-    _g2.elements.shrink_to_fit();
+    gx_unload(_g2, _g2Source);
 }
 
 void gfx_unload_csg()
 {
-    _csg.data.reset();
-    _csg.elements.clear();
-    _csg.elements.shrink_to_fit();
+    gx_unload(_csg, _csgSource);
 }
 
 bool gfx_load_g2()
@@ -270,27 +395,16 @@ bool gfx_load_g2()
     safe_strcat_path(path, "g2.dat", MAX_PATH);
     try
     {
-        auto fs = FileStream(path, FILE_MODE_OPEN);
-        _g2.header = fs.ReadValue<rct_g1_header>();
-
-        // Read element headers
-        _g2.elements.resize(_g2.header.num_entries);
-        read_and_convert_gxdat(&fs, _g2.header.num_entries, false, _g2.elements.data());
-
-        // Read element data
-        _g2.data = fs.ReadArray<uint8_t>(_g2.header.total_size);
-
-        // Fix entry data offsets
-        for (uint32_t i = 0; i < _g2.header.num_entries; i++)
         {
-            _g2.elements[i].offset += reinterpret_cast<uintptr_t>(_g2.data.get());
+            auto fs = FileStream(path, FILE_MODE_OPEN);
+            _g2.header = fs.ReadValue<rct_g1_header>();
         }
+        gx_load(_g2, _g2Source, GxFileKind::RCT2, path, sizeof(rct_g1_header), {});
         return true;
     }
     catch (const std::exception&)
     {
-        _g2.elements.clear();
-        _g2.elements.shrink_to_fit();
+        gx_unload(_g2, _g2Source);
 
         log_fatal("Unable to load g2 graphics");
         if (!gOpenRCT2Headless)
@@ -330,36 +444,26 @@ bool gfx_load_csg()
             return false;
         }
 
-        // Read element headers
-        _csg.elements.resize(_csg.header.num_entries);
-        read_and_convert_gxdat(&fileHeader, _csg.header.num_entries, false, _csg.elements.data());
-
-        // Read element data
-        _csg.data = fileData.ReadArray<uint8_t>(_csg.header.total_size);
-
-        // Fix entry data offsets
-        for (uint32_t i = 0; i < _csg.header.num_entries; i++)
-        {
-            _csg.elements[i].offset += reinterpret_cast<uintptr_t>(_csg.data.get());
-            // RCT1 used zoomed offsets that counted from the beginning of the file, rather than from the current sprite.
-            if (_csg.elements[i].flags & G1_FLAG_HAS_ZOOM_SPRITE)
-            {
-                _csg.elements[i].zoomed_offset = i - _csg.elements[i].zoomed_offset;
-            }
-        }
+        gx_load(_csg, _csgSource, GxFileKind::CSG, pathHeaderPath, 0, pathDataPath);
         _csgLoaded = true;
         return true;
     }
     catch (const std::exception&)
     {
-        _csg.elements.clear();
-        _csg.elements.shrink_to_fit();
+        gx_unload(_csg, _csgSource);
 
         log_error("Unable to load csg graphics");
         return false;
     }
 }
 
+static std::array<uint8_t, 256> gfx_copy_palette(const uint8_t (&palette)[256])
+{
+    std::array<uint8_t, 256> copy;
+    std::copy(std::begin(palette), std::end(palette), copy.begin());
+    return copy;
+}
+
 static std::optional<PaletteMap> FASTCALL gfx_draw_sprite_get_palette(ImageId imageId)
 {
     if (!imageId.HasSecondary())
@@ -373,10 +477,14 @@ static std::optional<PaletteMap> FASTCALL gfx_draw_sprite_get_palette(ImageId im
     }
     else
     {
-        auto paletteMap = PaletteMap(gPeepPalette);
+        // The remap ranges are written for every sprite, so each thread drawing viewport columns needs its own copies.
+        thread_local auto peepPalette = gfx_copy_palette(gPeepPalette);
+        thread_local auto otherPalette = gfx_copy_palette(gOtherPalette);
+
+        auto paletteMap = PaletteMap(peepPalette.data(), 1, static_cast<uint16_t>(peepPalette.size()));
         if (imageId.HasTertiary())
         {
-            paletteMap = PaletteMap(gOtherPalette);
+            paletteMap = PaletteMap(otherPalette.data(), 1, static_cast<uint16_t>(otherPalette.size()));
             auto tertiaryPaletteMap = GetPaletteMapForColour(imageId.GetTertiary());
             if (tertiaryPaletteMap)
             {
@@ -673,7 +781,7 @@ const rct_g1_element* gfx_get_g1_element(int32_t image_id)
     {
         if (offset < _g1.elements.size())
         {
-            return &_g1.elements[offset];
+            return gx_get_element(_g1, _g1Source, offset);
         }
     }
     else if (offset < SPR_G2_END)
@@ -681,7 +789,7 @@ const rct_g1_element* gfx_get_g1_element(int32_t image_id)
         size_t idx = offset - SPR_G2_BEGIN;
         if (idx < _g2.header.num_entries)
         {
-            return &_g2.elements[idx];
+            return gx_get_element(_g2, _g2Source, idx);
         }
         else
         {
@@ -695,7 +803,7 @@ const rct_g1_element* gfx_get_g1_element(int32_t image_id)
             size_t idx = offset - SPR_CSG_BEGIN;
             if (idx < _csg.header.num_entries)
             {
-                return &_csg.elements[idx];
+                return gx_get_element(_csg, _csgSource, idx);
             }
             else
             {
@@ -736,6 +844,7 @@ void gfx_set_g1_element(int32_t imageId, const rct_g1_element* g1)
 
     if (g1 != nullptr)
     {
+        SpriteCacheInvalidateImage(imageId);
         if (isTemp)
         {
             _g1Temp = *g1;
@@ -746,7 +855,8 @@ void gfx_set_g1_element(int32_t imageId, const rct_g1_element* g1)
             {
                 if (imageId < static_cast<int32_t>(_g1.elements.size()))
                 {
-                    _g1.elements[imageId] = *g1;
+                    // Decode first so a lazy decode cannot overwrite the new element later
+                    *gx_get_element(_g1, _g1Source, imageId) = *g1;
                 }
             }
             else if (imageId < SPR_SCROLLING_TEXT_END)
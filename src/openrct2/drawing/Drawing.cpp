@@ -556,22 +556,35 @@ void (*mask_fn)(
     int32_t maskWrap, int32_t colourWrap, int32_t dstWrap)
     = nullptr;
 
+RLERunFunc rle_remap_fn = nullptr;
+RLERunFunc rle_glass_fn = nullptr;
+RLERunFunc rle_blend_fn = nullptr;
+
 void mask_init()
 {
     if (avx2_available())
     {
         log_verbose("registering AVX2 mask function");
         mask_fn = mask_avx2;
+        rle_remap_fn = rle_remap_avx2;
+        rle_glass_fn = rle_glass_avx2;
+        rle_blend_fn = rle_blend_avx2;
     }
     else if (sse41_available())
     {
         log_verbose("registering SSE4.1 mask function");
         mask_fn = mask_sse4_1;
+        rle_remap_fn = rle_remap_sse4_1;
+        rle_glass_fn = rle_glass_sse4_1;
+        rle_blend_fn = nullptr;
     }
     else
     {
         log_verbose("registering scalar mask function");
         mask_fn = mask_scalar;
+        rle_remap_fn = nullptr;
+        rle_glass_fn = nullptr;
+        rle_blend_fn = nullptr;
     }
 }
 
@@ -535,6 +535,16 @@ public:
 
     uint8_t& operator[](size_t index);
     uint8_t operator[](size_t index) const;
+
+    const uint8_t* GetData() const
+    {
+        return _data;
+    }
+    uint32_t GetLength() const
+    {
+        return _dataLength;
+    }
+
     uint8_t Blend(uint8_t src, uint8_t dst) const;
     void Copy(size_t dstIndex, const PaletteMap& src, size_t srcIndex, size_t length);
 };
@@ -788,6 +798,36 @@ extern void (*mask_fn)(
     int32_t width, int32_t height, const uint8_t* RESTRICT maskSrc, const uint8_t* RESTRICT colourSrc, uint8_t* RESTRICT dst,
     int32_t maskWrap, int32_t colourWrap, int32_t dstWrap);
 
+/**
+ * Draws one run of an RLE sprite at zoom level 0. Remap and glass look the source or destination pixel up in a map of
+ * 256 entries, blend looks it up in the map for source colour - 1 of a list of 256 entry maps, indices past mapLength
+ * give 0. Source pixels of 0 and looked up pixels of 0 leave the destination unchanged.
+ */
+using RLERunFunc = void (*)(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map, size_t mapLength);
+
+void rle_remap_scalar(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map, size_t mapLength);
+void rle_glass_scalar(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map, size_t mapLength);
+void rle_blend_scalar(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map, size_t mapLength);
+void rle_remap_sse4_1(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map, size_t mapLength);
+void rle_glass_sse4_1(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map, size_t mapLength);
+void rle_remap_avx2(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map, size_t mapLength);
+void rle_glass_avx2(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map, size_t mapLength);
+void rle_blend_avx2(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map, size_t mapLength);
+
+// Left as nullptr where the CPU has no faster version, the sprite is then drawn one pixel at a time.
+extern RLERunFunc rle_remap_fn;
+extern RLERunFunc rle_glass_fn;
+extern RLERunFunc rle_blend_fn;
+
 std::optional<uint32_t> GetPaletteG1Index(colour_t paletteId);
 std::optional<PaletteMap> GetPaletteMapForColour(colour_t paletteId);
 
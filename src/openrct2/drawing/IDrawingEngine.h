@@ -32,6 +32,11 @@ enum DRAWING_ENGINE_FLAGS
      * Whether or not the engine will only draw changed blocks of the screen each frame.
      */
     DEF_DIRTY_OPTIMISATIONS = 1 << 0,
+
+    /**
+     * Whether or not separate areas of a DPI can be drawn to from multiple threads at once.
+     */
+    DEF_PARALLEL_DRAWING = 1 << 1,
 };
 
 struct rct_drawpixelinfo;
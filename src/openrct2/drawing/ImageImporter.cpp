@@ -11,6 +11,7 @@
 
 #include "../core/Imaging.h"
 
+#include <array>
 #include <cstring>
 #include <stdexcept>
 #include <string>
@@ -20,6 +21,77 @@ using ImportResult = ImageImporter::ImportResult;
 
 constexpr int32_t PALETTE_TRANSPARENT = -1;
 
+/**
+ * The entries of a palette grouped by their colour with 5 bits per channel, so that an exact match for a colour only
+ * has to be looked for among the few entries that share those bits rather than the whole palette.
+ */
+class PaletteIndexTable final
+{
+private:
+    static constexpr size_t BucketCount = 1 << 15;
+
+    const GamePalette& _palette;
+    std::array<uint16_t, BucketCount + 1> _bucketStarts{};
+    std::array<uint8_t, PALETTE_SIZE> _indices{};
+
+    static size_t GetBucket(int32_t red, int32_t green, int32_t blue)
+    {
+        return ((red >> 3) << 10) | ((green >> 3) << 5) | (blue >> 3);
+    }
+
+    static size_t GetBucket(const PaletteBGRA& colour)
+    {
+        return GetBucket(colour.Red, colour.Green, colour.Blue);
+    }
+
+public:
+    explicit PaletteIndexTable(const GamePalette& palette)
+        : _palette(palette)
+    {
+        for (int32_t i = 0; i < PALETTE_SIZE; i++)
+        {
+            _bucketStarts[GetBucket(palette[i]) + 1]++;
+        }
+        for (size_t i = 0; i < BucketCount; i++)
+        {
+            _bucketStarts[i + 1] += _bucketStarts[i];
+        }
+
+        // Entries are added in order, so the first one with a colour is still the one that is found. Adding them moves
+        // the start of each bucket to the start of the next one, which is moved back afterwards.
+        for (int32_t i = 0; i < PALETTE_SIZE; i++)
+        {
+            _indices[_bucketStarts[GetBucket(palette[i])]++] = static_cast<uint8_t>(i);
+        }
+        for (size_t i = BucketCount - 1; i > 0; i--)
+        {
+            _bucketStarts[i] = _bucketStarts[i - 1];
+        }
+        _bucketStarts[0] = 0;
+    }
+
+    int32_t Find(const int16_t* colour) const
+    {
+        // Dithering can push the channels out of range
+        if (colour[0] < 0 || colour[0] > 255 || colour[1] < 0 || colour[1] > 255 || colour[2] < 0 || colour[2] > 255)
+        {
+            return PALETTE_TRANSPARENT;
+        }
+
+        auto bucket = GetBucket(colour[0], colour[1], colour[2]);
+        for (auto i = _bucketStarts[bucket]; i < _bucketStarts[bucket + 1]; i++)
+        {
+            auto index = _indices[i];
+            const auto entry = _palette[index];
+            if (entry.Red == colour[0] && entry.Green == colour[1] && entry.Blue == colour[2])
+            {
+                return index;
+            }
+        }
+        return PALETTE_TRANSPARENT;
+    }
+};
+
 ImportResult ImageImporter::Import(
     const Image& image, int32_t offsetX, int32_t offsetY, IMPORT_FLAGS flags, IMPORT_MODE mode) const
 {
@@ -216,7 +288,7 @@ int32_t ImageImporter::CalculatePaletteIndex(
     IMPORT_MODE mode, int16_t* rgbaSrc, int32_t x, int32_t y, int32_t width, int32_t height)
 {
     auto& palette = StandardPalette;
-    auto paletteIndex = GetPaletteIndex(palette, rgbaSrc);
+    auto paletteIndex = GetPaletteIndex(rgbaSrc);
     if (mode == IMPORT_MODE::CLOSEST || mode == IMPORT_MODE::DITHERING)
     {
         if (paletteIndex == PALETTE_TRANSPARENT && !IsTransparentPixel(rgbaSrc))
@@ -226,7 +298,7 @@ int32_t ImageImporter::CalculatePaletteIndex(
     }
     if (mode == IMPORT_MODE::DITHERING)
     {
-        if (!IsTransparentPixel(rgbaSrc) && IsChangablePixel(GetPaletteIndex(palette, rgbaSrc)))
+        if (!IsTransparentPixel(rgbaSrc) && IsChangablePixel(GetPaletteIndex(rgbaSrc)))
         {
             auto dr = rgbaSrc[0] - static_cast<int16_t>(palette[paletteIndex].Red);
             auto dg = rgbaSrc[1] - static_cast<int16_t>(palette[paletteIndex].Green);
@@ -234,7 +306,7 @@ int32_t ImageImporter::CalculatePaletteIndex(
 
             if (x + 1 < width)
             {
-                if (!IsTransparentPixel(rgbaSrc + 4) && IsChangablePixel(GetPaletteIndex(palette, rgbaSrc + 4)))
+                if (!IsTransparentPixel(rgbaSrc + 4) && IsChangablePixel(GetPaletteIndex(rgbaSrc + 4)))
                 {
                     // Right
                     rgbaSrc[4] += dr * 7 / 16;
@@ -248,7 +320,7 @@ int32_t ImageImporter::CalculatePaletteIndex(
                 if (x > 0)
                 {
                     if (!IsTransparentPixel(rgbaSrc + 4 * (width - 1))
-                        && IsChangablePixel(GetPaletteIndex(palette, rgbaSrc + 4 * (width - 1))))
+                        && IsChangablePixel(GetPaletteIndex(rgbaSrc + 4 * (width - 1))))
                     {
                         // Bottom left
                         rgbaSrc[4 * (width - 1)] += dr * 3 / 16;
@@ -258,7 +330,7 @@ int32_t ImageImporter::CalculatePaletteIndex(
                 }
 
                 // Bottom
-                if (!IsTransparentPixel(rgbaSrc + 4 * width) && IsChangablePixel(GetPaletteIndex(palette, rgbaSrc + 4 * width)))
+                if (!IsTransparentPixel(rgbaSrc + 4 * width) && IsChangablePixel(GetPaletteIndex(rgbaSrc + 4 * width)))
                 {
                     rgbaSrc[4 * width] += dr * 5 / 16;
                     rgbaSrc[4 * width + 1] += dg * 5 / 16;
@@ -268,7 +340,7 @@ int32_t ImageImporter::CalculatePaletteIndex(
                 if (x + 1 < width)
                 {
                     if (!IsTransparentPixel(rgbaSrc + 4 * (width + 1))
-                        && IsChangablePixel(GetPaletteIndex(palette, rgbaSrc + 4 * (width + 1))))
+                        && IsChangablePixel(GetPaletteIndex(rgbaSrc + 4 * (width + 1))))
                     {
                         // Bottom right
                         rgbaSrc[4 * (width + 1)] += dr * 1 / 16;
@@ -282,18 +354,12 @@ int32_t ImageImporter::CalculatePaletteIndex(
     return paletteIndex;
 }
 
-int32_t ImageImporter::GetPaletteIndex(const GamePalette& palette, int16_t* colour)
+int32_t ImageImporter::GetPaletteIndex(const int16_t* colour)
 {
+    static const PaletteIndexTable table(StandardPalette);
     if (!IsTransparentPixel(colour))
     {
-        for (int32_t i = 0; i < PALETTE_SIZE; i++)
-        {
-            if (static_cast<int16_t>(palette[i].Red) == colour[0] && static_cast<int16_t>(palette[i].Green) == colour[1]
-                && static_cast<int16_t>(palette[i].Blue) == colour[2])
-            {
-                return i;
-            }
-        }
+        return table.Find(colour);
     }
     return PALETTE_TRANSPARENT;
 }
@@ -57,7 +57,7 @@ namespace OpenRCT2::Drawing
 
         static int32_t CalculatePaletteIndex(
             IMPORT_MODE mode, int16_t* rgbaSrc, int32_t x, int32_t y, int32_t width, int32_t height);
-        static int32_t GetPaletteIndex(const GamePalette& palette, int16_t* colour);
+        static int32_t GetPaletteIndex(const int16_t* colour);
         static bool IsTransparentPixel(const int16_t* colour);
         static bool IsChangablePixel(int32_t paletteIndex);
         static int32_t GetClosestPaletteIndex(const GamePalette& palette, const int16_t* colour);
@@ -11,6 +11,8 @@
 #include "../core/Guard.hpp"
 #include "Drawing.h"
 
+#include <cstring>
+
 #ifdef __SSE4_1__
 
 #    include <immintrin.h>
@@ -56,6 +58,76 @@ void mask_sse4_1(
     }
 }
 
+// Looks 16 indices up in a 256 entry table, one pshufb for every 16 entries.
+static inline __m128i rle_lookup_sse4_1(const uint8_t* RESTRICT map, __m128i indices)
+{
+    const __m128i lowMask = _mm_set1_epi8(0x0F);
+    const __m128i low = _mm_and_si128(indices, lowMask);
+    const __m128i high = _mm_and_si128(_mm_srli_epi16(indices, 4), lowMask);
+    __m128i result = _mm_setzero_si128();
+    for (int32_t i = 0; i < 16; i++)
+    {
+        const __m128i entries = _mm_loadu_si128(reinterpret_cast<const __m128i*>(map + i * 16));
+        const __m128i inSlice = _mm_cmpeq_epi8(high, _mm_set1_epi8(static_cast<char>(i)));
+        result = _mm_or_si128(result, _mm_and_si128(_mm_shuffle_epi8(entries, low), inSlice));
+    }
+    return result;
+}
+
+// Writes the looked up pixels, except where the source or the looked up pixel is 0.
+static inline void rle_store_sse4_1(uint8_t* RESTRICT dst, __m128i source, __m128i current, __m128i pixels)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i keep = _mm_or_si128(_mm_cmpeq_epi8(source, zero), _mm_cmpeq_epi8(pixels, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_blendv_epi8(pixels, current, keep));
+}
+
+// Draws 16 pixels of a remap run, or of a glass run which looks up the destination pixels instead.
+template<bool TGlass>
+static inline void rle_run16_sse4_1(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT map)
+{
+    const __m128i source = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst));
+    rle_store_sse4_1(dst, source, current, rle_lookup_sse4_1(map, TGlass ? current : source));
+}
+
+template<bool TGlass>
+static void rle_run_sse4_1(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map)
+{
+    int32_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        rle_run16_sse4_1<TGlass>(src + i, dst + i, map);
+    }
+
+    // Runs are mostly shorter than a vector, so the rest goes through a padded copy rather than one pixel at a time.
+    // Padding source pixels are 0 and leave their destination unchanged.
+    if (i < count)
+    {
+        const auto rest = static_cast<size_t>(count - i);
+        uint8_t source[16]{};
+        uint8_t current[16]{};
+        std::memcpy(source, src + i, rest);
+        std::memcpy(current, dst + i, rest);
+        rle_run16_sse4_1<TGlass>(source, current, map);
+        std::memcpy(dst + i, current, rest);
+    }
+}
+
+void rle_remap_sse4_1(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map,
+    [[maybe_unused]] size_t mapLength)
+{
+    rle_run_sse4_1<false>(src, dst, count, map);
+}
+
+void rle_glass_sse4_1(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map,
+    [[maybe_unused]] size_t mapLength)
+{
+    rle_run_sse4_1<true>(src, dst, count, map);
+}
+
 #else
 
 #    ifdef OPENRCT2_X86
@@ -69,4 +141,16 @@ void mask_sse4_1(
     openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
 }
 
+void rle_remap_sse4_1(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map, size_t mapLength)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+}
+
+void rle_glass_sse4_1(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t count, const uint8_t* RESTRICT map, size_t mapLength)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+}
+
 #endif // __SSE4_1__
@@ -0,0 +1,296 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "SpriteCache.h"
+
+#include "../config/Config.h"
+#include "../sprites.h"
+#include "Drawing.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    struct CachedSprite
+    {
+        uint32_t Key;
+        const rct_g1_element* Source;
+        uint32_t Generation;
+        uint32_t ImageGeneration;
+        std::atomic<uint32_t> LastUsed;
+        // Offset is nullptr if the sprite could not be minified, so it is drawn the usual way.
+        rct_g1_element Element;
+        std::vector<uint8_t> Data;
+    };
+
+    // Zoom levels 1 to 3 are cached, zoom level 0 draws every pixel anyway.
+    constexpr int32_t MaxCachedZoom = 3;
+    // Each key can only be cached in the ways of one set, the least recently used of them is evicted.
+    constexpr size_t Ways = 4;
+    constexpr size_t SetCountBits = 11;
+    constexpr size_t SetCount = 1 << SetCountBits;
+    // Images share generations when their indices are equal modulo this, which only costs an extra rebuild.
+    constexpr size_t ImageGenerationCount = 4096;
+
+    /**
+     * Sprites are published through atomic slots so lookups never lock. Replaced sprites are only freed by
+     * SpriteCacheCollect, as other drawing threads may still be reading them.
+     */
+    struct SpriteCacheTables
+    {
+        std::array<std::array<std::atomic<CachedSprite*>, SetCount * Ways>, MaxCachedZoom> Slots{};
+        std::mutex WriteMutex;
+        std::vector<CachedSprite*> Retired;
+
+        ~SpriteCacheTables()
+        {
+            for (auto& zoomSlots : Slots)
+            {
+                for (auto& slot : zoomSlots)
+                {
+                    delete slot.exchange(nullptr);
+                }
+            }
+            for (auto sprite : Retired)
+            {
+                delete sprite;
+            }
+        }
+    };
+} // namespace
+
+static SpriteCacheTables _tables;
+static std::array<std::atomic<uint32_t>, ImageGenerationCount> _imageGenerations;
+static std::atomic<uint32_t> _generation;
+static std::atomic<uint32_t> _clock;
+static std::atomic<uint64_t> _hits;
+static std::atomic<uint64_t> _misses;
+static std::atomic<uint64_t> _evictions;
+
+static bool IsCacheable(uint32_t imageIndex, const rct_g1_element& source)
+{
+    // Scrolling text and the temporary image are redrawn with new pixels all the time.
+    if (imageIndex == SPR_TEMP || (imageIndex >= SPR_SCROLLING_TEXT_START && imageIndex < SPR_SCROLLING_TEXT_END))
+        return false;
+    return (source.flags & G1_FLAG_RLE_COMPRESSION) && source.offset != nullptr && source.width > 0 && source.height > 0;
+}
+
+static uint32_t MakeKey(uint32_t imageIndex, int32_t phaseX, int32_t phaseY)
+{
+    return imageIndex | (static_cast<uint32_t>(phaseX) << 19) | (static_cast<uint32_t>(phaseY) << 22);
+}
+
+static std::atomic<CachedSprite*>* GetSet(int32_t zoom, uint32_t key)
+{
+    auto set = (key * 0x9E3779B1u) >> (32 - SetCountBits);
+    return &_tables.Slots[zoom - 1][set * Ways];
+}
+
+static std::atomic<uint32_t>& GetImageGeneration(uint32_t imageIndex)
+{
+    return _imageGenerations[imageIndex % ImageGenerationCount];
+}
+
+// Appends a row of pixels as RLE runs, transparent pixels are left out as the zoomed out blits skip them anyway.
+static void EncodeRLERow(const uint8_t* pixels, int32_t width, std::vector<uint8_t>& data)
+{
+    size_t lastRun = std::numeric_limits<size_t>::max();
+    for (int32_t x = 0; x < width;)
+    {
+        if (pixels[x] == 0)
+        {
+            x++;
+            continue;
+        }
+        auto start = x;
+        while (x < width && pixels[x] != 0 && x - start < 127)
+            x++;
+
+        lastRun = data.size();
+        data.push_back(static_cast<uint8_t>(x - start));
+        data.push_back(static_cast<uint8_t>(start));
+        data.insert(data.end(), pixels + start, pixels + x);
+    }
+
+    if (lastRun == std::numeric_limits<size_t>::max())
+    {
+        lastRun = data.size();
+        data.push_back(0);
+        data.push_back(0);
+    }
+    data[lastRun] |= 0x80;
+}
+
+static std::unique_ptr<CachedSprite> MinifySprite(const rct_g1_element& source, int32_t zoom, int32_t phaseX, int32_t phaseY)
+{
+    const int32_t step = 1 << zoom;
+    auto sprite = std::make_unique<CachedSprite>();
+    sprite->Element = {};
+    sprite->Element.flags = G1_FLAG_RLE_COMPRESSION;
+    sprite->Element.width = source.width > phaseX ? (source.width - phaseX + step - 1) >> zoom : 0;
+    sprite->Element.height = source.height > phaseY ? (source.height - phaseY + step - 1) >> zoom : 0;
+
+    const int32_t width = sprite->Element.width;
+    const int32_t height = sprite->Element.height;
+    if (width <= 0 || height <= 0)
+        return sprite;
+
+    auto& data = sprite->Data;
+    data.resize(static_cast<size_t>(height) * 2);
+    std::vector<uint8_t> sourceRow(source.width);
+    std::vector<uint8_t> row(width);
+    for (int32_t y = 0; y < height; y++)
+    {
+        // Line offsets are 16 bit, give up on sprites which outgrow them
+        if (data.size() > std::numeric_limits<uint16_t>::max())
+            return sprite;
+        data[y * 2] = data.size() & 0xFF;
+        data[y * 2 + 1] = (data.size() >> 8) & 0xFF;
+
+        const auto* src0 = source.offset;
+        const int32_t sourceY = phaseY + (y << zoom);
+        uint16_t lineOffset = src0[sourceY * 2] | (src0[sourceY * 2 + 1] << 8);
+        auto nextRun = src0 + lineOffset;
+        std::fill(sourceRow.begin(), sourceRow.end(), 0);
+        bool isEndOfLine = false;
+        while (!isEndOfLine)
+        {
+            auto src = nextRun;
+            auto dataSize = *src++;
+            auto firstPixelX = *src++;
+            isEndOfLine = (dataSize & 0x80) != 0;
+            dataSize &= 0x7F;
+            nextRun = src + dataSize;
+
+            auto numPixels = std::min<int32_t>(dataSize, source.width - firstPixelX);
+            if (numPixels > 0)
+            {
+                std::copy_n(src, numPixels, sourceRow.begin() + firstPixelX);
+            }
+        }
+
+        for (int32_t x = 0; x < width; x++)
+        {
+            row[x] = sourceRow[phaseX + (x << zoom)];
+        }
+        EncodeRLERow(row.data(), width, data);
+    }
+
+    data.shrink_to_fit();
+    sprite->Element.offset = data.data();
+    return sprite;
+}
+
+const rct_g1_element* SpriteCacheGetMinified(
+    uint32_t imageIndex, const rct_g1_element& source, int32_t zoom, int32_t phaseX, int32_t phaseY)
+{
+    if (!gConfigGeneral.zoomed_sprite_cache || zoom < 1 || zoom > MaxCachedZoom || !IsCacheable(imageIndex, source))
+        return nullptr;
+
+    const auto key = MakeKey(imageIndex, phaseX, phaseY);
+    const auto generation = _generation.load(std::memory_order_acquire);
+    const auto imageGeneration = GetImageGeneration(imageIndex).load(std::memory_order_acquire);
+    auto* set = GetSet(zoom, key);
+    for (size_t way = 0; way < Ways; way++)
+    {
+        auto* sprite = set[way].load(std::memory_order_acquire);
+        if (sprite != nullptr && sprite->Key == key && sprite->Source == &source && sprite->Generation == generation
+            && sprite->ImageGeneration == imageGeneration)
+        {
+            _hits.fetch_add(1, std::memory_order_relaxed);
+            // Only written when it changes, to keep the cache line shared between the drawing threads
+            const auto now = _clock.load(std::memory_order_relaxed);
+            if (sprite->LastUsed.load(std::memory_order_relaxed) != now)
+            {
+                sprite->LastUsed.store(now, std::memory_order_relaxed);
+            }
+            return sprite->Element.offset != nullptr ? &sprite->Element : nullptr;
+        }
+    }
+
+    _misses.fetch_add(1, std::memory_order_relaxed);
+    auto newSprite = MinifySprite(source, zoom, phaseX, phaseY);
+    newSprite->Key = key;
+    newSprite->Source = &source;
+    newSprite->Generation = generation;
+    newSprite->ImageGeneration = imageGeneration;
+    newSprite->LastUsed = _clock.load(std::memory_order_relaxed);
+    const auto* result = newSprite->Element.offset != nullptr ? &newSprite->Element : nullptr;
+
+    std::lock_guard<std::mutex> lock(_tables.WriteMutex);
+
+    // Replace the same key or an empty slot, otherwise the least recently used sprite
+    size_t victim = 0;
+    auto oldest = std::numeric_limits<uint32_t>::max();
+    for (size_t way = 0; way < Ways; way++)
+    {
+        const auto* sprite = set[way].load(std::memory_order_relaxed);
+        if (sprite == nullptr || sprite->Key == key)
+        {
+            victim = way;
+            break;
+        }
+        const auto lastUsed = sprite->LastUsed.load(std::memory_order_relaxed);
+        if (lastUsed < oldest)
+        {
+            oldest = lastUsed;
+            victim = way;
+        }
+    }
+
+    auto* replaced = set[victim].exchange(newSprite.release(), std::memory_order_acq_rel);
+    if (replaced != nullptr)
+    {
+        if (replaced->Key != key)
+        {
+            _evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+        _tables.Retired.push_back(replaced);
+    }
+    return result;
+}
+
+void SpriteCacheInvalidateImage(uint32_t imageIndex)
+{
+    GetImageGeneration(imageIndex).fetch_add(1, std::memory_order_release);
+}
+
+void SpriteCacheInvalidateAll()
+{
+    _generation.fetch_add(1, std::memory_order_release);
+}
+
+void SpriteCacheCollect()
+{
+    std::lock_guard<std::mutex> lock(_tables.WriteMutex);
+    for (auto sprite : _tables.Retired)
+    {
+        delete sprite;
+    }
+    _tables.Retired.clear();
+    _clock.fetch_add(1, std::memory_order_relaxed);
+}
+
+SpriteCacheStats SpriteCacheGetStats()
+{
+    return { _hits.load(), _misses.load(), _evictions.load() };
+}
+
+void SpriteCacheResetStats()
+{
+    _hits = 0;
+    _misses = 0;
+    _evictions = 0;
+}
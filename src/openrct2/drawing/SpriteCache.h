@@ -0,0 +1,42 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+
+struct rct_g1_element;
+
+struct SpriteCacheStats
+{
+    uint64_t Hits;
+    uint64_t Misses;
+    uint64_t Evictions;
+};
+
+/**
+ * Returns the RLE sprite made of every (1 << zoom)th pixel of source, starting at column phaseX and row phaseY, which
+ * draws at zoom level 0 the same as source does at zoom. It is built on first use and kept until evicted by sprites
+ * used more recently. Returns nullptr when the sprite is not cached, such as for images which change every frame.
+ * Safe to call from several drawing threads.
+ */
+const rct_g1_element* SpriteCacheGetMinified(
+    uint32_t imageIndex, const rct_g1_element& source, int32_t zoom, int32_t phaseX, int32_t phaseY);
+
+void SpriteCacheInvalidateImage(uint32_t imageIndex);
+void SpriteCacheInvalidateAll();
+
+/**
+ * Frees the sprites evicted since the last call and advances the clock used to find the least recently used sprites.
+ * Must only be called while nothing is drawing.
+ */
+void SpriteCacheCollect();
+
+SpriteCacheStats SpriteCacheGetStats();
+void SpriteCacheResetStats();
@@ -123,7 +123,6 @@ void X8WeatherDrawer::Restore()
 
 X8DrawingEngine::X8DrawingEngine([[maybe_unused]] const std::shared_ptr<Ui::IUiContext>& uiContext)
 {
-    _drawingContext = new X8DrawingContext(this);
     _bitsDPI.DrawingEngine = this;
 #ifdef __ENABLE_LIGHTFX__
     lightfx_set_available(true);
@@ -133,7 +132,6 @@ X8DrawingEngine::X8DrawingEngine([[maybe_unused]] const std::shared_ptr<Ui::IUiC
 
 X8DrawingEngine::~X8DrawingEngine()
 {
-    delete _drawingContext;
     delete[] _dirtyGrid.Blocks;
     delete[] _bits;
 }
@@ -272,8 +270,11 @@ std::string X8DrawingEngine::Screenshot()
 
 IDrawingContext* X8DrawingEngine::GetDrawingContext(rct_drawpixelinfo* dpi)
 {
-    _drawingContext->SetDPI(dpi);
-    return _drawingContext;
+    // The context holds the DPI being drawn to, every thread has its own so viewport columns can be drawn at once.
+    thread_local X8DrawingContext drawingContext(nullptr);
+    drawingContext.SetEngine(this);
+    drawingContext.SetDPI(dpi);
+    return &drawingContext;
 }
 
 rct_drawpixelinfo* X8DrawingEngine::GetDrawingPixelInfo()
@@ -283,7 +284,7 @@ rct_drawpixelinfo* X8DrawingEngine::GetDrawingPixelInfo()
 
 DRAWING_ENGINE_FLAGS X8DrawingEngine::GetFlags()
 {
-    return DEF_DIRTY_OPTIMISATIONS;
+    return static_cast<DRAWING_ENGINE_FLAGS>(DEF_DIRTY_OPTIMISATIONS | DEF_PARALLEL_DRAWING);
 }
 
 void X8DrawingEngine::InvalidateImage([[maybe_unused]] uint32_t image)
@@ -752,6 +753,11 @@ void X8DrawingContext::DrawGlyph(uint32_t image, int32_t x, int32_t y, const Pal
     gfx_draw_sprite_palette_set_software(_dpi, ImageId::FromUInt32(image), { x, y }, paletteMap);
 }
 
+void X8DrawingContext::SetEngine(X8DrawingEngine* engine)
+{
+    _engine = engine;
+}
+
 void X8DrawingContext::SetDPI(rct_drawpixelinfo* dpi)
 {
     _dpi = dpi;
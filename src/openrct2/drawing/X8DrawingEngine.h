@@ -83,7 +83,6 @@ namespace OpenRCT2
 #endif
 
             X8WeatherDrawer _weatherDrawer;
-            X8DrawingContext* _drawingContext;
 
         public:
             explicit X8DrawingEngine(const std::shared_ptr<Ui::IUiContext>& uiContext);
@@ -151,6 +150,7 @@ namespace OpenRCT2
             void DrawSpriteSolid(uint32_t image, int32_t x, int32_t y, uint8_t colour) override;
             void DrawGlyph(uint32_t image, int32_t x, int32_t y, const PaletteMap& paletteMap) override;
 
+            void SetEngine(X8DrawingEngine* engine);
             void SetDPI(rct_drawpixelinfo* dpi);
         };
     } // namespace Drawing
@@ -47,6 +47,7 @@
 #include "../windows/Intent.h"
 #include "../world/Climate.h"
 #include "../world/EntityList.h"
+#include "../world/FootpathGraph.h"
 #include "../world/Park.h"
 #include "../world/Scenery.h"
 #include "../world/Sprite.h"
@@ -1235,10 +1236,20 @@ static int32_t cc_remove_park_fences(InteractiveConsole& console, [[maybe_unused
     return 0;
 }
 
+static int32_t cc_check_footpath_graph(InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
+{
+    auto errors = footpath_graph_check();
+    for (const auto& error : errors)
+    {
+        console.WriteLineError(error);
+    }
+    console.WriteFormatLine("Footpath graph checked, %zu difference(s) found.", errors.size());
+    return 0;
+}
+
 static int32_t cc_show_limits(InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
 {
-    map_reorganise_elements();
-    int32_t tileElementCount = gNextFreeTileElement - gTileElements - 1;
+    auto tileElementCount = map_get_tile_element_count();
 
     int32_t rideCount = ride_get_count();
     int32_t spriteCount = 0;
@@ -1260,7 +1271,7 @@ static int32_t cc_show_limits(InteractiveConsole& console, [[maybe_unused]] cons
     }
 
     console.WriteFormatLine("Sprites: %d/%d", spriteCount, MAX_ENTITIES);
-    console.WriteFormatLine("Map Elements: %d/%d", tileElementCount, MAX_TILE_ELEMENTS);
+    console.WriteFormatLine("Map Elements: %u/%u", tileElementCount, MAX_TILE_ELEMENTS);
     console.WriteFormatLine("Banners: %d/%zu", bannerCount, MAX_BANNERS);
     console.WriteFormatLine("Rides: %d/%d", rideCount, MAX_RIDES);
     console.WriteFormatLine("Staff: %d/%d", staffCount, STAFF_MAX_COUNT);
@@ -1770,6 +1781,7 @@ static constexpr const console_command console_command_table[] = {
     { "abort", cc_abort, "Calls std::abort(), for testing purposes only.", "abort" },
     { "add_news_item", cc_add_news_item, "Inserts a news item", "add_news_item [<type> <message> <assoc>]" },
     { "assert", cc_assert, "Triggers assertion failure, for testing purposes only", "assert" },
+    { "check_footpath_graph", cc_check_footpath_graph, "Compares the footpath graph with the paths on the map.", "check_footpath_graph" },
     { "clear", cc_clear, "Clears the console.", "clear" },
     { "close", cc_close, "Closes the console.", "close" },
     { "date", cc_for_date, "Sets the date to a given date.", "Format <year>[ <month>[ <day>]]." },
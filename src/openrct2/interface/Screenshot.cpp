@@ -16,11 +16,16 @@
 #include "../OpenRCT2.h"
 #include "../actions/SetCheatAction.h"
 #include "../audio/audio.h"
+#include "../config/Config.h"
 #include "../core/Console.hpp"
 #include "../core/Imaging.h"
+#include "../core/String.hpp"
 #include "../drawing/Drawing.h"
+#include "../drawing/SpriteCache.h"
 #include "../drawing/X8DrawingEngine.h"
 #include "../localisation/Localisation.h"
+#include "../paint/PaintTileCache.h"
+#include "../paint/Painter.h"
 #include "../platform/Platform2.h"
 #include "../util/Util.h"
 #include "../world/Climate.h"
@@ -29,12 +34,17 @@
 #include "../world/Surface.h"
 #include "Viewport.h"
 
+#include <algorithm>
 #include <cctype>
 #include <chrono>
 #include <cstdlib>
+#include <future>
+#include <iostream>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <vector>
 
 using namespace std::literals::string_literals;
 using namespace OpenRCT2;
@@ -378,6 +388,82 @@ static void RenderViewport(IDrawingEngine* drawingEngine, const rct_viewport& vi
     viewport_render(&dpi, &viewport, 0, 0, viewport.width, viewport.height);
 }
 
+/**
+ * Renders a viewport in horizontal bands of bandHeight rows and streams every band into the PNG encoder as soon as it is
+ * drawn, so at most two bands are held in memory however large the image is. Each band is painted and drawn in parallel
+ * 32 pixel columns while the previous band is being encoded.
+ */
+static void RenderViewportTiled(const rct_viewport& viewport, int32_t bandHeight, std::string_view path)
+{
+    // Keep bands a multiple of 32 rows so every band starts on a whole pixel, even when magnified.
+    bandHeight = std::max(32, floor2(bandHeight, 32));
+
+    // Columns are only painted on the workers when multithreading is enabled.
+    auto savedMultithreading = gConfigGeneral.multithreading;
+    auto savedViewportDrawing = gConfigGeneral.multithreading_viewport_drawing;
+    gConfigGeneral.multithreading = true;
+    gConfigGeneral.multithreading_viewport_drawing = true;
+    try
+    {
+        auto drawingEngine = std::make_unique<X8DrawingEngine>(GetContext()->GetUiContext());
+        Imaging::PngRowWriter writer(path, viewport.width, viewport.height, gPalette);
+
+        const auto width = static_cast<size_t>(viewport.width);
+        std::vector<uint8_t> bands[2];
+        for (auto& band : bands)
+        {
+            band.resize(width * bandHeight);
+        }
+
+        std::future<void> encoding;
+        for (int32_t top = 0, bandIndex = 0; top < viewport.height; top += bandHeight, bandIndex++)
+        {
+            const auto rows = std::min(bandHeight, viewport.height - top);
+            auto& band = bands[bandIndex & 1];
+            if (viewport.flags & VIEWPORT_FLAG_TRANSPARENT_BACKGROUND)
+            {
+                std::memset(band.data(), PALETTE_INDEX_0, band.size());
+            }
+
+            rct_viewport bandViewport = viewport;
+            bandViewport.viewPos.y += top * viewport.zoom;
+            bandViewport.height = rows;
+            bandViewport.view_height = rows * viewport.zoom;
+
+            rct_drawpixelinfo dpi{};
+            dpi.bits = band.data();
+            dpi.width = viewport.width;
+            dpi.height = rows;
+            RenderViewport(drawingEngine.get(), bandViewport, dpi);
+
+            // The next band is drawn into the buffer the previous one is being encoded from.
+            if (encoding.valid())
+            {
+                encoding.get();
+            }
+            encoding = std::async(std::launch::async, [&writer, &band, width, rows]() {
+                for (int32_t y = 0; y < rows; y++)
+                {
+                    writer.WriteRow(band.data() + y * width);
+                }
+            });
+        }
+        if (encoding.valid())
+        {
+            encoding.get();
+        }
+        writer.Finish();
+    }
+    catch (const std::exception&)
+    {
+        gConfigGeneral.multithreading = savedMultithreading;
+        gConfigGeneral.multithreading_viewport_drawing = savedViewportDrawing;
+        throw;
+    }
+    gConfigGeneral.multithreading = savedMultithreading;
+    gConfigGeneral.multithreading_viewport_drawing = savedViewportDrawing;
+}
+
 void screenshot_giant()
 {
     rct_drawpixelinfo dpi{};
@@ -466,52 +552,100 @@ static void benchgfx_render_screenshots(const char* inputPath, std::unique_ptr<I
     }
 
     const uint32_t totalRenderCount = iterationCount * MAX_ROTATIONS * MAX_ZOOM_LEVEL;
+    auto painter = context->GetPainter();
 
-    try
-    {
-        double totalTime = 0.0;
-
-        std::array<double, MAX_ZOOM_LEVEL> zoomAverages;
-
-        // Render at every zoom.
+    // Renders every viewport N times and returns the average time per render for each zoom level.
+    auto renderAll = [&](uint32_t count) {
+        std::array<double, MAX_ZOOM_LEVEL> zoomAverages{};
         for (int32_t zoom = 0; zoom < MAX_ZOOM_LEVEL; zoom++)
         {
             double zoomLevelTime = 0.0;
-
-            // Render at every rotation.
             for (int32_t rotation = 0; rotation < MAX_ROTATIONS; rotation++)
             {
-                // N iterations.
-                for (uint32_t i = 0; i < iterationCount; i++)
+                for (uint32_t i = 0; i < count; i++)
                 {
                     auto& dpi = dpis[zoom * MAX_ZOOM_LEVEL + rotation];
                     auto& viewport = viewports[zoom * MAX_ZOOM_LEVEL + rotation];
-                    double elapsed = MeasureFunctionTime([&viewport, &dpi]() { RenderViewport(nullptr, viewport, dpi); });
-                    totalTime += elapsed;
-                    zoomLevelTime += elapsed;
+                    zoomLevelTime += MeasureFunctionTime([&viewport, &dpi]() { RenderViewport(nullptr, viewport, dpi); });
                 }
             }
-
-            zoomAverages[zoom] = zoomLevelTime / static_cast<double>(MAX_ROTATIONS * iterationCount);
+            zoomAverages[zoom] = zoomLevelTime / static_cast<double>(MAX_ROTATIONS * count);
+        }
+        return zoomAverages;
+    };
+    auto printAverages = [](const char* name, const std::array<double, MAX_ZOOM_LEVEL>& zoomAverages) {
+        double average = 0.0;
+        for (int32_t zoom = 0; zoom < MAX_ZOOM_LEVEL; zoom++)
+        {
+            const auto zoomAverage = zoomAverages[zoom];
+            std::printf("%sZoom[%d] average: %.06fs, %.f FPS\n", name, zoom, zoomAverage, 1.0 / zoomAverage);
+            average += zoomAverage / MAX_ZOOM_LEVEL;
         }
+        std::printf("%sTotal average: %.06fs, %.f FPS\n", name, average, 1.0 / average);
+        return average;
+    };
+
+    const bool paintTileCache = gConfigGeneral.paint_tile_cache;
+    const bool zoomedSpriteCache = gConfigGeneral.zoomed_sprite_cache;
+    try
+    {
+        gConfigGeneral.paint_tile_cache = false;
+        gConfigGeneral.zoomed_sprite_cache = false;
+        painter->ResetStats();
+        const auto zoomAverages = renderAll(iterationCount);
+        const auto paintStats = painter->GetStats();
+
+        // The first render of each viewport only fills the tile paint cache, the timed ones replay it.
+        gConfigGeneral.paint_tile_cache = true;
+        PaintTileCacheInvalidateAll();
+        renderAll(1);
+        PaintTileCacheResetStats();
+        const auto cachedZoomAverages = renderAll(iterationCount);
+        const auto cacheStats = PaintTileCacheGetStats();
+
+        // Likewise for the zoomed sprite cache, with the tile paint cache off again to measure it alone.
+        gConfigGeneral.paint_tile_cache = false;
+        gConfigGeneral.zoomed_sprite_cache = true;
+        SpriteCacheInvalidateAll();
+        renderAll(1);
+        SpriteCacheResetStats();
+        const auto spriteCachedZoomAverages = renderAll(iterationCount);
+        const auto spriteCacheStats = SpriteCacheGetStats();
 
-        const double average = totalTime / static_cast<double>(totalRenderCount);
         const auto engineStringId = DrawingEngineStringIds[EnumValue(DrawingEngine::Software)];
         const auto engineName = format_string(engineStringId, nullptr);
         std::printf("Engine: %s\n", engineName.c_str());
         std::printf("Render Count: %u\n", totalRenderCount);
-        for (int32_t zoom = 0; zoom < MAX_ZOOM_LEVEL; zoom++)
-        {
-            const auto zoomAverage = zoomAverages[zoom];
-            std::printf("Zoom[%d] average: %.06fs, %.f FPS\n", zoom, zoomAverage, 1.0 / zoomAverage);
-        }
-        std::printf("Total average: %.06fs, %.f FPS\n", average, 1.0 / average);
-        std::printf("Time: %.05fs\n", totalTime);
+        const auto average = printAverages("", zoomAverages);
+        std::printf("Time: %.05fs\n", average * totalRenderCount);
+
+        std::printf("Paint entries per render: %.f\n", static_cast<double>(paintStats.Entries) / totalRenderCount);
+        std::printf("Paint entries peak per session: %zu\n", paintStats.PeakSessionEntries);
+        std::printf("Paint entry chunks allocated: %llu\n", static_cast<unsigned long long>(paintStats.ArenaGrowths));
+
+        const auto cachedAverage = printAverages("Tile cache: ", cachedZoomAverages);
+        const auto cachedTiles = cacheStats.Hits + cacheStats.Misses;
+        const auto paintedTiles = cachedTiles + cacheStats.Skipped;
+        std::printf(
+            "Tile cache: %.1f%% of tiles cacheable, %.1f%% hit rate\n",
+            paintedTiles == 0 ? 0.0 : 100.0 * cachedTiles / paintedTiles,
+            cachedTiles == 0 ? 0.0 : 100.0 * cacheStats.Hits / cachedTiles);
+        std::printf("Tile cache speedup: %.2fx\n", average / cachedAverage);
+
+        const auto spriteCachedAverage = printAverages("Sprite cache: ", spriteCachedZoomAverages);
+        const auto spriteLookups = spriteCacheStats.Hits + spriteCacheStats.Misses;
+        std::printf(
+            "Sprite cache: %.1f%% hit rate, %llu evictions\n",
+            spriteLookups == 0 ? 0.0 : 100.0 * spriteCacheStats.Hits / spriteLookups,
+            static_cast<unsigned long long>(spriteCacheStats.Evictions));
+        std::printf("Sprite cache speedup: %.2fx\n", average / spriteCachedAverage);
     }
     catch (const std::exception& e)
     {
         Console::Error::WriteLine("%s", e.what());
     }
+    gConfigGeneral.paint_tile_cache = paintTileCache;
+    gConfigGeneral.zoomed_sprite_cache = zoomedSpriteCache;
 
     for (auto& dpi : dpis)
         ReleaseDPI(dpi);
@@ -597,6 +731,120 @@ static void ApplyOptions(const ScreenshotOptions* options, rct_viewport& viewpor
     }
 }
 
+static bool IsGiantScreenshot(const char** argv, int32_t argc)
+{
+    return argc == 5 && _stricmp(argv[2], "giant") == 0;
+}
+
+static bool IsValidScreenshotArgs(const char** argv, int32_t argc)
+{
+    return argc == 4 || argc == 8 || IsGiantScreenshot(argv, argc);
+}
+
+// Works out the view for the screenshot arguments following <file> <output_image>, the park must already be loaded.
+static rct_viewport GetScreenshotViewport(const char** argv, int32_t argc)
+{
+    rct_viewport viewport{};
+    if (IsGiantScreenshot(argv, argc))
+    {
+        auto zoom = std::atoi(argv[3]);
+        auto rotation = std::atoi(argv[4]) & 3;
+        viewport = GetGiantViewport(gMapSize, rotation, zoom);
+        gCurrentRotation = rotation;
+        return viewport;
+    }
+
+    bool customLocation = false;
+    bool centreMapX = false;
+    bool centreMapY = false;
+    int32_t resolutionWidth = std::atoi(argv[2]);
+    int32_t resolutionHeight = std::atoi(argv[3]);
+    int32_t customX = 0;
+    int32_t customY = 0;
+    int32_t customZoom = 0;
+    int32_t customRotation = 0;
+    if (argc == 8)
+    {
+        customLocation = true;
+        if (argv[4][0] == 'c')
+            centreMapX = true;
+        else
+            customX = std::atoi(argv[4]);
+
+        if (argv[5][0] == 'c')
+            centreMapY = true;
+        else
+            customY = std::atoi(argv[5]);
+
+        customZoom = std::atoi(argv[6]);
+        customRotation = std::atoi(argv[7]) & 3;
+    }
+
+    int32_t mapSize = gMapSize;
+    if (resolutionWidth == 0 || resolutionHeight == 0)
+    {
+        resolutionWidth = (mapSize * 32 * 2) >> customZoom;
+        resolutionHeight = (mapSize * 32 * 1) >> customZoom;
+
+        resolutionWidth += 8;
+        resolutionHeight += 128;
+    }
+
+    viewport.width = resolutionWidth;
+    viewport.height = resolutionHeight;
+    viewport.view_width = viewport.width;
+    viewport.view_height = viewport.height;
+    if (customLocation)
+    {
+        if (centreMapX)
+            customX = (mapSize / 2) * 32 + 16;
+        if (centreMapY)
+            customY = (mapSize / 2) * 32 + 16;
+
+        int32_t z = tile_element_height({ customX, customY });
+        CoordsXYZ coords3d = { customX, customY, z };
+
+        auto coords2d = translate_3d_to_2d_with_z(customRotation, coords3d);
+
+        viewport.viewPos = { coords2d.x - ((viewport.view_width << customZoom) / 2),
+                             coords2d.y - ((viewport.view_height << customZoom) / 2) };
+        viewport.zoom = customZoom;
+        gCurrentRotation = customRotation;
+    }
+    else
+    {
+        viewport.viewPos = { gSavedView - ScreenCoordsXY{ (viewport.view_width / 2), (viewport.view_height / 2) } };
+        viewport.zoom = gSavedViewZoom;
+        gCurrentRotation = gSavedViewRotation;
+    }
+    return viewport;
+}
+
+static std::unique_ptr<IContext> CreateScreenshotContext()
+{
+    core_init();
+    gOpenRCT2Headless = true;
+    auto context = CreateContext();
+    if (!context->Initialise())
+    {
+        throw std::runtime_error("Failed to initialize context.");
+    }
+
+    drawing_engine_init();
+    return context;
+}
+
+static void LoadScreenshotPark(IContext& context, const char* inputPath)
+{
+    if (!context.LoadParkFromFile(inputPath))
+    {
+        throw std::runtime_error("Failed to load park.");
+    }
+
+    gIntroState = IntroState::None;
+    gScreenFlags = SCREEN_FLAGS_PLAYING;
+}
+
 int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOptions* options)
 {
     // Don't include options in the count (they have been handled by CommandLine::ParseOptions already)
@@ -610,8 +858,8 @@ int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOption
         }
     }
 
-    bool giantScreenshot = (argc == 5) && _stricmp(argv[2], "giant") == 0;
-    if (argc != 4 && argc != 8 && !giantScreenshot)
+    bool giantScreenshot = IsGiantScreenshot(argv, argc);
+    if (!IsValidScreenshotArgs(argv, argc))
     {
         std::printf("Usage: openrct2 screenshot <file> <output_image> <width> <height> [<x> <y> <zoom> <rotation>]\n");
         std::printf("Usage: openrct2 screenshot <file> <output_image> giant <zoom> <rotation>\n");
@@ -622,120 +870,248 @@ int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOption
     rct_drawpixelinfo dpi;
     try
     {
-        core_init();
-        bool customLocation = false;
-        bool centreMapX = false;
-        bool centreMapY = false;
-
         const char* inputPath = argv[0];
         const char* outputPath = argv[1];
 
-        gOpenRCT2Headless = true;
-        auto context = CreateContext();
-        if (!context->Initialise())
+        auto context = CreateScreenshotContext();
+        LoadScreenshotPark(*context, inputPath);
+
+        auto viewport = GetScreenshotViewport(argv, argc);
+        ApplyOptions(options, viewport);
+
+        if (giantScreenshot && options->tile_size > 0)
         {
-            throw std::runtime_error("Failed to initialize context.");
+            RenderViewportTiled(viewport, options->tile_size, outputPath);
         }
+        else
+        {
+            dpi = CreateDPI(viewport);
 
-        drawing_engine_init();
+            RenderViewport(nullptr, viewport, dpi);
+            WriteDpiToFile(outputPath, &dpi, gPalette);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::printf("%s\n", e.what());
+        exitCode = -1;
+    }
+    ReleaseDPI(dpi);
+
+    drawing_engine_dispose();
+
+    return exitCode;
+}
 
-        if (!context->LoadParkFromFile(inputPath))
+// Splits a job line on whitespace, double quotes keep paths with spaces together.
+static std::vector<std::string> SplitScreenshotJob(const std::string& line)
+{
+    std::vector<std::string> tokens;
+    std::string token;
+    bool quoted = false;
+    bool hasToken = false;
+    for (auto c : line)
+    {
+        if (c == '"')
+        {
+            quoted = !quoted;
+            hasToken = true;
+        }
+        else if (!quoted && std::isspace(static_cast<unsigned char>(c)))
         {
-            throw std::runtime_error("Failed to load park.");
+            if (hasToken)
+            {
+                tokens.push_back(std::move(token));
+                token.clear();
+                hasToken = false;
+            }
         }
+        else
+        {
+            token.push_back(c);
+            hasToken = true;
+        }
+    }
+    if (hasToken)
+    {
+        tokens.push_back(std::move(token));
+    }
+    return tokens;
+}
 
-        gIntroState = IntroState::None;
-        gScreenFlags = SCREEN_FLAGS_PLAYING;
+// Reads the options trailing a job, using the same names as the screenshot command.
+static ScreenshotOptions ParseScreenshotJobOptions(
+    const std::vector<std::string>& tokens, size_t first, const ScreenshotOptions& defaults)
+{
+    static const std::pair<const char*, bool ScreenshotOptions::*> switches[] = {
+        { "--no-peeps", &ScreenshotOptions::hide_guests },       { "--no-sprites", &ScreenshotOptions::hide_sprites },
+        { "--clear-grass", &ScreenshotOptions::clear_grass },    { "--mowed-grass", &ScreenshotOptions::mowed_grass },
+        { "--water-plants", &ScreenshotOptions::water_plants },  { "--fix-vandalism", &ScreenshotOptions::fix_vandalism },
+        { "--remove-litter", &ScreenshotOptions::remove_litter }, { "--tidy-up-park", &ScreenshotOptions::tidy_up_park },
+        { "--transparent", &ScreenshotOptions::transparent },
+    };
 
-        rct_viewport viewport{};
-        if (giantScreenshot)
+    auto options = defaults;
+    for (size_t i = first; i < tokens.size(); i++)
+    {
+        const auto& token = tokens[i];
+        auto sw = std::find_if(
+            std::begin(switches), std::end(switches), [&token](const auto& s) { return token == s.first; });
+        if (sw != std::end(switches))
         {
-            auto zoom = std::atoi(argv[3]);
-            auto rotation = std::atoi(argv[4]) & 3;
-            viewport = GetGiantViewport(gMapSize, rotation, zoom);
-            gCurrentRotation = rotation;
+            options.*(sw->second) = true;
+        }
+        else if ((token == "--weather" || token == "--tile-size") && i + 1 < tokens.size())
+        {
+            auto value = std::atoi(tokens[++i].c_str());
+            if (token == "--weather")
+                options.weather = static_cast<WeatherType>(value);
+            else
+                options.tile_size = value;
         }
         else
         {
-            int32_t resolutionWidth = std::atoi(argv[2]);
-            int32_t resolutionHeight = std::atoi(argv[3]);
-            int32_t customX = 0;
-            int32_t customY = 0;
-            int32_t customZoom = 0;
-            int32_t customRotation = 0;
-            if (argc == 8)
+            throw std::runtime_error("Unknown option " + token);
+        }
+    }
+    return options;
+}
+
+// Whether rendering with these options changed the loaded park, so it has to be loaded again for the next job.
+static bool ScreenshotOptionsModifyPark(const ScreenshotOptions& options)
+{
+    return (options.weather != WeatherType::Sunny && options.weather != WeatherType::Count) || options.mowed_grass
+        || options.clear_grass || options.water_plants || options.fix_vandalism || options.remove_litter
+        || options.tidy_up_park;
+}
+
+static double MillisecondsSince(std::chrono::high_resolution_clock::time_point startTime)
+{
+    const auto endTime = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(endTime - startTime).count();
+}
+
+int32_t cmdline_for_screenshot_server(const ScreenshotOptions* defaultOptions)
+{
+    std::unique_ptr<IContext> context;
+    try
+    {
+        context = CreateScreenshotContext();
+    }
+    catch (const std::exception& e)
+    {
+        std::printf("%s\n", e.what());
+        return -1;
+    }
+
+    // Jobs paint their columns on the workers, and are encoded on a separate thread while the next job renders.
+    gConfigGeneral.multithreading = true;
+    gConfigGeneral.multithreading_viewport_drawing = true;
+
+    std::mutex outputMutex;
+    auto respond = [&outputMutex](const std::string& response) {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        std::printf("%s\n", response.c_str());
+        std::fflush(stdout);
+    };
+
+    std::string loadedPark;
+    bool parkModified = false;
+    std::future<void> encoding;
+    std::string line;
+    while (std::getline(std::cin, line))
+    {
+        auto tokens = SplitScreenshotJob(line);
+        if (tokens.empty() || tokens[0][0] == '#')
+        {
+            continue;
+        }
+        if (tokens[0] == "quit")
+        {
+            break;
+        }
+
+        const auto startTime = std::chrono::high_resolution_clock::now();
+        try
+        {
+            std::vector<const char*> argv;
+            for (const auto& token : tokens)
             {
-                customLocation = true;
-                if (argv[4][0] == 'c')
-                    centreMapX = true;
-                else
-                    customX = std::atoi(argv[4]);
-
-                if (argv[5][0] == 'c')
-                    centreMapY = true;
-                else
-                    customY = std::atoi(argv[5]);
-
-                customZoom = std::atoi(argv[6]);
-                customRotation = std::atoi(argv[7]) & 3;
+                if (token[0] == '-')
+                    break;
+                argv.push_back(token.c_str());
             }
-
-            int32_t mapSize = gMapSize;
-            if (resolutionWidth == 0 || resolutionHeight == 0)
+            auto argc = static_cast<int32_t>(argv.size());
+            if (!IsValidScreenshotArgs(argv.data(), argc))
             {
-                resolutionWidth = (mapSize * 32 * 2) >> customZoom;
-                resolutionHeight = (mapSize * 32 * 1) >> customZoom;
-
-                resolutionWidth += 8;
-                resolutionHeight += 128;
+                throw std::runtime_error("Expected <file> <output_image> <width> <height> [<x> <y> <zoom> <rotation>] or "
+                                         "<file> <output_image> giant <zoom> <rotation>");
             }
+            auto options = ParseScreenshotJobOptions(tokens, argv.size(), *defaultOptions);
 
-            viewport.width = resolutionWidth;
-            viewport.height = resolutionHeight;
-            viewport.view_width = viewport.width;
-            viewport.view_height = viewport.height;
-            if (customLocation)
+            // Parks are only loaded again when the path changes, objects shared with the previous park stay loaded.
+            if (loadedPark != argv[0] || parkModified)
             {
-                if (centreMapX)
-                    customX = (mapSize / 2) * 32 + 16;
-                if (centreMapY)
-                    customY = (mapSize / 2) * 32 + 16;
+                loadedPark.clear();
+                LoadScreenshotPark(*context, argv[0]);
+                loadedPark = argv[0];
+            }
+            parkModified = ScreenshotOptionsModifyPark(options);
 
-                int32_t z = tile_element_height({ customX, customY });
-                CoordsXYZ coords3d = { customX, customY, z };
+            auto viewport = GetScreenshotViewport(argv.data(), argc);
+            ApplyOptions(&options, viewport);
 
-                auto coords2d = translate_3d_to_2d_with_z(customRotation, coords3d);
+            std::string outputPath = argv[1];
+            if (IsGiantScreenshot(argv.data(), argc) && options.tile_size > 0)
+            {
+                if (encoding.valid())
+                {
+                    encoding.get();
+                }
+                RenderViewportTiled(viewport, options.tile_size, outputPath);
+                respond(String::StdFormat("ok %s %.1f", outputPath.c_str(), MillisecondsSince(startTime)));
+                continue;
+            }
 
-                viewport.viewPos = { coords2d.x - ((viewport.view_width << customZoom) / 2),
-                                     coords2d.y - ((viewport.view_height << customZoom) / 2) };
-                viewport.zoom = customZoom;
-                gCurrentRotation = customRotation;
+            auto dpi = CreateDPI(viewport);
+            try
+            {
+                RenderViewport(nullptr, viewport, dpi);
             }
-            else
+            catch (const std::exception&)
             {
-                viewport.viewPos = { gSavedView - ScreenCoordsXY{ (viewport.view_width / 2), (viewport.view_height / 2) } };
-                viewport.zoom = gSavedViewZoom;
-                gCurrentRotation = gSavedViewRotation;
+                ReleaseDPI(dpi);
+                throw;
             }
-        }
-
-        ApplyOptions(options, viewport);
-
-        dpi = CreateDPI(viewport);
 
-        RenderViewport(nullptr, viewport, dpi);
-        WriteDpiToFile(outputPath, &dpi, gPalette);
+            // Only one image waits for encoding at a time, which bounds the memory held by finished renders.
+            if (encoding.valid())
+            {
+                encoding.get();
+            }
+            encoding = std::async(
+                std::launch::async, [dpi, palette = gPalette, outputPath, startTime, &respond]() mutable {
+                    auto written = WriteDpiToFile(outputPath, &dpi, palette);
+                    ReleaseDPI(dpi);
+                    if (written)
+                        respond(String::StdFormat("ok %s %.1f", outputPath.c_str(), MillisecondsSince(startTime)));
+                    else
+                        respond(String::StdFormat("error %s Unable to write png", outputPath.c_str()));
+                });
+        }
+        catch (const std::exception& e)
+        {
+            respond(String::StdFormat("error %s %s", (tokens.size() > 1 ? tokens[1] : tokens[0]).c_str(), e.what()));
+        }
     }
-    catch (const std::exception& e)
+    if (encoding.valid())
     {
-        std::printf("%s\n", e.what());
-        exitCode = -1;
+        encoding.get();
     }
-    ReleaseDPI(dpi);
 
+    context = nullptr;
     drawing_engine_dispose();
-
-    return exitCode;
+    return 0;
 }
 
 static bool IsPathChildOf(fs::path x, const fs::path& parent)
@@ -34,6 +34,7 @@ struct ScreenshotOptions
     bool remove_litter = false;
     bool tidy_up_park = false;
     bool transparent = false;
+    int32_t tile_size = 0;
 };
 
 struct CaptureView
@@ -59,6 +60,14 @@ std::string screenshot_dump_png_32bpp(int32_t width, int32_t height, const void*
 
 void screenshot_giant();
 int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOptions* options);
+
+/**
+ * Initialises once, then renders a screenshot for every line read from stdin until it closes or reads "quit". Lines take
+ * the arguments of the screenshot command, followed by its options. Every job is answered with "ok <output_image> <ms>"
+ * or "error <output_image> <reason>", not necessarily in the order the jobs were given.
+ */
+int32_t cmdline_for_screenshot_server(const ScreenshotOptions* defaultOptions);
+
 int32_t cmdline_for_gfxbench(const char** argv, int32_t argc);
 
 void CaptureImage(const CaptureOptions& options);
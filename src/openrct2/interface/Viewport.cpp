@@ -15,9 +15,10 @@
 #include "../OpenRCT2.h"
 #include "../config/Config.h"
 #include "../core/Guard.hpp"
-#include "../core/JobPool.h"
+#include "../core/TaskScheduler.h"
 #include "../drawing/Drawing.h"
 #include "../drawing/IDrawingEngine.h"
+#include "../drawing/SpriteCache.h"
 #include "../paint/Paint.h"
 #include "../peep/Staff.h"
 #include "../ride/Ride.h"
@@ -46,7 +47,6 @@ uint8_t gShowConstuctionRightsRefCount;
 static std::list<rct_viewport> _viewports;
 rct_viewport* g_music_tracking_viewport;
 
-static std::unique_ptr<JobPool> _paintJobs;
 static std::vector<paint_session*> _paintColumns;
 
 ScreenCoordsXY gSavedView;
@@ -856,16 +856,17 @@ static void record_session(const paint_session* session, std::vector<paint_sessi
     paint_session* session_copy = &recorded_sessions->at(record_index);
 
     // Mind the offset needs to be calculated against the original `session`, not `session_copy`
+    auto indexOf = [session](const paint_struct* ps) {
+        return session->PaintStructs.IndexOf(reinterpret_cast<const paint_entry*>(ps));
+    };
     for (auto& ps : session_copy->PaintStructs)
     {
         ps.basic.next_quadrant_ps = reinterpret_cast<paint_struct*>(
-            ps.basic.next_quadrant_ps ? int(ps.basic.next_quadrant_ps - &session->PaintStructs[0].basic)
-                                      : std::size(session->PaintStructs));
+            ps.basic.next_quadrant_ps ? indexOf(ps.basic.next_quadrant_ps) : std::size(session->PaintStructs));
     }
     for (auto& quad : session_copy->Quadrants)
     {
-        quad = reinterpret_cast<paint_struct*>(
-            quad ? int(quad - &session->PaintStructs[0].basic) : std::size(session->Quadrants));
+        quad = reinterpret_cast<paint_struct*>(quad ? indexOf(quad) : std::size(session->Quadrants));
     }
 }
 
@@ -906,8 +907,6 @@ static void viewport_paint_column(paint_session* session)
     {
         PaintDrawMoneyStructs(&session->DPI, session->PSStringHead);
     }
-
-    PaintSessionFree(session);
 }
 
 /**
@@ -964,13 +963,14 @@ void viewport_paint(
     _paintColumns.clear();
 
     bool useMultithreading = gConfigGeneral.multithreading;
-    if (useMultithreading && _paintJobs == nullptr)
-    {
-        _paintJobs = std::make_unique<JobPool>();
-    }
-    else if (useMultithreading == false && _paintJobs != nullptr)
+    // Columns draw to separate 32 pixel strips of the DPI, so they can be drawn on the workers as well when the
+    // drawing engine allows it.
+    bool useParallelDrawing = useMultithreading && gConfigGeneral.multithreading_viewport_drawing
+        && dpi->DrawingEngine != nullptr && (dpi->DrawingEngine->GetFlags() & DEF_PARALLEL_DRAWING);
+    std::optional<TaskGroup> paintJobs;
+    if (useMultithreading)
     {
-        _paintJobs.reset();
+        paintJobs.emplace();
     }
 
     // Create space to record sessions and keep track which index is being drawn
@@ -1009,7 +1009,7 @@ void viewport_paint(
 
         if (useMultithreading)
         {
-            _paintJobs->AddTask(
+            paintJobs->Run(
                 [session, recorded_sessions, index]() -> void { viewport_fill_column(session, recorded_sessions, index); });
         }
         else
@@ -1020,12 +1020,32 @@ void viewport_paint(
 
     if (useMultithreading)
     {
-        _paintJobs->Join();
+        paintJobs->Wait();
     }
 
+    // All columns are generated before any is drawn, generating can replace the scrolling text images others use.
+    if (useParallelDrawing)
+    {
+        for (auto column : _paintColumns)
+        {
+            paintJobs->Run([column]() -> void { viewport_paint_column(column); });
+        }
+        paintJobs->Wait();
+    }
+    else
+    {
+        for (auto column : _paintColumns)
+        {
+            viewport_paint_column(column);
+        }
+    }
+
+    // Nothing is drawing now, so sprites evicted from the sprite cache can be freed
+    SpriteCacheCollect();
+
     for (auto column : _paintColumns)
     {
-        viewport_paint_column(column);
+        PaintSessionFree(column);
     }
 }
 
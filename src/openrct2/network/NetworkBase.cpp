@@ -714,6 +714,8 @@ const char* NetworkBase::FormatChat(NetworkPlayer* fromplayer, const char* text)
 
 void NetworkBase::SendPacketToClients(const NetworkPacket& packet, bool front, bool gameCmd)
 {
+    // Every client sends from the same buffer, which is only created if there is a client to send to.
+    NetworkSendBufferPtr buffer;
     for (auto& client_connection : client_connection_list)
     {
         if (client_connection->IsDisconnected)
@@ -733,8 +735,11 @@ void NetworkBase::SendPacketToClients(const NetworkPacket& packet, bool front, b
                 continue;
             }
         }
-        auto packetCopy = packet;
-        client_connection->QueuePacket(std::move(packetCopy), front);
+        if (buffer == nullptr)
+        {
+            buffer = packet.CreateSendBuffer();
+        }
+        client_connection->QueuePacket(buffer, front);
     }
 }
 
@@ -1458,12 +1463,13 @@ void NetworkBase::Server_Send_CHAT(const char* text, const std::vector<uint8_t>&
     }
     else
     {
+        auto buffer = packet.CreateSendBuffer();
         for (auto playerId : playerIds)
         {
             auto conn = GetPlayerConnection(playerId);
             if (conn != nullptr && !conn->IsDisconnected)
             {
-                conn->QueuePacket(packet);
+                conn->QueuePacket(buffer);
             }
         }
     }
@@ -2768,7 +2774,6 @@ bool NetworkBase::LoadMap(IStream* stream)
 bool NetworkBase::SaveMap(IStream* stream, const std::vector<const ObjectRepositoryItem*>& objects) const
 {
     bool result = false;
-    map_reorganise_elements();
     viewport_set_saved_view();
     try
     {
@@ -17,6 +17,8 @@
 #    include "Socket.h"
 #    include "network.h"
 
+#    include <array>
+
 constexpr size_t NETWORK_DISCONNECT_REASON_BUFFER_SIZE = 256;
 constexpr size_t NetworkBufferSize = 1024 * 64; // 64 KiB, maximum packet size.
 
@@ -89,7 +91,7 @@ NetworkReadPacket NetworkConnection::ReadPacket()
             // Received complete packet.
             _lastPacketTime = platform_get_ticks();
 
-            RecordPacketStats(InboundPacket, false);
+            RecordPacketStats(InboundPacket.GetCommand(), InboundPacket.BytesTransferred, false);
 
             return NetworkReadPacket::Success;
         }
@@ -98,42 +100,18 @@ NetworkReadPacket NetworkConnection::ReadPacket()
     return NetworkReadPacket::MoreData;
 }
 
-bool NetworkConnection::SendPacket(NetworkPacket& packet)
+void NetworkConnection::QueuePacket(const NetworkPacket& packet, bool front)
 {
-    auto header = packet.Header;
-
-    std::vector<uint8_t> buffer;
-    buffer.reserve(sizeof(header) + header.Size);
-
-    // NOTE: For compatibility reasons for the master server we need to add sizeof(Header.Id) to the size.
-    // Previously the Id field was not part of the header rather part of the body.
-    header.Size += sizeof(header.Id);
-    header.Size = Convert::HostToNetwork(header.Size);
-    header.Id = ByteSwapBE(header.Id);
-
-    buffer.insert(buffer.end(), reinterpret_cast<uint8_t*>(&header), reinterpret_cast<uint8_t*>(&header) + sizeof(header));
-    buffer.insert(buffer.end(), packet.Data.begin(), packet.Data.end());
-
-    size_t bufferSize = buffer.size() - packet.BytesTransferred;
-    size_t sent = Socket->SendData(buffer.data() + packet.BytesTransferred, bufferSize);
-    if (sent > 0)
-    {
-        packet.BytesTransferred += sent;
-    }
-
-    bool sendComplete = packet.BytesTransferred == buffer.size();
-    if (sendComplete)
+    if (AuthStatus == NetworkAuth::Ok || !packet.CommandRequiresAuth())
     {
-        RecordPacketStats(packet, true);
+        QueuePacket(packet.CreateSendBuffer(), front);
     }
-    return sendComplete;
 }
 
-void NetworkConnection::QueuePacket(NetworkPacket&& packet, bool front)
+void NetworkConnection::QueuePacket(const NetworkSendBufferPtr& buffer, bool front)
 {
-    if (AuthStatus == NetworkAuth::Ok || !packet.CommandRequiresAuth())
+    if (AuthStatus == NetworkAuth::Ok || !NetworkPacket::CommandRequiresAuth(buffer->Command))
     {
-        packet.Header.Size = static_cast<uint16_t>(packet.Data.size());
         if (front)
         {
             // If the first packet was already partially sent add new packet to second position
@@ -141,25 +119,60 @@ void NetworkConnection::QueuePacket(NetworkPacket&& packet, bool front)
             {
                 auto it = _outboundPackets.begin();
                 it++; // Second position
-                _outboundPackets.insert(it, std::move(packet));
+                _outboundPackets.insert(it, { buffer, 0 });
             }
             else
             {
-                _outboundPackets.push_front(std::move(packet));
+                _outboundPackets.push_front({ buffer, 0 });
             }
         }
         else
         {
-            _outboundPackets.push_back(std::move(packet));
+            _outboundPackets.push_back({ buffer, 0 });
         }
     }
 }
 
 void NetworkConnection::SendQueuedPackets()
 {
-    while (!_outboundPackets.empty() && SendPacket(_outboundPackets.front()))
+    // Packets queued in one tick are handed to the socket together, as many as fit in one gathered send.
+    constexpr size_t MaxPacketsPerSend = 64;
+    while (!_outboundPackets.empty())
     {
-        _outboundPackets.pop_front();
+        std::array<SocketBuffer, MaxPacketsPerSend> buffers;
+        size_t numBuffers = 0;
+        size_t bufferedSize = 0;
+        for (const auto& packet : _outboundPackets)
+        {
+            if (numBuffers == buffers.size())
+                break;
+            const auto& bytes = packet.Buffer->Bytes;
+            buffers[numBuffers++] = { bytes.data() + packet.BytesTransferred, bytes.size() - packet.BytesTransferred };
+            bufferedSize += bytes.size() - packet.BytesTransferred;
+        }
+
+        const size_t sent = Socket->SendData(buffers.data(), numBuffers);
+        size_t unaccounted = sent;
+        while (!_outboundPackets.empty())
+        {
+            auto& packet = _outboundPackets.front();
+            const auto packetSize = packet.Buffer->Bytes.size();
+            const auto remaining = packetSize - packet.BytesTransferred;
+            if (unaccounted < remaining)
+            {
+                packet.BytesTransferred += unaccounted;
+                break;
+            }
+            unaccounted -= remaining;
+            RecordPacketStats(packet.Buffer->Command, packetSize, true);
+            _outboundPackets.pop_front();
+        }
+
+        if (sent < bufferedSize)
+        {
+            // The socket is full, try again next tick
+            break;
+        }
     }
 }
 
@@ -207,12 +220,12 @@ void NetworkConnection::SetLastDisconnectReason(const rct_string_id string_id, v
     SetLastDisconnectReason(buffer);
 }
 
-void NetworkConnection::RecordPacketStats(const NetworkPacket& packet, bool sending)
+void NetworkConnection::RecordPacketStats(NetworkCommand command, size_t size, bool sending)
 {
-    uint32_t packetSize = static_cast<uint32_t>(packet.BytesTransferred);
+    uint32_t packetSize = static_cast<uint32_t>(size);
     NetworkStatisticsGroup trafficGroup;
 
-    switch (packet.GetCommand())
+    switch (command)
     {
         case NetworkCommand::GameAction:
             trafficGroup = NetworkStatisticsGroup::Commands;
@@ -41,12 +41,9 @@ public:
     ~NetworkConnection();
 
     NetworkReadPacket ReadPacket();
-    void QueuePacket(NetworkPacket&& packet, bool front = false);
-    void QueuePacket(const NetworkPacket& packet, bool front = false)
-    {
-        auto copy = packet;
-        return QueuePacket(std::move(copy), front);
-    }
+    void QueuePacket(const NetworkPacket& packet, bool front = false);
+    // Queues a packet whose buffer may also be queued on other connections.
+    void QueuePacket(const NetworkSendBufferPtr& buffer, bool front = false);
 
     void SendQueuedPackets();
     void ResetLastPacketTime();
@@ -57,12 +54,17 @@ public:
     void SetLastDisconnectReason(const rct_string_id string_id, void* args = nullptr);
 
 private:
-    std::deque<NetworkPacket> _outboundPackets;
+    struct OutboundPacket
+    {
+        NetworkSendBufferPtr Buffer;
+        size_t BytesTransferred = 0;
+    };
+
+    std::deque<OutboundPacket> _outboundPackets;
     uint32_t _lastPacketTime = 0;
     utf8* _lastDisconnectReason = nullptr;
 
-    void RecordPacketStats(const NetworkPacket& packet, bool sending);
-    bool SendPacket(NetworkPacket& packet);
+    void RecordPacketStats(NetworkCommand command, size_t size, bool sending);
 };
 
 #endif // DISABLE_NETWORK
@@ -12,6 +12,7 @@
 #    include "NetworkPacket.h"
 
 #    include "NetworkTypes.h"
+#    include "Socket.h"
 
 #    include <memory>
 
@@ -42,9 +43,14 @@ void NetworkPacket::Clear()
     Data.clear();
 }
 
-bool NetworkPacket::CommandRequiresAuth()
+bool NetworkPacket::CommandRequiresAuth() const
 {
-    switch (GetCommand())
+    return CommandRequiresAuth(GetCommand());
+}
+
+bool NetworkPacket::CommandRequiresAuth(NetworkCommand command)
+{
+    switch (command)
     {
         case NetworkCommand::Ping:
         case NetworkCommand::Auth:
@@ -60,6 +66,25 @@ bool NetworkPacket::CommandRequiresAuth()
     }
 }
 
+NetworkSendBufferPtr NetworkPacket::CreateSendBuffer() const
+{
+    auto buffer = std::make_shared<NetworkSendBuffer>();
+    buffer->Command = GetCommand();
+
+    // NOTE: For compatibility reasons for the master server we need to add sizeof(Header.Id) to the size.
+    // Previously the Id field was not part of the header rather part of the body.
+    PacketHeader header;
+    header.Size = Convert::HostToNetwork(static_cast<uint16_t>(Data.size() + sizeof(header.Id)));
+    header.Id = ByteSwapBE(GetCommand());
+
+    auto& bytes = buffer->Bytes;
+    bytes.reserve(sizeof(header) + Data.size());
+    const auto* headerBytes = reinterpret_cast<const uint8_t*>(&header);
+    bytes.insert(bytes.end(), headerBytes, headerBytes + sizeof(header));
+    bytes.insert(bytes.end(), Data.begin(), Data.end());
+    return buffer;
+}
+
 void NetworkPacket::Write(const void* bytes, size_t size)
 {
     const uint8_t* src = reinterpret_cast<const uint8_t*>(bytes);
@@ -25,6 +25,17 @@ struct PacketHeader
 static_assert(sizeof(PacketHeader) == 6);
 #pragma pack(pop)
 
+/**
+ * A packet's header and payload laid out as they are sent. Immutable, so the connections a packet is sent to can share
+ * one buffer and only keep their own progress.
+ */
+struct NetworkSendBuffer
+{
+    NetworkCommand Command = NetworkCommand::Invalid;
+    std::vector<uint8_t> Bytes;
+};
+using NetworkSendBufferPtr = std::shared_ptr<const NetworkSendBuffer>;
+
 struct NetworkPacket final
 {
     NetworkPacket() = default;
@@ -36,7 +47,10 @@ struct NetworkPacket final
     NetworkCommand GetCommand() const;
 
     void Clear();
-    bool CommandRequiresAuth();
+    bool CommandRequiresAuth() const;
+    static bool CommandRequiresAuth(NetworkCommand command);
+
+    NetworkSendBufferPtr CreateSendBuffer() const;
 
     const uint8_t* Read(size_t size);
     const utf8* ReadString();
@@ -51,6 +51,7 @@
     #include <netinet/tcp.h>
     #include <sys/ioctl.h>
     #include <sys/socket.h>
+    #include <sys/uio.h>
     #include "../common.h"
     using SOCKET = int32_t;
     #define SOCKET_ERROR -1
@@ -565,6 +566,81 @@ public:
         return totalSent;
     }
 
+    size_t SendData(const SocketBuffer* buffers, size_t count) override
+    {
+        if (_status != SocketStatus::Connected)
+        {
+            throw std::runtime_error("Socket not connected.");
+        }
+
+        // Gathers up to this many buffers for each call, more than any platform needs to fill its send buffer.
+        constexpr size_t MaxBuffersPerCall = 64;
+#    ifdef _WIN32
+        WSABUF platformBuffers[MaxBuffersPerCall];
+#    else
+        iovec platformBuffers[MaxBuffersPerCall];
+#    endif
+
+        size_t totalSent = 0;
+        size_t first = 0;
+        size_t firstOffset = 0;
+        while (first < count)
+        {
+            size_t numBuffers = 0;
+            for (size_t i = first; i < count && numBuffers < MaxBuffersPerCall; i++)
+            {
+                const size_t offset = i == first ? firstOffset : 0;
+                if (buffers[i].Size == offset)
+                {
+                    continue;
+                }
+                const auto* data = static_cast<const char*>(buffers[i].Data) + offset;
+#    ifdef _WIN32
+                platformBuffers[numBuffers].buf = const_cast<char*>(data);
+                platformBuffers[numBuffers].len = static_cast<ULONG>(buffers[i].Size - offset);
+#    else
+                platformBuffers[numBuffers].iov_base = const_cast<char*>(data);
+                platformBuffers[numBuffers].iov_len = buffers[i].Size - offset;
+#    endif
+                numBuffers++;
+            }
+            if (numBuffers == 0)
+            {
+                break;
+            }
+
+#    ifdef _WIN32
+            DWORD sentBytes = 0;
+            if (WSASend(_socket, platformBuffers, static_cast<DWORD>(numBuffers), &sentBytes, 0, nullptr, nullptr)
+                == SOCKET_ERROR)
+            {
+                return totalSent;
+            }
+#    else
+            msghdr message{};
+            message.msg_iov = platformBuffers;
+            message.msg_iovlen = numBuffers;
+            auto sentBytes = sendmsg(_socket, &message, FLAG_NO_PIPE);
+            if (sentBytes == SOCKET_ERROR)
+            {
+                return totalSent;
+            }
+#    endif
+            totalSent += static_cast<size_t>(sentBytes);
+
+            // Move past what was sent, which may end part way into a buffer
+            auto remaining = static_cast<size_t>(sentBytes);
+            while (first < count && remaining >= buffers[first].Size - firstOffset)
+            {
+                remaining -= buffers[first].Size - firstOffset;
+                first++;
+                firstOffset = 0;
+            }
+            firstOffset += remaining;
+        }
+        return totalSent;
+    }
+
     NetworkReadPacket ReceiveData(void* buffer, size_t size, size_t* sizeReceived) override
     {
         if (_status != SocketStatus::Connected)
@@ -45,6 +45,12 @@ struct INetworkEndpoint
     virtual std::string GetHostname() const abstract;
 };
 
+struct SocketBuffer
+{
+    const void* Data;
+    size_t Size;
+};
+
 /**
  * Represents a TCP socket / connection or listener.
  */
@@ -66,6 +72,8 @@ public:
     virtual void ConnectAsync(const std::string& address, uint16_t port) abstract;
 
     virtual size_t SendData(const void* buffer, size_t size) abstract;
+    // Sends the buffers one after the other with as few system calls as possible, returns how many bytes were sent.
+    virtual size_t SendData(const SocketBuffer* buffers, size_t count) abstract;
     virtual NetworkReadPacket ReceiveData(void* buffer, size_t size, size_t* sizeReceived) abstract;
 
     virtual void SetNoDelay(bool noDelay) abstract;
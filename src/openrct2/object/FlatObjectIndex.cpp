@@ -0,0 +1,425 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "FlatObjectIndex.h"
+
+#include "../core/Console.hpp"
+#include "../core/File.h"
+#include "../core/Hash.hpp"
+#include "../core/MemoryMappedFile.h"
+#include "../core/Path.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace OpenRCT2;
+
+static constexpr uint32_t MAGIC_NUMBER = 0x544C464F; // OFLT
+// Increment this when the layout changes, which forces the index to be created again
+static constexpr uint16_t VERSION = 2;
+static constexpr uint32_t EMPTY_BUCKET = 0xFFFFFFFF;
+
+// A string in the string table, which is followed by a NUL that is not counted in the length.
+struct FlatString
+{
+    uint32_t Offset;
+    uint32_t Length;
+};
+
+// Values packed the way ObjectIndexList reads them, with the length in bytes.
+struct FlatList
+{
+    uint32_t Offset;
+    uint32_t Length;
+    uint32_t Count;
+};
+
+struct FlatObjectIndex::Header
+{
+    uint32_t MagicNumber;
+    uint16_t Version;
+    uint16_t LanguageId;
+    // Version of the file index the items were created by
+    uint16_t ItemsVersion;
+    uint16_t Padding[3];
+    uint64_t FilesHash;
+    uint32_t RecordSize;
+    uint32_t NumRecords;
+    uint32_t NumBuckets;
+    uint32_t RecordsOffset;
+    uint32_t IdentifierBucketsOffset;
+    uint32_t EntryBucketsOffset;
+    uint32_t StringsOffset;
+    uint32_t StringsLength;
+};
+
+struct FlatObjectIndex::Record
+{
+    rct_object_entry ObjectEntry;
+    FlatString Identifier;
+    FlatString Path;
+    FlatString Name;
+    FlatList Authors;
+    FlatList Sources;
+    FlatList SceneryGroupEntries;
+    ObjectRepositoryRideInfo RideInfo;
+    uint8_t Padding[2];
+};
+
+/**
+ * The string table being created, which stores equal strings and lists only once.
+ */
+class FlatStringTable
+{
+private:
+    std::vector<uint8_t> _data;
+    std::unordered_map<std::string, uint32_t> _offsets;
+
+public:
+    uint32_t Add(const std::string& bytes)
+    {
+        auto [it, added] = _offsets.emplace(bytes, static_cast<uint32_t>(_data.size()));
+        if (added)
+        {
+            _data.insert(_data.end(), bytes.begin(), bytes.end());
+        }
+        return it->second;
+    }
+
+    FlatString AddString(const std::string& str)
+    {
+        return { Add(str + '\0'), static_cast<uint32_t>(str.size()) };
+    }
+
+    FlatList AddList(const std::string& bytes, size_t count)
+    {
+        return { Add(bytes), static_cast<uint32_t>(bytes.size()), static_cast<uint32_t>(count) };
+    }
+
+    const std::vector<uint8_t>& GetData() const
+    {
+        return _data;
+    }
+};
+
+// The tables are written to disk, so the hash must be the same on every platform.
+static uint32_t GetHash(const void* data, size_t length)
+{
+    return Hash::FNV1a<uint32_t>(data, length);
+}
+
+static uint32_t GetEntryHash(const rct_object_entry& entry)
+{
+    return GetHash(entry.name, sizeof(entry.name));
+}
+
+static bool EntryNamesEqual(const rct_object_entry& lhs, const rct_object_entry& rhs)
+{
+    return std::memcmp(lhs.name, rhs.name, sizeof(lhs.name)) == 0;
+}
+
+static std::string PackAuthors(const std::vector<std::string>& authors)
+{
+    std::string result;
+    for (const auto& author : authors)
+    {
+        result += author;
+        result += '\0';
+    }
+    return result;
+}
+
+static std::string PackSources(const std::vector<ObjectSourceGame>& sources)
+{
+    std::string result;
+    for (auto source : sources)
+    {
+        result += static_cast<char>(source);
+    }
+    return result;
+}
+
+static std::string PackEntries(const std::vector<ObjectEntryDescriptor>& entries)
+{
+    std::string result;
+    for (const auto& descriptor : entries)
+    {
+        // The entry of descriptors for JSON objects is not set, so write zeroes for it instead
+        rct_object_entry entry{};
+        if (descriptor.Generation == ObjectGeneration::DAT)
+        {
+            entry = descriptor.Entry;
+        }
+        result += static_cast<char>(descriptor.Generation);
+        result.append(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        result += descriptor.Identifier;
+        result += '\0';
+    }
+    return result;
+}
+
+std::vector<uint8_t> FlatObjectIndex::Create(
+    const std::vector<ObjectIndexItem>& items, int32_t language, uint16_t itemsVersion, uint64_t filesHash)
+{
+    FlatStringTable strings;
+    std::vector<Record> records(items.size());
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        const auto& item = items[i];
+        auto& record = records[i];
+        record.ObjectEntry = item.ObjectEntry;
+        record.Identifier = strings.AddString(item.Identifier);
+        record.Path = strings.AddString(item.Path);
+        record.Name = strings.AddString(item.Name);
+        record.Authors = strings.AddList(PackAuthors(item.Authors), item.Authors.size());
+        record.Sources = strings.AddList(PackSources(item.Sources), item.Sources.size());
+        record.SceneryGroupEntries = strings.AddList(
+            PackEntries(item.SceneryGroupInfo.Entries), item.SceneryGroupInfo.Entries.size());
+        record.RideInfo = item.RideInfo;
+    }
+
+    // Open addressing with at most half of the buckets in use
+    uint32_t numBuckets = 1;
+    while (numBuckets < items.size() * 2)
+    {
+        numBuckets <<= 1;
+    }
+    const uint32_t mask = numBuckets - 1;
+    std::vector<uint32_t> identifierBuckets(numBuckets, EMPTY_BUCKET);
+    std::vector<uint32_t> entryBuckets(numBuckets, EMPTY_BUCKET);
+    for (uint32_t i = 0; i < items.size(); i++)
+    {
+        const auto& item = items[i];
+        if (!item.Identifier.empty())
+        {
+            auto bucket = GetHash(item.Identifier.data(), item.Identifier.size()) & mask;
+            while (identifierBuckets[bucket] != EMPTY_BUCKET
+                   && items[identifierBuckets[bucket]].Identifier != item.Identifier)
+            {
+                bucket = (bucket + 1) & mask;
+            }
+            identifierBuckets[bucket] = i;
+        }
+
+        auto bucket = GetEntryHash(item.ObjectEntry) & mask;
+        while (entryBuckets[bucket] != EMPTY_BUCKET
+               && !EntryNamesEqual(items[entryBuckets[bucket]].ObjectEntry, item.ObjectEntry))
+        {
+            bucket = (bucket + 1) & mask;
+        }
+        if (entryBuckets[bucket] == EMPTY_BUCKET)
+        {
+            entryBuckets[bucket] = i;
+        }
+    }
+
+    const auto& stringData = strings.GetData();
+    Header header{};
+    header.MagicNumber = MAGIC_NUMBER;
+    header.Version = VERSION;
+    header.LanguageId = static_cast<uint16_t>(language);
+    header.ItemsVersion = itemsVersion;
+    header.FilesHash = filesHash;
+    header.RecordSize = sizeof(Record);
+    header.NumRecords = static_cast<uint32_t>(records.size());
+    header.NumBuckets = numBuckets;
+    header.RecordsOffset = sizeof(Header);
+    header.IdentifierBucketsOffset = header.RecordsOffset + static_cast<uint32_t>(records.size() * sizeof(Record));
+    header.EntryBucketsOffset = header.IdentifierBucketsOffset + numBuckets * sizeof(uint32_t);
+    header.StringsOffset = header.EntryBucketsOffset + numBuckets * sizeof(uint32_t);
+    header.StringsLength = static_cast<uint32_t>(stringData.size());
+
+    std::vector<uint8_t> data(header.StringsOffset + stringData.size());
+    std::memcpy(data.data(), &header, sizeof(header));
+    std::memcpy(data.data() + header.RecordsOffset, records.data(), records.size() * sizeof(Record));
+    std::memcpy(data.data() + header.IdentifierBucketsOffset, identifierBuckets.data(), numBuckets * sizeof(uint32_t));
+    std::memcpy(data.data() + header.EntryBucketsOffset, entryBuckets.data(), numBuckets * sizeof(uint32_t));
+    std::memcpy(data.data() + header.StringsOffset, stringData.data(), stringData.size());
+    return data;
+}
+
+std::unique_ptr<FlatObjectIndex> FlatObjectIndex::Open(
+    const std::string& path, int32_t language, uint16_t itemsVersion, uint64_t filesHash)
+{
+    if (!File::Exists(path))
+        return nullptr;
+
+    try
+    {
+        log_verbose("FlatObjectIndex:Mapping index: '%s'", path.c_str());
+        auto index = std::unique_ptr<FlatObjectIndex>(new FlatObjectIndex());
+        index->_file = std::make_unique<MemoryMappedFile>(path);
+        if (index->SetData(index->_file->GetData(), static_cast<size_t>(index->_file->GetLength()))
+            && index->_header->LanguageId == language && index->_header->ItemsVersion == itemsVersion
+            && index->_header->FilesHash == filesHash)
+        {
+            return index;
+        }
+        log_verbose("FlatObjectIndex:Index is out of date: '%s'", path.c_str());
+    }
+    catch (const std::exception& e)
+    {
+        Console::Error::WriteLine("Unable to load index: '%s'.", path.c_str());
+        Console::Error::WriteLine("%s", e.what());
+    }
+    return nullptr;
+}
+
+bool FlatObjectIndex::Write(const std::string& path, const std::vector<uint8_t>& data)
+{
+    try
+    {
+        log_verbose("FlatObjectIndex:Writing index: '%s'", path.c_str());
+        Path::CreateDirectory(Path::GetDirectory(path));
+        // Writing over the file would change it under the processes that have it mapped
+        File::WriteAllBytesAtomic(path, data.data(), data.size());
+    }
+    catch (const std::exception& e)
+    {
+        Console::Error::WriteLine("Unable to save index: '%s'.", path.c_str());
+        Console::Error::WriteLine("%s", e.what());
+        return false;
+    }
+    return true;
+}
+
+FlatObjectIndex::FlatObjectIndex(std::vector<uint8_t>&& data)
+    : _buffer(std::move(data))
+{
+    if (!SetData(_buffer.data(), _buffer.size()))
+    {
+        throw std::runtime_error("Invalid object index.");
+    }
+}
+
+FlatObjectIndex::~FlatObjectIndex() = default;
+
+bool FlatObjectIndex::SetData(const uint8_t* data, size_t length)
+{
+    static_assert(sizeof(Header) == 56);
+    static_assert(sizeof(Record) == 84);
+
+    if (length < sizeof(Header))
+        return false;
+
+    auto header = reinterpret_cast<const Header*>(data);
+    if (header->MagicNumber != MAGIC_NUMBER || header->Version != VERSION || header->RecordSize != sizeof(Record))
+        return false;
+    if (header->NumBuckets == 0 || (header->NumBuckets & (header->NumBuckets - 1)) != 0)
+        return false;
+
+    auto isSectionValid = [length](uint32_t offset, uint64_t size) {
+        return offset % sizeof(uint32_t) == 0 && offset + size <= length;
+    };
+    const uint64_t bucketsSize = static_cast<uint64_t>(header->NumBuckets) * sizeof(uint32_t);
+    if (!isSectionValid(header->RecordsOffset, static_cast<uint64_t>(header->NumRecords) * sizeof(Record))
+        || !isSectionValid(header->IdentifierBucketsOffset, bucketsSize)
+        || !isSectionValid(header->EntryBucketsOffset, bucketsSize)
+        || static_cast<uint64_t>(header->StringsOffset) + header->StringsLength > length)
+    {
+        return false;
+    }
+
+    // Everything the records refer to has to be in the string table
+    auto records = reinterpret_cast<const Record*>(data + header->RecordsOffset);
+    const uint64_t stringsLength = header->StringsLength;
+    auto isInStrings = [stringsLength](uint32_t offset, uint32_t size) {
+        return static_cast<uint64_t>(offset) + size <= stringsLength;
+    };
+    for (uint32_t i = 0; i < header->NumRecords; i++)
+    {
+        const auto& record = records[i];
+        if (!isInStrings(record.Identifier.Offset, record.Identifier.Length)
+            || !isInStrings(record.Path.Offset, record.Path.Length) || !isInStrings(record.Name.Offset, record.Name.Length)
+            || !isInStrings(record.Authors.Offset, record.Authors.Length)
+            || !isInStrings(record.Sources.Offset, record.Sources.Length)
+            || !isInStrings(record.SceneryGroupEntries.Offset, record.SceneryGroupEntries.Length))
+        {
+            return false;
+        }
+    }
+
+    _header = header;
+    _records = records;
+    _identifierBuckets = reinterpret_cast<const uint32_t*>(data + header->IdentifierBucketsOffset);
+    _entryBuckets = reinterpret_cast<const uint32_t*>(data + header->EntryBucketsOffset);
+    _strings = data + header->StringsOffset;
+    return true;
+}
+
+std::string_view FlatObjectIndex::GetString(uint32_t offset, uint32_t length) const
+{
+    return std::string_view(reinterpret_cast<const char*>(_strings + offset), length);
+}
+
+size_t FlatObjectIndex::GetCount() const
+{
+    return _header->NumRecords;
+}
+
+ObjectRepositoryItem FlatObjectIndex::GetItem(size_t index) const
+{
+    const auto& record = _records[index];
+    ObjectRepositoryItem item{};
+    item.Id = index;
+    item.Identifier = GetString(record.Identifier.Offset, record.Identifier.Length);
+    item.ObjectEntry = record.ObjectEntry;
+    item.Path = GetString(record.Path.Offset, record.Path.Length);
+    item.Name = GetString(record.Name.Offset, record.Name.Length);
+    item.Authors = ObjectIndexList<std::string_view>(
+        _strings + record.Authors.Offset, record.Authors.Length, record.Authors.Count);
+    item.Sources = ObjectIndexList<ObjectSourceGame>(
+        _strings + record.Sources.Offset, record.Sources.Length, record.Sources.Count);
+    item.RideInfo = record.RideInfo;
+    item.SceneryGroupInfo.Entries = ObjectIndexList<ObjectEntryDescriptor>(
+        _strings + record.SceneryGroupEntries.Offset, record.SceneryGroupEntries.Length,
+        record.SceneryGroupEntries.Count);
+    return item;
+}
+
+std::optional<size_t> FlatObjectIndex::FindObject(std::string_view identifier) const
+{
+    if (identifier.empty())
+        return std::nullopt;
+
+    const uint32_t mask = _header->NumBuckets - 1;
+    auto bucket = GetHash(identifier.data(), identifier.size()) & mask;
+    for (uint32_t i = 0; i < _header->NumBuckets; i++)
+    {
+        auto recordIndex = _identifierBuckets[bucket];
+        if (recordIndex >= _header->NumRecords)
+            break;
+
+        const auto& record = _records[recordIndex];
+        if (GetString(record.Identifier.Offset, record.Identifier.Length) == identifier)
+            return recordIndex;
+
+        bucket = (bucket + 1) & mask;
+    }
+    return std::nullopt;
+}
+
+std::optional<size_t> FlatObjectIndex::FindObject(const rct_object_entry& entry) const
+{
+    const uint32_t mask = _header->NumBuckets - 1;
+    auto bucket = GetEntryHash(entry) & mask;
+    for (uint32_t i = 0; i < _header->NumBuckets; i++)
+    {
+        auto recordIndex = _entryBuckets[bucket];
+        if (recordIndex >= _header->NumRecords)
+            break;
+
+        if (EntryNamesEqual(_records[recordIndex].ObjectEntry, entry))
+            return recordIndex;
+
+        bucket = (bucket + 1) & mask;
+    }
+    return std::nullopt;
+}
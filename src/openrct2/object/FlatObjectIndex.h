@@ -0,0 +1,81 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "ObjectRepository.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace OpenRCT2
+{
+    class MemoryMappedFile;
+}
+
+/**
+ * The objects of the repository laid out as one block of memory: a record of fixed size for each object, hash tables
+ * for finding them by identifier and by entry, and a table holding every distinct string and list of the records once.
+ * Nothing has to be read before it is used, so the cache file is mapped into memory as it is and only the pages that are
+ * touched get loaded.
+ */
+class FlatObjectIndex final
+{
+private:
+    struct Header;
+    struct Record;
+
+    std::unique_ptr<OpenRCT2::MemoryMappedFile> _file;
+    std::vector<uint8_t> _buffer;
+    const Header* _header = nullptr;
+    const Record* _records = nullptr;
+    const uint32_t* _identifierBuckets = nullptr;
+    const uint32_t* _entryBuckets = nullptr;
+    const uint8_t* _strings = nullptr;
+
+    FlatObjectIndex() = default;
+    bool SetData(const uint8_t* data, size_t length);
+    std::string_view GetString(uint32_t offset, uint32_t length) const;
+
+public:
+    /**
+     * Lays out the items in the given order. Only the first item with a given entry can be found by it and only the last
+     * one with a given identifier by that.
+     */
+    static std::vector<uint8_t> Create(
+        const std::vector<ObjectIndexItem>& items, int32_t language, uint16_t itemsVersion, uint64_t filesHash);
+
+    /**
+     * Maps an index written by Write, returns nullptr if the file is missing or damaged, or if the index was created for
+     * other files, another language or another version of the items.
+     */
+    static std::unique_ptr<FlatObjectIndex> Open(
+        const std::string& path, int32_t language, uint16_t itemsVersion, uint64_t filesHash);
+
+    /**
+     * Writes the index to a file next to the given one and moves it over that, so processes that have the old file mapped
+     * keep their copy.
+     */
+    static bool Write(const std::string& path, const std::vector<uint8_t>& data);
+
+    /**
+     * Uses an index kept in memory. Throws a runtime_error if the data is not an index.
+     */
+    explicit FlatObjectIndex(std::vector<uint8_t>&& data);
+    ~FlatObjectIndex();
+
+    size_t GetCount() const;
+    ObjectRepositoryItem GetItem(size_t index) const;
+    std::optional<size_t> FindObject(std::string_view identifier) const;
+    std::optional<size_t> FindObject(const rct_object_entry& entry) const;
+};
@@ -20,6 +20,7 @@
 #include "../core/String.hpp"
 #include "../drawing/ImageImporter.h"
 #include "../sprites.h"
+#include "ImageTableCache.h"
 #include "Object.h"
 #include "ObjectFactory.h"
 
@@ -80,7 +81,8 @@ struct ImageTable::RequiredImage
     }
 };
 
-std::vector<std::unique_ptr<ImageTable::RequiredImage>> ImageTable::ParseImages(IReadObjectContext* context, std::string s)
+std::vector<std::unique_ptr<ImageTable::RequiredImage>> ImageTable::ParseImages(
+    IReadObjectContext* context, ImageTableCache* cache, std::string s)
 {
     std::vector<std::unique_ptr<RequiredImage>> result;
     if (s.empty())
@@ -131,13 +133,7 @@ std::vector<std::unique_ptr<ImageTable::RequiredImage>> ImageTable::ParseImages(
     {
         try
         {
-            auto imageData = context->GetData(s);
-            auto image = Imaging::ReadFromBuffer(imageData, IMAGE_FORMAT::PNG_32);
-
-            ImageImporter importer;
-            auto importResult = importer.Import(image, 0, 0, ImageImporter::IMPORT_FLAGS::RLE);
-
-            result.push_back(std::make_unique<RequiredImage>(importResult.Element));
+            result.push_back(ImportImage(context, cache, s, true));
         }
         catch (const std::exception& e)
         {
@@ -149,7 +145,8 @@ std::vector<std::unique_ptr<ImageTable::RequiredImage>> ImageTable::ParseImages(
     return result;
 }
 
-std::vector<std::unique_ptr<ImageTable::RequiredImage>> ImageTable::ParseImages(IReadObjectContext* context, json_t& el)
+std::vector<std::unique_ptr<ImageTable::RequiredImage>> ImageTable::ParseImages(
+    IReadObjectContext* context, ImageTableCache* cache, json_t& el)
 {
     Guard::Assert(el.is_object(), "ImageTable::ParseImages expects parameter el to be object");
 
@@ -161,20 +158,10 @@ std::vector<std::unique_ptr<ImageTable::RequiredImage>> ImageTable::ParseImages(
     std::vector<std::unique_ptr<RequiredImage>> result;
     try
     {
-        auto flags = ImageImporter::IMPORT_FLAGS::NONE;
-        if (!raw)
-        {
-            flags = static_cast<ImageImporter::IMPORT_FLAGS>(flags | ImageImporter::IMPORT_FLAGS::RLE);
-        }
-        auto imageData = context->GetData(path);
-        auto image = Imaging::ReadFromBuffer(imageData, IMAGE_FORMAT::PNG_32);
-
-        ImageImporter importer;
-        auto importResult = importer.Import(image, 0, 0, flags);
-        auto g1Element = importResult.Element;
-        g1Element.x_offset = x;
-        g1Element.y_offset = y;
-        result.push_back(std::make_unique<RequiredImage>(g1Element));
+        auto image = ImportImage(context, cache, path, !raw);
+        image->g1.x_offset = x;
+        image->g1.y_offset = y;
+        result.push_back(std::move(image));
     }
     catch (const std::exception& e)
     {
@@ -185,6 +172,31 @@ std::vector<std::unique_ptr<ImageTable::RequiredImage>> ImageTable::ParseImages(
     return result;
 }
 
+std::unique_ptr<ImageTable::RequiredImage> ImageTable::ImportImage(
+    IReadObjectContext* context, ImageTableCache* cache, const std::string& path, bool rle)
+{
+    if (cache != nullptr)
+    {
+        auto cachedElement = cache->Find(path, rle);
+        if (cachedElement)
+        {
+            return std::make_unique<RequiredImage>(*cachedElement);
+        }
+    }
+
+    auto imageData = context->GetData(path);
+    auto image = Imaging::ReadFromBuffer(imageData, IMAGE_FORMAT::PNG_32);
+
+    ImageImporter importer;
+    auto flags = rle ? ImageImporter::IMPORT_FLAGS::RLE : ImageImporter::IMPORT_FLAGS::NONE;
+    auto importResult = importer.Import(image, 0, 0, flags);
+    if (cache != nullptr)
+    {
+        cache->Add(path, importResult.Element);
+    }
+    return std::make_unique<RequiredImage>(importResult.Element);
+}
+
 std::vector<std::unique_ptr<ImageTable::RequiredImage>> ImageTable::LoadObjectImages(
     IReadObjectContext* context, const std::string& name, const std::vector<int32_t>& range)
 {
@@ -374,6 +386,14 @@ void ImageTable::ReadJson(IReadObjectContext* context, json_t& root)
 
     if (context->ShouldLoadImages())
     {
+        // Images imported from the files of the object are kept for the next time the same object file is read
+        std::unique_ptr<ImageTableCache> cache;
+        auto contentHash = context->GetContentHash();
+        if (contentHash.has_value())
+        {
+            cache = std::make_unique<ImageTableCache>(ImageTableCache::GetPath(*contentHash), *contentHash);
+        }
+
         // First gather all the required images from inspecting the JSON
         std::vector<std::unique_ptr<RequiredImage>> allImages;
         auto jsonImages = root["images"];
@@ -383,17 +403,21 @@ void ImageTable::ReadJson(IReadObjectContext* context, json_t& root)
             if (jsonImage.is_string())
             {
                 auto strImage = jsonImage.get<std::string>();
-                auto images = ParseImages(context, strImage);
+                auto images = ParseImages(context, cache.get(), strImage);
                 allImages.insert(
                     allImages.end(), std::make_move_iterator(images.begin()), std::make_move_iterator(images.end()));
             }
             else if (jsonImage.is_object())
             {
-                auto images = ParseImages(context, jsonImage);
+                auto images = ParseImages(context, cache.get(), jsonImage);
                 allImages.insert(
                     allImages.end(), std::make_move_iterator(images.begin()), std::make_move_iterator(images.end()));
             }
         }
+        if (cache != nullptr)
+        {
+            cache->Save();
+        }
 
         // Now add all the images to the image table
         auto imagesStartIndex = GetCount();
@@ -16,6 +16,7 @@
 #include <memory>
 #include <vector>
 
+class ImageTableCache;
 struct IReadObjectContext;
 namespace OpenRCT2
 {
@@ -32,11 +33,15 @@ private:
      * Container for a G1 image, additional information and RAII. Used by ReadJson
      */
     struct RequiredImage;
-    static std::vector<std::unique_ptr<ImageTable::RequiredImage>> ParseImages(IReadObjectContext* context, std::string s);
+    static std::vector<std::unique_ptr<ImageTable::RequiredImage>> ParseImages(
+        IReadObjectContext* context, ImageTableCache* cache, std::string s);
     /**
      * @note root is deliberately left non-const: json_t behaviour changes when const
      */
-    static std::vector<std::unique_ptr<ImageTable::RequiredImage>> ParseImages(IReadObjectContext* context, json_t& el);
+    static std::vector<std::unique_ptr<ImageTable::RequiredImage>> ParseImages(
+        IReadObjectContext* context, ImageTableCache* cache, json_t& el);
+    static std::unique_ptr<ImageTable::RequiredImage> ImportImage(
+        IReadObjectContext* context, ImageTableCache* cache, const std::string& path, bool rle);
     static std::vector<std::unique_ptr<ImageTable::RequiredImage>> LoadObjectImages(
         IReadObjectContext* context, const std::string& name, const std::vector<int32_t>& range);
     static std::vector<int32_t> ParseRange(std::string s);
@@ -0,0 +1,217 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "ImageTableCache.h"
+
+#include "../Context.h"
+#include "../PlatformEnvironment.h"
+#include "../core/Console.hpp"
+#include "../core/File.h"
+#include "../core/FileScanner.h"
+#include "../core/Hash.hpp"
+#include "../core/MemoryStream.h"
+#include "../core/Path.hpp"
+#include "../core/String.hpp"
+
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+using namespace OpenRCT2;
+
+static constexpr uint32_t MAGIC_NUMBER = 0x474D494F; // OIMG
+// Increment this when the layout or the way images are imported changes, which forces the images to be imported again
+static constexpr uint16_t VERSION = 1;
+
+#pragma pack(push, 1)
+struct ImageTableCacheHeader
+{
+    uint32_t MagicNumber;
+    uint16_t Version;
+    uint16_t Reserved;
+    uint64_t ContentHash;
+    uint64_t DataHash;
+    uint32_t NumImages;
+};
+assert_struct_size(ImageTableCacheHeader, 28);
+#pragma pack(pop)
+
+static uint64_t GetDataHash(const uint8_t* data, size_t length)
+{
+    return Hash::FNV1a<uint64_t>(data, length);
+}
+
+ImageTableCache::ImageTableCache(std::string path, uint64_t contentHash)
+    : _path(std::move(path))
+    , _contentHash(contentHash)
+{
+    if (File::Exists(_path))
+    {
+        try
+        {
+            Read();
+        }
+        catch (const std::exception& e)
+        {
+            log_verbose("ImageTableCache: Unable to read '%s': %s", _path.c_str(), e.what());
+            _images.clear();
+        }
+    }
+}
+
+std::string ImageTableCache::GetPath(uint64_t contentHash)
+{
+    auto env = GetContext()->GetPlatformEnvironment();
+    auto directory = env->GetFilePath(PATHID::CACHE_OBJECT_IMAGES);
+    return Path::Combine(directory, String::StdFormat("%016" PRIx64 ".dat", contentHash));
+}
+
+std::string ImageTableCache::GetKey(std::string_view imagePath, bool rle)
+{
+    std::string key;
+    key.reserve(imagePath.size() + 1);
+    key.push_back(rle ? 'r' : 'b');
+    key.append(imagePath);
+    return key;
+}
+
+void ImageTableCache::Read()
+{
+    auto data = File::ReadAllBytes(_path);
+    MemoryStream stream(data.data(), data.size());
+
+    auto header = stream.ReadValue<ImageTableCacheHeader>();
+    if (header.MagicNumber != MAGIC_NUMBER || header.Version != VERSION || header.ContentHash != _contentHash)
+    {
+        throw std::runtime_error("Cache is out of date.");
+    }
+    if (header.DataHash != GetDataHash(data.data() + sizeof(header), data.size() - sizeof(header)))
+    {
+        throw std::runtime_error("Cache is damaged.");
+    }
+
+    for (uint32_t i = 0; i < header.NumImages; i++)
+    {
+        auto imagePath = stream.ReadStdString();
+        CachedImage image;
+        image.Element.width = stream.ReadValue<int16_t>();
+        image.Element.height = stream.ReadValue<int16_t>();
+        image.Element.x_offset = stream.ReadValue<int16_t>();
+        image.Element.y_offset = stream.ReadValue<int16_t>();
+        image.Element.flags = stream.ReadValue<uint16_t>();
+        auto dataLength = stream.ReadValue<uint32_t>();
+        if (dataLength > stream.GetLength() - stream.GetPosition())
+        {
+            throw std::runtime_error("Image data is truncated.");
+        }
+        image.Data.resize(dataLength);
+        stream.Read(image.Data.data(), dataLength);
+
+        auto rle = (image.Element.flags & G1_FLAG_RLE_COMPRESSION) != 0;
+        _images[GetKey(imagePath, rle)] = std::move(image);
+    }
+}
+
+std::optional<rct_g1_element> ImageTableCache::Find(std::string_view imagePath, bool rle) const
+{
+    auto it = _images.find(GetKey(imagePath, rle));
+    if (it == _images.end())
+    {
+        return std::nullopt;
+    }
+
+    auto element = it->second.Element;
+    element.offset = const_cast<uint8_t*>(it->second.Data.data());
+    return element;
+}
+
+void ImageTableCache::Add(std::string_view imagePath, const rct_g1_element& element)
+{
+    auto rle = (element.flags & G1_FLAG_RLE_COMPRESSION) != 0;
+    auto& image = _images[GetKey(imagePath, rle)];
+    image.Element = element;
+    image.Element.offset = nullptr;
+    image.Element.zoomed_offset = 0;
+
+    auto length = g1_calculate_data_size(&element);
+    image.Data.assign(element.offset, element.offset + length);
+    _changed = true;
+}
+
+bool ImageTableCache::Save()
+{
+    if (!_changed)
+    {
+        return true;
+    }
+
+    MemoryStream stream;
+    ImageTableCacheHeader header{};
+    header.MagicNumber = MAGIC_NUMBER;
+    header.Version = VERSION;
+    header.ContentHash = _contentHash;
+    header.NumImages = static_cast<uint32_t>(_images.size());
+    stream.WriteValue(header);
+    for (const auto& [key, image] : _images)
+    {
+        stream.WriteString(key.substr(1));
+        stream.WriteValue<int16_t>(image.Element.width);
+        stream.WriteValue<int16_t>(image.Element.height);
+        stream.WriteValue<int16_t>(image.Element.x_offset);
+        stream.WriteValue<int16_t>(image.Element.y_offset);
+        stream.WriteValue<uint16_t>(image.Element.flags);
+        stream.WriteValue<uint32_t>(static_cast<uint32_t>(image.Data.size()));
+        stream.Write(image.Data.data(), image.Data.size());
+    }
+
+    auto data = static_cast<uint8_t*>(const_cast<void*>(stream.GetData()));
+    auto length = static_cast<size_t>(stream.GetLength());
+    header.DataHash = GetDataHash(data + sizeof(header), length - sizeof(header));
+    std::memcpy(data, &header, sizeof(header));
+
+    try
+    {
+        log_verbose("ImageTableCache: Writing images: '%s'", _path.c_str());
+        Path::CreateDirectory(Path::GetDirectory(_path));
+        // Objects with the same content share the file, so it is replaced rather than written over
+        File::WriteAllBytesAtomic(_path, data, length);
+    }
+    catch (const std::exception& e)
+    {
+        Console::Error::WriteLine("Unable to save images: '%s'.", _path.c_str());
+        Console::Error::WriteLine("%s", e.what());
+        return false;
+    }
+    _changed = false;
+    return true;
+}
+
+void ImageTableCache::RemoveUnused(const std::string& directory, const std::unordered_set<uint64_t>& contentHashes)
+{
+    std::vector<std::string> unused;
+    auto scanner = std::unique_ptr<IFileScanner>(Path::ScanDirectory(Path::Combine(directory, "*.dat"), false));
+    while (scanner->Next())
+    {
+        // Files are named by GetPath, anything else does not belong to an object file either
+        auto name = Path::GetFileNameWithoutExtension(std::string(scanner->GetPathRelative()));
+        uint64_t contentHash = std::strtoull(name.c_str(), nullptr, 16);
+        if (name != String::StdFormat("%016" PRIx64, contentHash) || contentHashes.find(contentHash) == contentHashes.end())
+        {
+            unused.emplace_back(scanner->GetPath());
+        }
+    }
+
+    for (const auto& path : unused)
+    {
+        log_verbose("ImageTableCache: Removing unused images: '%s'", path.c_str());
+        File::Delete(path);
+    }
+}
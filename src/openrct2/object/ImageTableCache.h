@@ -0,0 +1,71 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../drawing/Drawing.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * The images an object has imported from its PNG files, kept in a file of their own so that loading the object again
+ * does not have to decode and convert them. The file belongs to one version of the object file, so nothing in it has to
+ * be checked against the images it was made from.
+ */
+class ImageTableCache final
+{
+private:
+    struct CachedImage
+    {
+        rct_g1_element Element{};
+        std::vector<uint8_t> Data;
+    };
+
+    std::string _path;
+    uint64_t _contentHash{};
+    std::unordered_map<std::string, CachedImage> _images;
+    bool _changed{};
+
+    static std::string GetKey(std::string_view imagePath, bool rle);
+    void Read();
+
+public:
+    /**
+     * Reads the images cached at the given path. The cache starts out empty if the file is missing or damaged, or if it
+     * was written for another version of the object file.
+     */
+    ImageTableCache(std::string path, uint64_t contentHash);
+
+    /**
+     * Returns the cache file of the object file with the given content hash.
+     */
+    static std::string GetPath(uint64_t contentHash);
+
+    /**
+     * Deletes the cache files in the directory that belong to none of the given object files.
+     */
+    static void RemoveUnused(const std::string& directory, const std::unordered_set<uint64_t>& contentHashes);
+
+    /**
+     * Returns the image imported from the given file of the object, pointing at the data held by the cache.
+     */
+    std::optional<rct_g1_element> Find(std::string_view imagePath, bool rle) const;
+    void Add(std::string_view imagePath, const rct_g1_element& element);
+
+    /**
+     * Writes the cache if images have been added to it since it was read.
+     */
+    bool Save();
+};
@@ -187,6 +187,7 @@ namespace OpenRCT2
 {
     struct IStream;
 }
+struct ObjectIndexItem;
 struct ObjectRepositoryItem;
 struct rct_drawpixelinfo;
 
@@ -234,6 +235,11 @@ struct IReadObjectContext
     virtual std::vector<uint8_t> GetData(std::string_view path) abstract;
     virtual ObjectAsset GetAsset(std::string_view path) abstract;
 
+    /**
+     * Returns a hash of the file the object is read from, or nothing if its data does not all come from one file.
+     */
+    virtual std::optional<uint64_t> GetContentHash() abstract;
+
     virtual void LogWarning(ObjectError code, const utf8* text) abstract;
     virtual void LogError(ObjectError code, const utf8* text) abstract;
 };
@@ -337,7 +343,7 @@ public:
     virtual std::string GetName() const;
     virtual std::string GetName(int32_t language) const;
 
-    virtual void SetRepositoryItem(ObjectRepositoryItem* /*item*/) const
+    virtual void SetRepositoryItem(ObjectIndexItem* /*item*/) const
     {
     }
     std::vector<ObjectSourceGame> GetSourceGames();
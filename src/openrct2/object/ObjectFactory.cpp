@@ -39,6 +39,7 @@
 #include "WaterObject.h"
 
 #include <algorithm>
+#include <optional>
 #include <unordered_map>
 
 struct IFileDataRetriever
@@ -46,6 +47,7 @@ struct IFileDataRetriever
     virtual ~IFileDataRetriever() = default;
     virtual std::vector<uint8_t> GetData(std::string_view path) const abstract;
     virtual ObjectAsset GetAsset(std::string_view path) const abstract;
+    virtual std::optional<uint64_t> GetContentHash() const abstract;
 };
 
 class FileSystemDataRetriever : public IFileDataRetriever
@@ -70,6 +72,12 @@ public:
         auto absolutePath = Path::Combine(_basePath, path);
         return ObjectAsset(absolutePath);
     }
+
+    std::optional<uint64_t> GetContentHash() const override
+    {
+        // The files of the directory can change on their own
+        return std::nullopt;
+    }
 };
 
 class ZipDataRetriever : public IFileDataRetriever
@@ -94,6 +102,18 @@ public:
     {
         return ObjectAsset(_path, path);
     }
+
+    std::optional<uint64_t> GetContentHash() const override
+    {
+        try
+        {
+            return File::GetContentHash(_path);
+        }
+        catch (const std::exception&)
+        {
+            return std::nullopt;
+        }
+    }
 };
 
 class ReadObjectContext : public IReadObjectContext
@@ -161,6 +181,15 @@ public:
         return {};
     }
 
+    std::optional<uint64_t> GetContentHash() override
+    {
+        if (_fileDataRetriever != nullptr)
+        {
+            return _fileDataRetriever->GetContentHash();
+        }
+        return std::nullopt;
+    }
+
     void LogWarning(ObjectError code, const utf8* text) override
     {
         _wasWarning = true;
@@ -32,6 +32,8 @@
 #include "../scenario/ScenarioRepository.h"
 #include "../util/SawyerCoding.h"
 #include "../util/Util.h"
+#include "FlatObjectIndex.h"
+#include "ImageTableCache.h"
 #include "Object.h"
 #include "ObjectFactory.h"
 #include "ObjectList.h"
@@ -40,7 +42,9 @@
 
 #include <algorithm>
 #include <memory>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 // windows.h defines CP_UTF8
@@ -69,10 +73,9 @@ struct ObjectEntryEqual
     }
 };
 
-using ObjectIdentifierMap = std::unordered_map<std::string, size_t>;
 using ObjectEntryMap = std::unordered_map<rct_object_entry, size_t, ObjectEntryHash, ObjectEntryEqual>;
 
-class ObjectFileIndex final : public FileIndex<ObjectRepositoryItem>
+class ObjectFileIndex final : public FileIndex<ObjectIndexItem>
 {
 private:
     static constexpr uint32_t MAGIC_NUMBER = 0x5844494F; // OIDX
@@ -94,7 +97,7 @@ public:
     }
 
 public:
-    std::tuple<bool, ObjectRepositoryItem> Create([[maybe_unused]] int32_t language, const std::string& path) const override
+    std::tuple<bool, ObjectIndexItem> Create([[maybe_unused]] int32_t language, const std::string& path) const override
     {
         std::unique_ptr<Object> object;
         auto extension = Path::GetExtension(path);
@@ -112,7 +115,7 @@ public:
         }
         if (object != nullptr)
         {
-            ObjectRepositoryItem item = {};
+            ObjectIndexItem item = {};
             item.Identifier = object->GetIdentifier();
             item.ObjectEntry = *object->GetObjectEntry();
             item.Path = path;
@@ -122,11 +125,11 @@ public:
             object->SetRepositoryItem(&item);
             return std::make_tuple(true, item);
         }
-        return std::make_tuple(false, ObjectRepositoryItem());
+        return std::make_tuple(false, ObjectIndexItem());
     }
 
 protected:
-    void Serialise(DataSerialiser& ds, ObjectRepositoryItem& item) const override
+    void Serialise(DataSerialiser& ds, ObjectIndexItem& item) const override
     {
         ds << item.Identifier;
         ds << item.ObjectEntry;
@@ -166,8 +169,13 @@ class ObjectRepository final : public IObjectRepository
     std::shared_ptr<IPlatformEnvironment> const _env;
     ObjectFileIndex const _fileIndex;
     std::vector<ObjectRepositoryItem> _items;
-    ObjectIdentifierMap _newItemMap;
-    ObjectEntryMap _itemMap;
+    // The index of all objects found when loading, their IDs start at zero.
+    std::unique_ptr<FlatObjectIndex> _index;
+    // Objects added since loading, each in an index of its own that holds its strings, and their IDs by identifier and
+    // by entry. These take the place of loaded objects with the same identifier.
+    std::vector<std::unique_ptr<FlatObjectIndex>> _addedIndexes;
+    std::unordered_map<std::string, size_t> _addedIdentifiers;
+    ObjectEntryMap _addedEntries;
 
 public:
     explicit ObjectRepository(const std::shared_ptr<IPlatformEnvironment>& env)
@@ -184,16 +192,27 @@ public:
     void LoadOrConstruct(int32_t language) override
     {
         ClearItems();
-        auto items = _fileIndex.LoadOrBuild(language);
-        AddItems(items);
-        SortItems();
+        auto files = _fileIndex.Scan();
+        auto filesHash = ObjectFileIndex::GetFilesHash(files);
+        auto index = FlatObjectIndex::Open(
+            _env->GetFilePath(PATHID::CACHE_OBJECTS_FLAT), language, _fileIndex.GetVersion(), filesHash);
+        if (index == nullptr)
+        {
+            std::vector<uint64_t> contentHashes;
+            index = CreateIndex(_fileIndex.LoadOrBuild(language, files, &contentHashes), language, filesHash);
+            RemoveUnusedImages(contentHashes);
+        }
+        SetIndex(std::move(index));
     }
 
     void Construct(int32_t language) override
     {
-        auto items = _fileIndex.Rebuild(language);
-        AddItems(items);
-        SortItems();
+        ClearItems();
+        auto files = _fileIndex.Scan();
+        auto filesHash = ObjectFileIndex::GetFilesHash(files);
+        std::vector<uint64_t> contentHashes;
+        SetIndex(CreateIndex(_fileIndex.Rebuild(language, files, &contentHashes), language, filesHash));
+        RemoveUnusedImages(contentHashes);
     }
 
     size_t GetNumObjects() const override
@@ -210,33 +229,17 @@ public:
     {
         rct_object_entry entry = {};
         entry.SetName(legacyIdentifier);
-
-        auto kvp = _itemMap.find(entry);
-        if (kvp != _itemMap.end())
-        {
-            return &_items[kvp->second];
-        }
-        return nullptr;
+        return FindInIndexes(entry);
     }
 
     const ObjectRepositoryItem* FindObject(std::string_view identifier) const override final
     {
-        auto kvp = _newItemMap.find(std::string(identifier));
-        if (kvp != _newItemMap.end())
-        {
-            return &_items[kvp->second];
-        }
-        return nullptr;
+        return FindInIndexes(identifier);
     }
 
     const ObjectRepositoryItem* FindObject(const rct_object_entry* objectEntry) const override final
     {
-        auto kvp = _itemMap.find(*objectEntry);
-        if (kvp != _itemMap.end())
-        {
-            return &_items[kvp->second];
-        }
-        return nullptr;
+        return FindInIndexes(*objectEntry);
     }
 
     const ObjectRepositoryItem* FindObject(const ObjectEntryDescriptor& entry) const override final
@@ -251,18 +254,19 @@ public:
     {
         Guard::ArgumentNotNull(ori, GUARD_LINE);
 
-        auto extension = Path::GetExtension(ori->Path);
+        auto path = std::string(ori->Path);
+        auto extension = Path::GetExtension(path);
         if (String::Equals(extension, ".json", true))
         {
-            return ObjectFactory::CreateObjectFromJsonFile(*this, ori->Path);
+            return ObjectFactory::CreateObjectFromJsonFile(*this, path);
         }
         else if (String::Equals(extension, ".parkobj", true))
         {
-            return ObjectFactory::CreateObjectFromZipFile(*this, ori->Path);
+            return ObjectFactory::CreateObjectFromZipFile(*this, path);
         }
         else
         {
-            return ObjectFactory::CreateObjectFromLegacyFile(*this, ori->Path.c_str());
+            return ObjectFactory::CreateObjectFromLegacyFile(*this, path.c_str());
         }
     }
 
@@ -366,43 +370,97 @@ private:
     void ClearItems()
     {
         _items.clear();
-        _newItemMap.clear();
-        _itemMap.clear();
+        _index = nullptr;
+        _addedIndexes.clear();
+        _addedIdentifiers.clear();
+        _addedEntries.clear();
     }
 
-    void SortItems()
+    const ObjectRepositoryItem* FindInIndexes(std::string_view identifier) const
     {
-        std::sort(_items.begin(), _items.end(), [](const ObjectRepositoryItem& a, const ObjectRepositoryItem& b) -> bool {
-            return String::Compare(a.Name, b.Name) < 0;
-        });
+        if (!identifier.empty())
+        {
+            auto it = _addedIdentifiers.find(std::string(identifier));
+            if (it != _addedIdentifiers.end())
+            {
+                return &_items[it->second];
+            }
+        }
+        return FindInLoadedIndex(identifier);
+    }
 
-        // Fix the IDs
-        for (size_t i = 0; i < _items.size(); i++)
+    const ObjectRepositoryItem* FindInIndexes(const rct_object_entry& entry) const
+    {
+        auto it = _addedEntries.find(entry);
+        if (it != _addedEntries.end())
         {
-            _items[i].Id = i;
+            return &_items[it->second];
         }
+        return FindInLoadedIndex(entry);
+    }
+
+    template<typename TKey> const ObjectRepositoryItem* FindInLoadedIndex(const TKey& key) const
+    {
+        if (_index == nullptr)
+            return nullptr;
+
+        auto index = _index->FindObject(key);
+        return index.has_value() ? &_items[*index] : nullptr;
+    }
 
-        // Rebuild item map
-        _itemMap.clear();
-        _newItemMap.clear();
-        for (size_t i = 0; i < _items.size(); i++)
+    /**
+     * Creates the index of the given items without the ones that conflict with earlier items, sorted by name. The index
+     * is written to the cache and mapped from there if possible.
+     */
+    std::unique_ptr<FlatObjectIndex> CreateIndex(std::vector<ObjectIndexItem> items, int32_t language, uint64_t filesHash)
+    {
+        RemoveConflicts(items);
+        std::sort(items.begin(), items.end(), [](const ObjectIndexItem& a, const ObjectIndexItem& b) -> bool {
+            return String::Compare(a.Name, b.Name) < 0;
+        });
+
+        auto data = FlatObjectIndex::Create(items, language, _fileIndex.GetVersion(), filesHash);
+        auto path = _env->GetFilePath(PATHID::CACHE_OBJECTS_FLAT);
+        if (FlatObjectIndex::Write(path, data))
         {
-            rct_object_entry entry = _items[i].ObjectEntry;
-            _itemMap[entry] = i;
-            if (!_items[i].Identifier.empty())
+            auto index = FlatObjectIndex::Open(path, language, _fileIndex.GetVersion(), filesHash);
+            if (index != nullptr)
             {
-                _newItemMap[_items[i].Identifier] = i;
+                return index;
             }
         }
+        return std::make_unique<FlatObjectIndex>(std::move(data));
+    }
+
+    /**
+     * Object files that changed or were removed leave their imported images behind, these are deleted whenever the
+     * files are indexed again.
+     */
+    void RemoveUnusedImages(const std::vector<uint64_t>& contentHashes) const
+    {
+        ImageTableCache::RemoveUnused(
+            _env->GetFilePath(PATHID::CACHE_OBJECT_IMAGES),
+            std::unordered_set<uint64_t>(contentHashes.begin(), contentHashes.end()));
     }
 
-    void AddItems(const std::vector<ObjectRepositoryItem>& items)
+    static void RemoveConflicts(std::vector<ObjectIndexItem>& items)
     {
+        std::vector<ObjectIndexItem> result;
+        result.reserve(items.size());
+        ObjectEntryMap itemMap;
         size_t numConflicts = 0;
-        for (const auto& item : items)
+        for (auto& item : items)
         {
-            if (!AddItem(item))
+            auto conflict = itemMap.find(item.ObjectEntry);
+            if (conflict == itemMap.end())
+            {
+                itemMap[item.ObjectEntry] = result.size();
+                result.push_back(std::move(item));
+            }
+            else
             {
+                Console::Error::WriteLine("Object conflict: '%s'", result[conflict->second].Path.c_str());
+                Console::Error::WriteLine("               : '%s'", item.Path.c_str());
                 numConflicts++;
             }
         }
@@ -410,30 +468,31 @@ private:
         {
             Console::Error::WriteLine("%zu object conflicts found.", numConflicts);
         }
+        items = std::move(result);
     }
 
-    bool AddItem(const ObjectRepositoryItem& item)
+    void SetIndex(std::unique_ptr<FlatObjectIndex> index)
     {
-        auto conflict = FindObject(&item.ObjectEntry);
-        if (conflict == nullptr)
+        _items.reserve(index->GetCount());
+        for (size_t i = 0; i < index->GetCount(); i++)
         {
-            size_t index = _items.size();
-            auto copy = item;
-            copy.Id = index;
-            _items.push_back(std::move(copy));
-            if (!item.Identifier.empty())
-            {
-                _newItemMap[item.Identifier] = index;
-            }
-            _itemMap[item.ObjectEntry] = index;
-            return true;
+            _items.push_back(index->GetItem(i));
         }
-        else
+        _index = std::move(index);
+    }
+
+    void AddItem(const ObjectIndexItem& item, int32_t language)
+    {
+        auto index = std::make_unique<FlatObjectIndex>(FlatObjectIndex::Create({ item }, language, 0, 0));
+        auto repositoryItem = index->GetItem(0);
+        repositoryItem.Id = _items.size();
+        if (!item.Identifier.empty())
         {
-            Console::Error::WriteLine("Object conflict: '%s'", conflict->Path.c_str());
-            Console::Error::WriteLine("               : '%s'", item.Path.c_str());
-            return false;
+            _addedIdentifiers[item.Identifier] = repositoryItem.Id;
         }
+        _addedEntries[item.ObjectEntry] = repositoryItem.Id;
+        _items.push_back(repositoryItem);
+        _addedIndexes.push_back(std::move(index));
     }
 
     void ScanObject(const std::string& path)
@@ -442,8 +501,17 @@ private:
         auto result = _fileIndex.Create(language, path);
         if (std::get<0>(result))
         {
-            auto ori = std::get<1>(result);
-            AddItem(ori);
+            const auto& item = std::get<1>(result);
+            auto conflict = FindObject(&item.ObjectEntry);
+            if (conflict == nullptr)
+            {
+                AddItem(item, language);
+            }
+            else
+            {
+                Console::Error::WriteLine("Object conflict: '%s'", std::string(conflict->Path).c_str());
+                Console::Error::WriteLine("               : '%s'", item.Path.c_str());
+            }
         }
     }
 
@@ -604,7 +672,7 @@ private:
         }
 
         // Read object data from file
-        auto fs = OpenRCT2::FileStream(item->Path, OpenRCT2::FILE_MODE_OPEN);
+        auto fs = OpenRCT2::FileStream(std::string(item->Path), OpenRCT2::FILE_MODE_OPEN);
         auto fileEntry = fs.ReadValue<rct_object_entry>();
         if (!object_entry_compare(entry, &fileEntry))
         {
@@ -13,7 +13,10 @@
 #include "../object/Object.h"
 #include "../ride/Ride.h"
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
+#include <string_view>
 #include <vector>
 
 namespace OpenRCT2
@@ -34,25 +37,175 @@ namespace OpenRCT2::Localisation
 
 struct rct_drawpixelinfo;
 
-struct ObjectRepositoryItem
+struct ObjectRepositoryRideInfo
+{
+    uint8_t RideFlags;
+    uint8_t RideCategory[MAX_CATEGORIES_PER_RIDE];
+    uint8_t RideType[MAX_RIDE_TYPES_PER_RIDE_ENTRY];
+};
+
+/**
+ * An object as it is created when indexing its file. The repository packs these into a FlatObjectIndex and only hands
+ * out views of them.
+ */
+struct ObjectIndexItem
 {
-    size_t Id;
     std::string Identifier; // e.g. rct2.c3d
     rct_object_entry ObjectEntry;
     std::string Path;
     std::string Name;
     std::vector<std::string> Authors;
     std::vector<ObjectSourceGame> Sources;
-    Object* LoadedObject{};
+    ObjectRepositoryRideInfo RideInfo;
     struct
     {
-        uint8_t RideFlags;
-        uint8_t RideCategory[MAX_CATEGORIES_PER_RIDE];
-        uint8_t RideType[MAX_RIDE_TYPES_PER_RIDE_ENTRY];
-    } RideInfo;
+        std::vector<ObjectEntryDescriptor> Entries;
+    } SceneryGroupInfo;
+};
+
+/**
+ * How the values of an ObjectIndexList are packed. Strings are NUL-terminated, the other values are followed by a string
+ * if they have one.
+ */
+template<typename T> struct ObjectIndexListTraits;
+
+template<> struct ObjectIndexListTraits<std::string_view>
+{
+    static std::string_view Read(const uint8_t*& data, const uint8_t* end)
+    {
+        auto str = reinterpret_cast<const char*>(data);
+        auto length = std::find(data, end, 0) - data;
+        data = std::min(data + length + 1, end);
+        return std::string_view(str, length);
+    }
+};
+
+template<> struct ObjectIndexListTraits<ObjectSourceGame>
+{
+    static ObjectSourceGame Read(const uint8_t*& data, const uint8_t* end)
+    {
+        return data < end ? static_cast<ObjectSourceGame>(*data++) : ObjectSourceGame::Custom;
+    }
+};
+
+template<> struct ObjectIndexListTraits<ObjectEntryDescriptor>
+{
+    static ObjectEntryDescriptor Read(const uint8_t*& data, const uint8_t* end)
+    {
+        if (end - data < static_cast<ptrdiff_t>(1 + sizeof(rct_object_entry)))
+        {
+            data = end;
+            return {};
+        }
+
+        auto generation = static_cast<ObjectGeneration>(*data++);
+        rct_object_entry entry;
+        std::memcpy(&entry, data, sizeof(entry));
+        data += sizeof(entry);
+        auto identifier = ObjectIndexListTraits<std::string_view>::Read(data, end);
+        if (generation == ObjectGeneration::DAT)
+            return ObjectEntryDescriptor(entry);
+        return ObjectEntryDescriptor(identifier);
+    }
+};
+
+/**
+ * A list of values packed one after another in the object index. Values are only decoded when they are iterated.
+ */
+template<typename T> class ObjectIndexList
+{
+private:
+    const uint8_t* _data = nullptr;
+    const uint8_t* _end = nullptr;
+    size_t _count = 0;
+
+public:
+    class Iterator
+    {
+    private:
+        const uint8_t* _data;
+        const uint8_t* _end;
+        size_t _remaining;
+
+    public:
+        Iterator(const uint8_t* data, const uint8_t* end, size_t remaining)
+            : _data(data)
+            , _end(end)
+            , _remaining(remaining)
+        {
+        }
+
+        T operator*() const
+        {
+            auto data = _data;
+            return ObjectIndexListTraits<T>::Read(data, _end);
+        }
+
+        Iterator& operator++()
+        {
+            ObjectIndexListTraits<T>::Read(_data, _end);
+            _remaining--;
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const
+        {
+            return _remaining == other._remaining;
+        }
+
+        bool operator!=(const Iterator& other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    ObjectIndexList() = default;
+    ObjectIndexList(const uint8_t* data, size_t length, size_t count)
+        : _data(data)
+        , _end(data + length)
+        , _count(count)
+    {
+    }
+
+    Iterator begin() const
+    {
+        return Iterator(_data, _end, _count);
+    }
+
+    Iterator end() const
+    {
+        return Iterator(_end, _end, 0);
+    }
+
+    size_t size() const
+    {
+        return _count;
+    }
+
+    bool empty() const
+    {
+        return _count == 0;
+    }
+};
+
+/**
+ * An object in the repository. The strings and lists point into the object index, which lives for as long as the
+ * repository does.
+ */
+struct ObjectRepositoryItem
+{
+    size_t Id;
+    std::string_view Identifier; // e.g. rct2.c3d
+    rct_object_entry ObjectEntry;
+    std::string_view Path;
+    std::string_view Name;
+    ObjectIndexList<std::string_view> Authors;
+    ObjectIndexList<ObjectSourceGame> Sources;
+    Object* LoadedObject{};
+    ObjectRepositoryRideInfo RideInfo;
     struct
     {
-        std::vector<ObjectEntryDescriptor> Entries;
+        ObjectIndexList<ObjectEntryDescriptor> Entries;
     } SceneryGroupInfo;
 
     ObjectSourceGame GetFirstSourceGame() const
@@ -60,7 +213,7 @@ struct ObjectRepositoryItem
         if (Sources.empty())
             return ObjectSourceGame::Custom;
         else
-            return static_cast<ObjectSourceGame>(Sources[0]);
+            return *Sources.begin();
     }
 };
 
@@ -403,7 +403,7 @@ std::string RideObject::GetCapacity() const
     return GetString(ObjectStringID::CAPACITY);
 }
 
-void RideObject::SetRepositoryItem(ObjectRepositoryItem* item) const
+void RideObject::SetRepositoryItem(ObjectIndexItem* item) const
 {
     // Find the first non-null ride type, to be used when checking the ride group and determining the category.
     uint8_t firstRideType = ride_entry_get_first_non_null_ride_type(&_legacyType);
@@ -44,7 +44,7 @@ public:
     std::string GetDescription() const;
     std::string GetCapacity() const;
 
-    void SetRepositoryItem(ObjectRepositoryItem* item) const override;
+    void SetRepositoryItem(ObjectIndexItem* item) const override;
 
     static uint8_t ParseRideType(const std::string& s);
 
@@ -93,7 +93,7 @@ void SceneryGroupObject::UpdateEntryIndexes()
     }
 }
 
-void SceneryGroupObject::SetRepositoryItem(ObjectRepositoryItem* item) const
+void SceneryGroupObject::SetRepositoryItem(ObjectIndexItem* item) const
 {
     item->SceneryGroupInfo.Entries = _items;
 }
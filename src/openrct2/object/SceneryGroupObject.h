@@ -14,7 +14,7 @@
 
 #include <vector>
 
-struct ObjectRepositoryItem;
+struct ObjectIndexItem;
 
 enum class EntertainerCostume : uint8_t;
 
@@ -43,7 +43,7 @@ public:
 
     void DrawPreview(rct_drawpixelinfo* dpi, int32_t width, int32_t height) const override;
 
-    void SetRepositoryItem(ObjectRepositoryItem* item) const override;
+    void SetRepositoryItem(ObjectIndexItem* item) const override;
 
 private:
     static std::vector<ObjectEntryDescriptor> ReadItems(OpenRCT2::IStream* stream);
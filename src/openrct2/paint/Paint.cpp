@@ -17,12 +17,22 @@
 #include "../localisation/Localisation.h"
 #include "../localisation/LocalisationService.h"
 #include "../paint/Painter.h"
+#include "PaintTileCache.h"
 #include "sprite/Paint.Sprite.h"
 #include "tile_element/Paint.TileElement.h"
 
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// MSVC does not define __SSE2__, SSE2 is always available when it targets x86 or x64.
+#if defined(__SSE2__) || (defined(_MSC_VER) && defined(OPENRCT2_X86))
+#    define PAINT_USE_SSE2
+#    include <emmintrin.h>
+#endif
 
 using namespace OpenRCT2;
 
@@ -75,8 +85,13 @@ static constexpr int32_t CalculatePositionHash(const paint_struct& ps, uint8_t r
     return pos.x + pos.y;
 }
 
-static void PaintSessionAddPSToQuadrant(paint_session* session, paint_struct* ps)
+void PaintSessionAddPSToQuadrant(paint_session* session, paint_struct* ps)
 {
+    if (session->TileRecorder != nullptr)
+    {
+        session->TileRecorder->OnAddToQuadrant(ps);
+    }
+
     auto positionHash = CalculatePositionHash(*ps, session->CurrentRotation);
     uint32_t paintQuadrantIndex = std::clamp(positionHash / 32, 0, MAX_PAINT_QUADRANTS - 1);
     ps->quadrant_index = paintQuadrantIndex;
@@ -139,9 +154,6 @@ static paint_struct* CreateNormalPaintStruct(
     paint_session* session, const uint32_t image_id, const CoordsXYZ& offset, const CoordsXYZ& boundBoxSize,
     const CoordsXYZ& boundBoxOffset)
 {
-    if (session->NoPaintStructsAvailable())
-        return nullptr;
-
     auto* const g1 = gfx_get_g1_element(image_id & 0x7FFFF);
     if (g1 == nullptr)
     {
@@ -163,6 +175,10 @@ static paint_struct* CreateNormalPaintStruct(
     const auto rotBoundBoxSize = RotateBoundBoxSize(boundBoxSize, session->CurrentRotation);
 
     paint_struct* ps = session->AllocateNormalPaintEntry();
+    if (session->TileRecorder != nullptr)
+    {
+        session->TileRecorder->OnAllocate(PaintTileEntryKind::Normal);
+    }
     ps->image_id = image_id;
     ps->x = imagePos.x;
     ps->y = imagePos.y;
@@ -383,7 +399,7 @@ static paint_struct* PaintArrangeStructsHelperRotation(paint_struct* ps_next, ui
     }
 }
 
-template<int TRotation> static void PaintSessionArrange(paint_session* session, bool)
+template<int TRotation> static void PaintSessionArrangeLinked(paint_session* session, bool)
 {
     paint_struct* psHead = &session->PaintHead;
 
@@ -419,6 +435,315 @@ template<int TRotation> static void PaintSessionArrange(paint_session* session,
     }
 }
 
+/**
+ * Reference implementation of the paint struct ordering, walks the next_quadrant_ps chains directly.
+ */
+void PaintSessionArrangeLinked(paint_session* session)
+{
+    switch (session->CurrentRotation)
+    {
+        case 0:
+            return PaintSessionArrangeLinked<0>(session, true);
+        case 1:
+            return PaintSessionArrangeLinked<1>(session, true);
+        case 2:
+            return PaintSessionArrangeLinked<2>(session, true);
+        case 3:
+            return PaintSessionArrangeLinked<3>(session, true);
+    }
+    Guard::Assert(false);
+}
+
+namespace
+{
+    constexpr uint32_t ArrangeNullIndex = std::numeric_limits<uint32_t>::max();
+
+    // Bounding boxes split per field so several of them can be compared at once.
+    struct BoundBoxLanes
+    {
+        std::vector<uint16_t> X;
+        std::vector<uint16_t> Y;
+        std::vector<uint16_t> Z;
+        std::vector<uint16_t> XEnd;
+        std::vector<uint16_t> YEnd;
+        std::vector<uint16_t> ZEnd;
+
+        void resize(size_t size)
+        {
+            X.resize(size);
+            Y.resize(size);
+            Z.resize(size);
+            XEnd.resize(size);
+            YEnd.resize(size);
+            ZEnd.resize(size);
+        }
+        void set(size_t index, const paint_struct_bound_box& bounds)
+        {
+            X[index] = bounds.x;
+            Y[index] = bounds.y;
+            Z[index] = bounds.z;
+            XEnd[index] = bounds.x_end;
+            YEnd[index] = bounds.y_end;
+            ZEnd[index] = bounds.z_end;
+        }
+        paint_struct_bound_box operator[](size_t index) const
+        {
+            return { X[index], Y[index], Z[index], XEnd[index], YEnd[index], ZEnd[index] };
+        }
+    };
+
+    /**
+     * The paint structs of a session in drawing order, stored as arrays indexed by position instead of the
+     * next_quadrant_ps chain. Index 0 is the paint head.
+     */
+    struct PaintArrangeNodes
+    {
+        std::vector<paint_struct*> Structs;
+        std::vector<uint32_t> Next;
+        std::vector<uint16_t> QuadrantIndex;
+        std::vector<uint8_t> QuadrantFlags;
+        std::vector<paint_struct_bound_box> Bounds;
+
+        // Scratch space for the paint structs compared against a single bounding box, sized for all of them.
+        BoundBoxLanes Candidates;
+        std::vector<uint8_t> Results;
+
+        void resize(size_t size)
+        {
+            Structs.resize(size);
+            Next.resize(size);
+            QuadrantIndex.resize(size);
+            QuadrantFlags.resize(size);
+            Bounds.resize(size);
+            Candidates.resize(size);
+            Results.resize(size);
+        }
+        void set(size_t index, paint_struct* ps)
+        {
+            Structs[index] = ps;
+            QuadrantIndex[index] = ps->quadrant_index;
+            QuadrantFlags[index] = ps->quadrant_flags;
+            Bounds[index] = ps->bounds;
+        }
+    };
+} // namespace
+
+#ifdef PAINT_USE_SSE2
+static __m128i CompareGreaterUnsigned16(__m128i a, __m128i b)
+{
+    const __m128i bias = _mm_set1_epi16(static_cast<int16_t>(0x8000));
+    return _mm_cmpgt_epi16(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+}
+
+static __m128i LoadLane(const std::vector<uint16_t>& lane, size_t index)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(lane.data() + index));
+}
+#endif // PAINT_USE_SSE2
+
+/**
+ * CheckBoundingBox<TRotation> of initialBBox against every box in candidates, results are non-zero where it holds.
+ * Returns whether it holds for any of them.
+ */
+template<uint8_t TRotation>
+static bool CheckBoundingBoxes(
+    const paint_struct_bound_box& initialBBox, const BoundBoxLanes& candidates, size_t count, uint8_t* results)
+{
+    size_t index = 0;
+    bool any = false;
+#ifdef PAINT_USE_SSE2
+    // Along x and y the boxes are compared the other way around for some rotations, see CheckBoundingBox.
+    constexpr bool xForward = TRotation == 0 || TRotation == 3;
+    constexpr bool yForward = TRotation == 0 || TRotation == 1;
+    const __m128i allSet = _mm_set1_epi16(-1);
+    const __m128i initialX = _mm_set1_epi16(static_cast<int16_t>(initialBBox.x));
+    const __m128i initialY = _mm_set1_epi16(static_cast<int16_t>(initialBBox.y));
+    const __m128i initialZ = _mm_set1_epi16(static_cast<int16_t>(initialBBox.z));
+    const __m128i initialXEnd = _mm_set1_epi16(static_cast<int16_t>(initialBBox.x_end));
+    const __m128i initialYEnd = _mm_set1_epi16(static_cast<int16_t>(initialBBox.y_end));
+    const __m128i initialZEnd = _mm_set1_epi16(static_cast<int16_t>(initialBBox.z_end));
+    for (; index + 8 <= count; index += 8)
+    {
+        // initial end >= current start and initial start < current end, per axis.
+        const __m128i endBeforeX = CompareGreaterUnsigned16(LoadLane(candidates.X, index), initialXEnd);
+        const __m128i endBeforeY = CompareGreaterUnsigned16(LoadLane(candidates.Y, index), initialYEnd);
+        const __m128i endBeforeZ = CompareGreaterUnsigned16(LoadLane(candidates.Z, index), initialZEnd);
+        const __m128i startBeforeX = CompareGreaterUnsigned16(LoadLane(candidates.XEnd, index), initialX);
+        const __m128i startBeforeY = CompareGreaterUnsigned16(LoadLane(candidates.YEnd, index), initialY);
+        const __m128i startBeforeZ = CompareGreaterUnsigned16(LoadLane(candidates.ZEnd, index), initialZ);
+
+        const __m128i firstX = xForward ? _mm_xor_si128(endBeforeX, allSet) : endBeforeX;
+        const __m128i firstY = yForward ? _mm_xor_si128(endBeforeY, allSet) : endBeforeY;
+        const __m128i firstZ = _mm_xor_si128(endBeforeZ, allSet);
+        const __m128i secondX = xForward ? startBeforeX : _mm_xor_si128(startBeforeX, allSet);
+        const __m128i secondY = yForward ? startBeforeY : _mm_xor_si128(startBeforeY, allSet);
+
+        const __m128i first = _mm_and_si128(_mm_and_si128(firstX, firstY), firstZ);
+        const __m128i second = _mm_and_si128(_mm_and_si128(secondX, secondY), startBeforeZ);
+        const __m128i result = _mm_andnot_si128(second, first);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(results + index), _mm_packs_epi16(result, result));
+        any |= _mm_movemask_epi8(result) != 0;
+    }
+#endif // PAINT_USE_SSE2
+    for (; index < count; index++)
+    {
+        results[index] = CheckBoundingBox<TRotation>(initialBBox, candidates[index]) ? 1 : 0;
+        any |= results[index] != 0;
+    }
+    return any;
+}
+
+/**
+ * Same as PaintArrangeStructsHelperRotation, working on the arrays of nodes.
+ */
+template<uint8_t TRotation>
+static uint32_t PaintArrangeNodesRotation(PaintArrangeNodes& nodes, uint32_t start, uint16_t quadrantIndex, uint8_t flag)
+{
+    auto& next = nodes.Next;
+    auto& quadrants = nodes.QuadrantIndex;
+    auto& flags = nodes.QuadrantFlags;
+
+    uint32_t ps;
+    uint32_t psNext = start;
+    do
+    {
+        ps = psNext;
+        psNext = next[ps];
+        if (psNext == ArrangeNullIndex)
+            return ps;
+    } while (quadrantIndex > quadrants[psNext]);
+
+    const uint32_t psCache = ps;
+
+    uint32_t psTemp = ps;
+    do
+    {
+        ps = next[ps];
+        if (ps == ArrangeNullIndex)
+            break;
+
+        if (quadrants[ps] > quadrantIndex + 1)
+        {
+            flags[ps] = PAINT_QUADRANT_FLAG_BIGGER;
+        }
+        else if (quadrants[ps] == quadrantIndex + 1)
+        {
+            flags[ps] = PAINT_QUADRANT_FLAG_NEXT | PAINT_QUADRANT_FLAG_IDENTICAL;
+        }
+        else if (quadrants[ps] == quadrantIndex)
+        {
+            flags[ps] = flag | PAINT_QUADRANT_FLAG_IDENTICAL;
+        }
+    } while (quadrants[ps] <= quadrantIndex + 1);
+    ps = psTemp;
+
+    while (true)
+    {
+        while (true)
+        {
+            psNext = next[ps];
+            if (psNext == ArrangeNullIndex)
+                return psCache;
+            if (flags[psNext] & PAINT_QUADRANT_FLAG_BIGGER)
+                return psCache;
+            if (flags[psNext] & PAINT_QUADRANT_FLAG_IDENTICAL)
+                break;
+            ps = psNext;
+        }
+
+        flags[psNext] &= ~PAINT_QUADRANT_FLAG_IDENTICAL;
+        psTemp = ps;
+        const uint32_t initial = psNext;
+
+        // Every struct up to the next bigger quadrant is compared against the same box and the moves do not change which
+        // structs are visited, so all comparisons are done up front.
+        size_t candidateCount = 0;
+        for (auto index = next[initial]; index != ArrangeNullIndex && !(flags[index] & PAINT_QUADRANT_FLAG_BIGGER);
+             index = next[index])
+        {
+            if (flags[index] & PAINT_QUADRANT_FLAG_NEXT)
+            {
+                nodes.Candidates.set(candidateCount++, nodes.Bounds[index]);
+            }
+        }
+        const bool anyMoved = CheckBoundingBoxes<TRotation>(
+            nodes.Bounds[initial], nodes.Candidates, candidateCount, nodes.Results.data());
+
+        // Structs that have to be drawn before the initial one are moved in front of it, like the linked version does.
+        uint32_t previous = initial;
+        size_t candidate = 0;
+        for (auto index = next[initial]; anyMoved && index != ArrangeNullIndex && !(flags[index] & PAINT_QUADRANT_FLAG_BIGGER);
+             index = next[previous])
+        {
+            if ((flags[index] & PAINT_QUADRANT_FLAG_NEXT) && nodes.Results[candidate++] != 0)
+            {
+                next[previous] = next[index];
+                next[index] = next[psTemp];
+                next[psTemp] = index;
+            }
+            else
+            {
+                previous = index;
+            }
+        }
+
+        ps = psTemp;
+    }
+}
+
+template<uint8_t TRotation> static void PaintSessionArrange(paint_session* session, bool)
+{
+    paint_struct* psHead = &session->PaintHead;
+    psHead->next_quadrant_ps = nullptr;
+
+    const uint32_t backIndex = session->QuadrantBackIndex;
+    if (backIndex == UINT32_MAX)
+        return;
+
+    // Columns are arranged on several threads, each keeps its own arrays around for the next session.
+    thread_local PaintArrangeNodes nodes;
+    size_t count = 1;
+    for (auto quadrantIndex = backIndex; quadrantIndex <= session->QuadrantFrontIndex; quadrantIndex++)
+    {
+        for (auto* ps = session->Quadrants[quadrantIndex]; ps != nullptr; ps = ps->next_quadrant_ps)
+        {
+            count++;
+        }
+    }
+    nodes.resize(count);
+    nodes.set(0, psHead);
+
+    uint32_t last = 0;
+    for (auto quadrantIndex = backIndex; quadrantIndex <= session->QuadrantFrontIndex; quadrantIndex++)
+    {
+        for (auto* ps = session->Quadrants[quadrantIndex]; ps != nullptr; ps = ps->next_quadrant_ps)
+        {
+            nodes.Next[last] = last + 1;
+            nodes.set(++last, ps);
+        }
+    }
+    nodes.Next[last] = ArrangeNullIndex;
+
+    uint32_t psCache = PaintArrangeNodesRotation<TRotation>(nodes, 0, backIndex & 0xFFFF, PAINT_QUADRANT_FLAG_NEXT);
+
+    auto quadrantIndex = backIndex;
+    while (++quadrantIndex < session->QuadrantFrontIndex)
+    {
+        psCache = PaintArrangeNodesRotation<TRotation>(nodes, psCache, quadrantIndex & 0xFFFF, 0);
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        auto* ps = nodes.Structs[i];
+        const auto next = nodes.Next[i];
+        ps->next_quadrant_ps = next == ArrangeNullIndex ? nullptr : nodes.Structs[next];
+        if (i != 0)
+        {
+            ps->quadrant_flags = nodes.QuadrantFlags[i];
+        }
+    }
+}
+
 /**
  *
  *  rct2: 0x00688217
@@ -667,6 +992,69 @@ static uint32_t PaintPSColourifyImage(uint32_t imageId, ViewportInteractionItem
     return imageId;
 }
 
+PaintEntryPool::PaintEntryPool(const PaintEntryPool& other)
+{
+    *this = other;
+}
+
+/**
+ * Copies the entries into the chunks already allocated where possible, so pointers into this pool stay valid.
+ */
+PaintEntryPool& PaintEntryPool::operator=(const PaintEntryPool& other)
+{
+    if (this == &other)
+        return *this;
+
+    while (_chunks.size() < other._chunks.size())
+    {
+        _chunks.push_back(std::make_unique<Chunk>());
+    }
+    for (size_t i = 0; i < other._chunks.size() && i * ChunkSize < other._size; i++)
+    {
+        const auto count = std::min(ChunkSize, other._size - i * ChunkSize);
+        std::copy_n(other._chunks[i]->Entries, count, _chunks[i]->Entries);
+    }
+    _size = other._size;
+    _peakSize = std::max(_peakSize, other._peakSize);
+    return *this;
+}
+
+void PaintEntryPool::Grow()
+{
+    _chunks.push_back(std::make_unique<Chunk>());
+    _growCount++;
+}
+
+void PaintEntryPool::clear()
+{
+    _peakSize = std::max(_peakSize, _size);
+    _size = 0;
+}
+
+size_t PaintEntryPool::IndexOf(const paint_entry* entry) const
+{
+    for (size_t i = 0; i < _chunks.size(); i++)
+    {
+        const auto* chunkEntries = _chunks[i]->Entries;
+        if (entry >= chunkEntries && entry < chunkEntries + ChunkSize)
+        {
+            const auto index = i * ChunkSize + static_cast<size_t>(entry - chunkEntries);
+            return std::min(index, _size);
+        }
+    }
+    return _size;
+}
+
+size_t PaintEntryPool::GetPeakSize() const
+{
+    return std::max(_peakSize, _size);
+}
+
+uint32_t PaintEntryPool::TakeGrowCount()
+{
+    return std::exchange(_growCount, 0);
+}
+
 paint_session* PaintSessionAlloc(rct_drawpixelinfo* dpi, uint32_t viewFlags)
 {
     return GetContext()->GetPainter()->CreateSession(dpi, viewFlags);
@@ -847,11 +1235,6 @@ paint_struct* PaintAddImageAsChild(
  */
 bool PaintAttachToPreviousAttach(paint_session* session, uint32_t image_id, int16_t x, int16_t y)
 {
-    if (session->NoPaintStructsAvailable())
-    {
-        return false;
-    }
-
     attached_paint_struct* previousAttachedPS = session->LastAttachedPS;
     if (previousAttachedPS == nullptr)
     {
@@ -859,6 +1242,10 @@ bool PaintAttachToPreviousAttach(paint_session* session, uint32_t image_id, int1
     }
 
     attached_paint_struct* ps = session->AllocateAttachedPaintEntry();
+    if (session->TileRecorder != nullptr)
+    {
+        session->TileRecorder->OnAllocate(PaintTileEntryKind::Attached);
+    }
     ps->image_id = image_id;
     ps->x = x;
     ps->y = y;
@@ -880,11 +1267,6 @@ bool PaintAttachToPreviousAttach(paint_session* session, uint32_t image_id, int1
  */
 bool PaintAttachToPreviousPS(paint_session* session, uint32_t image_id, int16_t x, int16_t y)
 {
-    if (session->NoPaintStructsAvailable())
-    {
-        return false;
-    }
-
     paint_struct* masterPs = session->LastPS;
     if (masterPs == nullptr)
     {
@@ -892,6 +1274,10 @@ bool PaintAttachToPreviousPS(paint_session* session, uint32_t image_id, int16_t
     }
 
     attached_paint_struct* ps = session->AllocateAttachedPaintEntry();
+    if (session->TileRecorder != nullptr)
+    {
+        session->TileRecorder->OnAllocate(PaintTileEntryKind::Attached);
+    }
     ps->image_id = image_id;
     ps->x = x;
     ps->y = y;
@@ -918,11 +1304,6 @@ void PaintFloatingMoneyEffect(
     paint_session* session, money32 amount, rct_string_id string_id, int16_t y, int16_t z, int8_t y_offsets[], int16_t offset_x,
     uint32_t rotation)
 {
-    if (session->NoPaintStructsAvailable())
-    {
-        return;
-    }
-
     const CoordsXYZ position = {
         session->SpritePosition.x,
         session->SpritePosition.y,
@@ -931,6 +1312,10 @@ void PaintFloatingMoneyEffect(
     const auto coord = translate_3d_to_2d_with_z(rotation, position);
 
     paint_string_struct* ps = session->AllocateStringPaintEntry();
+    if (session->TileRecorder != nullptr)
+    {
+        session->TileRecorder->OnAllocate(PaintTileEntryKind::String);
+    }
     ps->string_id = string_id;
     ps->next = nullptr;
     ps->args[0] = amount;
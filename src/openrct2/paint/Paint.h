@@ -10,11 +10,15 @@
 #pragma once
 
 #include "../common.h"
-#include "../core/FixedVector.h"
 #include "../drawing/Drawing.h"
 #include "../interface/Colour.h"
 #include "../world/Location.hpp"
 
+#include <memory>
+#include <new>
+#include <vector>
+
+struct PaintTileRecorder;
 struct TileElement;
 enum class ViewportInteractionItem : uint8_t;
 
@@ -106,6 +110,115 @@ union paint_entry
     paint_string_struct string;
 };
 
+/**
+ * Bump allocator for the paint entries of a session. Entries are taken from fixed size chunks so they never move
+ * while it grows, clearing it keeps the chunks for the next frame.
+ */
+class PaintEntryPool
+{
+public:
+    static constexpr size_t ChunkSize = 1024;
+
+    class iterator
+    {
+    private:
+        PaintEntryPool* _pool;
+        size_t _index;
+
+    public:
+        iterator(PaintEntryPool* pool, size_t index)
+            : _pool(pool)
+            , _index(index)
+        {
+        }
+
+        paint_entry& operator*() const
+        {
+            return (*_pool)[_index];
+        }
+        iterator& operator++()
+        {
+            _index++;
+            return *this;
+        }
+        bool operator==(const iterator& other) const
+        {
+            return _index == other._index;
+        }
+        bool operator!=(const iterator& other) const
+        {
+            return _index != other._index;
+        }
+    };
+
+private:
+    struct Chunk
+    {
+        paint_entry Entries[ChunkSize];
+    };
+
+    std::vector<std::unique_ptr<Chunk>> _chunks;
+    size_t _size = 0;
+    size_t _peakSize = 0;
+    uint32_t _growCount = 0;
+
+    void Grow();
+
+public:
+    PaintEntryPool() = default;
+    PaintEntryPool(const PaintEntryPool& other);
+    PaintEntryPool& operator=(const PaintEntryPool& other);
+
+    paint_entry& emplace_back()
+    {
+        const auto chunkIndex = _size / ChunkSize;
+        if (chunkIndex == _chunks.size())
+        {
+            Grow();
+        }
+        auto& entry = _chunks[chunkIndex]->Entries[_size % ChunkSize];
+        _size++;
+        ::new (&entry) paint_entry();
+        return entry;
+    }
+
+    paint_entry& operator[](size_t index)
+    {
+        return _chunks[index / ChunkSize]->Entries[index % ChunkSize];
+    }
+    const paint_entry& operator[](size_t index) const
+    {
+        return _chunks[index / ChunkSize]->Entries[index % ChunkSize];
+    }
+
+    iterator begin()
+    {
+        return iterator(this, 0);
+    }
+    iterator end()
+    {
+        return iterator(this, _size);
+    }
+
+    size_t size() const
+    {
+        return _size;
+    }
+    size_t capacity() const
+    {
+        return _chunks.size() * ChunkSize;
+    }
+    void clear();
+
+    // Position of the entry in allocation order, size() if it is not part of the pool.
+    size_t IndexOf(const paint_entry* entry) const;
+
+    // Most entries in use at once since the pool was created.
+    size_t GetPeakSize() const;
+    // Chunks allocated since the last call.
+    uint32_t TakeGrowCount();
+};
+
 struct sprite_bb
 {
     uint32_t sprite_id;
@@ -138,7 +251,7 @@ struct tunnel_entry
 struct paint_session
 {
     rct_drawpixelinfo DPI;
-    FixedVector<paint_entry, 4000> PaintStructs;
+    PaintEntryPool PaintStructs;
     paint_struct* Quadrants[MAX_PAINT_QUADRANTS];
     paint_struct* LastPS;
     paint_string_struct* PSStringHead;
@@ -168,25 +281,22 @@ struct paint_session
     uint8_t Unk141E9DB;
     uint16_t WaterHeight;
     uint32_t TrackColours[4];
+    // Set while the tile paint cache records the entries of a tile.
+    PaintTileRecorder* TileRecorder;
 
-    constexpr bool NoPaintStructsAvailable() noexcept
-    {
-        return PaintStructs.size() >= PaintStructs.capacity();
-    }
-
-    constexpr paint_struct* AllocateNormalPaintEntry() noexcept
+    paint_struct* AllocateNormalPaintEntry()
     {
         LastPS = &PaintStructs.emplace_back().basic;
         return LastPS;
     }
 
-    constexpr attached_paint_struct* AllocateAttachedPaintEntry() noexcept
+    attached_paint_struct* AllocateAttachedPaintEntry()
     {
         LastAttachedPS = &PaintStructs.emplace_back().attached;
         return LastAttachedPS;
     }
 
-    constexpr paint_string_struct* AllocateStringPaintEntry() noexcept
+    paint_string_struct* AllocateStringPaintEntry()
     {
         auto* string = &PaintStructs.emplace_back().string;
         if (LastPSString == nullptr)
@@ -257,10 +367,12 @@ void PaintFloatingMoneyEffect(
     paint_session* session, money32 amount, rct_string_id string_id, int16_t y, int16_t z, int8_t y_offsets[], int16_t offset_x,
     uint32_t rotation);
 
+void PaintSessionAddPSToQuadrant(paint_session* session, paint_struct* ps);
 paint_session* PaintSessionAlloc(rct_drawpixelinfo* dpi, uint32_t viewFlags);
 void PaintSessionFree(paint_session* session);
 void PaintSessionGenerate(paint_session* session);
 void PaintSessionArrange(paint_session* session);
+void PaintSessionArrangeLinked(paint_session* session);
 void PaintDrawStructs(paint_session* session);
 void PaintDrawMoneyStructs(rct_drawpixelinfo* dpi, paint_string_struct* ps);
 
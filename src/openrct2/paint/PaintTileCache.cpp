@@ -0,0 +1,481 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "PaintTileCache.h"
+
+#include "../Cheats.h"
+#include "../OpenRCT2.h"
+#include "../config/Config.h"
+#include "../interface/Viewport.h"
+#include "../peep/Staff.h"
+#include "../ride/TrackDesign.h"
+#include "../world/Footpath.h"
+#include "../world/LargeScenery.h"
+#include "../world/Map.h"
+#include "../world/Scenery.h"
+#include "../world/SmallScenery.h"
+#include "../world/Sprite.h"
+#include "../world/Wall.h"
+#include "Paint.h"
+#include "VirtualFloor.h"
+#include "tile_element/Paint.TileElement.h"
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+    constexpr int32_t NoLink = -1;
+    constexpr int32_t Unchanged = -2;
+
+    struct RecordedEntry
+    {
+        paint_entry Data;
+        PaintTileEntryKind Kind;
+        // attached_ps and children for normal entries, next for attached ones.
+        int32_t Links[2];
+        int32_t ElementOffset;
+    };
+
+    struct TileRecording
+    {
+        uint32_t TileVersion;
+        std::vector<RecordedEntry> Entries;
+        std::vector<uint16_t> QuadrantOrder;
+        int32_t LastPS;
+        int32_t LastAttachedPS;
+        int32_t SurfaceElement;
+    };
+
+    struct TileKey
+    {
+        int32_t X;
+        int32_t Y;
+        int32_t DpiX;
+        int32_t DpiY;
+        int32_t DpiWidth;
+        int32_t DpiHeight;
+        uint32_t ViewFlags;
+        uint32_t Settings;
+        int8_t Zoom;
+        uint8_t Rotation;
+        uint8_t Variant;
+
+        bool operator==(const TileKey& other) const
+        {
+            return X == other.X && Y == other.Y && DpiX == other.DpiX && DpiY == other.DpiY && DpiWidth == other.DpiWidth
+                && DpiHeight == other.DpiHeight && ViewFlags == other.ViewFlags && Settings == other.Settings
+                && Zoom == other.Zoom && Rotation == other.Rotation && Variant == other.Variant;
+        }
+    };
+
+    struct TileKeyHash
+    {
+        size_t operator()(const TileKey& key) const
+        {
+            size_t hash = 0;
+            auto combine = [&hash](uint64_t value) {
+                hash ^= std::hash<uint64_t>()(value) + 0x9E3779B9 + (hash << 6) + (hash >> 2);
+            };
+            combine((static_cast<uint64_t>(key.X) << 32) | static_cast<uint32_t>(key.Y));
+            combine((static_cast<uint64_t>(key.DpiX) << 32) | static_cast<uint32_t>(key.DpiY));
+            combine((static_cast<uint64_t>(key.DpiWidth) << 32) | static_cast<uint32_t>(key.DpiHeight));
+            combine((static_cast<uint64_t>(key.ViewFlags) << 32) | key.Settings);
+            combine((static_cast<uint32_t>(key.Zoom) << 16) | (key.Rotation << 8) | key.Variant);
+            return hash;
+        }
+    };
+
+    // Viewport columns are painted on several threads, so the recordings are split over independently locked shards.
+    constexpr size_t ShardCount = 16;
+    // Recordings kept per shard before the shard is emptied, bounds the memory used when scrolling around big parks.
+    constexpr size_t MaxRecordingsPerShard = 16384;
+
+    struct Shard
+    {
+        std::mutex Mutex;
+        std::unordered_map<TileKey, std::shared_ptr<const TileRecording>, TileKeyHash> Recordings;
+    };
+} // namespace
+
+static std::array<Shard, ShardCount> _shards;
+static std::array<std::atomic<uint32_t>, MAXIMUM_MAP_SIZE_TECHNICAL * MAXIMUM_MAP_SIZE_TECHNICAL> _tileVersions;
+static std::atomic<uint64_t> _hits;
+static std::atomic<uint64_t> _misses;
+static std::atomic<uint64_t> _skipped;
+
+static std::atomic<uint32_t>* GetTileVersion(const CoordsXY& mapCoords)
+{
+    auto tileCoords = TileCoordsXY(mapCoords);
+    if (tileCoords.x < 0 || tileCoords.y < 0 || tileCoords.x >= MAXIMUM_MAP_SIZE_TECHNICAL
+        || tileCoords.y >= MAXIMUM_MAP_SIZE_TECHNICAL)
+    {
+        return nullptr;
+    }
+    return &_tileVersions[tileCoords.y * MAXIMUM_MAP_SIZE_TECHNICAL + tileCoords.x];
+}
+
+/**
+ * Whether anything besides the tile itself, the key and the neighbouring tiles affects how the tile is painted.
+ */
+static bool CanUseCache(const paint_session* session)
+{
+    if (!gConfigGeneral.paint_tile_cache)
+        return false;
+    if (session->ViewFlags & VIEWPORT_FLAG_CLIP_VIEW)
+        return false;
+    if (gMapSelectFlags != 0 || gStaffDrawPatrolAreas != SPRITE_INDEX_NULL || gTrackDesignSaveMode)
+        return false;
+    if (gShowSupportSegmentHeights || gPaintBlockedTiles || gPaintWidePathsAsGhost)
+        return false;
+    if (gConfigGeneral.virtual_floor_style != VirtualFloorStyles::Off && virtual_floor_is_enabled())
+        return false;
+    return true;
+}
+
+static bool TileElementIsStatic(const TileElement& tileElement)
+{
+    switch (tileElement.GetType())
+    {
+        case TILE_ELEMENT_TYPE_SURFACE:
+            return true;
+        case TILE_ELEMENT_TYPE_PATH:
+            // Queues show the scrolling name and state of their ride.
+            return !tileElement.AsPath()->IsQueue();
+        case TILE_ELEMENT_TYPE_SMALL_SCENERY:
+        {
+            auto* entry = tileElement.AsSmallScenery()->GetEntry();
+            return entry != nullptr && !scenery_small_entry_has_flag(entry, SMALL_SCENERY_FLAG_ANIMATED);
+        }
+        case TILE_ELEMENT_TYPE_LARGE_SCENERY:
+        {
+            auto* entry = tileElement.AsLargeScenery()->GetEntry();
+            return entry != nullptr && !(entry->large_scenery.flags & LARGE_SCENERY_FLAG_3D_TEXT);
+        }
+        case TILE_ELEMENT_TYPE_WALL:
+        {
+            auto* entry = tileElement.AsWall()->GetEntry();
+            return entry != nullptr && !(entry->wall.flags2 & WALL_SCENERY_2_ANIMATED)
+                && entry->wall.scrolling_mode == SCROLLING_MODE_NONE;
+        }
+        default:
+            return false;
+    }
+}
+
+static bool TileIsStatic(const TileElement* tileElement, int32_t& elementCount)
+{
+    elementCount = 0;
+    do
+    {
+        elementCount++;
+        if (!TileElementIsStatic(*tileElement))
+        {
+            return false;
+        }
+    } while (!(tileElement++)->IsLastForTile());
+    return true;
+}
+
+static TileKey MakeKey(const paint_session* session, const CoordsXY& mapCoords)
+{
+    TileKey key{};
+    key.X = mapCoords.x;
+    key.Y = mapCoords.y;
+    key.DpiX = session->DPI.x;
+    key.DpiY = session->DPI.y;
+    key.DpiWidth = session->DPI.width;
+    key.DpiHeight = session->DPI.height;
+    key.ViewFlags = session->ViewFlags;
+    key.Settings = gScreenFlags | (gCheatsSandboxMode ? 1 << 8 : 0) | (gConfigGeneral.landscape_smoothing ? 1 << 9 : 0);
+    key.Zoom = static_cast<int8_t>(session->DPI.zoom_level);
+    key.Rotation = session->CurrentRotation;
+    key.Variant = session->Unk141E9DB;
+    return key;
+}
+
+static Shard& GetShard(const TileKey& key)
+{
+    return _shards[TileKeyHash()(key) % ShardCount];
+}
+
+static int32_t EncodeEntry(const paint_session* session, const void* entry, size_t firstEntry)
+{
+    if (entry == nullptr)
+        return NoLink;
+
+    const auto index = session->PaintStructs.IndexOf(static_cast<const paint_entry*>(entry));
+    if (index < firstEntry || index >= session->PaintStructs.size())
+        return Unchanged;
+    return static_cast<int32_t>(index - firstEntry);
+}
+
+static int32_t EncodeElement(const void* element, const TileElement* firstElement, int32_t elementCount)
+{
+    if (element == nullptr)
+        return NoLink;
+
+    const auto offset = static_cast<const TileElement*>(element) - firstElement;
+    if (offset < 0 || offset >= elementCount)
+        return Unchanged;
+    return static_cast<int32_t>(offset);
+}
+
+/**
+ * Paints the tile and converts what it emitted into a recording that no longer points into the session. Returns
+ * nullptr when the tile touched entries of earlier tiles or emitted something that cannot be replayed.
+ */
+static std::shared_ptr<TileRecording> RecordTile(
+    paint_session* session, const CoordsXY& mapCoords, PaintTileFunc paintTile, const TileElement* firstElement,
+    int32_t elementCount)
+{
+    thread_local PaintTileRecorder recorder;
+    recorder.Kinds.clear();
+    recorder.QuadrantOrder.clear();
+
+    // Painters may link new entries to the last entries of the previous tile, which a replay cannot reproduce.
+    auto* lastPS = session->LastPS;
+    auto* lastAttachedPS = session->LastAttachedPS;
+    auto* prependTo = session->WoodenSupportsPrependTo;
+    auto* lastPSChildren = lastPS != nullptr ? lastPS->children : nullptr;
+    auto* lastPSAttached = lastPS != nullptr ? lastPS->attached_ps : nullptr;
+    auto* lastAttachedNext = lastAttachedPS != nullptr ? lastAttachedPS->next : nullptr;
+    auto* prependToChildren = prependTo != nullptr ? prependTo->children : nullptr;
+    auto* surfaceElement = session->SurfaceElement;
+    const auto firstEntry = session->PaintStructs.size();
+
+    session->TileRecorder = &recorder;
+    paintTile(session, mapCoords.x, mapCoords.y);
+    session->TileRecorder = nullptr;
+
+    if ((lastPS != nullptr && (lastPS->children != lastPSChildren || lastPS->attached_ps != lastPSAttached))
+        || (lastAttachedPS != nullptr && lastAttachedPS->next != lastAttachedNext)
+        || (prependTo != nullptr && prependTo->children != prependToChildren)
+        || session->WoodenSupportsPrependTo != prependTo)
+    {
+        return nullptr;
+    }
+
+    const auto entryCount = session->PaintStructs.size() - firstEntry;
+    if (entryCount != recorder.Kinds.size() || entryCount > std::numeric_limits<uint16_t>::max())
+    {
+        return nullptr;
+    }
+
+    auto recording = std::make_shared<TileRecording>();
+    recording->Entries.resize(entryCount);
+    for (size_t i = 0; i < entryCount; i++)
+    {
+        auto& recorded = recording->Entries[i];
+        recorded.Data = session->PaintStructs[firstEntry + i];
+        recorded.Kind = recorder.Kinds[i];
+        recorded.Links[0] = NoLink;
+        recorded.Links[1] = NoLink;
+        recorded.ElementOffset = NoLink;
+        switch (recorded.Kind)
+        {
+            case PaintTileEntryKind::Normal:
+            {
+                auto& ps = recorded.Data.basic;
+                recorded.Links[0] = EncodeEntry(session, ps.attached_ps, firstEntry);
+                recorded.Links[1] = EncodeEntry(session, ps.children, firstEntry);
+                recorded.ElementOffset = EncodeElement(ps.tileElement, firstElement, elementCount);
+                ps.attached_ps = nullptr;
+                ps.children = nullptr;
+                ps.next_quadrant_ps = nullptr;
+                ps.tileElement = nullptr;
+                break;
+            }
+            case PaintTileEntryKind::Attached:
+                recorded.Links[0] = EncodeEntry(session, recorded.Data.attached.next, firstEntry);
+                recorded.Data.attached.next = nullptr;
+                break;
+            case PaintTileEntryKind::String:
+                return nullptr;
+        }
+        if (recorded.Links[0] == Unchanged || recorded.Links[1] == Unchanged || recorded.ElementOffset == Unchanged)
+        {
+            return nullptr;
+        }
+    }
+
+    recording->QuadrantOrder.reserve(recorder.QuadrantOrder.size());
+    for (auto* ps : recorder.QuadrantOrder)
+    {
+        const auto index = EncodeEntry(session, ps, firstEntry);
+        if (index < 0)
+        {
+            return nullptr;
+        }
+        recording->QuadrantOrder.push_back(static_cast<uint16_t>(index));
+    }
+
+    recording->LastPS = session->LastPS == lastPS ? Unchanged : EncodeEntry(session, session->LastPS, firstEntry);
+    recording->LastAttachedPS = session->LastAttachedPS == lastAttachedPS
+        ? Unchanged
+        : EncodeEntry(session, session->LastAttachedPS, firstEntry);
+    recording->SurfaceElement = EncodeElement(session->SurfaceElement, firstElement, elementCount);
+    if (recording->SurfaceElement == Unchanged && session->SurfaceElement != surfaceElement)
+    {
+        return nullptr;
+    }
+    return recording;
+}
+
+static void ReplayTile(
+    paint_session* session, const CoordsXY& mapCoords, const TileRecording& recording, TileElement* firstElement)
+{
+    auto& paintStructs = session->PaintStructs;
+    const auto firstEntry = paintStructs.size();
+    for (const auto& recorded : recording.Entries)
+    {
+        paintStructs.emplace_back() = recorded.Data;
+    }
+
+    auto linkedEntry = [&paintStructs, firstEntry](int32_t link) -> paint_entry* {
+        return link == NoLink ? nullptr : &paintStructs[firstEntry + link];
+    };
+    for (size_t i = 0; i < recording.Entries.size(); i++)
+    {
+        const auto& recorded = recording.Entries[i];
+        auto& entry = paintStructs[firstEntry + i];
+        if (recorded.Kind == PaintTileEntryKind::Normal)
+        {
+            auto* attached = linkedEntry(recorded.Links[0]);
+            auto* children = linkedEntry(recorded.Links[1]);
+            entry.basic.attached_ps = attached != nullptr ? &attached->attached : nullptr;
+            entry.basic.children = children != nullptr ? &children->basic : nullptr;
+            entry.basic.tileElement = recorded.ElementOffset == NoLink ? nullptr : firstElement + recorded.ElementOffset;
+        }
+        else
+        {
+            auto* next = linkedEntry(recorded.Links[0]);
+            entry.attached.next = next != nullptr ? &next->attached : nullptr;
+        }
+    }
+
+    for (auto index : recording.QuadrantOrder)
+    {
+        PaintSessionAddPSToQuadrant(session, &paintStructs[firstEntry + index].basic);
+    }
+
+    if (recording.LastPS != Unchanged)
+    {
+        auto* entry = linkedEntry(recording.LastPS);
+        session->LastPS = entry != nullptr ? &entry->basic : nullptr;
+    }
+    if (recording.LastAttachedPS != Unchanged)
+    {
+        auto* entry = linkedEntry(recording.LastAttachedPS);
+        session->LastAttachedPS = entry != nullptr ? &entry->attached : nullptr;
+    }
+    if (recording.SurfaceElement != Unchanged)
+    {
+        session->SurfaceElement = recording.SurfaceElement == NoLink ? nullptr : firstElement + recording.SurfaceElement;
+    }
+    session->MapPosition = mapCoords;
+}
+
+void PaintTileCached(paint_session* session, const CoordsXY& mapCoords, PaintTileFunc paintTile)
+{
+    TileElement* firstElement = nullptr;
+    int32_t elementCount = 0;
+    auto* tileVersion = GetTileVersion(mapCoords);
+    if (tileVersion == nullptr || !CanUseCache(session) || (firstElement = map_get_first_element_at(mapCoords)) == nullptr
+        || !TileIsStatic(firstElement, elementCount))
+    {
+        _skipped.fetch_add(1, std::memory_order_relaxed);
+        paintTile(session, mapCoords.x, mapCoords.y);
+        return;
+    }
+
+    const auto key = MakeKey(session, mapCoords);
+    const auto version = tileVersion->load(std::memory_order_acquire);
+    auto& shard = GetShard(key);
+    std::shared_ptr<const TileRecording> recording;
+    {
+        std::lock_guard<std::mutex> lock(shard.Mutex);
+        auto it = shard.Recordings.find(key);
+        if (it != shard.Recordings.end())
+        {
+            recording = it->second;
+        }
+    }
+
+    if (recording != nullptr && recording->TileVersion == version)
+    {
+        _hits.fetch_add(1, std::memory_order_relaxed);
+        ReplayTile(session, mapCoords, *recording, firstElement);
+        return;
+    }
+
+    _misses.fetch_add(1, std::memory_order_relaxed);
+    auto newRecording = RecordTile(session, mapCoords, paintTile, firstElement, elementCount);
+    if (newRecording != nullptr)
+    {
+        newRecording->TileVersion = version;
+        std::lock_guard<std::mutex> lock(shard.Mutex);
+        if (shard.Recordings.size() >= MaxRecordingsPerShard)
+        {
+            shard.Recordings.clear();
+        }
+        shard.Recordings[key] = std::move(newRecording);
+    }
+}
+
+void PaintTileCacheInvalidateTile(const CoordsXY& mapCoords)
+{
+    static constexpr const CoordsXY Neighbours[] = { { 0, 0 }, { -32, 0 }, { 32, 0 }, { 0, -32 }, { 0, 32 } };
+    const auto tileStart = mapCoords.ToTileStart();
+    for (const auto& offset : Neighbours)
+    {
+        auto* tileVersion = GetTileVersion(tileStart + offset);
+        if (tileVersion != nullptr)
+        {
+            tileVersion->fetch_add(1, std::memory_order_release);
+        }
+    }
+}
+
+void PaintTileCacheInvalidateRegion(const CoordsXY& mins, const CoordsXY& maxs)
+{
+    for (int32_t y = mins.y; y <= maxs.y; y += COORDS_XY_STEP)
+    {
+        for (int32_t x = mins.x; x <= maxs.x; x += COORDS_XY_STEP)
+        {
+            PaintTileCacheInvalidateTile({ x, y });
+        }
+    }
+}
+
+void PaintTileCacheInvalidateAll()
+{
+    for (auto& shard : _shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.Mutex);
+        shard.Recordings.clear();
+    }
+}
+
+PaintTileCacheStats PaintTileCacheGetStats()
+{
+    return { _hits.load(), _misses.load(), _skipped.load() };
+}
+
+void PaintTileCacheResetStats()
+{
+    _hits = 0;
+    _misses = 0;
+    _skipped = 0;
+}
@@ -0,0 +1,69 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../world/Location.hpp"
+
+#include <vector>
+
+struct paint_session;
+struct paint_struct;
+
+enum class PaintTileEntryKind : uint8_t
+{
+    Normal,
+    Attached,
+    String,
+};
+
+/**
+ * Collects what the tile element painters emit for one tile while the tile paint cache records it. The paint functions
+ * report every entry they allocate and every paint struct they add to a quadrant.
+ */
+struct PaintTileRecorder
+{
+    std::vector<PaintTileEntryKind> Kinds;
+    std::vector<paint_struct*> QuadrantOrder;
+
+    void OnAllocate(PaintTileEntryKind kind)
+    {
+        Kinds.push_back(kind);
+    }
+    void OnAddToQuadrant(paint_struct* ps)
+    {
+        QuadrantOrder.push_back(ps);
+    }
+};
+
+struct PaintTileCacheStats
+{
+    uint64_t Hits;
+    uint64_t Misses;
+    uint64_t Skipped;
+};
+
+using PaintTileFunc = void (*)(paint_session* session, int32_t x, int32_t y);
+
+/**
+ * Paints the tile at mapCoords through paintTile, or replays the entries the tile emitted the last time it was painted
+ * with the same rotation, zoom, view flags and clip rectangle. Tiles containing anything that animates without
+ * changing the map (rides, entrances, banners, animated scenery, queues) are always painted.
+ */
+void PaintTileCached(paint_session* session, const CoordsXY& mapCoords, PaintTileFunc paintTile);
+
+// Drops the recordings of a tile and of its neighbours, whose edges depend on it. The map only does this while the cache
+// is enabled, so enabling it has to be followed by PaintTileCacheInvalidateAll.
+void PaintTileCacheInvalidateTile(const CoordsXY& mapCoords);
+void PaintTileCacheInvalidateRegion(const CoordsXY& mins, const CoordsXY& maxs);
+void PaintTileCacheInvalidateAll();
+
+PaintTileCacheStats PaintTileCacheGetStats();
+void PaintTileCacheResetStats();
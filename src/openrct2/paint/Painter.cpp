@@ -25,6 +25,8 @@
 #include "../title/TitleScreen.h"
 #include "../ui/UiContext.h"
 
+#include <algorithm>
+
 using namespace OpenRCT2;
 using namespace OpenRCT2::Drawing;
 using namespace OpenRCT2::Paint;
@@ -78,6 +80,7 @@ void Painter::Paint(IDrawingEngine& de)
         PaintFPS(dpi);
     }
     gCurrentDrawCount++;
+    _stats.Frames++;
 }
 
 void Painter::PaintReplayNotice(rct_drawpixelinfo* dpi, const char* text)
@@ -161,11 +164,25 @@ paint_session* Painter::CreateSession(rct_drawpixelinfo* dpi, uint32_t viewFlags
     session->WoodenSupportsPrependTo = nullptr;
     session->CurrentlyDrawnItem = nullptr;
     session->SurfaceElement = nullptr;
+    session->TileRecorder = nullptr;
 
     return session;
 }
 
 void Painter::ReleaseSession(paint_session* session)
 {
+    _stats.Entries += session->PaintStructs.size();
+    _stats.PeakSessionEntries = std::max(_stats.PeakSessionEntries, session->PaintStructs.GetPeakSize());
+    _stats.ArenaGrowths += session->PaintStructs.TakeGrowCount();
     _freePaintSessions.push_back(session);
 }
+
+const PaintStats& Painter::GetStats() const
+{
+    return _stats;
+}
+
+void Painter::ResetStats()
+{
+    _stats = {};
+}
@@ -32,6 +32,17 @@ namespace OpenRCT2
 
     namespace Paint
     {
+        struct PaintStats
+        {
+            // Frames painted and paint entries allocated by the sessions released in them.
+            uint64_t Frames;
+            uint64_t Entries;
+            // Most entries a single session used.
+            size_t PeakSessionEntries;
+            // Chunks the sessions had to allocate to fit their entries.
+            uint64_t ArenaGrowths;
+        };
+
         struct Painter final
         {
         private:
@@ -41,6 +52,7 @@ namespace OpenRCT2
             time_t _lastSecond = 0;
             int32_t _currentFPS = 0;
             int32_t _frames = 0;
+            PaintStats _stats = {};
 
         public:
             explicit Painter(const std::shared_ptr<Ui::IUiContext>& uiContext);
@@ -49,6 +61,9 @@ namespace OpenRCT2
             paint_session* CreateSession(rct_drawpixelinfo* dpi, uint32_t viewFlags);
             void ReleaseSession(paint_session* session);
 
+            const PaintStats& GetStats() const;
+            void ResetStats();
+
         private:
             void PaintReplayNotice(rct_drawpixelinfo* dpi, const char* text);
             void PaintFPS(rct_drawpixelinfo* dpi);
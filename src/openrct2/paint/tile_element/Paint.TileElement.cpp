@@ -26,6 +26,7 @@
 #include "../../world/Sprite.h"
 #include "../../world/Surface.h"
 #include "../Paint.h"
+#include "../PaintTileCache.h"
 #include "../Supports.h"
 #include "../VirtualFloor.h"
 #include "Paint.Surface.h"
@@ -38,6 +39,7 @@ uint16_t testPaintVerticalTunnelHeight;
 
 static void blank_tiles_paint(paint_session* session, int32_t x, int32_t y);
 static void sub_68B3FB(paint_session* session, int32_t x, int32_t y);
+static void paint_tile(paint_session* session, int32_t x, int32_t y);
 
 const int32_t SEGMENTS_ALL = SEGMENT_B4 | SEGMENT_B8 | SEGMENT_BC | SEGMENT_C0 | SEGMENT_C4 | SEGMENT_C8 | SEGMENT_CC
     | SEGMENT_D0 | SEGMENT_D4;
@@ -55,7 +57,7 @@ void tile_element_paint_setup(paint_session* session, int32_t x, int32_t y)
         session->Unk141E9DB = 0;
         session->WaterHeight = 0xFFFF;
 
-        sub_68B3FB(session, x, y);
+        paint_tile(session, x, y);
     }
     else if (!(session->ViewFlags & VIEWPORT_FLAG_TRANSPARENT_BACKGROUND))
     {
@@ -76,7 +78,7 @@ void sub_68B2B7(paint_session* session, const CoordsXY& mapCoords)
         session->WaterHeight = 0xFFFF;
         session->Unk141E9DB = G141E9DB_FLAG_2;
 
-        sub_68B3FB(session, mapCoords.x, mapCoords.y);
+        paint_tile(session, mapCoords.x, mapCoords.y);
     }
     else if (!(session->ViewFlags & VIEWPORT_FLAG_TRANSPARENT_BACKGROUND))
     {
@@ -84,6 +86,15 @@ void sub_68B2B7(paint_session* session, const CoordsXY& mapCoords)
     }
 }
 
+static void paint_tile(paint_session* session, int32_t x, int32_t y)
+{
+#ifndef __TESTPAINT__
+    PaintTileCached(session, { x, y }, sub_68B3FB);
+#else
+    sub_68B3FB(session, x, y);
+#endif // __TESTPAINT__
+}
+
 /**
  *
  *  rct2: 0x0068B60E
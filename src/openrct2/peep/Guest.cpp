@@ -33,11 +33,14 @@
 #include "../world/LargeScenery.h"
 #include "../world/Map.h"
 #include "../world/Park.h"
+#include "../world/RidePresence.h"
 #include "../world/Scenery.h"
 #include "../world/Sprite.h"
 #include "../world/Surface.h"
 #include "../world/TileElementsView.h"
 #include "GuestPathfinding.h"
+#include "GuestPrecompute.h"
+#include "GuestSurroundings.h"
 #include "Peep.h"
 #include "Staff.h"
 
@@ -222,7 +225,6 @@ static void peep_update_ride_nausea_growth(Peep* peep, Ride* ride);
 static bool peep_should_go_on_ride_again(Peep* peep, Ride* ride);
 static bool peep_should_preferred_intensity_increase(Peep* peep);
 static bool peep_really_liked_ride(Peep* peep, Ride* ride);
-static PeepThoughtType peep_assess_surroundings(int16_t centre_x, int16_t centre_y, int16_t centre_z);
 static void peep_update_hunger(Peep* peep);
 static void peep_decide_whether_to_leave_park(Peep* peep);
 static void peep_leave_park(Peep* peep);
@@ -675,10 +677,31 @@ void Guest::loc_68FA89()
     }
 }
 
+// Results of the parallel guest update phase for the guest running its 128 tick update, null unless it is enabled.
+static const GuestPrecomputedTick* _tickPrecomputed = nullptr;
+
+namespace
+{
+    struct TickPrecomputedScope
+    {
+        TickPrecomputedScope(uint16_t spriteIndex, int32_t updateIndex)
+        {
+            _tickPrecomputed = guest_precompute_find(spriteIndex, updateIndex);
+        }
+
+        ~TickPrecomputedScope()
+        {
+            _tickPrecomputed = nullptr;
+        }
+    };
+} // namespace
+
 void Guest::Tick128UpdateGuest(int32_t index)
 {
     if (static_cast<uint32_t>(index & 0x1FF) == (gCurrentTicks & 0x1FF))
     {
+        TickPrecomputedScope precomputedScope(sprite_index, index);
+
         /* Effect of masking with 0x1FF here vs mask 0x7F,
          * which is the condition for calling this function, is
          * to reduce how often the content in this conditional
@@ -745,7 +768,17 @@ void Guest::Tick128UpdateGuest(int32_t index)
                 SurroundingsThoughtTimeout = 0;
                 if (x != LOCATION_NULL)
                 {
-                    PeepThoughtType thought_type = peep_assess_surroundings(x & 0xFFE0, y & 0xFFE0, z);
+                    const CoordsXYZ centre = { x & 0xFFE0, y & 0xFFE0, z };
+                    PeepThoughtType thought_type;
+                    if (_tickPrecomputed != nullptr && _tickPrecomputed->HasSurroundings
+                        && _tickPrecomputed->SurroundingsLocation == centre)
+                    {
+                        thought_type = _tickPrecomputed->Surroundings;
+                    }
+                    else
+                    {
+                        thought_type = peep_assess_surroundings(centre.x, centre.y, centre.z);
+                    }
 
                     if (thought_type != PeepThoughtType::None)
                     {
@@ -1620,7 +1653,16 @@ void Guest::PickRideToGoOn()
 Ride* Guest::FindBestRideToGoOn()
 {
     // Pick the most exciting ride
-    auto rideConsideration = FindRidesToGoOn();
+    std::bitset<MAX_RIDES> rideConsideration;
+    if (_tickPrecomputed != nullptr && _tickPrecomputed->SpriteIndex == sprite_index && _tickPrecomputed->HasRideConsideration
+        && _tickPrecomputed->RidesLocation == CoordsXY{ x, y } && _tickPrecomputed->RidesHasMap == HasItem(ShopItem::Map))
+    {
+        rideConsideration = _tickPrecomputed->RideConsideration;
+    }
+    else
+    {
+        rideConsideration = FindRidesToGoOn();
+    }
     Ride* mostExcitingRide = nullptr;
     for (auto& ride : GetRideManager())
     {
@@ -1662,33 +1704,10 @@ std::bitset<MAX_RIDES> Guest::FindRidesToGoOn()
     else
     {
         // Take nearby rides into consideration
-        constexpr auto radius = 10 * 32;
-        int32_t cx = floor2(x, 32);
-        int32_t cy = floor2(y, 32);
-        for (int32_t tileX = cx - radius; tileX <= cx + radius; tileX += COORDS_XY_STEP)
-        {
-            for (int32_t tileY = cy - radius; tileY <= cy + radius; tileY += COORDS_XY_STEP)
-            {
-                auto location = CoordsXY{ tileX, tileY };
-                if (!map_is_location_valid(location))
-                    continue;
-
-                for (auto* trackElement : TileElementsView<TrackElement>(location))
-                {
-                    auto rideIndex = trackElement->GetRideIndex();
-                    rideConsideration[rideIndex] = true;
-                }
-            }
-        }
+        rideConsideration = ride_presence_get_nearby({ x, y });
 
         // Always take the tall rides into consideration (realistic as you can usually see them from anywhere in the park)
-        for (auto& ride : GetRideManager())
-        {
-            if (ride.highest_drop_height > 66 || ride.excitement >= RIDE_RATING(8, 00))
-            {
-                rideConsideration[ride.id] = true;
-            }
-        }
+        rideConsideration |= ride_presence_get_tall_rides();
     }
 
     return rideConsideration;
@@ -2664,121 +2683,6 @@ static bool peep_really_liked_ride(Peep* peep, Ride* ride)
     return true;
 }
 
-/**
- *
- *  rct2: 0x0069BC9A
- */
-static PeepThoughtType peep_assess_surroundings(int16_t centre_x, int16_t centre_y, int16_t centre_z)
-{
-    if ((tile_element_height({ centre_x, centre_y })) > centre_z)
-        return PeepThoughtType::None;
-
-    uint16_t num_scenery = 0;
-    uint16_t num_fountains = 0;
-    uint16_t nearby_music = 0;
-    uint16_t num_rubbish = 0;
-
-    int16_t initial_x = std::max(centre_x - 160, 0);
-    int16_t initial_y = std::max(centre_y - 160, 0);
-    int16_t final_x = std::min(centre_x + 160, MAXIMUM_MAP_SIZE_BIG);
-    int16_t final_y = std::min(centre_y + 160, MAXIMUM_MAP_SIZE_BIG);
-
-    for (int16_t x = initial_x; x < final_x; x += COORDS_XY_STEP)
-    {
-        for (int16_t y = initial_y; y < final_y; y += COORDS_XY_STEP)
-        {
-            for (auto* tileElement : TileElementsView({ x, y }))
-            {
-                Ride* ride;
-                rct_scenery_entry* scenery;
-
-                switch (tileElement->GetType())
-                {
-                    case TILE_ELEMENT_TYPE_PATH:
-                        if (!tileElement->AsPath()->HasAddition())
-                            break;
-
-                        scenery = tileElement->AsPath()->GetAdditionEntry();
-                        if (scenery == nullptr)
-                        {
-                            return PeepThoughtType::None;
-                        }
-                        if (tileElement->AsPath()->AdditionIsGhost())
-                            break;
-
-                        if (scenery->path_bit.flags
-                            & (PATH_BIT_FLAG_JUMPING_FOUNTAIN_WATER | PATH_BIT_FLAG_JUMPING_FOUNTAIN_SNOW))
-                        {
-                            num_fountains++;
-                            break;
-                        }
-                        if (tileElement->AsPath()->IsBroken())
-                        {
-                            num_rubbish++;
-                        }
-                        break;
-                    case TILE_ELEMENT_TYPE_LARGE_SCENERY:
-                    case TILE_ELEMENT_TYPE_SMALL_SCENERY:
-                        num_scenery++;
-                        break;
-                    case TILE_ELEMENT_TYPE_TRACK:
-                        ride = get_ride(tileElement->AsTrack()->GetRideIndex());
-                        if (ride != nullptr)
-                        {
-                            if (ride->lifecycle_flags & RIDE_LIFECYCLE_MUSIC && ride->status != RIDE_STATUS_CLOSED
-                                && !(ride->lifecycle_flags & (RIDE_LIFECYCLE_BROKEN_DOWN | RIDE_LIFECYCLE_CRASHED)))
-                            {
-                                if (ride->type == RIDE_TYPE_MERRY_GO_ROUND)
-                                {
-                                    nearby_music |= 1;
-                                    break;
-                                }
-
-                                if (ride->music == MUSIC_STYLE_ORGAN)
-                                {
-                                    nearby_music |= 1;
-                                    break;
-                                }
-
-                                if (ride->type == RIDE_TYPE_DODGEMS)
-                                {
-                                    // Dodgems drown out music?
-                                    nearby_music |= 2;
-                                }
-                            }
-                        }
-                        break;
-                }
-            }
-        }
-    }
-
-    for (auto litter : EntityList<Litter>())
-    {
-        int16_t dist_x = abs(litter->x - centre_x);
-        int16_t dist_y = abs(litter->y - centre_y);
-        if (std::max(dist_x, dist_y) <= 160)
-        {
-            num_rubbish++;
-        }
-    }
-
-    if (num_fountains >= 5 && num_rubbish < 20)
-        return PeepThoughtType::Fountains;
-
-    if (num_scenery >= 40 && num_rubbish < 8)
-        return PeepThoughtType::Scenery;
-
-    if (nearby_music == 1 && num_rubbish < 20)
-        return PeepThoughtType::Music;
-
-    if (num_rubbish < 2 && !gCheatsDisableLittering)
-        // if disable littering cheat is enabled, peeps will not have the "clean and tidy park" thought
-        return PeepThoughtType::VeryClean;
-
-    return PeepThoughtType::None;
-}
-
 /**
  *
  *  rct2: 0x0068F9A9
@@ -5911,6 +5815,8 @@ static void peep_update_walking_break_scenery(Peep* peep)
     }
 
     tileElement->SetIsBroken(true);
+    guest_precompute_invalidate(peep->NextLoc);
+    surroundings_invalidate_tile(peep->NextLoc);
 
     map_invalidate_tile_zoom1({ peep->NextLoc, tileElement->GetBaseZ(), tileElement->GetBaseZ() + 32 });
 
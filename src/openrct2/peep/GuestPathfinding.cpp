@@ -17,6 +17,7 @@
 #include "../util/Util.h"
 #include "../world/Entrance.h"
 #include "../world/Footpath.h"
+#include "GuestPathfindingCache.h"
 #include "Peep.h"
 #include "Staff.h"
 
@@ -111,7 +112,7 @@ static int32_t banner_clear_path_edges(PathElement* pathElement, int32_t edges)
 /**
  * Gets the connected edges of a path that are permitted (i.e. no 'no entry' signs)
  */
-static int32_t path_get_permitted_edges(PathElement* pathElement)
+int32_t path_get_permitted_edges(PathElement* pathElement)
 {
     return banner_clear_path_edges(pathElement, pathElement->GetEdgesAndCorners()) & 0x0F;
 }
@@ -1421,8 +1422,18 @@ Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
 
     int32_t chosen_edge = bitscanforward(edges);
 
+    Direction fieldEdge = INVALID_DIRECTION;
+    if ((edges & ~(1 << chosen_edge)) && !peep->Is<Staff>() && pathfinding_cache_is_enabled())
+    {
+        fieldEdge = pathfinding_cache_choose_direction(loc, edges);
+    }
+
+    if (fieldEdge != INVALID_DIRECTION)
+    {
+        chosen_edge = fieldEdge;
+    }
     // Peep has multiple edges still to try.
-    if (edges & ~(1 << chosen_edge))
+    else if (edges & ~(1 << chosen_edge))
     {
         uint16_t best_score = 0xFFFF;
         uint8_t best_sub = 0xFF;
@@ -1798,6 +1809,10 @@ static int32_t guest_path_find_park_entrance(Peep* peep, uint8_t edges)
  *
  * In case where the map element at (x, y) is invalid or there is no entrance
  * or queue leading to it the function will not update its arguments.
+ *
+ * This walks the tiles rather than the footpath graph: the walk only visits the queue itself, and it follows
+ * ghost queues and queues behind 'no entry' banners and goes straight on at forks, none of which the graph's
+ * segments describe.
  */
 static void get_ride_queue_end(TileCoordsXYZ& loc)
 {
@@ -16,6 +16,7 @@
 struct Peep;
 struct Guest;
 struct TileElement;
+struct PathElement;
 
 // The tile position of the place the peep is trying to get to (park entrance/exit, ride
 // entrance/exit, or the end of the queue line for a ride).
@@ -41,6 +42,9 @@ extern bool gPeepPathFindIgnoreForeignQueues;
 // the direction the peep should walk in from the current tile.
 Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep);
 
+// Gets the connected edges of a path that are not blocked by a 'no entry' banner.
+int32_t path_get_permitted_edges(PathElement* pathElement);
+
 // Test whether the given tile can be walked onto, if the peep is currently at height currentZ and
 // moving in direction currentDirection.
 bool IsValidPathZAndDirection(TileElement* tileElement, int32_t currentZ, int32_t currentDirection);
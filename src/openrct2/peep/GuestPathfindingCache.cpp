@@ -0,0 +1,239 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "GuestPathfindingCache.h"
+
+#include "../config/Config.h"
+#include "../network/network.h"
+#include "../world/FootpathGraph.h"
+#include "GuestPathfinding.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+// Fields kept at once, the least recently used one is dropped to make room for a new goal.
+static constexpr size_t MAX_DISTANCE_FIELDS = 64;
+
+namespace
+{
+    struct DistanceFieldKey
+    {
+        TileCoordsXYZ Goal;
+        ride_id_t QueueRideIndex;
+        bool IgnoreForeignQueues;
+
+        bool operator==(const DistanceFieldKey& other) const
+        {
+            return Goal == other.Goal && QueueRideIndex == other.QueueRideIndex
+                && IgnoreForeignQueues == other.IgnoreForeignQueues;
+        }
+    };
+
+    struct DistanceField
+    {
+        DistanceFieldKey Key;
+        // Steps to the goal from each junction, keyed by packed position.
+        std::unordered_map<uint32_t, uint32_t> Distances;
+        // Generation of the footpath graph the field was built from.
+        uint32_t Generation = 0;
+        uint64_t LastUsed = 0;
+    };
+} // namespace
+
+static std::vector<std::unique_ptr<DistanceField>> _fields;
+static uint64_t _useCounter = 0;
+static PathfindingCacheStats _stats = {};
+
+static uint32_t pathfinding_cache_pack(const TileCoordsXYZ& loc)
+{
+    return (static_cast<uint32_t>(loc.x) << 20) | (static_cast<uint32_t>(loc.y) << 10) | static_cast<uint32_t>(loc.z);
+}
+
+/**
+ * Guests do not walk through queues of other rides when ignoring them, mirroring the search which only stops at
+ * such a queue when it is not a junction.
+ */
+static bool pathfinding_cache_is_blocked(const DistanceFieldKey& key, const FootpathGraphSegment& segment)
+{
+    if (!key.IgnoreForeignQueues || segment.QueueRide == RIDE_ID_NULL)
+        return false;
+    return segment.QueueRide != key.QueueRideIndex || segment.HasMultipleQueueRides;
+}
+
+/**
+ * Steps along the segment to the goal, if the goal is on it.
+ */
+static std::optional<uint32_t> pathfinding_cache_steps_to_goal(
+    const DistanceFieldKey& key, const FootpathGraphSegment& segment)
+{
+    auto it = std::find(segment.Tiles.begin(), segment.Tiles.end(), key.Goal);
+    if (it != segment.Tiles.end())
+        return static_cast<uint32_t>(std::distance(segment.Tiles.begin(), it) + 1);
+    if (segment.End == key.Goal && !pathfinding_cache_is_blocked(key, segment))
+        return segment.Length;
+    return std::nullopt;
+}
+
+/**
+ * Walks the junction graph backwards from the goal, the distance of a junction is the shortest segment leading
+ * to the goal or to a junction already in the field plus that junction's distance.
+ */
+static void pathfinding_cache_build(DistanceField& field)
+{
+    const auto& key = field.Key;
+    using Entry = std::pair<uint32_t, uint32_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    std::unordered_map<uint32_t, std::vector<Entry>> incoming;
+
+    field.Distances.clear();
+    field.Generation = footpath_graph_get_generation();
+    for (const auto& node : footpath_graph_get_nodes())
+    {
+        const auto nodeKey = pathfinding_cache_pack(node.Loc);
+        if (node.Loc == key.Goal)
+        {
+            open.emplace(0, nodeKey);
+        }
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            if (!(node.Edges & (1 << direction)))
+                continue;
+
+            const auto& segment = node.Segments[direction];
+            if (auto steps = pathfinding_cache_steps_to_goal(key, segment))
+            {
+                open.emplace(*steps, nodeKey);
+            }
+            else if (segment.EndsAtJunction && !pathfinding_cache_is_blocked(key, segment))
+            {
+                incoming[pathfinding_cache_pack(segment.End)].emplace_back(segment.Length, nodeKey);
+            }
+        }
+    }
+
+    while (!open.empty())
+    {
+        const auto [distance, nodeKey] = open.top();
+        open.pop();
+        if (!field.Distances.emplace(nodeKey, distance).second)
+            continue;
+
+        auto it = incoming.find(nodeKey);
+        if (it == incoming.end())
+            continue;
+        for (const auto& [length, fromKey] : it->second)
+        {
+            if (field.Distances.find(fromKey) == field.Distances.end())
+            {
+                open.emplace(distance + length, fromKey);
+            }
+        }
+    }
+    _stats.FieldsBuilt++;
+}
+
+static DistanceField& pathfinding_cache_get_field(const DistanceFieldKey& key)
+{
+    _useCounter++;
+    for (auto& field : _fields)
+    {
+        if (field->Key == key)
+        {
+            field->LastUsed = _useCounter;
+            if (field->Generation != footpath_graph_get_generation())
+            {
+                pathfinding_cache_build(*field);
+            }
+            return *field;
+        }
+    }
+
+    if (_fields.size() >= MAX_DISTANCE_FIELDS)
+    {
+        auto leastRecent = std::min_element(_fields.begin(), _fields.end(), [](const auto& a, const auto& b) {
+            return a->LastUsed < b->LastUsed;
+        });
+        _fields.erase(leastRecent);
+    }
+
+    auto field = std::make_unique<DistanceField>();
+    field->Key = key;
+    field->LastUsed = _useCounter;
+    pathfinding_cache_build(*field);
+    _fields.push_back(std::move(field));
+    return *_fields.back();
+}
+
+bool pathfinding_cache_is_enabled()
+{
+    return gConfigGeneral.guest_pathfinding_distance_fields && network_get_mode() == NETWORK_MODE_NONE;
+}
+
+Direction pathfinding_cache_choose_direction(const TileCoordsXYZ& loc, uint8_t edges)
+{
+    const auto* node = footpath_graph_get_node(loc);
+    if (node == nullptr)
+    {
+        _stats.Misses++;
+        return INVALID_DIRECTION;
+    }
+
+    const DistanceFieldKey key{ gPeepPathFindGoalPosition, gPeepPathFindQueueRideIndex, gPeepPathFindIgnoreForeignQueues };
+    const auto& field = pathfinding_cache_get_field(key);
+
+    Direction bestDirection = INVALID_DIRECTION;
+    uint32_t bestDistance = std::numeric_limits<uint32_t>::max();
+    for (Direction direction : ALL_DIRECTIONS)
+    {
+        if (!(edges & node->Edges & (1 << direction)))
+            continue;
+
+        const auto& segment = node->Segments[direction];
+        auto distance = pathfinding_cache_steps_to_goal(key, segment);
+        if (!distance.has_value() && segment.EndsAtJunction && !pathfinding_cache_is_blocked(key, segment))
+        {
+            auto it = field.Distances.find(pathfinding_cache_pack(segment.End));
+            if (it != field.Distances.end())
+            {
+                distance = segment.Length + it->second;
+            }
+        }
+        if (distance.has_value() && *distance < bestDistance)
+        {
+            bestDistance = *distance;
+            bestDirection = direction;
+        }
+    }
+
+    if (bestDirection == INVALID_DIRECTION)
+    {
+        _stats.Misses++;
+    }
+    else
+    {
+        _stats.Hits++;
+    }
+    return bestDirection;
+}
+
+PathfindingCacheStats pathfinding_cache_get_stats()
+{
+    return _stats;
+}
+
+void pathfinding_cache_reset_stats()
+{
+    _stats = {};
+}
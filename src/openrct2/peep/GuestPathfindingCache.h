@@ -0,0 +1,40 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../world/Location.hpp"
+
+/**
+ * Distance fields for guest pathfinding. A field holds the number of steps from every junction of the footpath
+ * graph to one goal, found by walking the graph backwards from the goal. Guests heading for the same goal share
+ * it, so a junction decision becomes a lookup of the segments leaving the junction instead of a heuristic search.
+ *
+ * Fields are built again when the footpath graph changes. This changes how guests walk, so it is only used when
+ * enabled through the guest_pathfinding_distance_fields option and never in network games.
+ */
+bool pathfinding_cache_is_enabled();
+
+/**
+ * Picks the edge out of edges that leads closest to gPeepPathFindGoalPosition for a guest standing on the
+ * junction at loc. Returns INVALID_DIRECTION when loc is not a junction or none of the edges is known to lead to
+ * the goal, in which case the heuristic search should be used.
+ */
+Direction pathfinding_cache_choose_direction(const TileCoordsXYZ& loc, uint8_t edges);
+
+struct PathfindingCacheStats
+{
+    uint64_t FieldsBuilt;
+    uint64_t Hits;
+    uint64_t Misses;
+};
+
+PathfindingCacheStats pathfinding_cache_get_stats();
+void pathfinding_cache_reset_stats();
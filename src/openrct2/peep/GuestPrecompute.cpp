@@ -0,0 +1,133 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "GuestPrecompute.h"
+
+#include "../Game.h"
+#include "../core/TaskScheduler.h"
+#include "../ride/Ride.h"
+#include "../world/EntityList.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace OpenRCT2;
+
+// Distance from the assessed tile at which litter and path additions are counted by peep_assess_surroundings.
+static constexpr int32_t SURROUNDINGS_RADIUS = 160;
+
+static std::vector<GuestPrecomputedTick> _precomputed;
+
+static bool guest_precompute_wants_surroundings(const Guest& guest)
+{
+    if (guest.State != PeepState::Walking && guest.State != PeepState::Sitting)
+        return false;
+    if (guest.x == LOCATION_NULL)
+        return false;
+    // Surroundings are only assessed when the timeout is about to expire.
+    return guest.SurroundingsThoughtTimeout + 1 >= 18;
+}
+
+static bool guest_precompute_wants_rides(const Guest& guest)
+{
+    // Same early outs as Guest::PickRideToGoOn.
+    if (guest.State != PeepState::Walking)
+        return false;
+    if (guest.GuestHeadingToRideId != RIDE_ID_NULL)
+        return false;
+    if (guest.PeepFlags & PEEP_FLAGS_LEAVING_PARK)
+        return false;
+    if (guest.HasFoodOrDrink())
+        return false;
+    return guest.x != LOCATION_NULL;
+}
+
+static void guest_precompute_entry(GuestPrecomputedTick& entry)
+{
+    auto guest = GetEntity<Guest>(entry.SpriteIndex);
+    if (guest == nullptr)
+        return;
+
+    if (guest_precompute_wants_surroundings(*guest))
+    {
+        entry.SurroundingsLocation = { guest->x & 0xFFE0, guest->y & 0xFFE0, guest->z };
+        entry.Surroundings = peep_assess_surroundings(
+            entry.SurroundingsLocation.x, entry.SurroundingsLocation.y, entry.SurroundingsLocation.z);
+        entry.HasSurroundings = true;
+    }
+
+    if (guest_precompute_wants_rides(*guest))
+    {
+        entry.RidesLocation = { guest->x, guest->y };
+        entry.RidesHasMap = guest->HasItem(ShopItem::Map);
+        entry.RideConsideration = guest->FindRidesToGoOn();
+        entry.HasRideConsideration = true;
+    }
+}
+
+void guest_precompute_prepare()
+{
+    _precomputed.clear();
+
+    // Mirrors the indexing of peep_update_all, the part guarded by this mask runs once every 512 ticks per guest.
+    int32_t index = 0;
+    for (auto guest : EntityList<Guest>())
+    {
+        if (static_cast<uint32_t>(index & 0x1FF) == (gCurrentTicks & 0x1FF))
+        {
+            auto& entry = _precomputed.emplace_back();
+            entry.SpriteIndex = guest->sprite_index;
+            entry.UpdateIndex = index;
+        }
+        index++;
+    }
+
+    if (_precomputed.empty())
+        return;
+
+    // Nothing is written to the game state here, every task only fills its own entry.
+    TaskScheduler::GetDefault().ParallelFor(0, _precomputed.size(), 1, [](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            guest_precompute_entry(_precomputed[i]);
+        }
+    });
+}
+
+void guest_precompute_clear()
+{
+    _precomputed.clear();
+}
+
+void guest_precompute_invalidate(const CoordsXY& loc)
+{
+    for (auto& entry : _precomputed)
+    {
+        if (!entry.HasSurroundings)
+            continue;
+
+        const int32_t distX = std::abs(loc.x - entry.SurroundingsLocation.x);
+        const int32_t distY = std::abs(loc.y - entry.SurroundingsLocation.y);
+        if (std::max(distX, distY) <= SURROUNDINGS_RADIUS)
+        {
+            entry.HasSurroundings = false;
+        }
+    }
+}
+
+const GuestPrecomputedTick* guest_precompute_find(uint16_t spriteIndex, int32_t updateIndex)
+{
+    // Entries are created in entity list order, which is sorted by sprite index.
+    auto it = std::lower_bound(
+        _precomputed.begin(), _precomputed.end(), spriteIndex,
+        [](const GuestPrecomputedTick& entry, uint16_t index) { return entry.SpriteIndex < index; });
+    if (it == _precomputed.end() || it->SpriteIndex != spriteIndex || it->UpdateIndex != updateIndex)
+        return nullptr;
+    return &*it;
+}
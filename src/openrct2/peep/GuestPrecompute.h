@@ -0,0 +1,52 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../world/Location.hpp"
+#include "Peep.h"
+
+#include <bitset>
+
+/**
+ * Results of the read-only queries a guest makes during its 128 tick update. They are computed in parallel
+ * against the state at the start of peep_update_all and handed to the serial update, which still runs in
+ * sprite_index order and draws every random number itself. A result is only used when the state it was
+ * computed from is unchanged, so the game state is identical to a fully serial update.
+ */
+struct GuestPrecomputedTick
+{
+    uint16_t SpriteIndex = SPRITE_INDEX_NULL;
+    // Position of the guest in the update loop, the 128 tick update only runs when it matches the current tick.
+    int32_t UpdateIndex = 0;
+
+    CoordsXYZ SurroundingsLocation;
+    PeepThoughtType Surroundings = PeepThoughtType::None;
+    bool HasSurroundings = false;
+
+    CoordsXY RidesLocation;
+    bool RidesHasMap = false;
+    bool HasRideConsideration = false;
+    std::bitset<MAX_RIDES> RideConsideration;
+};
+
+/**
+ * Computes the results for every guest whose 128 tick update runs this tick.
+ */
+void guest_precompute_prepare();
+void guest_precompute_clear();
+
+/**
+ * Marks precomputed surroundings that could have seen a change at the given location as stale,
+ * called whenever a guest adds or removes litter or breaks a path addition during the update.
+ */
+void guest_precompute_invalidate(const CoordsXY& loc);
+
+const GuestPrecomputedTick* guest_precompute_find(uint16_t spriteIndex, int32_t updateIndex);
@@ -0,0 +1,477 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "GuestSurroundings.h"
+
+#include "../Cheats.h"
+#include "../ride/Ride.h"
+#include "../world/EntityList.h"
+#include "../world/Footpath.h"
+#include "../world/Map.h"
+#include "../world/RidePresence.h"
+#include "../world/Scenery.h"
+#include "../world/Sprite.h"
+#include "../world/TileElementsView.h"
+#include "Peep.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+using namespace OpenRCT2;
+
+static constexpr int32_t MAP_TILES = MAXIMUM_MAP_SIZE_TECHNICAL;
+
+// Tiles assessed on each side of the guest, the window is ten tiles wide with the guest's tile right of centre.
+static constexpr int32_t SURROUNDINGS_TILES_BEFORE = 5;
+static constexpr int32_t SURROUNDINGS_TILES_AFTER = 4;
+
+namespace
+{
+    struct TileCounts
+    {
+        int32_t Scenery = 0;
+        int32_t Fountains = 0;
+        int32_t BrokenAdditions = 0;
+        // Path additions whose object is not loaded, the assessment gives up when it finds one.
+        int32_t MissingAdditions = 0;
+
+        TileCounts operator+(const TileCounts& rhs) const
+        {
+            return { Scenery + rhs.Scenery, Fountains + rhs.Fountains, BrokenAdditions + rhs.BrokenAdditions,
+                     MissingAdditions + rhs.MissingAdditions };
+        }
+
+        TileCounts operator-(const TileCounts& rhs) const
+        {
+            return { Scenery - rhs.Scenery, Fountains - rhs.Fountains, BrokenAdditions - rhs.BrokenAdditions,
+                     MissingAdditions - rhs.MissingAdditions };
+        }
+    };
+
+    // Litter is counted up to and including 160 units from the centre, which reaches onto the first
+    // coordinate of the tiles just after the window, so litter lying exactly on a tile edge is also counted apart.
+    struct LitterCounts
+    {
+        int32_t All = 0;
+        int32_t OnEdgeX = 0;
+        int32_t OnEdgeY = 0;
+        int32_t OnCorner = 0;
+
+        LitterCounts operator+(const LitterCounts& rhs) const
+        {
+            return { All + rhs.All, OnEdgeX + rhs.OnEdgeX, OnEdgeY + rhs.OnEdgeY, OnCorner + rhs.OnCorner };
+        }
+
+        LitterCounts operator-(const LitterCounts& rhs) const
+        {
+            return { All - rhs.All, OnEdgeX - rhs.OnEdgeX, OnEdgeY - rhs.OnEdgeY, OnCorner - rhs.OnCorner };
+        }
+    };
+
+    /**
+     * Per-tile values with a running sum along each row, any run of tiles in a row is summed in constant time.
+     */
+    template<typename T> class RowSumGrid
+    {
+    private:
+        std::vector<T> _cells;
+        // MAP_TILES + 1 entries per row, entry x is the sum of the cells before x.
+        std::vector<T> _rowSums;
+
+    public:
+        void Reset()
+        {
+            _cells.assign(MAP_TILES * MAP_TILES, {});
+            _rowSums.assign(MAP_TILES * (MAP_TILES + 1), {});
+        }
+
+        bool IsEmpty() const
+        {
+            return _cells.empty();
+        }
+
+        const T& Get(int32_t x, int32_t y) const
+        {
+            return _cells[y * MAP_TILES + x];
+        }
+
+        T& GetMutable(int32_t x, int32_t y)
+        {
+            return _cells[y * MAP_TILES + x];
+        }
+
+        void UpdateRow(int32_t y, int32_t fromX = 0)
+        {
+            auto rowSums = &_rowSums[y * (MAP_TILES + 1)];
+            for (int32_t x = fromX; x < MAP_TILES; x++)
+            {
+                rowSums[x + 1] = rowSums[x] + Get(x, y);
+            }
+        }
+
+        // Sum of the cells from x0 up to and including x1.
+        T SumRow(int32_t y, int32_t x0, int32_t x1) const
+        {
+            auto rowSums = &_rowSums[y * (MAP_TILES + 1)];
+            return rowSums[x1 + 1] - rowSums[x0];
+        }
+    };
+} // namespace
+
+static RowSumGrid<TileCounts> _tileCounts;
+static RowSumGrid<LitterCounts> _litterCounts;
+static std::vector<TileCoordsXY> _dirtyTiles;
+static bool _rebuildAll = true;
+
+static std::atomic<uint64_t> _cacheHits = { 0 };
+static std::atomic<uint64_t> _cacheMisses = { 0 };
+
+/**
+ * How the music of a ride is heard by guests nearby, 1 for a pleasant tune and 2 for noise drowning it out.
+ */
+static uint16_t ride_get_surroundings_music(const Ride* ride)
+{
+    if (ride->lifecycle_flags & RIDE_LIFECYCLE_MUSIC && ride->status != RIDE_STATUS_CLOSED
+        && !(ride->lifecycle_flags & (RIDE_LIFECYCLE_BROKEN_DOWN | RIDE_LIFECYCLE_CRASHED)))
+    {
+        if (ride->type == RIDE_TYPE_MERRY_GO_ROUND)
+            return 1;
+
+        if (ride->music == MUSIC_STYLE_ORGAN)
+            return 1;
+
+        if (ride->type == RIDE_TYPE_DODGEMS)
+        {
+            // Dodgems drown out music?
+            return 2;
+        }
+    }
+    return 0;
+}
+
+static PeepThoughtType peep_choose_surroundings_thought(
+    uint16_t num_scenery, uint16_t num_fountains, uint16_t num_rubbish, uint16_t nearby_music)
+{
+    if (num_fountains >= 5 && num_rubbish < 20)
+        return PeepThoughtType::Fountains;
+
+    if (num_scenery >= 40 && num_rubbish < 8)
+        return PeepThoughtType::Scenery;
+
+    if (nearby_music == 1 && num_rubbish < 20)
+        return PeepThoughtType::Music;
+
+    if (num_rubbish < 2 && !gCheatsDisableLittering)
+        // if disable littering cheat is enabled, peeps will not have the "clean and tidy park" thought
+        return PeepThoughtType::VeryClean;
+
+    return PeepThoughtType::None;
+}
+
+static PeepThoughtType peep_assess_surroundings_scan(int16_t centre_x, int16_t centre_y)
+{
+    uint16_t num_scenery = 0;
+    uint16_t num_fountains = 0;
+    uint16_t nearby_music = 0;
+    uint16_t num_rubbish = 0;
+
+    int16_t initial_x = std::max(centre_x - 160, 0);
+    int16_t initial_y = std::max(centre_y - 160, 0);
+    int16_t final_x = std::min(centre_x + 160, MAXIMUM_MAP_SIZE_BIG);
+    int16_t final_y = std::min(centre_y + 160, MAXIMUM_MAP_SIZE_BIG);
+
+    for (int16_t x = initial_x; x < final_x; x += COORDS_XY_STEP)
+    {
+        for (int16_t y = initial_y; y < final_y; y += COORDS_XY_STEP)
+        {
+            for (auto* tileElement : TileElementsView({ x, y }))
+            {
+                Ride* ride;
+                rct_scenery_entry* scenery;
+
+                switch (tileElement->GetType())
+                {
+                    case TILE_ELEMENT_TYPE_PATH:
+                        if (!tileElement->AsPath()->HasAddition())
+                            break;
+
+                        scenery = tileElement->AsPath()->GetAdditionEntry();
+                        if (scenery == nullptr)
+                        {
+                            return PeepThoughtType::None;
+                        }
+                        if (tileElement->AsPath()->AdditionIsGhost())
+                            break;
+
+                        if (scenery->path_bit.flags
+                            & (PATH_BIT_FLAG_JUMPING_FOUNTAIN_WATER | PATH_BIT_FLAG_JUMPING_FOUNTAIN_SNOW))
+                        {
+                            num_fountains++;
+                            break;
+                        }
+                        if (tileElement->AsPath()->IsBroken())
+                        {
+                            num_rubbish++;
+                        }
+                        break;
+                    case TILE_ELEMENT_TYPE_LARGE_SCENERY:
+                    case TILE_ELEMENT_TYPE_SMALL_SCENERY:
+                        num_scenery++;
+                        break;
+                    case TILE_ELEMENT_TYPE_TRACK:
+                        ride = get_ride(tileElement->AsTrack()->GetRideIndex());
+                        if (ride != nullptr)
+                        {
+                            nearby_music |= ride_get_surroundings_music(ride);
+                        }
+                        break;
+                }
+            }
+        }
+    }
+
+    for (auto litter : EntityList<Litter>())
+    {
+        int16_t dist_x = abs(litter->x - centre_x);
+        int16_t dist_y = abs(litter->y - centre_y);
+        if (std::max(dist_x, dist_y) <= 160)
+        {
+            num_rubbish++;
+        }
+    }
+
+    return peep_choose_surroundings_thought(num_scenery, num_fountains, num_rubbish, nearby_music);
+}
+
+static TileCounts surroundings_read_tile(const TileCoordsXY& tile)
+{
+    TileCounts counts;
+    for (auto* tileElement : TileElementsView(tile.ToCoordsXY()))
+    {
+        switch (tileElement->GetType())
+        {
+            case TILE_ELEMENT_TYPE_PATH:
+            {
+                auto pathElement = tileElement->AsPath();
+                if (!pathElement->HasAddition())
+                    break;
+
+                auto scenery = pathElement->GetAdditionEntry();
+                if (scenery == nullptr)
+                {
+                    counts.MissingAdditions++;
+                    break;
+                }
+                if (pathElement->AdditionIsGhost())
+                    break;
+
+                if (scenery->path_bit.flags & (PATH_BIT_FLAG_JUMPING_FOUNTAIN_WATER | PATH_BIT_FLAG_JUMPING_FOUNTAIN_SNOW))
+                {
+                    counts.Fountains++;
+                    break;
+                }
+                if (pathElement->IsBroken())
+                {
+                    counts.BrokenAdditions++;
+                }
+                break;
+            }
+            case TILE_ELEMENT_TYPE_LARGE_SCENERY:
+            case TILE_ELEMENT_TYPE_SMALL_SCENERY:
+                counts.Scenery++;
+                break;
+        }
+    }
+    return counts;
+}
+
+static LitterCounts surroundings_litter_counts_at(const CoordsXY& loc)
+{
+    const bool onEdgeX = (loc.x % COORDS_XY_STEP) == 0;
+    const bool onEdgeY = (loc.y % COORDS_XY_STEP) == 0;
+    return { 1, onEdgeX ? 1 : 0, onEdgeY ? 1 : 0, onEdgeX && onEdgeY ? 1 : 0 };
+}
+
+static void surroundings_litter_change(const CoordsXY& loc, bool added)
+{
+    if (!map_is_location_valid(loc))
+        return;
+
+    if (_litterCounts.IsEmpty())
+    {
+        _litterCounts.Reset();
+    }
+
+    const TileCoordsXY tile(loc);
+    auto& cell = _litterCounts.GetMutable(tile.x, tile.y);
+    const auto change = surroundings_litter_counts_at(loc);
+    cell = added ? cell + change : cell - change;
+    _litterCounts.UpdateRow(tile.y, tile.x);
+}
+
+void surroundings_litter_reset()
+{
+    _litterCounts.Reset();
+}
+
+void surroundings_litter_added(const CoordsXY& loc)
+{
+    surroundings_litter_change(loc, true);
+}
+
+void surroundings_litter_removed(const CoordsXY& loc)
+{
+    surroundings_litter_change(loc, false);
+}
+
+void surroundings_invalidate_all()
+{
+    _rebuildAll = true;
+}
+
+void surroundings_invalidate_tile(const CoordsXY& loc)
+{
+    if (!_rebuildAll && map_is_location_valid(loc))
+    {
+        _dirtyTiles.emplace_back(loc);
+    }
+}
+
+void surroundings_update()
+{
+    if (_litterCounts.IsEmpty())
+    {
+        _litterCounts.Reset();
+    }
+
+    if (_rebuildAll)
+    {
+        _tileCounts.Reset();
+        for (int32_t y = 0; y < MAP_TILES; y++)
+        {
+            for (int32_t x = 0; x < MAP_TILES; x++)
+            {
+                _tileCounts.GetMutable(x, y) = surroundings_read_tile({ x, y });
+            }
+            _tileCounts.UpdateRow(y);
+        }
+        _rebuildAll = false;
+    }
+    else
+    {
+        for (const auto& tile : _dirtyTiles)
+        {
+            _tileCounts.GetMutable(tile.x, tile.y) = surroundings_read_tile(tile);
+            _tileCounts.UpdateRow(tile.y, tile.x);
+        }
+    }
+    _dirtyTiles.clear();
+}
+
+static bool surroundings_has_pending_changes(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+    if (_rebuildAll || _litterCounts.IsEmpty())
+        return true;
+
+    return std::any_of(_dirtyTiles.begin(), _dirtyTiles.end(), [x0, y0, x1, y1](const TileCoordsXY& tile) {
+        return tile.x >= x0 && tile.x <= x1 && tile.y >= y0 && tile.y <= y1;
+    });
+}
+
+/**
+ *
+ *  rct2: 0x0069BC9A
+ */
+PeepThoughtType peep_assess_surroundings(int16_t centre_x, int16_t centre_y, int16_t centre_z)
+{
+    if ((tile_element_height({ centre_x, centre_y })) > centre_z)
+        return PeepThoughtType::None;
+
+    const int32_t centreTileX = centre_x / COORDS_XY_STEP;
+    const int32_t centreTileY = centre_y / COORDS_XY_STEP;
+    const int32_t x0 = std::max(centreTileX - SURROUNDINGS_TILES_BEFORE, 0);
+    const int32_t y0 = std::max(centreTileY - SURROUNDINGS_TILES_BEFORE, 0);
+    const int32_t x1 = std::min(centreTileX + SURROUNDINGS_TILES_AFTER, MAP_TILES - 1);
+    const int32_t y1 = std::min(centreTileY + SURROUNDINGS_TILES_AFTER, MAP_TILES - 1);
+
+    // The counts only line up with the scan for tile aligned centres, which is what guests pass.
+    if (centre_x < 0 || centre_y < 0 || (centre_x % COORDS_XY_STEP) != 0 || (centre_y % COORDS_XY_STEP) != 0
+        || surroundings_has_pending_changes(x0, y0, x1, y1))
+    {
+        _cacheMisses.fetch_add(1, std::memory_order_relaxed);
+        return peep_assess_surroundings_scan(centre_x, centre_y);
+    }
+    _cacheHits.fetch_add(1, std::memory_order_relaxed);
+
+    TileCounts counts;
+    LitterCounts litter;
+    for (int32_t y = y0; y <= y1; y++)
+    {
+        counts = counts + _tileCounts.SumRow(y, x0, x1);
+        litter = litter + _litterCounts.SumRow(y, x0, x1);
+    }
+
+    if (counts.MissingAdditions > 0)
+        return PeepThoughtType::None;
+
+    int32_t rubbish = counts.BrokenAdditions + litter.All;
+    const int32_t edgeX = centreTileX + SURROUNDINGS_TILES_AFTER + 1;
+    const int32_t edgeY = centreTileY + SURROUNDINGS_TILES_AFTER + 1;
+    if (edgeX < MAP_TILES)
+    {
+        for (int32_t y = y0; y <= y1; y++)
+        {
+            rubbish += _litterCounts.Get(edgeX, y).OnEdgeX;
+        }
+    }
+    if (edgeY < MAP_TILES)
+    {
+        rubbish += _litterCounts.SumRow(edgeY, x0, x1).OnEdgeY;
+    }
+    if (edgeX < MAP_TILES && edgeY < MAP_TILES)
+    {
+        rubbish += _litterCounts.Get(edgeX, edgeY).OnCorner;
+    }
+
+    const auto numScenery = static_cast<uint16_t>(counts.Scenery);
+    const auto numFountains = static_cast<uint16_t>(counts.Fountains);
+    const auto numRubbish = static_cast<uint16_t>(rubbish);
+
+    // Music only matters when neither fountains nor scenery gave a thought, so the rides are only looked at then.
+    uint16_t nearbyMusic = 0;
+    if (!(numFountains >= 5 && numRubbish < 20) && !(numScenery >= 40 && numRubbish < 8) && numRubbish < 20)
+    {
+        const auto rides = ride_presence_get_area({ x0, y0 }, { x1, y1 });
+        for (size_t rideIndex = 0; rideIndex < rides.size(); rideIndex++)
+        {
+            if (!rides[rideIndex])
+                continue;
+
+            auto ride = get_ride(static_cast<ride_id_t>(rideIndex));
+            if (ride != nullptr)
+            {
+                nearbyMusic |= ride_get_surroundings_music(ride);
+            }
+        }
+    }
+
+    return peep_choose_surroundings_thought(numScenery, numFountains, numRubbish, nearbyMusic);
+}
+
+SurroundingsCacheStats surroundings_get_stats()
+{
+    return { _cacheHits.load(std::memory_order_relaxed), _cacheMisses.load(std::memory_order_relaxed) };
+}
+
+void surroundings_reset_stats()
+{
+    _cacheHits = 0;
+    _cacheMisses = 0;
+}
@@ -0,0 +1,39 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../world/Location.hpp"
+
+/**
+ * Per-tile counts of what peep_assess_surroundings looks at: scenery, fountains, broken path additions and litter.
+ * Each row also keeps running sums, so the 10x10 tile window around a guest is summed a row at a time
+ * instead of walking the tile elements of every tile.
+ *
+ * Litter is tracked as it is added and removed. Tile elements are marked dirty by the actions that change
+ * them and read again by surroundings_update, which peep_update_all calls before any guest is updated.
+ * Queries touching a tile with pending changes walk the tiles instead, so results never differ.
+ */
+void surroundings_invalidate_all();
+void surroundings_invalidate_tile(const CoordsXY& loc);
+void surroundings_update();
+
+void surroundings_litter_reset();
+void surroundings_litter_added(const CoordsXY& loc);
+void surroundings_litter_removed(const CoordsXY& loc);
+
+struct SurroundingsCacheStats
+{
+    uint64_t Hits;
+    uint64_t Misses;
+};
+
+SurroundingsCacheStats surroundings_get_stats();
+void surroundings_reset_stats();
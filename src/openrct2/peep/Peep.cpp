@@ -42,11 +42,14 @@
 #include "../world/LargeScenery.h"
 #include "../world/Map.h"
 #include "../world/Park.h"
+#include "../world/RidePresence.h"
 #include "../world/Scenery.h"
 #include "../world/SmallScenery.h"
 #include "../world/Sprite.h"
 #include "../world/Surface.h"
 #include "GuestPathfinding.h"
+#include "GuestPrecompute.h"
+#include "GuestSurroundings.h"
 #include "Staff.h"
 
 #include <algorithm>
@@ -398,6 +401,16 @@ void peep_update_all()
     if (gScreenFlags & SCREEN_FLAGS_EDITOR)
         return;
 
+    ride_presence_update();
+    surroundings_update();
+
+    // The read-only part of the guest updates can be computed ahead on other threads, the results are only
+    // used while still valid so the outcome is identical to a serial update.
+    if (gConfigGeneral.multithreading_guest_update)
+    {
+        guest_precompute_prepare();
+    }
+
     int32_t i = 0;
     // Warning this loop can delete peeps
     for (auto peep : EntityList<Guest>())
@@ -418,6 +431,7 @@ void peep_update_all()
 
         i++;
     }
+    guest_precompute_clear();
 
     for (auto staff : EntityList<Staff>())
     {
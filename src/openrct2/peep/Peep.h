@@ -794,6 +794,7 @@ public:
     void TryGetUpFromSitting();
     void ChoseNotToGoOnRide(Ride* ride, bool peepAtRide, bool updateLastRide);
     void PickRideToGoOn();
+    std::bitset<MAX_RIDES> FindRidesToGoOn();
     void ReadMap();
     bool ShouldGoOnRide(Ride* ride, int32_t entranceNum, bool atQueue, bool thinking);
     bool ShouldGoToShop(Ride* ride, bool peepAtShop);
@@ -858,7 +859,6 @@ private:
     void MakePassingPeepsSick(Guest* passingPeep);
     void GivePassingPeepsIceCream(Guest* passingPeep);
     Ride* FindBestRideToGoOn();
-    std::bitset<MAX_RIDES> FindRidesToGoOn();
     bool FindVehicleToEnter(Ride* ride, std::vector<uint8_t>& car_array);
     void GoToRideEntrance(Ride* ride);
 };
@@ -1009,6 +1009,7 @@ extern uint8_t gPeepWarningThrottle[16];
 Peep* try_get_guest(uint16_t spriteIndex);
 int32_t peep_get_staff_count();
 void peep_update_all();
+PeepThoughtType peep_assess_surroundings(int16_t centre_x, int16_t centre_y, int16_t centre_z);
 void peep_problem_warnings_update();
 void peep_stop_crowd_noise();
 void peep_update_crowd_noise();
@@ -32,6 +32,7 @@
 #include "../scenario/Scenario.h"
 #include "../util/Util.h"
 #include "../windows/Intent.h"
+#include "../world/EntityQuery.h"
 #include "../world/Entrance.h"
 #include "../world/Footpath.h"
 #include "../world/Scenery.h"
@@ -421,20 +422,11 @@ void staff_toggle_patrol_area(int32_t staffIndex, const CoordsXY& coords)
  */
 Direction Staff::HandymanDirectionToNearestLitter() const
 {
-    uint16_t nearestLitterDist = 0xFFFF;
-    Litter* nearestLitter = nullptr;
-    for (auto litter : EntityList<Litter>())
-    {
-        uint16_t distance = abs(litter->x - x) + abs(litter->y - y) + abs(litter->z - z) * 4;
-
-        if (distance < nearestLitterDist)
-        {
-            nearestLitterDist = distance;
-            nearestLitter = litter;
-        }
-    }
+    auto nearestLitter = FindNearestEntity<Litter>({ x, y }, MAX_LITTER_DISTANCE, [this](const Litter* litter) {
+        return abs(litter->x - x) + abs(litter->y - y) + abs(litter->z - z) * 4;
+    });
 
-    if (nearestLitterDist > MAX_LITTER_DISTANCE)
+    if (nearestLitter == nullptr)
     {
         return INVALID_DIRECTION;
     }
@@ -879,6 +871,8 @@ bool Staff::DoMechanicPathFinding()
 /**
  *
  *  rct2: 0x006C050B
+ *  Only looks at the path the staff member is on. Staff ignore 'no entry' banners, so the footpath graph, whose
+ *  edges leave those out, cannot answer this.
  */
 Direction Staff::DirectionPath(uint8_t validDirections, PathElement* pathElement) const
 {
@@ -960,23 +954,19 @@ bool Staff::DoMiscPathFinding()
  */
 void Staff::EntertainerUpdateNearbyPeeps() const
 {
-    for (auto guest : EntityList<Guest>())
-    {
-        if (guest->x == LOCATION_NULL)
-            continue;
-
+    ForEachEntityInRange<Guest>({ x - 96, y - 96 }, { x + 96, y + 96 }, [this](Guest* guest) {
         int16_t z_dist = abs(z - guest->z);
         if (z_dist > 48)
-            continue;
+            return;
 
         int16_t x_dist = abs(x - guest->x);
         int16_t y_dist = abs(y - guest->y);
 
         if (x_dist > 96)
-            continue;
+            return;
 
         if (y_dist > 96)
-            continue;
+            return;
 
         if (guest->State == PeepState::Walking)
         {
@@ -987,7 +977,7 @@ void Staff::EntertainerUpdateNearbyPeeps() const
             guest->TimeInQueue = std::max(0, guest->TimeInQueue - 200);
             guest->HappinessTarget = std::min(guest->HappinessTarget + 3, PEEP_MAX_HAPPINESS);
         }
-    }
+    });
 }
 
 /**
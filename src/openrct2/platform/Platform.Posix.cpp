@@ -21,6 +21,9 @@
 #    include <ctime>
 #    include <dirent.h>
 #    include <pwd.h>
+#    ifdef __linux__
+#        include <sched.h>
+#    endif
 #    include <sys/stat.h>
 
 namespace Platform
@@ -109,6 +112,19 @@ namespace Platform
         return false;
     }
 
+    bool SetCurrentThreadAffinity(size_t processorIndex)
+    {
+#    ifdef __linux__
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(processorIndex, &cpuSet);
+        return sched_setaffinity(0, sizeof(cpuSet), &cpuSet) == 0;
+#    else
+        // macOS and the BSDs only offer affinity hints, leave scheduling to the OS.
+        return false;
+#    endif
+    }
+
     bool FindApp(const std::string& app, std::string* output)
     {
         return Execute(String::StdFormat("which %s 2> /dev/null", app.c_str()), output) == 0;
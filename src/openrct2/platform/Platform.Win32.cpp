@@ -270,6 +270,15 @@ namespace Platform
         return false;
     }
 
+    bool SetCurrentThreadAffinity(size_t processorIndex)
+    {
+        if (processorIndex >= sizeof(DWORD_PTR) * 8)
+        {
+            return false;
+        }
+        return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << processorIndex) != 0;
+    }
+
     /**
      * Checks if the current version of Windows supports ANSI colour codes.
      * From Windows 10, build 10586 ANSI escape colour codes can be used on stdout.
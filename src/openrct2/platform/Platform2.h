@@ -63,6 +63,7 @@ namespace Platform
 #endif
 
     bool IsRunningInWine();
+    bool SetCurrentThreadAffinity(size_t processorIndex);
     bool IsColourTerminalSupported();
     bool HandleSpecialCommandLineArgument(const char* argument);
     utf8* StrDecompToPrecomp(utf8* input);
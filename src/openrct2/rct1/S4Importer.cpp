@@ -1595,7 +1595,8 @@ private:
         // Build tile pointer cache (needed to get the first element at a certain location)
         auto tilePointerIndex = TilePointerIndex<RCT12TileElement>(RCT1_MAX_MAP_SIZE, _s4.tile_elements);
 
-        TileElement* dstElement = gTileElements;
+        std::vector<TileElement> tileElements;
+        tileElements.reserve(RCT1_MAX_TILE_ELEMENTS + MAX_TILE_TILE_ELEMENT_POINTERS);
 
         for (TileCoordsXY coords = { 0, 0 }; coords.y < MAXIMUM_MAP_SIZE_TECHNICAL; coords.y++)
         {
@@ -1603,9 +1604,9 @@ private:
             {
                 if (coords.x >= RCT1_MAX_MAP_SIZE || coords.y >= RCT1_MAX_MAP_SIZE)
                 {
-                    dstElement->ClearAs(TILE_ELEMENT_TYPE_SURFACE);
-                    dstElement->SetLastForTile(true);
-                    dstElement++;
+                    auto& dstElement = tileElements.emplace_back();
+                    dstElement.ClearAs(TILE_ELEMENT_TYPE_SURFACE);
+                    dstElement.SetLastForTile(true);
                     continue;
                 }
 
@@ -1616,16 +1617,18 @@ private:
                     if (srcElement->base_height == RCT12_MAX_ELEMENT_HEIGHT)
                         continue;
 
-                    auto numAddedElements = ImportTileElement(dstElement, srcElement);
-                    dstElement += numAddedElements;
+                    // Walls are split into an element for each edge
+                    TileElement dstElements[4]{};
+                    auto numAddedElements = ImportTileElement(dstElements, srcElement);
+                    tileElements.insert(tileElements.end(), dstElements, dstElements + numAddedElements);
                 } while (!(srcElement++)->IsLastForTile());
 
                 // Set last element flag in case the original last element was never added
-                (dstElement - 1)->SetLastForTile(true);
+                tileElements.back().SetLastForTile(true);
             }
         }
 
-        map_update_tile_pointers();
+        map_set_tile_elements(std::move(tileElements));
 
         FixEntrancePositions();
     }
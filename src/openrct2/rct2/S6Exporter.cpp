@@ -52,6 +52,7 @@
 #include <functional>
 #include <iterator>
 #include <optional>
+#include <stdexcept>
 
 S6Exporter::S6Exporter()
 {
@@ -185,8 +186,6 @@ void S6Exporter::Export()
     _s6.scenario_srand_0 = state.s0;
     _s6.scenario_srand_1 = state.s1;
 
-    // Map elements must be reorganised prior to saving otherwise save may be invalid
-    map_reorganise_elements();
     ExportTileElements();
     ExportEntities();
     ExportParkName();
@@ -1559,23 +1558,35 @@ void S6Exporter::ExportMapAnimations()
 
 void S6Exporter::ExportTileElements()
 {
-    for (uint32_t index = 0; index < RCT2_MAX_TILE_ELEMENTS; index++)
+    // The stacks of the tiles are written one after another, the elements after them are left zeroed
+    uint32_t index = 0;
+    for (auto* src : gTileElementTilePointers)
     {
-        auto src = &gTileElements[index];
-        auto dst = &_s6.tile_elements[index];
-        if (src->base_height == MAX_ELEMENT_HEIGHT)
-        {
-            std::memcpy(dst, src, sizeof(*dst));
-        }
-        else
+        if (src == nullptr)
+            continue;
+        do
         {
-            auto tileElementType = static_cast<RCT12TileElementType>(src->GetType());
-            if (tileElementType == RCT12TileElementType::Corrupt || tileElementType == RCT12TileElementType::EightCarsCorrupt14
-                || tileElementType == RCT12TileElementType::EightCarsCorrupt15)
+            if (index >= RCT2_MAX_TILE_ELEMENTS)
+            {
+                throw std::runtime_error("Too many tile elements to save the park.");
+            }
+
+            auto dst = &_s6.tile_elements[index++];
+            if (src->base_height == MAX_ELEMENT_HEIGHT)
+            {
                 std::memcpy(dst, src, sizeof(*dst));
+            }
             else
-                ExportTileElement(dst, src);
-        }
+            {
+                auto tileElementType = static_cast<RCT12TileElementType>(src->GetType());
+                if (tileElementType == RCT12TileElementType::Corrupt
+                    || tileElementType == RCT12TileElementType::EightCarsCorrupt14
+                    || tileElementType == RCT12TileElementType::EightCarsCorrupt15)
+                    std::memcpy(dst, src, sizeof(*dst));
+                else
+                    ExportTileElement(dst, src);
+            }
+        } while (!(src++)->IsLastForTile());
     }
     _s6.next_free_tile_element_pointer_index = gNextFreeTileElementPointerIndex;
 }
@@ -1831,7 +1842,6 @@ int32_t scenario_save(const utf8* path, int32_t flags)
         window_close_construction_windows();
     }
 
-    map_reorganise_elements();
     viewport_set_saved_view();
 
     bool result = false;
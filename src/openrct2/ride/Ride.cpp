@@ -48,6 +48,7 @@
 #include "../windows/Intent.h"
 #include "../world/Banner.h"
 #include "../world/Climate.h"
+#include "../world/EntityQuery.h"
 #include "../world/Footpath.h"
 #include "../world/Location.hpp"
 #include "../world/Map.h"
@@ -2729,51 +2730,44 @@ Peep* ride_find_closest_mechanic(Ride* ride, int32_t forInspection)
  */
 Peep* find_closest_mechanic(const CoordsXY& entrancePosition, int32_t forInspection)
 {
-    Peep* closestMechanic = nullptr;
-    uint32_t closestDistance = std::numeric_limits<uint32_t>::max();
+    auto location = entrancePosition.ToTileStart();
+    const bool checkPatrol = map_is_location_in_park(location);
 
-    for (auto peep : EntityList<Staff>())
-    {
+    auto isAvailable = [forInspection, checkPatrol, &location](const Staff* peep) {
         if (!peep->IsMechanic())
-            continue;
+            return false;
 
         if (!forInspection)
         {
             if (peep->State == PeepState::HeadingToInspection)
             {
                 if (peep->SubState >= 4)
-                    continue;
+                    return false;
             }
             else if (peep->State != PeepState::Patrolling)
-                continue;
+                return false;
 
             if (!(peep->StaffOrders & STAFF_ORDERS_FIX_RIDES))
-                continue;
+                return false;
         }
         else
         {
             if (peep->State != PeepState::Patrolling || !(peep->StaffOrders & STAFF_ORDERS_INSPECT_RIDES))
-                continue;
+                return false;
         }
 
-        auto location = entrancePosition.ToTileStart();
-        if (map_is_location_in_park(location))
-            if (!peep->IsLocationInPatrol(location))
-                continue;
+        if (checkPatrol && !peep->IsLocationInPatrol(location))
+            return false;
 
-        if (peep->x == LOCATION_NULL)
-            continue;
+        return peep->x != LOCATION_NULL;
+    };
 
-        // Manhattan distance
-        uint32_t distance = std::abs(peep->x - entrancePosition.x) + std::abs(peep->y - entrancePosition.y);
-        if (distance < closestDistance)
-        {
-            closestDistance = distance;
-            closestMechanic = peep;
-        }
-    }
+    // Manhattan distance
+    auto distance = [&entrancePosition](const Staff* peep) {
+        return std::abs(peep->x - entrancePosition.x) + std::abs(peep->y - entrancePosition.y);
+    };
 
-    return closestMechanic;
+    return FindNearestEntity<Staff>(entrancePosition, std::numeric_limits<int32_t>::max(), distance, isAvailable);
 }
 
 Staff* ride_get_mechanic(Ride* ride)
@@ -6733,7 +6727,7 @@ void sub_6CB945(Ride* ride)
                 footpath_remove_edges_at(location, tileElement);
                 footpath_update_queue_chains();
                 map_invalidate_tile_full(location);
-                tile_element_remove(tileElement);
+                tile_element_remove(location, tileElement);
                 tileElement--;
             }
         } while (!(tileElement++)->IsLastForTile());
@@ -7274,7 +7268,7 @@ void ride_clear_leftover_entrances(Ride* ride)
             && it.element->AsEntrance()->GetEntranceType() != ENTRANCE_TYPE_PARK_ENTRANCE
             && it.element->AsEntrance()->GetRideIndex() == ride->id)
         {
-            tile_element_remove(it.element);
+            tile_element_remove(TileCoordsXY{ it.x, it.y }.ToCoordsXY(), it.element);
             tile_element_iterator_restart_for_tile(&it);
         }
     }
@@ -68,9 +68,7 @@ using namespace OpenRCT2::Drawing;
 
 struct map_backup
 {
-    TileElement tile_elements[MAX_TILE_ELEMENTS];
-    TileElement* tile_pointers[MAX_TILE_TILE_ELEMENT_POINTERS];
-    TileElement* next_free_tile_element;
+    TileElementStorage tile_elements;
     uint16_t map_size_units;
     uint16_t map_size_units_minus_2;
     uint16_t map_size;
@@ -2099,9 +2097,8 @@ static std::unique_ptr<map_backup> track_design_preview_backup_map()
     auto backup = std::make_unique<map_backup>();
     if (backup != nullptr)
     {
-        std::memcpy(backup->tile_elements, gTileElements, sizeof(backup->tile_elements));
-        std::memcpy(backup->tile_pointers, gTileElementTilePointers, sizeof(backup->tile_pointers));
-        backup->next_free_tile_element = gNextFreeTileElement;
+        // The elements are moved out of the map rather than copied and moved back when restoring
+        map_swap_tile_elements(backup->tile_elements);
         backup->map_size_units = gMapSizeUnits;
         backup->map_size_units_minus_2 = gMapSizeMinus2;
         backup->map_size = gMapSize;
@@ -2116,9 +2113,7 @@ static std::unique_ptr<map_backup> track_design_preview_backup_map()
  */
 static void track_design_preview_restore_map(map_backup* backup)
 {
-    std::memcpy(gTileElements, backup->tile_elements, sizeof(backup->tile_elements));
-    std::memcpy(gTileElementTilePointers, backup->tile_pointers, sizeof(backup->tile_pointers));
-    gNextFreeTileElement = backup->next_free_tile_element;
+    map_swap_tile_elements(backup->tile_elements);
     gMapSizeUnits = backup->map_size_units;
     gMapSizeMinus2 = backup->map_size_units_minus_2;
     gMapSize = backup->map_size;
@@ -2137,9 +2132,10 @@ static void track_design_preview_clear_map()
     gMapSizeMinus2 = (264 * 32) - 2;
     gMapSize = 256;
 
-    for (int32_t i = 0; i < MAX_TILE_TILE_ELEMENT_POINTERS; i++)
+    std::vector<TileElement> tileElements(MAX_TILE_TILE_ELEMENT_POINTERS);
+    for (auto& element : tileElements)
     {
-        TileElement* tile_element = &gTileElements[i];
+        TileElement* tile_element = &element;
         tile_element->ClearAs(TILE_ELEMENT_TYPE_SURFACE);
         tile_element->SetLastForTile(true);
         tile_element->AsSurface()->SetSlope(TILE_ELEMENT_SLOPE_FLAT);
@@ -2150,7 +2146,7 @@ static void track_design_preview_clear_map()
         tile_element->AsSurface()->SetOwnership(OWNERSHIP_OWNED);
         tile_element->AsSurface()->SetParkFences(0);
     }
-    map_update_tile_pointers();
+    map_set_tile_elements(std::move(tileElements));
 }
 
 bool track_design_are_entrance_and_exit_placed()
@@ -21,7 +21,7 @@ namespace TrainManager
 
         while (iter != end && Entity == nullptr)
         {
-            Entity = GetEntity<Vehicle>(*iter++);
+            Entity = *iter++;
             if (Entity && !Entity->IsHead())
             {
                 Entity = nullptr;
@@ -7,8 +7,10 @@
  * OpenRCT2 is licensed under the GNU General Public License version 3.
  *****************************************************************************/
 #pragma once
+#include "../world/EntityList.h"
+
 #include <cstdint>
-#include <list>
+#include <vector>
 
 struct Vehicle;
 
@@ -18,19 +20,19 @@ namespace TrainManager
     class View
     {
     private:
-        const std::list<uint16_t>* vec;
+        const std::vector<uint16_t>* vec;
 
         class Iterator
         {
         private:
-            std::list<uint16_t>::const_iterator iter;
-            std::list<uint16_t>::const_iterator end;
+            EntityListIterator<Vehicle> iter;
+            EntityListIterator<Vehicle> end;
             Vehicle* Entity = nullptr;
 
         public:
-            Iterator(std::list<uint16_t>::const_iterator _iter, std::list<uint16_t>::const_iterator _end)
-                : iter(_iter)
-                , end(_end)
+            Iterator(const std::vector<uint16_t>& _vec, size_t _index)
+                : iter(_vec, _index)
+                , end(_vec, _vec.size())
             {
                 ++(*this);
             }
@@ -67,11 +69,11 @@ namespace TrainManager
 
         Iterator begin()
         {
-            return Iterator(std::cbegin(*vec), std::cend(*vec));
+            return Iterator(*vec, 0);
         }
         Iterator end()
         {
-            return Iterator(std::cend(*vec), std::cend(*vec));
+            return Iterator(*vec, vec->size());
         }
     };
 } // namespace TrainManager
@@ -14,8 +14,11 @@
 #    include "../Context.h"
 #    include "../common.h"
 #    include "../core/Guard.hpp"
+#    include "../peep/GuestSurroundings.h"
 #    include "../ride/Track.h"
 #    include "../world/Footpath.h"
+#    include "../world/FootpathGraph.h"
+#    include "../world/RidePresence.h"
 #    include "../world/Scenery.h"
 #    include "../world/Sprite.h"
 #    include "../world/Surface.h"
@@ -99,6 +102,7 @@ namespace OpenRCT2::Scripting
             }
 
             _element->type = type;
+            ride_presence_invalidate_tile(_coords);
             Invalidate();
         }
 
@@ -485,6 +489,7 @@ namespace OpenRCT2::Scripting
                 {
                     auto el = _element->AsTrack();
                     el->SetRideIndex(value);
+                    ride_presence_invalidate_tile(_coords);
                     Invalidate();
                     break;
                 }
@@ -870,7 +875,7 @@ namespace OpenRCT2::Scripting
             {
                 TileElement* const elementToRemove = _element - 1;
                 Guard::Assert(elementToRemove->GetType() == TILE_ELEMENT_TYPE_CORRUPT);
-                tile_element_remove(elementToRemove);
+                tile_element_remove(_coords, elementToRemove);
                 _element--;
             }
 
@@ -1475,6 +1480,9 @@ namespace OpenRCT2::Scripting
 
         void Invalidate()
         {
+            // Any property of the element may have changed, so everything cached about the tile is read again.
+            surroundings_invalidate_tile(_coords);
+            footpath_graph_invalidate_tile(_coords);
             map_invalidate_tile_full(_coords);
         }
 
@@ -1648,6 +1656,7 @@ namespace OpenRCT2::Scripting
                 auto numElements = dataLen / sizeof(TileElement);
                 if (numElements == 0)
                 {
+                    map_update_tile_element_count(GetNumElements(GetFirstElement()), 0);
                     map_set_tile_element(TileCoordsXY(_coords), nullptr);
                 }
                 else
@@ -1680,6 +1689,9 @@ namespace OpenRCT2::Scripting
                         // Safely force last tile flag for last element to avoid read overrun
                         first[numElements - 1].SetLastForTile(true);
                     }
+
+                    // The copied elements can end the stack early, and the elements after a shorter stack are unused
+                    map_update_tile_element_count(currentNumElements, GetNumElements(first));
                 }
                 map_invalidate_tile_full(_coords);
             }
@@ -1751,7 +1763,7 @@ namespace OpenRCT2::Scripting
             auto first = GetFirstElement();
             if (index < GetNumElements(first))
             {
-                tile_element_remove(&first[index]);
+                tile_element_remove(_coords, &first[index]);
                 map_invalidate_tile_full(_coords);
             }
         }
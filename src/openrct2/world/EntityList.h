@@ -15,7 +15,7 @@
 #include "Location.hpp"
 #include "SpriteBase.h"
 
-#include <list>
+#include <algorithm>
 #include <vector>
 
 enum class EntityListId : uint8_t
@@ -23,7 +23,7 @@ enum class EntityListId : uint8_t
     Count = 6,
 };
 
-const std::list<uint16_t>& GetEntityList(const EntityType id);
+const std::vector<uint16_t>& GetEntityList(const EntityType id);
 
 uint16_t GetEntityListCount(EntityType list);
 uint16_t GetMiscEntityCount();
@@ -102,17 +102,22 @@ public:
     }
 };
 
+/**
+ * Iterates the sorted id list of one entity type. Entities may be created or removed while iterating, the iterator
+ * resynchronises on the last visited id whenever the list has shifted underneath it.
+ */
 template<typename T> class EntityListIterator
 {
 private:
-    std::list<uint16_t>::const_iterator iter;
-    std::list<uint16_t>::const_iterator end;
+    const std::vector<uint16_t>* vec;
+    size_t index;
+    uint16_t lastId = SPRITE_INDEX_NULL;
     T* Entity = nullptr;
 
 public:
-    EntityListIterator(std::list<uint16_t>::const_iterator _iter, std::list<uint16_t>::const_iterator _end)
-        : iter(_iter)
-        , end(_end)
+    EntityListIterator(const std::vector<uint16_t>& _vec, size_t _index)
+        : vec(&_vec)
+        , index(_index)
     {
         ++(*this);
     }
@@ -120,9 +125,14 @@ public:
     {
         Entity = nullptr;
 
-        while (iter != end && Entity == nullptr)
+        if (lastId != SPRITE_INDEX_NULL && (index == 0 || index > vec->size() || (*vec)[index - 1] != lastId))
         {
-            Entity = GetEntity<T>(*iter++);
+            index = std::upper_bound(std::begin(*vec), std::end(*vec), lastId) - std::begin(*vec);
+        }
+        while (index < vec->size() && Entity == nullptr)
+        {
+            lastId = (*vec)[index++];
+            Entity = GetEntity<T>(lastId);
         }
         return *this;
     }
@@ -131,7 +141,7 @@ public:
     {
         EntityListIterator retval = *this;
         ++(*this);
-        return *iter;
+        return retval;
     }
     bool operator==(EntityListIterator other) const
     {
@@ -157,7 +167,7 @@ template<typename T = SpriteBase> class EntityList
 {
 private:
     using EntityListIterator_t = EntityListIterator<T>;
-    const std::list<uint16_t>& vec;
+    const std::vector<uint16_t>& vec;
 
 public:
     EntityList()
@@ -167,10 +177,10 @@ public:
 
     EntityListIterator_t begin()
     {
-        return EntityListIterator_t(std::cbegin(vec), std::cend(vec));
+        return EntityListIterator_t(vec, 0);
     }
     EntityListIterator_t end()
     {
-        return EntityListIterator_t(std::cend(vec), std::cend(vec));
+        return EntityListIterator_t(vec, vec.size());
     }
 };
@@ -0,0 +1,160 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "EntityList.h"
+#include "Location.hpp"
+#include "Map.h"
+
+#include <algorithm>
+#include <vector>
+
+template<typename T> struct EntityDistance
+{
+    T* Entity;
+    int32_t Distance;
+};
+
+/**
+ * Calls func for each entity of type T on the tiles overlapping the inclusive range of coordinates, one tile at a
+ * time. Entities without a location are never visited, func still has to check the exact distance.
+ */
+template<typename T, typename TFunc> void ForEachEntityInRange(const CoordsXY& min, const CoordsXY& max, TFunc func)
+{
+    if (max.x < 0 || max.y < 0)
+        return;
+
+    const int32_t left = std::max(min.x, 0) / COORDS_XY_STEP;
+    const int32_t top = std::max(min.y, 0) / COORDS_XY_STEP;
+    const int32_t right = std::min(max.x / COORDS_XY_STEP, MAXIMUM_MAP_SIZE_TECHNICAL - 1);
+    const int32_t bottom = std::min(max.y / COORDS_XY_STEP, MAXIMUM_MAP_SIZE_TECHNICAL - 1);
+    for (int32_t tileX = left; tileX <= right; tileX++)
+    {
+        for (int32_t tileY = top; tileY <= bottom; tileY++)
+        {
+            for (auto* entity : EntityTileList<T>(TileCoordsXY{ tileX, tileY }.ToCoordsXY()))
+            {
+                func(entity);
+            }
+        }
+    }
+}
+
+/**
+ * Finds up to count entities of type T closest to loc that pass filter and are no further than maxDistance,
+ * closest first. Equal distances are ordered by sprite index, so the first result is the one a scan of
+ * EntityList<T> keeping the first of equal distances would find.
+ *
+ * distance must never be less than the larger of the x and y distances to loc. Tiles are searched in rings
+ * around loc until no closer entity can follow. Once more tiles have been searched than there are entities of
+ * type T, the entity list is scanned instead, so sparse types such as staff are never slower than a plain scan.
+ */
+template<typename T, typename TDistance, typename TFilter>
+std::vector<EntityDistance<T>> FindNearestEntities(
+    const CoordsXY& loc, size_t count, int32_t maxDistance, TDistance distance, TFilter filter)
+{
+    std::vector<EntityDistance<T>> result;
+    if (count == 0)
+        return result;
+
+    auto isCloser = [](const EntityDistance<T>& a, const EntityDistance<T>& b) {
+        if (a.Distance != b.Distance)
+            return a.Distance < b.Distance;
+        return a.Entity->sprite_index < b.Entity->sprite_index;
+    };
+    auto consider = [&](T* entity) {
+        if (!filter(entity))
+            return;
+
+        const EntityDistance<T> candidate{ entity, distance(entity) };
+        if (candidate.Distance > maxDistance)
+            return;
+        if (result.size() == count && !isCloser(candidate, result.back()))
+            return;
+
+        result.insert(std::upper_bound(result.begin(), result.end(), candidate, isCloser), candidate);
+        if (result.size() > count)
+        {
+            result.pop_back();
+        }
+    };
+
+    const size_t entityCount = GetEntityListCount(T::cEntityType);
+    size_t tilesSearched = 0;
+    bool useEntityList = false;
+    auto searchTile = [&](int32_t tileX, int32_t tileY) {
+        if (useEntityList || tileX < 0 || tileY < 0 || tileX >= MAXIMUM_MAP_SIZE_TECHNICAL
+            || tileY >= MAXIMUM_MAP_SIZE_TECHNICAL)
+            return;
+
+        if (++tilesSearched > entityCount)
+        {
+            useEntityList = true;
+            return;
+        }
+        for (auto* entity : EntityTileList<T>(TileCoordsXY{ tileX, tileY }.ToCoordsXY()))
+        {
+            consider(entity);
+        }
+    };
+
+    const TileCoordsXY centre(loc);
+    const int32_t lastRing = std::max(
+        { centre.x, centre.y, MAXIMUM_MAP_SIZE_TECHNICAL - 1 - centre.x, MAXIMUM_MAP_SIZE_TECHNICAL - 1 - centre.y });
+    for (int32_t ring = 0; ring <= lastRing && !useEntityList; ring++)
+    {
+        // Nothing on this ring or beyond is closer than this.
+        const int32_t ringDistance = std::max(ring * COORDS_XY_STEP - (COORDS_XY_STEP - 1), 0);
+        if (ringDistance > maxDistance || (result.size() == count && ringDistance > result.back().Distance))
+            break;
+
+        if (ring == 0)
+        {
+            searchTile(centre.x, centre.y);
+            continue;
+        }
+        for (int32_t tileX = centre.x - ring; tileX <= centre.x + ring; tileX++)
+        {
+            searchTile(tileX, centre.y - ring);
+            searchTile(tileX, centre.y + ring);
+        }
+        for (int32_t tileY = centre.y - ring + 1; tileY <= centre.y + ring - 1; tileY++)
+        {
+            searchTile(centre.x - ring, tileY);
+            searchTile(centre.x + ring, tileY);
+        }
+    }
+
+    if (useEntityList)
+    {
+        result.clear();
+        for (auto* entity : EntityList<T>())
+        {
+            if (entity->x != LOCATION_NULL)
+            {
+                consider(entity);
+            }
+        }
+    }
+    return result;
+}
+
+template<typename T, typename TDistance, typename TFilter>
+T* FindNearestEntity(const CoordsXY& loc, int32_t maxDistance, TDistance distance, TFilter filter)
+{
+    auto result = FindNearestEntities<T>(loc, 1, maxDistance, distance, filter);
+    return result.empty() ? nullptr : result.front().Entity;
+}
+
+template<typename T, typename TDistance> T* FindNearestEntity(const CoordsXY& loc, int32_t maxDistance, TDistance distance)
+{
+    return FindNearestEntity<T>(loc, maxDistance, distance, [](const T*) { return true; });
+}
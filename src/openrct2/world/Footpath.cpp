@@ -14,6 +14,7 @@
 #include "../actions/FootpathPlaceAction.h"
 #include "../actions/FootpathRemoveAction.h"
 #include "../actions/LandSetRightsAction.h"
+#include "../config/Config.h"
 #include "../core/Guard.hpp"
 #include "../interface/Window_internal.h"
 #include "../localisation/Localisation.h"
@@ -29,14 +30,17 @@
 #include "../ride/TrackData.h"
 #include "../util/Util.h"
 #include "EntityList.h"
+#include "FootpathGraph.h"
 #include "Map.h"
 #include "MapAnimation.h"
 #include "Park.h"
 #include "Sprite.h"
 #include "Surface.h"
+#include "TileElementsView.h"
 
 #include <algorithm>
 #include <iterator>
+#include <set>
 
 void footpath_update_queue_entrance_banner(const CoordsXY& footpathPos, TileElement* tileElement);
 
@@ -57,6 +61,10 @@ uint8_t gFootpathGroundFlags;
 static uint8_t* _footpathQueueChainNext;
 static uint8_t _footpathQueueChain[64];
 
+// Tiles with changed paths since the wide flags were last updated, only used by incremental updates.
+static std::vector<TileCoordsXY> _wideFlagsDirtyTiles;
+static bool _wideFlagsUpdateAll = true;
+
 // This is the coordinates that a user of the bin should move to
 // rct2: 0x00992A4C
 const CoordsXY BinUseOffsets[4] = {
@@ -565,6 +573,11 @@ static void footpath_connect_corners(const CoordsXY& footpathPos, PathElement* i
         direction = initialDirection;
         tileElements[0].first->SetCorners(tileElements[0].first->GetCorners() | (1 << (direction)));
         map_invalidate_element(tileElements[0].second, reinterpret_cast<TileElement*>(tileElements[0].first));
+
+        for (const auto& [pathElement, pathPos] : tileElements)
+        {
+            footpath_wide_flags_invalidate_tile(pathPos);
+        }
     }
 }
 
@@ -722,7 +735,11 @@ static bool footpath_reconnect_queue_to_path(
             targetQueueElement->SetEdges(targetQueueElement->GetEdges() | (1 << (direction_reverse(direction) & 3)));
         }
         if (action != 0)
+        {
+            footpath_graph_invalidate_tile(footpathPos);
+            footpath_graph_invalidate_tile(targetQueuePos);
             map_invalidate_tile_full(targetQueuePos);
+        }
         return true;
     }
     return false;
@@ -770,6 +787,7 @@ static void loc_6A6FD2(const CoordsXYZ& initialTileElementPos, int32_t direction
         if (!query)
         {
             initialTileElement->AsPath()->SetEdges(initialTileElement->AsPath()->GetEdges() | (1 << direction));
+            footpath_graph_invalidate_tile(initialTileElementPos);
             map_invalidate_element(initialTileElementPos, initialTileElement);
         }
     }
@@ -816,6 +834,7 @@ static void loc_6A6F1F(
     {
         footpath_disconnect_queue_from_path(targetPos, tileElement, 1 + ((flags >> 6) & 1));
         tileElement->AsPath()->SetEdges(tileElement->AsPath()->GetEdges() | (1 << direction_reverse(direction)));
+        footpath_graph_invalidate_tile(targetPos);
         if (tileElement->AsPath()->IsQueue())
         {
             footpath_queue_chain_push(tileElement->AsPath()->GetRideIndex());
@@ -1151,6 +1170,7 @@ void footpath_chain_ride_queue(
             tileElement->AsPath()->SetEdges(tileElement->AsPath()->GetEdges() | (1 << direction_reverse(direction)));
             tileElement->AsPath()->SetRideIndex(rideIndex);
             tileElement->AsPath()->SetStationIndex(entranceIndex);
+            footpath_graph_invalidate_tile(targetQueuePos);
 
             curQueuePos = targetQueuePos;
             map_invalidate_element(targetQueuePos, tileElement);
@@ -1937,6 +1957,106 @@ void footpath_update_path_wide_flags(const CoordsXY& footpathPos)
     } while (!(tileElement++)->IsLastForTile());
 }
 
+bool footpath_wide_flags_is_incremental()
+{
+    return gConfigGeneral.incremental_wide_path_flags && network_get_mode() == NETWORK_MODE_NONE;
+}
+
+void footpath_wide_flags_invalidate_all()
+{
+    _wideFlagsUpdateAll = true;
+    _wideFlagsDirtyTiles.clear();
+}
+
+void footpath_wide_flags_invalidate_tile(const CoordsXY& footpathPos)
+{
+    if (!_wideFlagsUpdateAll)
+    {
+        _wideFlagsDirtyTiles.emplace_back(footpathPos);
+    }
+}
+
+static uint32_t footpath_get_wide_flags(const CoordsXY& footpathPos)
+{
+    uint32_t flags = 0;
+    uint32_t bit = 1;
+    for (auto* pathElement : OpenRCT2::TileElementsView<PathElement>(footpathPos))
+    {
+        if (pathElement->IsWide())
+        {
+            flags |= bit;
+        }
+        bit <<= 1;
+    }
+    return flags;
+}
+
+/**
+ * Updates the wide flags of the tiles around the paths changed since the last call, instead of sweeping the map.
+ * footpath_update_path_wide_flags reads the flags of the tiles before it in the order of the sweep, so tiles are
+ * updated in that order and a changed tile passes the update on to the tiles after it. The flags end up the same
+ * as after a complete sweep.
+ */
+void footpath_update_dirty_wide_flags()
+{
+    if (_wideFlagsUpdateAll)
+    {
+        _wideFlagsUpdateAll = false;
+        _wideFlagsDirtyTiles.clear();
+        for (int32_t y = 0; y < MAXIMUM_MAP_SIZE_TECHNICAL; y++)
+        {
+            for (int32_t x = 0; x < MAXIMUM_MAP_SIZE_TECHNICAL; x++)
+            {
+                const auto footpathPos = TileCoordsXY{ x, y }.ToCoordsXY();
+                if (footpath_graph_tile_has_path(footpathPos))
+                {
+                    footpath_update_path_wide_flags(footpathPos);
+                }
+            }
+        }
+        return;
+    }
+
+    std::set<int32_t> open;
+    auto push = [&open](int32_t x, int32_t y) {
+        if (x >= 0 && y >= 0 && x < MAXIMUM_MAP_SIZE_TECHNICAL && y < MAXIMUM_MAP_SIZE_TECHNICAL)
+        {
+            open.insert(y * MAXIMUM_MAP_SIZE_TECHNICAL + x);
+        }
+    };
+    for (const auto& tile : _wideFlagsDirtyTiles)
+    {
+        for (int32_t y = tile.y - 1; y <= tile.y + 1; y++)
+        {
+            for (int32_t x = tile.x - 1; x <= tile.x + 1; x++)
+            {
+                push(x, y);
+            }
+        }
+    }
+    _wideFlagsDirtyTiles.clear();
+
+    while (!open.empty())
+    {
+        const int32_t tileIndex = *open.begin();
+        open.erase(open.begin());
+
+        const int32_t x = tileIndex % MAXIMUM_MAP_SIZE_TECHNICAL;
+        const int32_t y = tileIndex / MAXIMUM_MAP_SIZE_TECHNICAL;
+        const auto footpathPos = TileCoordsXY{ x, y }.ToCoordsXY();
+        const auto oldFlags = footpath_get_wide_flags(footpathPos);
+        footpath_update_path_wide_flags(footpathPos);
+        if (footpath_get_wide_flags(footpathPos) != oldFlags)
+        {
+            // The tiles that read this one's wide flags.
+            push(x + 1, y);
+            push(x - 1, y + 1);
+            push(x, y + 1);
+            push(x + 1, y + 1);
+        }
+    }
+}
+
 bool footpath_is_blocked_by_vehicle(const TileCoordsXYZ& position)
 {
     auto pathElement = map_get_path_element_at(position);
@@ -1964,6 +2084,7 @@ void footpath_update_queue_entrance_banner(const CoordsXY& footpathPos, TileElem
                     }
                 }
                 tileElement->AsPath()->SetRideIndex(RIDE_ID_NULL);
+                footpath_graph_invalidate_tile(footpathPos);
             }
             break;
         case TILE_ELEMENT_TYPE_ENTRANCE:
@@ -1990,6 +2111,7 @@ static void footpath_remove_edges_towards_here(
 
     auto d = direction_reverse(direction);
     tileElement->AsPath()->SetEdges(tileElement->AsPath()->GetEdges() & ~(1 << d));
+    footpath_graph_invalidate_tile(footpathPos);
     int32_t cd = ((d - 1) & 3);
     tileElement->AsPath()->SetCorners(tileElement->AsPath()->GetCorners() & ~(1 << cd));
     cd = ((cd + 1) & 3);
@@ -2248,7 +2370,10 @@ void footpath_remove_edges_at(const CoordsXY& footpathPos, TileElement* tileElem
     }
 
     if (tileElement->GetType() == TILE_ELEMENT_TYPE_PATH)
+    {
         tileElement->AsPath()->SetEdgesAndCorners(0);
+        footpath_graph_invalidate_tile(footpathPos);
+    }
 }
 
 PathSurfaceEntry* get_path_surface_entry(PathSurfaceIndex entryIndex)
@@ -192,6 +192,10 @@ bool fence_in_the_way(const CoordsXYRangedZ& fencePos, int32_t direction);
 void footpath_chain_ride_queue(
     ride_id_t rideIndex, int32_t entranceIndex, const CoordsXY& footpathPos, TileElement* tileElement, int32_t direction);
 void footpath_update_path_wide_flags(const CoordsXY& footpathPos);
+bool footpath_wide_flags_is_incremental();
+void footpath_wide_flags_invalidate_all();
+void footpath_wide_flags_invalidate_tile(const CoordsXY& footpathPos);
+void footpath_update_dirty_wide_flags();
 bool footpath_is_blocked_by_vehicle(const TileCoordsXYZ& position);
 
 int32_t footpath_is_connected_to_map_edge(const CoordsXYZ& footpathPos, int32_t direction, int32_t flags);
@@ -0,0 +1,445 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "FootpathGraph.h"
+
+#include "../core/String.hpp"
+#include "../peep/GuestPathfinding.h"
+#include "../util/Util.h"
+#include "Footpath.h"
+#include "Map.h"
+
+#include <algorithm>
+#include <bitset>
+#include <limits>
+#include <unordered_map>
+
+static constexpr int32_t MAP_TILES = MAXIMUM_MAP_SIZE_TECHNICAL;
+
+static std::vector<FootpathGraphNode> _nodes;
+// Index in _nodes of each junction, keyed by packed position.
+static std::unordered_map<uint32_t, size_t> _nodeIndices;
+// Junctions whose segments were compiled from each tile, these are compiled again when the tile changes.
+static std::unordered_map<size_t, std::vector<uint32_t>> _tileReaders;
+static std::bitset<MAP_TILES * MAP_TILES> _pathTiles;
+
+static std::vector<TileCoordsXY> _dirtyTiles;
+static bool _rebuildAll = true;
+static uint32_t _generation = 0;
+
+bool FootpathGraphSegment::operator==(const FootpathGraphSegment& other) const
+{
+    return Tiles == other.Tiles && End == other.End && EndsAtJunction == other.EndsAtJunction && Length == other.Length
+        && Rise == other.Rise && SlopedTiles == other.SlopedTiles && QueueRide == other.QueueRide
+        && HasMultipleQueueRides == other.HasMultipleQueueRides;
+}
+
+bool FootpathGraphNode::operator==(const FootpathGraphNode& other) const
+{
+    return Loc == other.Loc && Edges == other.Edges && Segments == other.Segments;
+}
+
+static uint32_t footpath_graph_pack(const TileCoordsXYZ& loc)
+{
+    return (static_cast<uint32_t>(loc.x) << 20) | (static_cast<uint32_t>(loc.y) << 10) | static_cast<uint32_t>(loc.z);
+}
+
+static bool footpath_graph_is_valid_tile(const TileCoordsXY& tile)
+{
+    return tile.x >= 0 && tile.y >= 0 && tile.x < MAP_TILES && tile.y < MAP_TILES;
+}
+
+static size_t footpath_graph_tile_index(const TileCoordsXY& tile)
+{
+    return static_cast<size_t>(tile.y) * MAP_TILES + tile.x;
+}
+
+static bool footpath_graph_is_junction(PathElement* pathElement)
+{
+    return bitcount(path_get_permitted_edges(pathElement)) != 2;
+}
+
+/**
+ * The path at loc a guest walking in direction steps onto, if any.
+ */
+static PathElement* footpath_graph_find_path(const TileCoordsXYZ& loc, Direction direction)
+{
+    if (!footpath_graph_is_valid_tile(loc))
+        return nullptr;
+
+    auto tileElement = map_get_first_element_at(loc.ToCoordsXY());
+    if (tileElement == nullptr)
+        return nullptr;
+    do
+    {
+        if (tileElement->IsGhost() || tileElement->GetType() != TILE_ELEMENT_TYPE_PATH)
+            continue;
+        if (IsValidPathZAndDirection(tileElement, loc.z, direction))
+            return tileElement->AsPath();
+    } while (!(tileElement++)->IsLastForTile());
+    return nullptr;
+}
+
+static FootpathGraphSegment footpath_graph_trace(const TileCoordsXYZ& start, PathElement* pathElement, Direction direction)
+{
+    FootpathGraphSegment segment;
+    TileCoordsXYZ loc = start;
+    while (true)
+    {
+        if (pathElement->IsSloped() && pathElement->GetSlopeDirection() == direction)
+        {
+            loc.z += 2;
+        }
+        loc += TileDirectionDelta[direction];
+        segment.Length++;
+
+        auto nextElement = footpath_graph_find_path(loc, direction);
+        if (nextElement == nullptr)
+            break;
+
+        loc.z = nextElement->base_height;
+        if (nextElement->IsSloped())
+        {
+            segment.SlopedTiles++;
+        }
+        if (footpath_graph_is_junction(nextElement))
+        {
+            segment.EndsAtJunction = true;
+            break;
+        }
+
+        // Paths that do not lead back the way the guest came are one way, the segment ends on them.
+        const auto edges = path_get_permitted_edges(nextElement);
+        const Direction back = direction_reverse(direction);
+        if (!(edges & (1 << back)) || segment.Length == std::numeric_limits<uint16_t>::max())
+            break;
+
+        segment.Tiles.push_back(loc);
+        if (nextElement->IsQueue() && nextElement->GetRideIndex() != RIDE_ID_NULL)
+        {
+            if (segment.QueueRide == RIDE_ID_NULL)
+            {
+                segment.QueueRide = nextElement->GetRideIndex();
+            }
+            else if (segment.QueueRide != nextElement->GetRideIndex())
+            {
+                segment.HasMultipleQueueRides = true;
+            }
+        }
+        direction = bitscanforward(edges & ~(1 << back));
+        pathElement = nextElement;
+    }
+
+    segment.End = loc;
+    segment.Rise = loc.z - start.z;
+    return segment;
+}
+
+static FootpathGraphNode footpath_graph_compile_node(const TileCoordsXY& tile, PathElement* pathElement)
+{
+    FootpathGraphNode node;
+    node.Loc = { tile.x, tile.y, pathElement->base_height };
+    node.Edges = path_get_permitted_edges(pathElement);
+    for (Direction direction : ALL_DIRECTIONS)
+    {
+        if (node.Edges & (1 << direction))
+        {
+            node.Segments[direction] = footpath_graph_trace(node.Loc, pathElement, direction);
+        }
+    }
+    return node;
+}
+
+/**
+ * Calls func for each junction on the tile, returns whether there is any path on it.
+ */
+template<typename TFunc> static bool footpath_graph_read_tile(const TileCoordsXY& tile, TFunc func)
+{
+    auto tileElement = map_get_first_element_at(tile.ToCoordsXY());
+    if (tileElement == nullptr)
+        return false;
+
+    bool hasPath = false;
+    do
+    {
+        if (tileElement->GetType() != TILE_ELEMENT_TYPE_PATH)
+            continue;
+
+        hasPath = true;
+        if (!tileElement->IsGhost() && footpath_graph_is_junction(tileElement->AsPath()))
+        {
+            func(tileElement->AsPath());
+        }
+    } while (!(tileElement++)->IsLastForTile());
+    return hasPath;
+}
+
+template<typename TFunc> static void footpath_graph_for_each_tile_read(const FootpathGraphNode& node, TFunc func)
+{
+    func(TileCoordsXY{ node.Loc.x, node.Loc.y });
+    for (Direction direction : ALL_DIRECTIONS)
+    {
+        if (!(node.Edges & (1 << direction)))
+            continue;
+
+        const auto& segment = node.Segments[direction];
+        for (const auto& tile : segment.Tiles)
+        {
+            func(TileCoordsXY{ tile.x, tile.y });
+        }
+        func(TileCoordsXY{ segment.End.x, segment.End.y });
+    }
+}
+
+static void footpath_graph_add_node(FootpathGraphNode&& node)
+{
+    const auto key = footpath_graph_pack(node.Loc);
+    if (_nodeIndices.find(key) != _nodeIndices.end())
+        return;
+
+    footpath_graph_for_each_tile_read(node, [key](const TileCoordsXY& tile) {
+        if (footpath_graph_is_valid_tile(tile))
+        {
+            _tileReaders[footpath_graph_tile_index(tile)].push_back(key);
+        }
+    });
+    _nodeIndices[key] = _nodes.size();
+    _nodes.push_back(std::move(node));
+}
+
+static FootpathGraphNode footpath_graph_remove_node(uint32_t key)
+{
+    const auto index = _nodeIndices.at(key);
+    auto node = std::move(_nodes[index]);
+    footpath_graph_for_each_tile_read(node, [key](const TileCoordsXY& tile) {
+        auto it = _tileReaders.find(footpath_graph_tile_index(tile));
+        if (it != _tileReaders.end())
+        {
+            auto& readers = it->second;
+            readers.erase(std::remove(readers.begin(), readers.end(), key), readers.end());
+            if (readers.empty())
+            {
+                _tileReaders.erase(it);
+            }
+        }
+    });
+
+    if (index != _nodes.size() - 1)
+    {
+        _nodes[index] = std::move(_nodes.back());
+        _nodeIndices[footpath_graph_pack(_nodes[index].Loc)] = index;
+    }
+    _nodes.pop_back();
+    _nodeIndices.erase(key);
+    return node;
+}
+
+static void footpath_graph_rebuild()
+{
+    _nodes.clear();
+    _nodeIndices.clear();
+    _tileReaders.clear();
+    _pathTiles.reset();
+    for (int32_t y = 0; y < MAP_TILES; y++)
+    {
+        for (int32_t x = 0; x < MAP_TILES; x++)
+        {
+            const TileCoordsXY tile{ x, y };
+            _pathTiles[footpath_graph_tile_index(tile)] = footpath_graph_read_tile(
+                tile, [&tile](PathElement* pathElement) { footpath_graph_add_node(footpath_graph_compile_node(tile, pathElement)); });
+        }
+    }
+}
+
+/**
+ * Compiles the junctions that read any of the changed tiles again, only bumps the generation when the result
+ * differs so placing and removing ghost paths does not throw away caches built from the graph.
+ */
+static bool footpath_graph_update_dirty_tiles()
+{
+    std::sort(_dirtyTiles.begin(), _dirtyTiles.end(), [](const TileCoordsXY& a, const TileCoordsXY& b) {
+        return a.y != b.y ? a.y < b.y : a.x < b.x;
+    });
+    _dirtyTiles.erase(std::unique(_dirtyTiles.begin(), _dirtyTiles.end()), _dirtyTiles.end());
+    _dirtyTiles.erase(
+        std::remove_if(
+            _dirtyTiles.begin(), _dirtyTiles.end(), [](const TileCoordsXY& tile) { return !footpath_graph_is_valid_tile(tile); }),
+        _dirtyTiles.end());
+
+    std::vector<uint32_t> affected;
+    for (const auto& tile : _dirtyTiles)
+    {
+        auto it = _tileReaders.find(footpath_graph_tile_index(tile));
+        if (it != _tileReaders.end())
+        {
+            affected.insert(affected.end(), it->second.begin(), it->second.end());
+        }
+    }
+    std::sort(affected.begin(), affected.end());
+    affected.erase(std::unique(affected.begin(), affected.end()), affected.end());
+
+    std::unordered_map<uint32_t, FootpathGraphNode> previous;
+    for (auto key : affected)
+    {
+        previous.emplace(key, footpath_graph_remove_node(key));
+    }
+
+    bool changed = false;
+    for (const auto& tile : _dirtyTiles)
+    {
+        _pathTiles[footpath_graph_tile_index(tile)] = footpath_graph_read_tile(tile, [&](PathElement* pathElement) {
+            auto node = footpath_graph_compile_node(tile, pathElement);
+            changed |= previous.find(footpath_graph_pack(node.Loc)) == previous.end();
+            footpath_graph_add_node(std::move(node));
+        });
+    }
+
+    // Junctions on tiles that did not change are still junctions, only their segments may differ.
+    for (const auto& [key, oldNode] : previous)
+    {
+        if (_nodeIndices.find(key) == _nodeIndices.end())
+        {
+            const TileCoordsXY tile{ oldNode.Loc.x, oldNode.Loc.y };
+            footpath_graph_read_tile(tile, [&](PathElement* pathElement) {
+                if (pathElement->base_height == oldNode.Loc.z)
+                {
+                    footpath_graph_add_node(footpath_graph_compile_node(tile, pathElement));
+                }
+            });
+        }
+
+        auto it = _nodeIndices.find(key);
+        changed |= it == _nodeIndices.end() || _nodes[it->second] != oldNode;
+    }
+    return changed;
+}
+
+void footpath_graph_invalidate_all()
+{
+    // The wide flags are derived from the same paths, so they follow the same changes.
+    footpath_wide_flags_invalidate_all();
+    _rebuildAll = true;
+    _dirtyTiles.clear();
+}
+
+void footpath_graph_invalidate_tile(const CoordsXY& loc)
+{
+    footpath_wide_flags_invalidate_tile(loc);
+    if (!_rebuildAll)
+    {
+        _dirtyTiles.emplace_back(loc);
+    }
+}
+
+void footpath_graph_update()
+{
+    if (_rebuildAll)
+    {
+        footpath_graph_rebuild();
+        _rebuildAll = false;
+        _generation++;
+    }
+    else if (!_dirtyTiles.empty())
+    {
+        if (footpath_graph_update_dirty_tiles())
+        {
+            _generation++;
+        }
+    }
+    _dirtyTiles.clear();
+}
+
+uint32_t footpath_graph_get_generation()
+{
+    footpath_graph_update();
+    return _generation;
+}
+
+const FootpathGraphNode* footpath_graph_get_node(const TileCoordsXYZ& loc)
+{
+    footpath_graph_update();
+    auto it = _nodeIndices.find(footpath_graph_pack(loc));
+    return it == _nodeIndices.end() ? nullptr : &_nodes[it->second];
+}
+
+const std::vector<FootpathGraphNode>& footpath_graph_get_nodes()
+{
+    footpath_graph_update();
+    return _nodes;
+}
+
+bool footpath_graph_tile_has_path(const CoordsXY& loc)
+{
+    const TileCoordsXY tile(loc);
+    if (!footpath_graph_is_valid_tile(tile))
+        return false;
+
+    footpath_graph_update();
+    return _pathTiles[footpath_graph_tile_index(tile)];
+}
+
+std::vector<std::string> footpath_graph_check()
+{
+    footpath_graph_update();
+
+    std::vector<std::string> errors;
+    std::unordered_map<uint32_t, FootpathGraphNode> compiled;
+    for (int32_t y = 0; y < MAP_TILES; y++)
+    {
+        for (int32_t x = 0; x < MAP_TILES; x++)
+        {
+            const TileCoordsXY tile{ x, y };
+            const bool hasPath = footpath_graph_read_tile(tile, [&](PathElement* pathElement) {
+                auto node = footpath_graph_compile_node(tile, pathElement);
+                compiled.emplace(footpath_graph_pack(node.Loc), std::move(node));
+            });
+            if (hasPath != _pathTiles[footpath_graph_tile_index(tile)])
+            {
+                errors.push_back(String::StdFormat("Tile (%d, %d) path presence differs", x, y));
+            }
+        }
+    }
+
+    for (const auto& [key, node] : compiled)
+    {
+        const auto& loc = node.Loc;
+        auto it = _nodeIndices.find(key);
+        if (it == _nodeIndices.end())
+        {
+            errors.push_back(String::StdFormat("Junction (%d, %d, %d) is missing", loc.x, loc.y, loc.z));
+            continue;
+        }
+
+        const auto& maintained = _nodes[it->second];
+        if (maintained.Edges != node.Edges)
+        {
+            errors.push_back(String::StdFormat(
+                "Junction (%d, %d, %d) has edges %d, expected %d", loc.x, loc.y, loc.z, maintained.Edges, node.Edges));
+            continue;
+        }
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            if ((node.Edges & (1 << direction)) && maintained.Segments[direction] != node.Segments[direction])
+            {
+                errors.push_back(
+                    String::StdFormat("Junction (%d, %d, %d) segment %d differs", loc.x, loc.y, loc.z, direction));
+            }
+        }
+    }
+
+    for (const auto& node : _nodes)
+    {
+        if (compiled.find(footpath_graph_pack(node.Loc)) == compiled.end())
+        {
+            errors.push_back(
+                String::StdFormat("Junction (%d, %d, %d) no longer exists", node.Loc.x, node.Loc.y, node.Loc.z));
+        }
+    }
+    return errors;
+}
@@ -0,0 +1,89 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../ride/RideTypes.h"
+#include "Location.hpp"
+
+#include <array>
+#include <string>
+#include <vector>
+
+/**
+ * The path walked from a junction in one direction up to the next junction, following path tiles that only
+ * lead on in one other direction.
+ */
+struct FootpathGraphSegment
+{
+    // Path tiles walked over between the junction and End.
+    std::vector<TileCoordsXYZ> Tiles;
+    // The next junction, or the first tile without a path leading on such as a ride entrance, shop or the end of
+    // a one way path.
+    TileCoordsXYZ End;
+    bool EndsAtJunction = false;
+    // Steps from the junction to End.
+    uint16_t Length = 0;
+    // Height from the junction to End and the number of sloped paths walked over, including End.
+    int16_t Rise = 0;
+    uint16_t SlopedTiles = 0;
+    // Ride of the queues walked over, RIDE_ID_NULL if there are none.
+    ride_id_t QueueRide = RIDE_ID_NULL;
+    bool HasMultipleQueueRides = false;
+
+    bool operator==(const FootpathGraphSegment& other) const;
+    bool operator!=(const FootpathGraphSegment& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+/**
+ * A path element guests have to choose a direction on, that is every path that does not lead on in exactly two
+ * directions. Dead ends and paths leading nowhere are junctions too.
+ */
+struct FootpathGraphNode
+{
+    TileCoordsXYZ Loc;
+    // Edges guests may leave by, 'no entry' banners excluded.
+    uint8_t Edges = 0;
+    // Only the segments of the directions in Edges are set.
+    std::array<FootpathGraphSegment, NumOrthogonalDirections> Segments;
+
+    bool operator==(const FootpathGraphNode& other) const;
+    bool operator!=(const FootpathGraphNode& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+/**
+ * The footpath network compiled into junctions and the segments between them, so connectivity does not have to
+ * be found again from the tile elements each time. Tiles are marked as changed when paths or banners on them
+ * are placed, removed or modified, the affected junctions are compiled again on the next query.
+ */
+void footpath_graph_invalidate_all();
+void footpath_graph_invalidate_tile(const CoordsXY& loc);
+void footpath_graph_update();
+
+// Changes every time the compiled graph changes, for caches built from it.
+uint32_t footpath_graph_get_generation();
+
+const FootpathGraphNode* footpath_graph_get_node(const TileCoordsXYZ& loc);
+const std::vector<FootpathGraphNode>& footpath_graph_get_nodes();
+
+// Whether there is any path element on the tile, ghosts included.
+bool footpath_graph_tile_has_path(const CoordsXY& loc);
+
+/**
+ * Compiles the graph again from the tile elements and compares it with the maintained one, returns a
+ * description of each difference.
+ */
+std::vector<std::string> footpath_graph_check();
@@ -36,6 +36,8 @@
 #include "../network/network.h"
 #include "../object/ObjectManager.h"
 #include "../object/TerrainSurfaceObject.h"
+#include "../paint/PaintTileCache.h"
+#include "../peep/GuestSurroundings.h"
 #include "../ride/RideData.h"
 #include "../ride/Track.h"
 #include "../ride/TrackData.h"
@@ -46,9 +48,11 @@
 #include "Banner.h"
 #include "Climate.h"
 #include "Footpath.h"
+#include "FootpathGraph.h"
 #include "LargeScenery.h"
 #include "MapAnimation.h"
 #include "Park.h"
+#include "RidePresence.h"
 #include "Scenery.h"
 #include "SmallScenery.h"
 #include "Surface.h"
@@ -100,14 +104,15 @@ int16_t gMapSize;
 int16_t gMapSizeMaxXY;
 int16_t gMapBaseZ;
 
-TileElement gTileElements[MAX_TILE_ELEMENTS_WITH_SPARE_ROOM];
 TileElement* gTileElementTilePointers[MAX_TILE_TILE_ELEMENT_POINTERS];
 std::vector<CoordsXY> gMapSelectionTiles;
 std::vector<PeepSpawn> gPeepSpawns;
 
-TileElement* gNextFreeTileElement;
 uint32_t gNextFreeTileElementPointerIndex;
 
+// TilePointers is left empty, gTileElementTilePointers is used instead.
+static TileElementStorage _tileElements;
+
 bool gLandMountainMode;
 bool gLandPaintMode;
 bool gClearSmallScenery;
@@ -256,9 +261,10 @@ void map_init(int32_t size)
 {
     gNextFreeTileElementPointerIndex = 0;
 
-    for (int32_t i = 0; i < MAX_TILE_TILE_ELEMENT_POINTERS; i++)
+    std::vector<TileElement> tileElements(MAX_TILE_TILE_ELEMENT_POINTERS);
+    for (auto& element : tileElements)
     {
-        TileElement* tile_element = &gTileElements[i];
+        TileElement* tile_element = &element;
         tile_element->ClearAs(TILE_ELEMENT_TYPE_SURFACE);
         tile_element->SetLastForTile(true);
         tile_element->base_height = 14;
@@ -280,7 +286,7 @@ void map_init(int32_t size)
     gMapSize = size;
     gMapSizeMaxXY = size * 32 - 33;
     gMapBaseZ = 7;
-    map_update_tile_pointers();
+    map_set_tile_elements(std::move(tileElements));
     map_remove_out_of_range_elements();
     AutoCreateMapAnimations();
 
@@ -340,38 +346,103 @@ void map_count_remaining_land_rights()
  */
 void map_strip_ghost_flag_from_elements()
 {
-    for (auto& element : gTileElements)
+    for (auto* tileElement : gTileElementTilePointers)
     {
-        element.SetGhost(false);
+        if (tileElement == nullptr)
+            continue;
+        do
+        {
+            tileElement->SetGhost(false);
+        } while (!(tileElement++)->IsLastForTile());
     }
 }
 
+static void map_invalidate_tile_element_caches()
+{
+    ride_presence_invalidate_all();
+    surroundings_invalidate_all();
+    footpath_graph_invalidate_all();
+    PaintTileCacheInvalidateAll();
+}
+
 /**
  *
  *  rct2: 0x0068AFFD
  */
-void map_update_tile_pointers()
+void map_set_tile_elements(std::vector<TileElement>&& tileElements)
 {
-    int32_t i, x, y;
+    std::fill(std::begin(gTileElementTilePointers), std::end(gTileElementTilePointers), nullptr);
+    _tileElements.Blocks.assign(MAX_TILE_TILE_ELEMENT_POINTERS, {});
+    _tileElements.ElementCount = 0;
 
-    for (i = 0; i < MAX_TILE_TILE_ELEMENT_POINTERS; i++)
+    // The elements do not move when the vector is handed to the pool, so the blocks can be set up first
+    TileElement* tileElement = tileElements.data();
+    TileElement* tileElementsEnd = tileElement + tileElements.size();
+    for (int32_t i = 0; i < MAX_TILE_TILE_ELEMENT_POINTERS && tileElement != tileElementsEnd; i++)
     {
-        gTileElementTilePointers[i] = TILE_UNDEFINED_TILE_ELEMENT;
+        auto* firstElement = tileElement;
+        while (!(tileElement++)->IsLastForTile() && tileElement != tileElementsEnd)
+            ;
+
+        const auto numElements = static_cast<size_t>(tileElement - firstElement);
+        gTileElementTilePointers[i] = firstElement;
+        _tileElements.Blocks[i] = { firstElement, numElements };
+        _tileElements.ElementCount += static_cast<uint32_t>(numElements);
     }
+    if (tileElement == tileElementsEnd && !tileElements.empty() && !(tileElement - 1)->IsLastForTile())
+    {
+        log_error("The last tile element is not marked as the last one for its tile.");
+        (tileElement - 1)->SetLastForTile(true);
+    }
+    _tileElements.Pool.Reset(std::move(tileElements));
 
-    TileElement* tileElement = gTileElements;
-    TileElement** tile = gTileElementTilePointers;
-    for (y = 0; y < MAXIMUM_MAP_SIZE_TECHNICAL; y++)
+    map_invalidate_tile_element_caches();
+}
+
+/**
+ * Returns a copy of the elements of the map, with the stacks of all tiles one after another, row by row.
+ */
+std::vector<TileElement> map_get_reorganised_tile_elements()
+{
+    std::vector<TileElement> tileElements;
+    tileElements.reserve(_tileElements.ElementCount);
+    for (const auto* tileElement : gTileElementTilePointers)
     {
-        for (x = 0; x < MAXIMUM_MAP_SIZE_TECHNICAL; x++)
+        if (tileElement == nullptr)
+            continue;
+        do
         {
-            *tile++ = tileElement;
-            while (!(tileElement++)->IsLastForTile())
-                ;
-        }
+            tileElements.push_back(*tileElement);
+        } while (!(tileElement++)->IsLastForTile());
     }
+    return tileElements;
+}
 
-    gNextFreeTileElement = tileElement;
+void map_swap_tile_elements(TileElementStorage& storage)
+{
+    storage.TilePointers.resize(MAX_TILE_TILE_ELEMENT_POINTERS, nullptr);
+    std::swap_ranges(std::begin(gTileElementTilePointers), std::end(gTileElementTilePointers), storage.TilePointers.begin());
+    std::swap(_tileElements.Pool, storage.Pool);
+    std::swap(_tileElements.Blocks, storage.Blocks);
+    std::swap(_tileElements.ElementCount, storage.ElementCount);
+    _tileElements.Blocks.resize(MAX_TILE_TILE_ELEMENT_POINTERS);
+
+    map_invalidate_tile_element_caches();
+}
+
+uint32_t map_get_tile_element_count()
+{
+    return _tileElements.ElementCount;
+}
+
+/**
+ * Updates the number of elements in use after the stack of a tile was changed without tile_element_insert or
+ * tile_element_remove.
+ */
+void map_update_tile_element_count(size_t oldNumElements, size_t newNumElements)
+{
+    _tileElements.ElementCount -= static_cast<uint32_t>(oldNumElements);
+    _tileElements.ElementCount += static_cast<uint32_t>(newNumElements);
 }
 
 /**
@@ -596,6 +667,15 @@ void map_update_path_wide_flags()
         return;
     }
 
+    if (footpath_wide_flags_is_incremental())
+    {
+        footpath_update_dirty_wide_flags();
+        return;
+    }
+
+    // Changes are not tracked while sweeping, switching to incremental updates starts with a full pass.
+    footpath_wide_flags_invalidate_all();
+
     // Presumably update_path_wide_flags is too computationally expensive to call for every
     // tile every update, so gWidePathTileLoopX and gWidePathTileLoopY store the x and y
     // progress. A maximum of 128 calls is done per update.
@@ -603,7 +683,11 @@ void map_update_path_wide_flags()
     uint16_t y = gWidePathTileLoopY;
     for (int32_t i = 0; i < 128; i++)
     {
-        footpath_update_path_wide_flags({ x, y });
+        // Tiles without paths have no wide flags to update.
+        if (footpath_graph_tile_has_path({ x, y }))
+        {
+            footpath_update_path_wide_flags({ x, y });
+        }
 
         // Next x, y tile
         x += COORDS_XY_STEP;
@@ -910,8 +994,29 @@ bool map_is_location_at_edge(const CoordsXY& loc)
  *
  *  rct2: 0x0068B280
  */
-void tile_element_remove(TileElement* tileElement)
+void tile_element_remove(const CoordsXY& loc, TileElement* tileElement)
 {
+    switch (tileElement->GetType())
+    {
+        case TILE_ELEMENT_TYPE_TRACK:
+            ride_presence_invalidate_ride(tileElement->AsTrack()->GetRideIndex());
+            break;
+        case TILE_ELEMENT_TYPE_PATH:
+            footpath_graph_invalidate_tile(loc);
+            if (tileElement->AsPath()->HasAddition())
+            {
+                surroundings_invalidate_tile(loc);
+            }
+            break;
+        case TILE_ELEMENT_TYPE_BANNER:
+            footpath_graph_invalidate_tile(loc);
+            break;
+        case TILE_ELEMENT_TYPE_SMALL_SCENERY:
+        case TILE_ELEMENT_TYPE_LARGE_SCENERY:
+            surroundings_invalidate_tile(loc);
+            break;
+    }
+
     // Replace Nth element by (N+1)th element.
     // This loop will make tileElement point to the old last element position,
     // after copy it to it's new position
@@ -927,10 +1032,8 @@ void tile_element_remove(TileElement* tileElement)
     (tileElement - 1)->SetLastForTile(true);
     tileElement->base_height = MAX_ELEMENT_HEIGHT;
 
-    if ((tileElement + 1) == gNextFreeTileElement)
-    {
-        gNextFreeTileElement--;
-    }
+    // The tile keeps its block, the free element is used by the next insert on it
+    _tileElements.ElementCount--;
 }
 
 /**
@@ -960,11 +1063,12 @@ void map_remove_all_rides()
             case TILE_ELEMENT_TYPE_TRACK:
                 footpath_queue_chain_reset();
                 footpath_remove_edges_at(TileCoordsXY{ it.x, it.y }.ToCoordsXY(), it.element);
-                tile_element_remove(it.element);
+                tile_element_remove(TileCoordsXY{ it.x, it.y }.ToCoordsXY(), it.element);
                 tile_element_iterator_restart_for_tile(&it);
                 break;
         }
     } while (tile_element_iterator_next(&it));
+    footpath_graph_invalidate_all();
 }
 
 /**
@@ -1032,74 +1136,29 @@ void map_invalidate_selection_rect()
 }
 
 /**
- *
+ * Moves the elements of all tiles together into new storage, leaving out the free blocks. Inserting elements does not
+ * need this, it is only useful to release the storage of elements that were removed.
  *  rct2: 0x0068B111
  */
 void map_reorganise_elements()
 {
     context_setcurrentcursor(CursorID::ZZZ);
 
-    auto newTileElements = std::make_unique<TileElement[]>(MAX_TILE_ELEMENTS_WITH_SPARE_ROOM);
-    TileElement* newElementsPtr = newTileElements.get();
-
-    if (newTileElements == nullptr)
-    {
-        log_fatal("Unable to allocate memory for map elements.");
-        return;
-    }
-
-    for (int32_t y = 0; y < MAXIMUM_MAP_SIZE_TECHNICAL; y++)
-    {
-        for (int32_t x = 0; x < MAXIMUM_MAP_SIZE_TECHNICAL; x++)
-        {
-            TileElement* startElement = map_get_first_element_at(TileCoordsXY{ x, y }.ToCoordsXY());
-            if (startElement == nullptr)
-                continue;
-            TileElement* endElement = startElement;
-            while (!(endElement++)->IsLastForTile())
-                ;
-
-            const auto numElements = static_cast<uint32_t>(endElement - startElement);
-            std::memcpy(newElementsPtr, startElement, numElements * sizeof(TileElement));
-            newElementsPtr += numElements;
-        }
-    }
-
-    const auto numElements = static_cast<uint32_t>(newElementsPtr - newTileElements.get());
-    std::memcpy(gTileElements, newTileElements.get(), numElements * sizeof(TileElement));
-    std::memset(gTileElements + numElements, 0, (MAX_TILE_ELEMENTS_WITH_SPARE_ROOM - numElements) * sizeof(TileElement));
-
-    map_update_tile_pointers();
+    map_set_tile_elements(map_get_reorganised_tile_elements());
 }
 
 /**
  *
  *  rct2: 0x0068B044
- *  Returns true on space available for more elements
- *  Reorganises the map elements to check for space
+ *  Returns true if the park can have the given number of elements more. Storage for them is added when needed, so the
+ *  only limit is what a saved park can hold.
  */
 bool map_check_free_elements_and_reorganise(int32_t numElements)
 {
-    if (numElements != 0)
+    if (numElements > 0 && _tileElements.ElementCount + static_cast<uint32_t>(numElements) > MAX_TILE_ELEMENTS)
     {
-        auto tileElementEnd = &gTileElements[MAX_TILE_ELEMENTS];
-
-        // Check if is there is room for the required number of elements
-        auto newTileElementEnd = gNextFreeTileElement + numElements;
-        if (newTileElementEnd > tileElementEnd)
-        {
-            // Defragment the map element list
-            map_reorganise_elements();
-
-            // Check if there is any room again
-            newTileElementEnd = gNextFreeTileElement + numElements;
-            if (newTileElementEnd > tileElementEnd)
-            {
-                // Not enough spare elements left :'(
-                gGameCommandErrorText = STR_ERR_LANDSCAPE_DATA_AREA_FULL;
-                return false;
-            }
-        }
+        gGameCommandErrorText = STR_ERR_LANDSCAPE_DATA_AREA_FULL;
+        return false;
     }
     return true;
 }
@@ -1111,8 +1170,6 @@ bool map_check_free_elements_and_reorganise(int32_t numElements)
 TileElement* tile_element_insert(const CoordsXYZ& loc, int32_t occupiedQuadrants, TileElementType type)
 {
     const auto& tileLoc = TileCoordsXYZ(loc);
-    TileElement *originalTileElement, *newTileElement, *insertedElement;
-    bool isLastForTile = false;
 
     if (!map_check_free_elements_and_reorganise(1))
     {
@@ -1120,65 +1177,107 @@ TileElement* tile_element_insert(const CoordsXYZ& loc, int32_t occupiedQuadrants
         return nullptr;
     }
 
-    newTileElement = gNextFreeTileElement;
-    originalTileElement = gTileElementTilePointers[tileLoc.y * MAXIMUM_MAP_SIZE_TECHNICAL + tileLoc.x];
+    const auto tileIndex = tileLoc.y * MAXIMUM_MAP_SIZE_TECHNICAL + tileLoc.x;
+    auto* originalTileElement = gTileElementTilePointers[tileIndex];
+    auto& block = _tileElements.Blocks[tileIndex];
 
-    // Set tile index pointer to point to new element block
-    gTileElementTilePointers[tileLoc.y * MAXIMUM_MAP_SIZE_TECHNICAL + tileLoc.x] = newTileElement;
+    // The new element goes above all elements it is not below
+    size_t numElements = 0;
+    size_t insertIndex = 0;
+    if (originalTileElement != nullptr)
+    {
+        const auto* tileElement = originalTileElement;
+        do
+        {
+            if (insertIndex == numElements && loc.z >= tileElement->GetBaseZ())
+            {
+                insertIndex++;
+            }
+            numElements++;
+        } while (!(tileElement++)->IsLastForTile());
+    }
 
-    if (originalTileElement == nullptr)
+    TileElement* tileElements;
+    if (originalTileElement != nullptr && originalTileElement == block.Elements && numElements < block.Size)
     {
-        isLastForTile = true;
+        // Room left in the block, only move up the elements above
+        tileElements = originalTileElement;
+        std::copy_backward(tileElements + insertIndex, tileElements + numElements, tileElements + numElements + 1);
     }
     else
     {
-        // Copy all elements that are below the insert height
-        while (loc.z >= originalTileElement->GetBaseZ())
+        size_t blockSize;
+        tileElements = _tileElements.Pool.Allocate(numElements + 1, blockSize);
+        if (tileElements == nullptr)
         {
-            // Copy over map element
-            *newTileElement = *originalTileElement;
-            originalTileElement->base_height = MAX_ELEMENT_HEIGHT;
-            originalTileElement++;
-            newTileElement++;
+            log_error("Cannot insert new element, too many elements on tile");
+            gGameCommandErrorText = STR_ERR_LANDSCAPE_DATA_AREA_FULL;
+            return nullptr;
+        }
 
-            if ((newTileElement - 1)->IsLastForTile())
-            {
-                // No more elements above the insert element
-                (newTileElement - 1)->SetLastForTile(false);
-                isLastForTile = true;
-                break;
-            }
+        if (originalTileElement != nullptr)
+        {
+            std::copy_n(originalTileElement, insertIndex, tileElements);
+            std::copy(originalTileElement + insertIndex, originalTileElement + numElements, tileElements + insertIndex + 1);
+        }
+
+        // Tiles can be pointed at elements outside of their block, which then stays with them until the map is
+        // reorganised, as they may be pointed back at it.
+        if (originalTileElement != nullptr && originalTileElement == block.Elements)
+        {
+            _tileElements.Pool.Free(block.Elements, block.Size);
         }
+        else if (block.Elements != nullptr)
+        {
+            log_warning(
+                "Tile %d, %d does not point at its block, which is not reused until the map is reorganised.", tileLoc.x,
+                tileLoc.y);
+        }
+        block = { tileElements, blockSize };
+        gTileElementTilePointers[tileIndex] = tileElements;
     }
 
-    // Insert new map element
-    insertedElement = newTileElement;
-    newTileElement->type = 0;
-    newTileElement->SetType(static_cast<uint8_t>(type));
-    newTileElement->SetBaseZ(loc.z);
-    newTileElement->Flags = 0;
-    newTileElement->SetLastForTile(isLastForTile);
-    newTileElement->SetOccupiedQuadrants(occupiedQuadrants);
-    newTileElement->SetClearanceZ(loc.z);
-    newTileElement->owner = 0;
-    std::memset(&newTileElement->pad_05, 0, sizeof(newTileElement->pad_05));
-    std::memset(&newTileElement->pad_08, 0, sizeof(newTileElement->pad_08));
-    newTileElement++;
-
-    // Insert rest of map elements above insert height
-    if (!isLastForTile)
+    const bool isLastForTile = insertIndex == numElements;
+    if (isLastForTile && numElements != 0)
     {
-        do
-        {
-            // Copy over map element
-            *newTileElement = *originalTileElement;
-            originalTileElement->base_height = MAX_ELEMENT_HEIGHT;
-            originalTileElement++;
-            newTileElement++;
-        } while (!((newTileElement - 1)->IsLastForTile()));
+        tileElements[numElements - 1].SetLastForTile(false);
+    }
+
+    // Insert new map element
+    auto* insertedElement = &tileElements[insertIndex];
+    insertedElement->type = 0;
+    insertedElement->SetType(static_cast<uint8_t>(type));
+    insertedElement->SetBaseZ(loc.z);
+    insertedElement->Flags = 0;
+    insertedElement->SetLastForTile(isLastForTile);
+    insertedElement->SetOccupiedQuadrants(occupiedQuadrants);
+    insertedElement->SetClearanceZ(loc.z);
+    insertedElement->owner = 0;
+    std::memset(&insertedElement->pad_05, 0, sizeof(insertedElement->pad_05));
+    std::memset(&insertedElement->pad_08, 0, sizeof(insertedElement->pad_08));
+    _tileElements.ElementCount++;
+
+    switch (type)
+    {
+        case TileElementType::Track:
+            // The ride is only set by the caller, the tile is read again before the next query.
+            ride_presence_invalidate_tile(loc);
+            break;
+        case TileElementType::Banner:
+            footpath_graph_invalidate_tile(loc);
+            break;
+        case TileElementType::Path:
+            footpath_graph_invalidate_tile(loc);
+            surroundings_invalidate_tile(loc);
+            break;
+        case TileElementType::SmallScenery:
+        case TileElementType::LargeScenery:
+            surroundings_invalidate_tile(loc);
+            break;
+        default:
+            break;
     }
 
-    gNextFreeTileElement = newTileElement;
     return insertedElement;
 }
 
@@ -1710,7 +1809,7 @@ static void clear_element_at(const CoordsXY& loc, TileElement** elementPtr)
             // If asking nicely did not work, forcibly remove this to avoid an infinite loop.
             if (result->Error != GameActions::Status::Ok)
             {
-                tile_element_remove(element);
+                tile_element_remove(loc, element);
             }
             break;
         }
@@ -1722,7 +1821,7 @@ static void clear_element_at(const CoordsXY& loc, TileElement** elementPtr)
             // If asking nicely did not work, forcibly remove this to avoid an infinite loop.
             if (result->Error != GameActions::Status::Ok)
             {
-                tile_element_remove(element);
+                tile_element_remove(loc, element);
             }
         }
         break;
@@ -1734,7 +1833,7 @@ static void clear_element_at(const CoordsXY& loc, TileElement** elementPtr)
             // If asking nicely did not work, forcibly remove this to avoid an infinite loop.
             if (result->Error != GameActions::Status::Ok)
             {
-                tile_element_remove(element);
+                tile_element_remove(loc, element);
             }
         }
         break;
@@ -1746,12 +1845,12 @@ static void clear_element_at(const CoordsXY& loc, TileElement** elementPtr)
             // If asking nicely did not work, forcibly remove this to avoid an infinite loop.
             if (result->Error != GameActions::Status::Ok)
             {
-                tile_element_remove(element);
+                tile_element_remove(loc, element);
             }
             break;
         }
         default:
-            tile_element_remove(element);
+            tile_element_remove(loc, element);
             break;
     }
 }
@@ -2005,6 +2104,9 @@ static void map_invalidate_tile_under_zoom(int32_t x, int32_t y, int32_t z0, int
     if (gOpenRCT2Headless)
         return;
 
+    if (gConfigGeneral.paint_tile_cache)
+        PaintTileCacheInvalidateTile({ x, y });
+
     int32_t x1, y1, x2, y2;
 
     x += 16;
@@ -2064,6 +2166,9 @@ void map_invalidate_region(const CoordsXY& mins, const CoordsXY& maxs)
 {
     int32_t x0, y0, x1, y1, left, right, top, bottom;
 
+    if (gConfigGeneral.paint_tile_cache)
+        PaintTileCacheInvalidateRegion(mins, maxs);
+
     x0 = mins.x + 16;
     y0 = mins.y + 16;
 
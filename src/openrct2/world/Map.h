@@ -13,6 +13,7 @@
 #include "../common.h"
 #include "Location.hpp"
 #include "TileElement.h"
+#include "TileElementPool.h"
 
 #include <initializer_list>
 #include <vector>
@@ -33,8 +34,8 @@ constexpr const int32_t MINIMUM_LAND_HEIGHT_BIG = MINIMUM_LAND_HEIGHT * COORDS_Z
 
 #define MAP_MINIMUM_X_Y (-MAXIMUM_MAP_SIZE_TECHNICAL)
 
-constexpr const uint32_t MAX_TILE_ELEMENTS_WITH_SPARE_ROOM = 0x30000;
-constexpr const uint32_t MAX_TILE_ELEMENTS = MAX_TILE_ELEMENTS_WITH_SPARE_ROOM - 512;
+// As many elements as a saved park can hold, storage for them is only allocated when they are used.
+constexpr const uint32_t MAX_TILE_ELEMENTS = 0x30000;
 #define MAX_TILE_TILE_ELEMENT_POINTERS (MAXIMUM_MAP_SIZE_TECHNICAL * MAXIMUM_MAP_SIZE_TECHNICAL)
 #define MAX_PEEP_SPAWNS 2
 
@@ -117,13 +118,11 @@ extern uint8_t gMapSelectArrowDirection;
 
 extern uint8_t gMapGroundFlags;
 
-extern TileElement gTileElements[MAX_TILE_ELEMENTS_WITH_SPARE_ROOM];
 extern TileElement* gTileElementTilePointers[MAX_TILE_TILE_ELEMENT_POINTERS];
 
 extern std::vector<CoordsXY> gMapSelectionTiles;
 extern std::vector<PeepSpawn> gPeepSpawns;
 
-extern TileElement* gNextFreeTileElement;
 extern uint32_t gNextFreeTileElementPointerIndex;
 
 // Used in the land tool window to enable mountain tool / land smoothing
@@ -174,13 +173,47 @@ public:
     }
 };
 
+// The block of the pool holding the elements of a tile.
+struct TileElementBlock
+{
+    TileElement* Elements = nullptr;
+    size_t Size = 0;
+};
+
+/**
+ * The tile elements of a map along with the storage they are in. Swapping it with the one of the map moves the
+ * elements in and out without copying them, so pointers to them stay valid.
+ */
+struct TileElementStorage
+{
+    TileElementPool Pool;
+    std::vector<TileElementBlock> Blocks;
+    std::vector<TileElement*> TilePointers;
+    uint32_t ElementCount = 0;
+};
+
 void map_init(int32_t size);
 
 void map_count_remaining_land_rights();
 void map_strip_ghost_flag_from_elements();
-void map_update_tile_pointers();
+
+/**
+ * Replaces the elements of the map with the given ones, which hold the stacks of all tiles one after another, row by
+ * row.
+ */
+void map_set_tile_elements(std::vector<TileElement>&& tileElements);
+std::vector<TileElement> map_get_reorganised_tile_elements();
+void map_swap_tile_elements(TileElementStorage& storage);
+uint32_t map_get_tile_element_count();
+void map_update_tile_element_count(size_t oldNumElements, size_t newNumElements);
 TileElement* map_get_first_element_at(const CoordsXY& elementPos);
 TileElement* map_get_nth_element_at(const CoordsXY& coords, int32_t n);
+
+/**
+ * Points a tile at the given elements, which need not be in its block. Inserting on the tile before it is pointed back
+ * at its block abandons the block until the map is reorganised. Callers that change the number of elements on the tile
+ * update it with map_update_tile_element_count.
+ */
 void map_set_tile_element(const TileCoordsXY& tilePos, TileElement* elements);
 int32_t map_height_from_slope(const CoordsXY& coords, int32_t slopeDirection, bool isSloped);
 BannerElement* map_get_banner_element_at(const CoordsXYZ& bannerPos, uint8_t direction);
@@ -207,7 +240,7 @@ bool map_is_location_owned(const CoordsXYZ& loc);
 bool map_is_location_in_park(const CoordsXY& coords);
 bool map_is_location_owned_or_has_rights(const CoordsXY& loc);
 bool map_surface_is_blocked(const CoordsXY& mapCoords);
-void tile_element_remove(TileElement* tileElement);
+void tile_element_remove(const CoordsXY& loc, TileElement* tileElement);
 void map_remove_all_rides();
 void map_invalidate_map_selection_tiles();
 void map_invalidate_selection_rect();
@@ -0,0 +1,295 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "RidePresence.h"
+
+#include "../Game.h"
+#include "../ride/Ride.h"
+#include "Map.h"
+#include "TileElementsView.h"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+using namespace OpenRCT2;
+
+static constexpr int32_t MAP_TILES = MAXIMUM_MAP_SIZE_TECHNICAL;
+
+// Rides with track on each tile.
+static std::vector<RidePresenceSet> _tileRides;
+// Rides on the tiles within RIDE_PRESENCE_RADIUS in the same row, a query ORs one of these per row.
+static std::vector<RidePresenceSet> _rowRides;
+// Tiles each ride has track on, used to find the affected tiles when a track element is removed.
+static std::array<std::vector<TileCoordsXY>, MAX_RIDES> _rideTiles;
+
+static std::vector<TileCoordsXY> _dirtyTiles;
+static RidePresenceSet _dirtyRides;
+static bool _rebuildAll = true;
+
+static RidePresenceSet _tallRides;
+static uint32_t _tallRidesTick = 0;
+static bool _tallRidesValid = false;
+
+static size_t ride_presence_tile_index(int32_t x, int32_t y)
+{
+    return static_cast<size_t>(y) * MAP_TILES + x;
+}
+
+static bool ride_presence_has_pending_changes()
+{
+    return _rebuildAll || !_dirtyTiles.empty() || _dirtyRides.any();
+}
+
+static RidePresenceSet ride_presence_read_tile(const TileCoordsXY& tile)
+{
+    RidePresenceSet rides;
+    for (auto* trackElement : TileElementsView<TrackElement>(tile.ToCoordsXY()))
+    {
+        auto rideIndex = trackElement->GetRideIndex();
+        if (rideIndex < MAX_RIDES)
+        {
+            rides[rideIndex] = true;
+        }
+    }
+    return rides;
+}
+
+static RidePresenceSet ride_presence_find_tall_rides()
+{
+    // Realistic as you can usually see them from anywhere in the park
+    RidePresenceSet rides;
+    for (auto& ride : GetRideManager())
+    {
+        if (ride.highest_drop_height > 66 || ride.excitement >= RIDE_RATING(8, 00))
+        {
+            rides[ride.id] = true;
+        }
+    }
+    return rides;
+}
+
+static void ride_presence_update_row(int32_t x, int32_t y)
+{
+    const int32_t left = std::max(x - RIDE_PRESENCE_RADIUS, 0);
+    const int32_t right = std::min(x + RIDE_PRESENCE_RADIUS, MAP_TILES - 1);
+    RidePresenceSet rides;
+    for (int32_t i = left; i <= right; i++)
+    {
+        rides |= _tileRides[ride_presence_tile_index(i, y)];
+    }
+    _rowRides[ride_presence_tile_index(x, y)] = rides;
+}
+
+static void ride_presence_update_tile(const TileCoordsXY& tile)
+{
+    if (tile.x < 0 || tile.y < 0 || tile.x >= MAP_TILES || tile.y >= MAP_TILES)
+        return;
+
+    auto& tileRides = _tileRides[ride_presence_tile_index(tile.x, tile.y)];
+    const auto newRides = ride_presence_read_tile(tile);
+    const auto changed = tileRides ^ newRides;
+    if (changed.none())
+        return;
+
+    for (size_t rideIndex = 0; rideIndex < changed.size(); rideIndex++)
+    {
+        if (!changed[rideIndex])
+            continue;
+
+        auto& rideTiles = _rideTiles[rideIndex];
+        if (newRides[rideIndex])
+        {
+            rideTiles.push_back(tile);
+        }
+        else
+        {
+            rideTiles.erase(std::remove(rideTiles.begin(), rideTiles.end(), tile), rideTiles.end());
+        }
+    }
+    tileRides = newRides;
+
+    const int32_t left = std::max(tile.x - RIDE_PRESENCE_RADIUS, 0);
+    const int32_t right = std::min(tile.x + RIDE_PRESENCE_RADIUS, MAP_TILES - 1);
+    for (int32_t x = left; x <= right; x++)
+    {
+        ride_presence_update_row(x, tile.y);
+    }
+}
+
+static void ride_presence_rebuild()
+{
+    _tileRides.assign(MAP_TILES * MAP_TILES, {});
+    _rowRides.assign(MAP_TILES * MAP_TILES, {});
+    for (auto& rideTiles : _rideTiles)
+    {
+        rideTiles.clear();
+    }
+
+    for (int32_t y = 0; y < MAP_TILES; y++)
+    {
+        for (int32_t x = 0; x < MAP_TILES; x++)
+        {
+            const TileCoordsXY tile{ x, y };
+            const auto rides = ride_presence_read_tile(tile);
+            if (rides.none())
+                continue;
+
+            _tileRides[ride_presence_tile_index(x, y)] = rides;
+            for (size_t rideIndex = 0; rideIndex < rides.size(); rideIndex++)
+            {
+                if (rides[rideIndex])
+                {
+                    _rideTiles[rideIndex].push_back(tile);
+                }
+            }
+
+            // Most tiles have no track, so spread each tile over its row rather than gathering for every tile.
+            const int32_t left = std::max(x - RIDE_PRESENCE_RADIUS, 0);
+            const int32_t right = std::min(x + RIDE_PRESENCE_RADIUS, MAP_TILES - 1);
+            for (int32_t i = left; i <= right; i++)
+            {
+                _rowRides[ride_presence_tile_index(i, y)] |= rides;
+            }
+        }
+    }
+}
+
+void ride_presence_invalidate_all()
+{
+    _rebuildAll = true;
+    _tallRidesValid = false;
+}
+
+void ride_presence_invalidate_tile(const CoordsXY& loc)
+{
+    if (!_rebuildAll)
+    {
+        _dirtyTiles.emplace_back(loc);
+    }
+}
+
+void ride_presence_invalidate_ride(ride_id_t rideIndex)
+{
+    if (!_rebuildAll && rideIndex < MAX_RIDES)
+    {
+        _dirtyRides[rideIndex] = true;
+    }
+}
+
+void ride_presence_update()
+{
+    if (_rebuildAll)
+    {
+        ride_presence_rebuild();
+        _rebuildAll = false;
+    }
+    else
+    {
+        for (size_t rideIndex = 0; rideIndex < _dirtyRides.size(); rideIndex++)
+        {
+            if (_dirtyRides[rideIndex])
+            {
+                // Updating a tile can remove it from the list being iterated.
+                auto rideTiles = _rideTiles[rideIndex];
+                for (const auto& tile : rideTiles)
+                {
+                    ride_presence_update_tile(tile);
+                }
+            }
+        }
+        for (const auto& tile : _dirtyTiles)
+        {
+            ride_presence_update_tile(tile);
+        }
+    }
+    _dirtyTiles.clear();
+    _dirtyRides.reset();
+
+    // Excitement and drop height can change on any tick, this is cheap enough to redo every time.
+    _tallRides = ride_presence_find_tall_rides();
+    _tallRidesTick = gCurrentTicks;
+    _tallRidesValid = true;
+}
+
+RidePresenceSet ride_presence_scan_nearby(const CoordsXY& loc)
+{
+    RidePresenceSet rides;
+    constexpr auto radius = RIDE_PRESENCE_RADIUS * COORDS_XY_STEP;
+    int32_t cx = floor2(loc.x, COORDS_XY_STEP);
+    int32_t cy = floor2(loc.y, COORDS_XY_STEP);
+    for (int32_t tileX = cx - radius; tileX <= cx + radius; tileX += COORDS_XY_STEP)
+    {
+        for (int32_t tileY = cy - radius; tileY <= cy + radius; tileY += COORDS_XY_STEP)
+        {
+            auto location = CoordsXY{ tileX, tileY };
+            if (!map_is_location_valid(location))
+                continue;
+
+            rides |= ride_presence_read_tile(TileCoordsXY(location));
+        }
+    }
+    return rides;
+}
+
+RidePresenceSet ride_presence_get_nearby(const CoordsXY& loc)
+{
+    if (ride_presence_has_pending_changes())
+    {
+        return ride_presence_scan_nearby(loc);
+    }
+
+    // Tile of the centre, the scan above starts from the same rounded down coordinate.
+    const int32_t centreX = floor2(loc.x, COORDS_XY_STEP) / COORDS_XY_STEP;
+    const int32_t centreY = floor2(loc.y, COORDS_XY_STEP) / COORDS_XY_STEP;
+    const int32_t left = centreX - RIDE_PRESENCE_RADIUS;
+    const int32_t right = centreX + RIDE_PRESENCE_RADIUS;
+    const int32_t top = std::max(centreY - RIDE_PRESENCE_RADIUS, 0);
+    const int32_t bottom = std::min(centreY + RIDE_PRESENCE_RADIUS, MAP_TILES - 1);
+
+    RidePresenceSet rides;
+    if (right < 0 || left >= MAP_TILES)
+        return rides;
+
+    if (centreX < 0 || centreX >= MAP_TILES)
+    {
+        // Window is clipped by the map edge, the row sums of the centre column do not cover it.
+        return ride_presence_scan_nearby(loc);
+    }
+
+    for (int32_t y = top; y <= bottom; y++)
+    {
+        rides |= _rowRides[ride_presence_tile_index(centreX, y)];
+    }
+    return rides;
+}
+
+RidePresenceSet ride_presence_get_area(const TileCoordsXY& min, const TileCoordsXY& max)
+{
+    const bool pending = ride_presence_has_pending_changes();
+    RidePresenceSet rides;
+    for (int32_t y = std::max(min.y, 0); y <= std::min(max.y, MAP_TILES - 1); y++)
+    {
+        for (int32_t x = std::max(min.x, 0); x <= std::min(max.x, MAP_TILES - 1); x++)
+        {
+            rides |= pending ? ride_presence_read_tile({ x, y }) : _tileRides[ride_presence_tile_index(x, y)];
+        }
+    }
+    return rides;
+}
+
+RidePresenceSet ride_presence_get_tall_rides()
+{
+    if (_tallRidesValid && _tallRidesTick == gCurrentTicks)
+    {
+        return _tallRides;
+    }
+
+    return ride_presence_find_tall_rides();
+}
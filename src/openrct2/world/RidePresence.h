@@ -0,0 +1,54 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../ride/Ride.h"
+#include "Location.hpp"
+
+#include <bitset>
+
+// Distance in tiles at which guests notice rides around them.
+constexpr int32_t RIDE_PRESENCE_RADIUS = 10;
+
+using RidePresenceSet = std::bitset<MAX_RIDES>;
+
+/**
+ * Index of which rides have track on each tile, so finding the rides near a guest does not have to
+ * walk the tile elements of every surrounding tile. Changes to track are recorded as they happen and
+ * applied by ride_presence_update, which peep_update_all calls before any guest is updated.
+ */
+void ride_presence_invalidate_all();
+void ride_presence_invalidate_tile(const CoordsXY& loc);
+// Used when a track element is removed and its location is not known.
+void ride_presence_invalidate_ride(ride_id_t rideIndex);
+
+/**
+ * Applies all pending changes and refreshes the set of rides that can be seen from anywhere.
+ * Must not run at the same time as any query.
+ */
+void ride_presence_update();
+
+/**
+ * Rides with track within RIDE_PRESENCE_RADIUS tiles of the given location. Walks the tiles instead
+ * while changes are pending, so the result is always the same as ride_presence_scan_nearby.
+ */
+RidePresenceSet ride_presence_get_nearby(const CoordsXY& loc);
+RidePresenceSet ride_presence_scan_nearby(const CoordsXY& loc);
+
+/**
+ * Rides with track on any tile of the inclusive range, clipped to the map.
+ */
+RidePresenceSet ride_presence_get_area(const TileCoordsXY& min, const TileCoordsXY& max);
+
+/**
+ * Rides that are tall or exciting enough to be considered from anywhere in the park.
+ */
+RidePresenceSet ride_presence_get_tall_rides();
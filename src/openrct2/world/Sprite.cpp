@@ -18,17 +18,117 @@
 #include "../interface/Viewport.h"
 #include "../localisation/Date.h"
 #include "../localisation/Localisation.h"
+#include "../peep/GuestPrecompute.h"
+#include "../peep/GuestSurroundings.h"
 #include "../scenario/Scenario.h"
 #include "Fountain.h"
 
 #include <algorithm>
 #include <cmath>
 #include <iterator>
+#include <memory>
 #include <numeric>
+#include <utility>
 #include <vector>
 
-static rct_sprite _spriteList[MAX_ENTITIES];
-static std::array<std::list<uint16_t>, EnumValue(EntityType::Count)> gEntityLists;
+/**
+ * Entities of one type are allocated from fixed size chunks so that they are packed together in memory and
+ * their addresses remain stable for their whole lifetime.
+ */
+class EntityPool
+{
+private:
+    static constexpr size_t ChunkSize = 64;
+
+    size_t _elementSize = 0;
+    std::vector<std::unique_ptr<uint8_t[]>> _chunks;
+    std::vector<SpriteBase*> _freeSlots;
+
+public:
+    explicit EntityPool(size_t elementSize)
+        : _elementSize((elementSize + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1))
+    {
+    }
+
+    size_t GetElementSize() const
+    {
+        return _elementSize;
+    }
+
+    SpriteBase* Allocate()
+    {
+        if (_freeSlots.empty())
+        {
+            auto& chunk = _chunks.emplace_back(std::make_unique<uint8_t[]>(_elementSize * ChunkSize));
+            // Push back to front so that slots are handed out in address order.
+            for (size_t i = ChunkSize; i > 0; i--)
+            {
+                _freeSlots.push_back(reinterpret_cast<SpriteBase*>(chunk.get() + ((i - 1) * _elementSize)));
+            }
+        }
+        auto* slot = _freeSlots.back();
+        _freeSlots.pop_back();
+        return slot;
+    }
+
+    void Free(SpriteBase* slot)
+    {
+        _freeSlots.push_back(slot);
+    }
+
+    void Clear()
+    {
+        _chunks.clear();
+        _freeSlots.clear();
+    }
+};
+
+static EntityPool CreateEntityPool(EntityType type)
+{
+    switch (type)
+    {
+        case EntityType::Vehicle:
+            return EntityPool(sizeof(Vehicle));
+        case EntityType::Guest:
+            return EntityPool(sizeof(Guest));
+        case EntityType::Staff:
+            return EntityPool(sizeof(Staff));
+        case EntityType::Litter:
+            return EntityPool(sizeof(Litter));
+        case EntityType::SteamParticle:
+            return EntityPool(sizeof(SteamParticle));
+        case EntityType::MoneyEffect:
+            return EntityPool(sizeof(MoneyEffect));
+        case EntityType::CrashedVehicleParticle:
+            return EntityPool(sizeof(VehicleCrashParticle));
+        case EntityType::ExplosionCloud:
+            return EntityPool(sizeof(ExplosionCloud));
+        case EntityType::CrashSplash:
+            return EntityPool(sizeof(CrashSplashParticle));
+        case EntityType::ExplosionFlare:
+            return EntityPool(sizeof(ExplosionFlare));
+        case EntityType::JumpingFountain:
+            return EntityPool(sizeof(JumpingFountain));
+        case EntityType::Balloon:
+            return EntityPool(sizeof(Balloon));
+        case EntityType::Duck:
+            return EntityPool(sizeof(Duck));
+        default:
+            return EntityPool(sizeof(rct_sprite));
+    }
+}
+
+template<size_t... TIndex> static auto CreateEntityPools(std::index_sequence<TIndex...>)
+{
+    return std::array<EntityPool, sizeof...(TIndex)>{ CreateEntityPool(static_cast<EntityType>(TIndex))... };
+}
+
+static std::array<EntityPool, EnumValue(EntityType::Count)> _entityPools = CreateEntityPools(
+    std::make_index_sequence<EnumValue(EntityType::Count)>());
+// Every id resolves to either its pool slot or its entry in _freeEntities while unused.
+static SpriteBase* _entityPointers[MAX_ENTITIES];
+static SpriteBase _freeEntities[MAX_ENTITIES];
+static std::array<std::vector<uint16_t>, EnumValue(EntityType::Count)> gEntityLists;
 static std::vector<uint16_t> _freeIdList;
 
 static bool _spriteFlashingList[MAX_ENTITIES];
@@ -145,7 +245,7 @@ std::string rct_sprite_checksum::ToString() const
 
 SpriteBase* try_get_sprite(size_t spriteIndex)
 {
-    return spriteIndex >= MAX_ENTITIES ? nullptr : &_spriteList[spriteIndex].misc;
+    return spriteIndex >= MAX_ENTITIES ? nullptr : _entityPointers[spriteIndex];
 }
 
 SpriteBase* get_sprite(size_t spriteIndex)
@@ -218,7 +318,7 @@ static void ResetFreeIds()
     std::iota(std::rbegin(_freeIdList), std::rend(_freeIdList), 0);
 }
 
-const std::list<uint16_t>& GetEntityList(const EntityType id)
+const std::vector<uint16_t>& GetEntityList(const EntityType id)
 {
     return gEntityLists[EnumValue(id)];
 }
@@ -230,17 +330,17 @@ const std::list<uint16_t>& GetEntityList(const EntityType id)
 void reset_sprite_list()
 {
     gSavedAge = 0;
-    std::memset(static_cast<void*>(_spriteList), 0, sizeof(_spriteList));
+    for (auto& pool : _entityPools)
+    {
+        pool.Clear();
+    }
     for (int32_t i = 0; i < MAX_ENTITIES; ++i)
     {
-        auto* spr = GetEntity(i);
-        if (spr == nullptr)
-        {
-            continue;
-        }
-
-        spr->Type = EntityType::Null;
-        spr->sprite_index = i;
+        auto& freeEntity = _freeEntities[i];
+        freeEntity = {};
+        freeEntity.Type = EntityType::Null;
+        freeEntity.sprite_index = i;
+        _entityPointers[i] = &freeEntity;
 
         _spriteFlashingList[i] = false;
     }
@@ -263,12 +363,17 @@ void reset_sprite_spatial_index()
     {
         vec.clear();
     }
+    surroundings_litter_reset();
     for (size_t i = 0; i < MAX_ENTITIES; i++)
     {
         auto* spr = GetEntity(i);
         if (spr != nullptr && spr->Type != EntityType::Null)
         {
             SpriteSpatialInsert(spr, { spr->x, spr->y });
+            if (spr->Type == EntityType::Litter)
+            {
+                surroundings_litter_added({ spr->x, spr->y });
+            }
         }
     }
 }
@@ -345,13 +450,13 @@ rct_sprite_checksum sprite_checksum()
 
 #endif // DISABLE_NETWORK
 
-static void sprite_reset(SpriteBase* sprite)
+static void sprite_reset(SpriteBase* sprite, size_t size)
 {
     // Need to retain how the sprite is linked in lists
     uint16_t sprite_index = sprite->sprite_index;
     _spriteFlashingList[sprite_index] = false;
 
-    std::memset(sprite, 0, sizeof(rct_sprite));
+    std::memset(static_cast<void*>(sprite), 0, size);
 
     sprite->sprite_index = sprite_index;
     sprite->Type = EntityType::Null;
@@ -365,17 +470,33 @@ void sprite_clear_all_unused()
 {
     for (auto index : _freeIdList)
     {
-        auto* entity = GetEntity(index);
-        if (entity == nullptr)
-        {
-            continue;
-        }
-        sprite_reset(entity);
-
-        _spriteFlashingList[entity->sprite_index] = false;
+        sprite_reset(&_freeEntities[index], sizeof(SpriteBase));
     }
 }
 
+static SpriteBase* AllocateEntity(uint16_t index, const EntityType type)
+{
+    auto& pool = _entityPools[EnumValue(type)];
+    auto* entity = pool.Allocate();
+    entity->sprite_index = index;
+    // Need to reset all sprite data, as the uninitialised values
+    // may contain garbage and cause a desync later on.
+    sprite_reset(entity, pool.GetElementSize());
+    _entityPointers[index] = entity;
+    return entity;
+}
+
+static void FreeEntity(SpriteBase* entity)
+{
+    const auto index = entity->sprite_index;
+    auto& pool = _entityPools[EnumValue(entity->Type)];
+
+    // The memory is kept zeroed so a pointer to a removed entity still reads as a null entity.
+    sprite_reset(entity, pool.GetElementSize());
+    pool.Free(entity);
+    _entityPointers[index] = &_freeEntities[index];
+}
+
 static constexpr uint16_t MAX_MISC_SPRITES = 300;
 static void AddToEntityList(SpriteBase* entity)
 {
@@ -412,11 +533,9 @@ uint16_t GetMiscEntityCount()
     return count;
 }
 
-static void PrepareNewEntity(SpriteBase* base, const EntityType type)
+static SpriteBase* PrepareNewEntity(uint16_t index, const EntityType type)
 {
-    // Need to reset all sprite data, as the uninitialised values
-    // may contain garbage and cause a desync later on.
-    sprite_reset(base);
+    auto* base = AllocateEntity(index, type);
 
     base->Type = type;
     AddToEntityList(base);
@@ -431,6 +550,7 @@ static void PrepareNewEntity(SpriteBase* base, const EntityType type)
     base->sprite_left = LOCATION_NULL;
 
     SpriteSpatialInsert(base, { LOCATION_NULL, 0 });
+    return base;
 }
 
 rct_sprite* create_sprite(EntityType type)
@@ -453,15 +573,10 @@ rct_sprite* create_sprite(EntityType type)
         }
     }
 
-    auto* sprite = GetEntity(_freeIdList.back());
-    if (sprite == nullptr)
-    {
-        return nullptr;
-    }
+    const auto index = _freeIdList.back();
     _freeIdList.pop_back();
 
-    PrepareNewEntity(sprite, type);
-
+    auto* sprite = PrepareNewEntity(index, type);
     return reinterpret_cast<rct_sprite*>(sprite);
 }
 
@@ -473,16 +588,9 @@ SpriteBase* CreateEntityAt(const uint16_t index, const EntityType type)
         return nullptr;
     }
 
-    auto* entity = GetEntity(index);
-    if (entity == nullptr)
-    {
-        return nullptr;
-    }
-
     _freeIdList.erase(std::next(id).base());
 
-    PrepareNewEntity(entity, type);
-    return entity;
+    return PrepareNewEntity(index, type);
 }
 /**
  *
@@ -620,11 +728,18 @@ static void SpriteSpatialMove(SpriteBase* sprite, const CoordsXY& newLoc)
 {
     size_t newIndex = GetSpatialIndexOffset(newLoc.x, newLoc.y);
     size_t currentIndex = GetSpatialIndexOffset(sprite->x, sprite->y);
-    if (newIndex == currentIndex)
-        return;
+    if (newIndex != currentIndex)
+    {
+        SpriteSpatialRemove(sprite);
+        SpriteSpatialInsert(sprite, newLoc);
+    }
 
-    SpriteSpatialRemove(sprite);
-    SpriteSpatialInsert(sprite, newLoc);
+    // Surroundings count litter lying on a tile edge apart, so moves within a tile are tracked as well.
+    if (sprite->Type == EntityType::Litter)
+    {
+        surroundings_litter_removed({ sprite->x, sprite->y });
+        surroundings_litter_added(newLoc);
+    }
 }
 
 void SpriteBase::MoveTo(const CoordsXYZ& newLocation)
@@ -699,7 +814,11 @@ void sprite_remove(SpriteBase* sprite)
     AddToFreeList(sprite->sprite_index);
 
     SpriteSpatialRemove(sprite);
-    sprite_reset(sprite);
+    if (sprite->Type == EntityType::Litter)
+    {
+        surroundings_litter_removed({ sprite->x, sprite->y });
+    }
+    FreeEntity(sprite);
 }
 
 static bool litter_can_be_at(const CoordsXYZ& mapPos)
@@ -757,6 +876,7 @@ void litter_create(const CoordsXYZD& litterPos, LitterType type)
 
         if (newestLitter != nullptr)
         {
+            guest_precompute_invalidate({ newestLitter->x, newestLitter->y });
             newestLitter->Invalidate();
             sprite_remove(newestLitter);
         }
@@ -773,6 +893,7 @@ void litter_create(const CoordsXYZD& litterPos, LitterType type)
     litter->SubType = type;
     litter->MoveTo(offsetLitterPos);
     litter->creationTick = gScenarioTicks;
+    guest_precompute_invalidate(offsetLitterPos);
 }
 
 /**
@@ -76,7 +76,7 @@ struct TileElementBase
     uint8_t clearance_height; // 3
     uint8_t owner;            // 4
 
-    void Remove();
+    void Remove(const CoordsXY& loc);
 
     uint8_t GetType() const;
     void SetType(uint8_t newType);
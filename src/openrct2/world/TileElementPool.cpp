@@ -0,0 +1,108 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TileElementPool.h"
+
+static size_t GetSizeClass(size_t size)
+{
+    size_t sizeClass = 0;
+    while ((size >> (sizeClass + 1)) != 0)
+    {
+        sizeClass++;
+    }
+    return sizeClass;
+}
+
+void TileElementPool::AddFreeBlock(TileElement* elements, size_t size)
+{
+    if (size == 0)
+        return;
+
+    _freeBlocks[GetSizeClass(size)].push_back({ elements, size });
+    _freeCount += size;
+}
+
+TileElement* TileElementPool::Allocate(size_t minSize, size_t& size)
+{
+    if (minSize > MaxBlockSize)
+        return nullptr;
+
+    size_t blockSize = 1;
+    while (blockSize < minSize)
+    {
+        blockSize <<= 1;
+    }
+
+    // Take a free block from the smallest size class that fits and keep the rest of it free
+    for (auto sizeClass = GetSizeClass(blockSize); sizeClass < SizeClassCount; sizeClass++)
+    {
+        auto& freeBlocks = _freeBlocks[sizeClass];
+        if (freeBlocks.empty())
+            continue;
+
+        auto block = freeBlocks.back();
+        freeBlocks.pop_back();
+        _freeCount -= block.Size;
+        AddFreeBlock(block.Elements + blockSize, block.Size - blockSize);
+        size = blockSize;
+        return block.Elements;
+    }
+
+    if (_chunks.empty() || _chunks.back().size() - _lastChunkUsed < blockSize)
+    {
+        if (!_chunks.empty())
+        {
+            auto& lastChunk = _chunks.back();
+            AddFreeBlock(lastChunk.data() + _lastChunkUsed, lastChunk.size() - _lastChunkUsed);
+        }
+        _chunks.emplace_back(ChunkSize);
+        _lastChunkUsed = 0;
+    }
+
+    auto* elements = _chunks.back().data() + _lastChunkUsed;
+    _lastChunkUsed += blockSize;
+    size = blockSize;
+    return elements;
+}
+
+void TileElementPool::Free(TileElement* elements, size_t size)
+{
+    AddFreeBlock(elements, size);
+}
+
+void TileElementPool::Reset(std::vector<TileElement>&& elements)
+{
+    for (auto& freeBlocks : _freeBlocks)
+    {
+        freeBlocks.clear();
+    }
+    _freeCount = 0;
+
+    _chunks.clear();
+    _lastChunkUsed = elements.size();
+    if (!elements.empty())
+    {
+        _chunks.push_back(std::move(elements));
+    }
+}
+
+size_t TileElementPool::GetCapacity() const
+{
+    size_t capacity = 0;
+    for (const auto& chunk : _chunks)
+    {
+        capacity += chunk.size();
+    }
+    return capacity;
+}
+
+size_t TileElementPool::GetFreeCount() const
+{
+    return _freeCount;
+}
@@ -0,0 +1,66 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "TileElement.h"
+
+#include <array>
+#include <vector>
+
+/**
+ * Storage for the element stacks of tiles. Each stack lives in a block of consecutive elements, which is handed out
+ * with room to spare so most inserts only move the elements above the new one. Outgrown blocks are kept on free
+ * lists by size and used again, rather than left behind as gaps that have to be removed by reorganising the map.
+ * Storage is added a chunk at a time and elements never move when it grows.
+ */
+class TileElementPool
+{
+public:
+    static constexpr size_t ChunkSize = 0x10000;
+    // Block sizes are powers of two up to a whole chunk, except for blocks of stacks given to Reset.
+    static constexpr size_t MaxBlockSize = ChunkSize;
+
+private:
+    static constexpr size_t SizeClassCount = 17;
+
+    struct FreeBlock
+    {
+        TileElement* Elements;
+        size_t Size;
+    };
+
+    std::vector<std::vector<TileElement>> _chunks;
+    size_t _lastChunkUsed = 0;
+    // Blocks of at least 1 << n elements are kept in _freeBlocks[n].
+    std::array<std::vector<FreeBlock>, SizeClassCount> _freeBlocks;
+    size_t _freeCount = 0;
+
+    void AddFreeBlock(TileElement* elements, size_t size);
+
+public:
+    /**
+     * Returns a block of at least minSize elements, nullptr if minSize is above MaxBlockSize. The number of elements
+     * in the block is written to size, which has to be passed to Free along with it.
+     */
+    TileElement* Allocate(size_t minSize, size_t& size);
+    void Free(TileElement* elements, size_t size);
+
+    /**
+     * Drops all blocks and takes the given elements as the only chunk, with the stacks of the tiles one after another
+     * in blocks of their own size.
+     */
+    void Reset(std::vector<TileElement>&& elements);
+
+    // Elements in all chunks, used or not.
+    size_t GetCapacity() const;
+    // Elements in free blocks, which does not include the unused end of the last chunk.
+    size_t GetFreeCount() const;
+};
@@ -17,6 +17,7 @@
 #include "../interface/Window.h"
 #include "../interface/Window_internal.h"
 #include "../localisation/Localisation.h"
+#include "../peep/GuestSurroundings.h"
 #include "../ride/Station.h"
 #include "../ride/Track.h"
 #include "../ride/TrackData.h"
@@ -225,7 +226,7 @@ namespace OpenRCT2::TileInspector
                 tileElement->RemoveBannerEntry();
             }
 
-            tile_element_remove(tileElement);
+            tile_element_remove(loc, tileElement);
             map_invalidate_tile_full(loc);
 
             if (auto* inspector = GetTileInspectorWithPos(loc); inspector != nullptr)
@@ -708,6 +709,7 @@ namespace OpenRCT2::TileInspector
         if (isExecuting)
         {
             pathElement->AsPath()->SetIsBroken(broken);
+            surroundings_invalidate_tile(loc);
 
             map_invalidate_tile_full(loc);
 
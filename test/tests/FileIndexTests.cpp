@@ -0,0 +1,126 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <openrct2/core/File.h>
+#include <openrct2/core/FileIndex.hpp>
+#include <openrct2/core/FileSystem.hpp>
+#include <string>
+#include <vector>
+
+// Indexes text files, with the text as the item. Empty files have no item.
+class TextFileIndex final : public FileIndex<std::string>
+{
+public:
+    mutable std::atomic<int32_t> NumCreated = 0;
+
+    explicit TextFileIndex(const fs::path& directory)
+        : FileIndex(
+            "text file index", 0x54584554, 1, (directory / "text.idx").u8string(), "*.txt", { directory.u8string() })
+    {
+    }
+
+protected:
+    std::tuple<bool, std::string> Create(int32_t, const std::string& path) const override
+    {
+        NumCreated++;
+        auto text = File::ReadAllText(path);
+        return std::make_tuple(!text.empty(), text);
+    }
+
+    void Serialise(DataSerialiser& ds, std::string& item) const override
+    {
+        ds << item;
+    }
+};
+
+class FileIndexTests : public testing::Test
+{
+protected:
+    fs::path _directory;
+
+    void SetUp() override
+    {
+        _directory = fs::temp_directory_path() / "openrct2_file_index_tests";
+        fs::remove_all(_directory);
+        fs::create_directories(_directory);
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(_directory);
+    }
+
+    void WriteFile(const std::string& name, const std::string& text)
+    {
+        std::ofstream(_directory / name, std::ios::binary) << text;
+    }
+
+    // Loads the index again, as on the next start
+    std::vector<std::string> Load(int32_t& numCreated)
+    {
+        TextFileIndex index(_directory);
+        auto items = index.LoadOrBuild(0);
+        numCreated = index.NumCreated;
+        std::sort(items.begin(), items.end());
+        return items;
+    }
+};
+
+TEST_F(FileIndexTests, only_changed_files_are_indexed)
+{
+    WriteFile("a.txt", "alpha");
+    WriteFile("b.txt", "bravo");
+    WriteFile("c.txt", "charlie");
+    WriteFile("empty.txt", "");
+
+    int32_t numCreated = 0;
+    EXPECT_EQ(Load(numCreated), (std::vector<std::string>{ "alpha", "bravo", "charlie" }));
+    EXPECT_EQ(numCreated, 4);
+
+    EXPECT_EQ(Load(numCreated), (std::vector<std::string>{ "alpha", "bravo", "charlie" }));
+    EXPECT_EQ(numCreated, 0);
+
+    // Changed and new files are indexed, removed ones are dropped
+    WriteFile("b.txt", "bravo 2");
+    WriteFile("d.txt", "delta");
+    fs::remove(_directory / "c.txt");
+    EXPECT_EQ(Load(numCreated), (std::vector<std::string>{ "alpha", "bravo 2", "delta" }));
+    EXPECT_EQ(numCreated, 2);
+
+    // A file that is only touched keeps its item
+    auto aPath = _directory / "a.txt";
+    fs::last_write_time(aPath, fs::last_write_time(aPath) + std::chrono::hours(1));
+    EXPECT_EQ(Load(numCreated), (std::vector<std::string>{ "alpha", "bravo 2", "delta" }));
+    EXPECT_EQ(numCreated, 0);
+
+    // Unless its contents changed, even if its size did not
+    WriteFile("a.txt", "ALPHA");
+    fs::last_write_time(aPath, fs::last_write_time(aPath) + std::chrono::hours(2));
+    EXPECT_EQ(Load(numCreated), (std::vector<std::string>{ "ALPHA", "bravo 2", "delta" }));
+    EXPECT_EQ(numCreated, 1);
+}
+
+TEST_F(FileIndexTests, rebuild_indexes_all_files)
+{
+    WriteFile("a.txt", "alpha");
+    WriteFile("b.txt", "bravo");
+
+    int32_t numCreated = 0;
+    Load(numCreated);
+
+    TextFileIndex index(_directory);
+    auto items = index.Rebuild(0);
+    EXPECT_EQ(items.size(), 2U);
+    EXPECT_EQ(index.NumCreated, 2);
+}
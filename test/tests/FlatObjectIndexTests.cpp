@@ -0,0 +1,125 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <openrct2/core/File.h>
+#include <openrct2/core/FileSystem.hpp>
+#include <openrct2/object/FlatObjectIndex.h>
+#include <string>
+#include <vector>
+
+static ObjectIndexItem CreateItem(const std::string& identifier, const char* entryName, const std::string& name)
+{
+    ObjectIndexItem item{};
+    item.Identifier = identifier;
+    std::copy_n(entryName, sizeof(item.ObjectEntry.name), item.ObjectEntry.name);
+    item.ObjectEntry.SetType(ObjectType::SceneryGroup);
+    item.Path = "objects/" + name + ".parkobj";
+    item.Name = name;
+    return item;
+}
+
+static std::vector<ObjectIndexItem> CreateItems()
+{
+    std::vector<ObjectIndexItem> items;
+    items.push_back(CreateItem("", "LEGACY  ", "Legacy"));
+    items.push_back(CreateItem("rct2.scgtrees", "SCGTREES", "Trees"));
+    items.back().Authors = { "Chris Sawyer", "Simon Foster" };
+    items.back().Sources = { ObjectSourceGame::RCT2, ObjectSourceGame::WackyWorlds };
+    items.back().RideInfo.RideType[1] = 7;
+    rct_object_entry legacyEntry = items[0].ObjectEntry;
+    items.back().SceneryGroupInfo.Entries = { ObjectEntryDescriptor(legacyEntry), ObjectEntryDescriptor("rct2.tic") };
+    items.push_back(CreateItem("rct2.scgtrees", "SCGTREE2", "Trees 2"));
+    items.back().Authors = { "Chris Sawyer", "Simon Foster" };
+    return items;
+}
+
+TEST(FlatObjectIndexTests, items_and_lookups)
+{
+    auto items = CreateItems();
+    FlatObjectIndex index(FlatObjectIndex::Create(items, 0, 0, 0));
+    ASSERT_EQ(index.GetCount(), items.size());
+
+    auto trees = index.GetItem(1);
+    EXPECT_EQ(trees.Id, 1U);
+    EXPECT_EQ(trees.Identifier, "rct2.scgtrees");
+    EXPECT_EQ(trees.Name, "Trees");
+    EXPECT_EQ(trees.Path, "objects/Trees.parkobj");
+    EXPECT_EQ(trees.ObjectEntry.GetName(), "SCGTREES");
+    EXPECT_EQ(trees.RideInfo.RideType[1], 7);
+    EXPECT_EQ(trees.GetFirstSourceGame(), ObjectSourceGame::RCT2);
+
+    std::vector<std::string> authors;
+    for (auto author : trees.Authors)
+    {
+        authors.emplace_back(author);
+    }
+    EXPECT_EQ(authors, items[1].Authors);
+
+    std::vector<ObjectEntryDescriptor> entries;
+    for (const auto& entry : trees.SceneryGroupInfo.Entries)
+    {
+        entries.push_back(entry);
+    }
+    ASSERT_EQ(entries.size(), 2U);
+    EXPECT_EQ(entries[0].Generation, ObjectGeneration::DAT);
+    EXPECT_EQ(entries[0].Entry.GetName(), "LEGACY  ");
+    EXPECT_EQ(entries[1].Generation, ObjectGeneration::JSON);
+    EXPECT_EQ(entries[1].Identifier, "rct2.tic");
+
+    auto legacy = index.GetItem(0);
+    EXPECT_TRUE(legacy.Identifier.empty());
+    EXPECT_TRUE(legacy.Authors.empty());
+    EXPECT_EQ(legacy.GetFirstSourceGame(), ObjectSourceGame::Custom);
+
+    // The last item with an identifier is the one found by it
+    EXPECT_EQ(index.FindObject(std::string_view("rct2.scgtrees")), 2U);
+    EXPECT_EQ(index.FindObject(std::string_view("rct2.missing")), std::nullopt);
+    EXPECT_EQ(index.FindObject(std::string_view()), std::nullopt);
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        EXPECT_EQ(index.FindObject(items[i].ObjectEntry), i);
+    }
+    rct_object_entry missing{};
+    missing.SetName("MISSING");
+    EXPECT_EQ(index.FindObject(missing), std::nullopt);
+}
+
+TEST(FlatObjectIndexTests, open_checks_files_language_and_version)
+{
+    auto directory = fs::temp_directory_path() / "openrct2_flat_object_index_tests";
+    fs::remove_all(directory);
+    auto path = (directory / "objects.flat").u8string();
+
+    auto data = FlatObjectIndex::Create(CreateItems(), 1, 27, 1234);
+    ASSERT_TRUE(FlatObjectIndex::Write(path, data));
+
+    auto index = FlatObjectIndex::Open(path, 1, 27, 1234);
+    ASSERT_NE(index, nullptr);
+    EXPECT_EQ(index->GetItem(2).Name, "Trees 2");
+    EXPECT_EQ(FlatObjectIndex::Open(path, 2, 27, 1234), nullptr);
+    EXPECT_EQ(FlatObjectIndex::Open(path, 1, 28, 1234), nullptr);
+    EXPECT_EQ(FlatObjectIndex::Open(path, 1, 27, 4321), nullptr);
+
+    index.reset();
+    data = FlatObjectIndex::Create({ CreateItem("rct2.tic", "TIC     ", "Tree") }, 1, 27, 5678);
+    ASSERT_TRUE(FlatObjectIndex::Write(path, data));
+    index = FlatObjectIndex::Open(path, 1, 27, 5678);
+    ASSERT_NE(index, nullptr);
+    EXPECT_EQ(index->GetCount(), 1U);
+    index.reset();
+
+    // Damaged files are not used
+    data.resize(data.size() / 2);
+    File::WriteAllBytes(path, data.data(), data.size());
+    EXPECT_EQ(FlatObjectIndex::Open(path, 1, 27, 5678), nullptr);
+
+    fs::remove_all(directory);
+}
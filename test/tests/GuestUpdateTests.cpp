@@ -0,0 +1,69 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <gtest/gtest.h>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/GameState.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/config/Config.h>
+#include <openrct2/platform/platform.h>
+#include <openrct2/world/Sprite.h>
+#include <string>
+#include <vector>
+
+using namespace OpenRCT2;
+
+// Every guest runs the precomputed part of its update once every 512 ticks, cover that twice.
+constexpr int32_t updatesToTest = 1024;
+
+static std::vector<std::string> RunGuestUpdates(bool parallel)
+{
+    std::vector<std::string> checksums;
+
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+    core_init();
+
+    auto context = CreateContext();
+    if (!context->Initialise())
+        return checksums;
+
+    gConfigGeneral.multithreading_guest_update = parallel;
+
+    std::string path = TestData::GetParkPath("bpb.sv6");
+    load_from_sv6(path.c_str());
+    game_load_init();
+
+    auto gs = context->GetGameState();
+    for (int32_t i = 0; i < updatesToTest; i++)
+    {
+        gs->UpdateLogic();
+        checksums.push_back(sprite_checksum().ToString());
+    }
+
+    gConfigGeneral.multithreading_guest_update = false;
+    return checksums;
+}
+
+TEST(GuestUpdateTests, ParallelMatchesSerial)
+{
+    auto serial = RunGuestUpdates(false);
+    ASSERT_EQ(serial.size(), static_cast<size_t>(updatesToTest));
+
+    auto parallel = RunGuestUpdates(true);
+    ASSERT_EQ(parallel.size(), static_cast<size_t>(updatesToTest));
+
+    for (int32_t i = 0; i < updatesToTest; i++)
+    {
+        ASSERT_EQ(serial[i], parallel[i]) << "Sprite checksum differs at tick " << i;
+    }
+}
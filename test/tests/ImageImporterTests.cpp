@@ -56,3 +56,38 @@ TEST_F(ImageImporterTests, Import_Logo)
     auto hash = GetHash(result.Buffer.data(), result.Buffer.size());
     ASSERT_EQ(0xCEF27C7D, hash);
 }
+
+TEST_F(ImageImporterTests, Import_PaletteColours)
+{
+    // Every colour of the palette, followed by a colour that is not in it and a transparent pixel
+    Image image;
+    image.Width = (PALETTE_SIZE + 2) / 2;
+    image.Height = 2;
+    image.Depth = 32;
+    for (int32_t i = 0; i < PALETTE_SIZE; i++)
+    {
+        const auto colour = StandardPalette[i];
+        image.Pixels.insert(image.Pixels.end(), { colour.Red, colour.Green, colour.Blue, 255 });
+    }
+    image.Pixels.insert(image.Pixels.end(), { 255, 0, 254, 255 });
+    image.Pixels.insert(image.Pixels.end(), { 35, 35, 23, 0 });
+
+    ImageImporter importer;
+    auto result = importer.Import(image);
+    ASSERT_EQ(static_cast<size_t>(PALETTE_SIZE + 2), result.Buffer.size());
+
+    // Colours that are in the palette more than once get their first index
+    for (int32_t i = 0; i < PALETTE_SIZE; i++)
+    {
+        int32_t expected = 0;
+        while (StandardPalette[expected].Red != StandardPalette[i].Red
+               || StandardPalette[expected].Green != StandardPalette[i].Green
+               || StandardPalette[expected].Blue != StandardPalette[i].Blue)
+        {
+            expected++;
+        }
+        EXPECT_EQ(expected, result.Buffer[i]) << "palette index " << i;
+    }
+    EXPECT_EQ(0, result.Buffer[PALETTE_SIZE]);
+    EXPECT_EQ(0, result.Buffer[PALETTE_SIZE + 1]);
+}
@@ -0,0 +1,116 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <openrct2/core/File.h>
+#include <openrct2/core/FileSystem.hpp>
+#include <openrct2/drawing/ImageImporter.h>
+#include <openrct2/object/ImageTableCache.h>
+#include <string>
+#include <vector>
+
+using namespace OpenRCT2::Drawing;
+
+static ImageImporter::ImportResult ImportImage(ImageImporter::IMPORT_FLAGS flags)
+{
+    // A diagonal line of palette colours on a transparent background
+    Image image;
+    image.Width = 8;
+    image.Height = 8;
+    image.Depth = 32;
+    image.Pixels.resize(image.Width * image.Height * 4);
+    for (uint32_t i = 0; i < image.Width; i++)
+    {
+        const auto colour = StandardPalette[10 + i];
+        auto* pixel = &image.Pixels[(i * image.Width + i) * 4];
+        pixel[0] = colour.Red;
+        pixel[1] = colour.Green;
+        pixel[2] = colour.Blue;
+        pixel[3] = 255;
+    }
+
+    ImageImporter importer;
+    return importer.Import(image, 0, 0, flags);
+}
+
+static void ExpectSameImage(const rct_g1_element& expected, const rct_g1_element& actual)
+{
+    EXPECT_EQ(expected.width, actual.width);
+    EXPECT_EQ(expected.height, actual.height);
+    EXPECT_EQ(expected.flags, actual.flags);
+    ASSERT_NE(actual.offset, nullptr);
+    auto length = g1_calculate_data_size(&expected);
+    ASSERT_EQ(length, g1_calculate_data_size(&actual));
+    EXPECT_TRUE(std::equal(expected.offset, expected.offset + length, actual.offset));
+}
+
+TEST(ImageTableCacheTests, images_are_kept_for_the_same_content)
+{
+    auto directory = fs::temp_directory_path() / "openrct2_image_table_cache_tests";
+    fs::remove_all(directory);
+    auto path = (directory / "images.dat").u8string();
+
+    auto rle = ImportImage(ImageImporter::IMPORT_FLAGS::RLE);
+    auto raw = ImportImage(ImageImporter::IMPORT_FLAGS::NONE);
+    {
+        ImageTableCache cache(path, 1234);
+        EXPECT_FALSE(cache.Find("images/line.png", true).has_value());
+        cache.Add("images/line.png", rle.Element);
+        cache.Add("images/line.png", raw.Element);
+        ASSERT_TRUE(cache.Save());
+    }
+
+    ImageTableCache cache(path, 1234);
+    auto cachedRle = cache.Find("images/line.png", true);
+    ASSERT_TRUE(cachedRle.has_value());
+    ExpectSameImage(rle.Element, *cachedRle);
+    auto cachedRaw = cache.Find("images/line.png", false);
+    ASSERT_TRUE(cachedRaw.has_value());
+    ExpectSameImage(raw.Element, *cachedRaw);
+    EXPECT_FALSE(cache.Find("images/other.png", true).has_value());
+
+    // The images of another version of the object are not used
+    EXPECT_FALSE(ImageTableCache(path, 4321).Find("images/line.png", true).has_value());
+
+    // Damaged files are not used
+    auto data = File::ReadAllBytes(path);
+    data.back() ^= 0xFF;
+    File::WriteAllBytes(path, data.data(), data.size());
+    EXPECT_FALSE(ImageTableCache(path, 1234).Find("images/line.png", true).has_value());
+    data.resize(data.size() / 2);
+    File::WriteAllBytes(path, data.data(), data.size());
+    EXPECT_FALSE(ImageTableCache(path, 1234).Find("images/line.png", true).has_value());
+
+    fs::remove_all(directory);
+}
+
+TEST(ImageTableCacheTests, unused_files_are_removed)
+{
+    auto directory = fs::temp_directory_path() / "openrct2_image_table_cache_unused_tests";
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+
+    const uint8_t data[] = { 1, 2, 3 };
+    auto write = [&](const char* name) {
+        auto path = (directory / name).u8string();
+        File::WriteAllBytes(path, data, sizeof(data));
+        return path;
+    };
+    auto used = write("00000000000004d2.dat");
+    auto unused = write("00000000000010e1.dat");
+    auto other = write("images.dat");
+
+    ImageTableCache::RemoveUnused(directory.u8string(), { 1234 });
+    EXPECT_TRUE(File::Exists(used));
+    EXPECT_FALSE(File::Exists(unused));
+    EXPECT_FALSE(File::Exists(other));
+
+    fs::remove_all(directory);
+}
@@ -1,4 +1,5 @@
 #include "TestData.h"
+#include "openrct2/actions/FootpathRemoveAction.h"
 #include "openrct2/core/StringReader.h"
 #include "openrct2/peep/GuestPathfinding.h"
 #include "openrct2/peep/Peep.h"
@@ -12,7 +13,9 @@
 #include <openrct2/ParkImporter.h>
 #include <openrct2/platform/platform.h>
 #include <openrct2/world/Footpath.h>
+#include <openrct2/world/FootpathGraph.h>
 #include <openrct2/world/Map.h>
+#include <optional>
 
 using namespace OpenRCT2;
 
@@ -251,3 +254,51 @@ INSTANTIATE_TEST_CASE_P(
         SimplePathfindingScenario("PathWithFences", { 11, 6, 14 }, 10000),
         SimplePathfindingScenario("PathWithCliff", { 7, 17, 14 }, 10000)),
     SimplePathfindingScenario::ToName);
+
+class FootpathGraphTest : public PathfindingTestBase
+{
+protected:
+    static ::testing::AssertionResult AssertGraphMatchesMap()
+    {
+        auto errors = footpath_graph_check();
+        if (errors.empty())
+            return ::testing::AssertionSuccess();
+
+        auto failure = ::testing::AssertionFailure() << errors.size() << " difference(s) in the footpath graph:";
+        for (const auto& error : errors)
+        {
+            failure << "\n" << error;
+        }
+        return failure;
+    }
+};
+
+TEST_F(FootpathGraphTest, MatchesMapAfterRemovingPath)
+{
+    ASSERT_TRUE(AssertGraphMatchesMap());
+    ASSERT_FALSE(footpath_graph_get_nodes().empty());
+
+    // Remove a path from the middle of a segment, which splits it into two dead ends.
+    std::optional<TileCoordsXYZ> removed;
+    for (const auto& node : footpath_graph_get_nodes())
+    {
+        for (const auto& segment : node.Segments)
+        {
+            if (!segment.Tiles.empty())
+            {
+                removed = segment.Tiles[segment.Tiles.size() / 2];
+                break;
+            }
+        }
+        if (removed.has_value())
+            break;
+    }
+    ASSERT_TRUE(removed.has_value());
+
+    auto action = FootpathRemoveAction(removed->ToCoordsXYZ());
+    auto result = GameActions::Execute(&action);
+    ASSERT_EQ(result->Error, GameActions::Status::Ok);
+
+    EXPECT_EQ(map_get_footpath_element(removed->ToCoordsXYZ()), nullptr);
+    EXPECT_TRUE(AssertGraphMatchesMap());
+}
@@ -0,0 +1,311 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <openrct2/Context.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/config/Config.h>
+#include <openrct2/drawing/Drawing.h>
+#include <openrct2/drawing/SpriteCache.h>
+#include <openrct2/platform/platform.h>
+#include <openrct2/sprites.h>
+#include <openrct2/util/Util.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace OpenRCT2;
+
+struct RLERunFuncs
+{
+    const char* Name;
+    RLERunFunc Remap;
+    RLERunFunc Glass;
+    RLERunFunc Blend;
+};
+
+// The scalar version is the per pixel loop used when no run functions are set.
+static std::vector<RLERunFuncs> GetVectorisedRunFuncs()
+{
+    std::vector<RLERunFuncs> result;
+    if (sse41_available())
+    {
+        result.push_back({ "SSE4.1", rle_remap_sse4_1, rle_glass_sse4_1, nullptr });
+    }
+    if (avx2_available())
+    {
+        result.push_back({ "AVX2", rle_remap_avx2, rle_glass_avx2, rle_blend_avx2 });
+    }
+    return result;
+}
+
+static void SetRunFuncs(const RLERunFuncs& funcs)
+{
+    rle_remap_fn = funcs.Remap;
+    rle_glass_fn = funcs.Glass;
+    rle_blend_fn = funcs.Blend;
+}
+
+static std::vector<uint8_t> DrawRLE(
+    const rct_g1_element& g1, ImageId image, const PaletteMap& paletteMap, int32_t srcX,
+    const std::vector<uint8_t>& background)
+{
+    auto bits = background;
+    rct_drawpixelinfo dpi;
+    dpi.bits = bits.data();
+    dpi.width = g1.width;
+    dpi.height = g1.height;
+
+    DrawSpriteArgs args(&dpi, image, paletteMap, g1, srcX, 0, g1.width - srcX, g1.height, bits.data());
+    gfx_rle_sprite_to_buffer(args);
+    return bits;
+}
+
+struct RLEDrawCase
+{
+    const char* Name;
+    ImageId Image;
+    const PaletteMap* Map;
+};
+
+/**
+ * Draws the sprite with every blend op, clipped at a few positions, and checks that each set of run functions gives
+ * the same pixels as the scalar version.
+ */
+static void CompareRLE(const rct_g1_element& g1, const char* spriteName, std::mt19937& random)
+{
+    static uint8_t remapData[256];
+    static std::vector<uint8_t> blendData(255 * 256);
+    static bool mapsCreated = false;
+    if (!mapsCreated)
+    {
+        // Zeroes are transparent in the maps too, so leave some in
+        for (auto& entry : remapData)
+            entry = (random() % 8 == 0) ? 0 : static_cast<uint8_t>(random());
+        for (auto& entry : blendData)
+            entry = (random() % 8 == 0) ? 0 : static_cast<uint8_t>(random());
+        mapsCreated = true;
+    }
+    static PaletteMap remapMap(remapData);
+    static PaletteMap blendMap(blendData.data(), 255, 256);
+
+    const RLEDrawCase cases[] = {
+        { "copy", ImageId(0), &PaletteMap::GetDefault() },
+        { "remap", ImageId(0).WithRemap(1), &remapMap },
+        { "glass", ImageId::FromUInt32(IMAGE_TYPE_TRANSPARENT), &remapMap },
+        { "blend", ImageId::FromUInt32(IMAGE_TYPE_REMAP | IMAGE_TYPE_TRANSPARENT), &blendMap },
+    };
+
+    std::vector<uint8_t> background(static_cast<size_t>(g1.width) * g1.height);
+    for (auto& pixel : background)
+        pixel = static_cast<uint8_t>(random());
+
+    const int32_t clips[] = { 0, 1, g1.width / 3 };
+    for (const auto& drawCase : cases)
+    {
+        for (auto srcX : clips)
+        {
+            if (srcX >= g1.width)
+                continue;
+
+            SetRunFuncs({ "scalar", nullptr, nullptr, nullptr });
+            auto expected = DrawRLE(g1, drawCase.Image, *drawCase.Map, srcX, background);
+            for (const auto& funcs : GetVectorisedRunFuncs())
+            {
+                SetRunFuncs(funcs);
+                auto actual = DrawRLE(g1, drawCase.Image, *drawCase.Map, srcX, background);
+                ASSERT_EQ(expected, actual) << spriteName << " " << drawCase.Name << " " << funcs.Name << " srcX "
+                                            << srcX;
+            }
+        }
+    }
+}
+
+// Encodes rows of pixels the way g1 does, one run for each span of non-zero pixels.
+static std::vector<uint8_t> EncodeRLE(const std::vector<std::vector<uint8_t>>& rows)
+{
+    std::vector<uint8_t> lines;
+    std::vector<uint16_t> offsets;
+    const auto headerLength = rows.size() * 2;
+    for (const auto& row : rows)
+    {
+        offsets.push_back(static_cast<uint16_t>(headerLength + lines.size()));
+        std::vector<std::pair<size_t, size_t>> runs;
+        for (size_t x = 0; x < row.size();)
+        {
+            if (row[x] == 0)
+            {
+                x++;
+                continue;
+            }
+            auto start = x;
+            while (x < row.size() && row[x] != 0 && x - start < 127)
+                x++;
+            runs.emplace_back(start, x - start);
+        }
+        if (runs.empty())
+            runs.emplace_back(0, 0);
+
+        for (size_t i = 0; i < runs.size(); i++)
+        {
+            auto [start, length] = runs[i];
+            auto isLast = i == runs.size() - 1;
+            lines.push_back(static_cast<uint8_t>(length | (isLast ? 0x80 : 0)));
+            lines.push_back(static_cast<uint8_t>(start));
+            lines.insert(lines.end(), row.begin() + start, row.begin() + start + length);
+        }
+    }
+
+    std::vector<uint8_t> result;
+    for (auto offset : offsets)
+    {
+        result.push_back(offset & 0xFF);
+        result.push_back(offset >> 8);
+    }
+    result.insert(result.end(), lines.begin(), lines.end());
+    return result;
+}
+
+static std::vector<std::vector<uint8_t>> CreateRandomRows(std::mt19937& random)
+{
+    auto width = 1 + random() % 255;
+    auto height = 1 + random() % 64;
+    std::vector<std::vector<uint8_t>> rows(height, std::vector<uint8_t>(width));
+    for (auto& row : rows)
+    {
+        // Alternate between opaque spans and gaps of varying length, with the odd transparent pixel inside
+        bool opaque = random() % 2 == 0;
+        for (size_t x = 0; x < row.size(); x++)
+        {
+            if (random() % 24 == 0)
+                opaque = !opaque;
+            row[x] = opaque ? static_cast<uint8_t>(random()) : 0;
+        }
+    }
+    return rows;
+}
+
+TEST(RLEDrawingTests, random_sprites)
+{
+    std::mt19937 random(0x5EED);
+    for (int32_t i = 0; i < 200; i++)
+    {
+        auto rows = CreateRandomRows(random);
+        auto width = static_cast<int16_t>(rows[0].size());
+        auto height = static_cast<int16_t>(rows.size());
+        auto data = EncodeRLE(rows);
+        rct_g1_element g1{};
+        g1.offset = data.data();
+        g1.width = width;
+        g1.height = height;
+        g1.flags = G1_FLAG_RLE_COMPRESSION;
+        CompareRLE(g1, ("random sprite " + std::to_string(i)).c_str(), random);
+    }
+
+    mask_init();
+}
+
+static std::vector<uint8_t> DrawZoomedRLE(
+    const rct_g1_element& g1, uint32_t imageIndex, int32_t zoom, int32_t srcX, int32_t srcY, const PaletteMap& paletteMap,
+    ImageId image, const std::vector<uint8_t>& background)
+{
+    auto bits = background;
+    rct_drawpixelinfo dpi;
+    dpi.bits = bits.data();
+    dpi.width = static_cast<int16_t>((g1.width >> zoom) + 2) << zoom;
+    dpi.height = static_cast<int16_t>((g1.height >> zoom) + 3) << zoom;
+    dpi.zoom_level = zoom;
+
+    DrawSpriteArgs args(
+        &dpi, image.WithIndex(imageIndex), paletteMap, g1, srcX, srcY, g1.width - srcX, g1.height - srcY, bits.data());
+    gfx_rle_sprite_to_buffer(args);
+    return bits;
+}
+
+TEST(RLEDrawingTests, zoomed_sprite_cache)
+{
+    const bool zoomedSpriteCache = gConfigGeneral.zoomed_sprite_cache;
+    SpriteCacheInvalidateAll();
+    SpriteCacheResetStats();
+
+    static uint8_t remapData[256];
+    std::mt19937 random(0x5EED);
+    for (auto& entry : remapData)
+        entry = static_cast<uint8_t>(random());
+    PaletteMap remapMap(remapData);
+
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        auto rows = CreateRandomRows(random);
+        auto data = EncodeRLE(rows);
+        rct_g1_element g1{};
+        g1.offset = data.data();
+        g1.width = static_cast<int16_t>(rows[0].size());
+        g1.height = static_cast<int16_t>(rows.size());
+        g1.flags = G1_FLAG_RLE_COMPRESSION;
+
+        for (int32_t zoom = 1; zoom <= 3; zoom++)
+        {
+            std::vector<uint8_t> background(((g1.width >> zoom) + 2) * ((g1.height >> zoom) + 3));
+            for (auto& pixel : background)
+                pixel = static_cast<uint8_t>(random());
+
+            // Sprites start between one zoomed pixel left or above of the first destination pixel and on it
+            const int32_t step = 1 << zoom;
+            const int32_t srcX = -static_cast<int32_t>(random() % step);
+            const int32_t srcY = -static_cast<int32_t>(random() % step);
+            const auto image = (i % 2 == 0) ? ImageId(0) : ImageId(0).WithRemap(1);
+            const auto& paletteMap = (i % 2 == 0) ? PaletteMap::GetDefault() : remapMap;
+
+            gConfigGeneral.zoomed_sprite_cache = false;
+            auto expected = DrawZoomedRLE(g1, i, zoom, srcX, srcY, paletteMap, image, background);
+
+            // The first draw minifies the sprite, the second draws the cached one
+            gConfigGeneral.zoomed_sprite_cache = true;
+            for (int32_t draw = 0; draw < 2; draw++)
+            {
+                auto actual = DrawZoomedRLE(g1, i, zoom, srcX, srcY, paletteMap, image, background);
+                ASSERT_EQ(expected, actual) << "sprite " << i << " zoom " << zoom << " srcX " << srcX << " srcY " << srcY
+                                            << " draw " << draw;
+            }
+        }
+    }
+
+    auto stats = SpriteCacheGetStats();
+    EXPECT_EQ(stats.Hits, stats.Misses);
+    EXPECT_GT(stats.Hits, 0U);
+
+    SpriteCacheCollect();
+    gConfigGeneral.zoomed_sprite_cache = zoomedSpriteCache;
+}
+
+TEST(RLEDrawingTests, g1_sprites)
+{
+    gOpenRCT2Headless = true;
+    core_init();
+
+    auto context = CreateContext();
+    ASSERT_TRUE(context->Initialise());
+
+    std::mt19937 random(0x5EED);
+    int32_t compared = 0;
+    for (int32_t i = 0; i < SPR_G1_END; i++)
+    {
+        auto g1 = gfx_get_g1_element(i);
+        if (g1 == nullptr || g1->offset == nullptr || !(g1->flags & G1_FLAG_RLE_COMPRESSION) || g1->width <= 0
+            || g1->height <= 0)
+            continue;
+
+        CompareRLE(*g1, ("g1 sprite " + std::to_string(i)).c_str(), random);
+        compared++;
+    }
+    EXPECT_GT(compared, 0);
+
+    mask_init();
+}
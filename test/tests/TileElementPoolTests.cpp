@@ -0,0 +1,206 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/ParkImporter.h>
+#include <openrct2/world/Map.h>
+#include <openrct2/world/TileElementPool.h>
+#include <random>
+#include <vector>
+
+using namespace OpenRCT2;
+
+TEST(TileElementPoolTests, allocate_and_free)
+{
+    TileElementPool pool;
+    size_t size = 0;
+    auto* first = pool.Allocate(3, size);
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(size, 4U);
+
+    size_t otherSize = 0;
+    auto* other = pool.Allocate(1, otherSize);
+    EXPECT_EQ(otherSize, 1U);
+    EXPECT_TRUE(other >= first + size || other + otherSize <= first);
+
+    // A freed block is handed out again, and bigger ones are split
+    pool.Free(first, size);
+    EXPECT_EQ(pool.GetFreeCount(), 4U);
+    size_t reusedSize = 0;
+    EXPECT_EQ(pool.Allocate(2, reusedSize), first);
+    EXPECT_EQ(reusedSize, 2U);
+    EXPECT_EQ(pool.GetFreeCount(), 2U);
+    EXPECT_EQ(pool.Allocate(2, reusedSize), first + 2);
+    EXPECT_EQ(pool.GetFreeCount(), 0U);
+
+    EXPECT_EQ(pool.Allocate(TileElementPool::MaxBlockSize + 1, size), nullptr);
+}
+
+TEST(TileElementPoolTests, elements_stay_when_growing)
+{
+    TileElementPool pool;
+    std::vector<std::pair<TileElement*, size_t>> blocks;
+    for (size_t i = 0; pool.GetCapacity() < TileElementPool::ChunkSize * 3; i++)
+    {
+        size_t size = 0;
+        auto* elements = pool.Allocate(1 + i % 37, size);
+        ASSERT_NE(elements, nullptr);
+        for (size_t j = 0; j < size; j++)
+        {
+            elements[j].base_height = static_cast<uint8_t>(i);
+        }
+        blocks.emplace_back(elements, size);
+    }
+
+    for (size_t i = 0; i < blocks.size(); i++)
+    {
+        auto [elements, size] = blocks[i];
+        for (size_t j = 0; j < size; j++)
+        {
+            ASSERT_EQ(elements[j].base_height, static_cast<uint8_t>(i));
+        }
+    }
+}
+
+TEST(TileElementPoolTests, reset_keeps_elements)
+{
+    std::vector<TileElement> elements(10);
+    auto* data = elements.data();
+
+    TileElementPool pool;
+    size_t size = 0;
+    pool.Allocate(5, size);
+    pool.Reset(std::move(elements));
+    EXPECT_EQ(pool.GetCapacity(), 10U);
+    EXPECT_EQ(pool.GetFreeCount(), 0U);
+
+    // The adopted chunk is full, so new blocks come from another one
+    auto* block = pool.Allocate(1, size);
+    EXPECT_TRUE(block < data || block >= data + 10);
+}
+
+class TileElementInsertTests : public testing::Test
+{
+protected:
+    static void SetUpTestCase()
+    {
+        std::string parkPath = TestData::GetParkPath("bpb.sv6");
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = true;
+        _context = CreateContext();
+        bool initialised = _context->Initialise();
+        ASSERT_TRUE(initialised);
+
+        load_from_sv6(parkPath.c_str());
+        game_load_init();
+        SUCCEED();
+    }
+
+    static void TearDownTestCase()
+    {
+        if (_context)
+            _context.reset();
+    }
+
+private:
+    static std::shared_ptr<IContext> _context;
+};
+
+std::shared_ptr<IContext> TileElementInsertTests::_context;
+
+static std::vector<TileElement> GetTileElements(const CoordsXY& loc)
+{
+    std::vector<TileElement> result;
+    auto* tileElement = map_get_first_element_at(loc);
+    do
+    {
+        result.push_back(*tileElement);
+    } while (!(tileElement++)->IsLastForTile());
+    return result;
+}
+
+static void ExpectSameElements(const std::vector<TileElement>& expected, const std::vector<TileElement>& actual)
+{
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        EXPECT_EQ(expected[i].GetType(), actual[i].GetType()) << "element " << i;
+        EXPECT_EQ(expected[i].base_height, actual[i].base_height) << "element " << i;
+        EXPECT_EQ(expected[i].clearance_height, actual[i].clearance_height) << "element " << i;
+        EXPECT_EQ(i == expected.size() - 1, actual[i].IsLastForTile()) << "element " << i;
+    }
+}
+
+TEST_F(TileElementInsertTests, insert_and_remove)
+{
+    const CoordsXY loc = TileCoordsXY{ 3, 3 }.ToCoordsXY();
+    const CoordsXY neighbourLoc = TileCoordsXY{ 4, 3 }.ToCoordsXY();
+    auto expected = GetTileElements(loc);
+    const auto neighbourElements = GetTileElements(neighbourLoc);
+    const auto elementCount = map_get_tile_element_count();
+
+    std::mt19937 random(0x5EED);
+    for (uint8_t i = 0; i < 200; i++)
+    {
+        // Elements go above the ones at the same height and below the higher ones
+        const auto z = static_cast<int32_t>(random() % 64) * COORDS_Z_STEP;
+        auto* element = tile_element_insert({ loc, z }, 0b1111, TileElementType::Wall);
+        ASSERT_NE(element, nullptr);
+        element->clearance_height = i;
+
+        auto position = std::find_if(
+            expected.begin(), expected.end(), [z](const TileElement& other) { return other.GetBaseZ() > z; });
+        expected.insert(position, *element);
+        ExpectSameElements(expected, GetTileElements(loc));
+    }
+    EXPECT_EQ(map_get_tile_element_count(), elementCount + 200);
+    ExpectSameElements(neighbourElements, GetTileElements(neighbourLoc));
+
+    for (size_t i = 0; i < 100; i++)
+    {
+        auto index = 1 + random() % (expected.size() - 1);
+        tile_element_remove(loc, map_get_first_element_at(loc) + index);
+        expected.erase(expected.begin() + index);
+        ExpectSameElements(expected, GetTileElements(loc));
+    }
+    EXPECT_EQ(map_get_tile_element_count(), elementCount + 100);
+
+    map_reorganise_elements();
+    ExpectSameElements(expected, GetTileElements(loc));
+    ExpectSameElements(neighbourElements, GetTileElements(neighbourLoc));
+    EXPECT_EQ(map_get_tile_element_count(), elementCount + 100);
+}
+
+TEST_F(TileElementInsertTests, changed_stacks_update_count)
+{
+    const TileCoordsXY tilePos{ 6, 3 };
+    auto* first = map_get_first_element_at(tilePos.ToCoordsXY());
+    const auto numElements = GetTileElements(tilePos.ToCoordsXY()).size();
+    const auto elementCount = map_get_tile_element_count();
+
+    // Cleared and pointed back at its elements, the way scripts and the ride construction preview do it
+    map_update_tile_element_count(numElements, 0);
+    map_set_tile_element(tilePos, nullptr);
+    EXPECT_EQ(map_get_tile_element_count(), elementCount - numElements);
+    map_set_tile_element(tilePos, first);
+    map_update_tile_element_count(0, numElements);
+    EXPECT_EQ(map_get_tile_element_count(), elementCount);
+
+    // A stack ended early, reorganising counts the elements again
+    first->SetLastForTile(true);
+    map_update_tile_element_count(numElements, 1);
+    map_reorganise_elements();
+    EXPECT_EQ(map_get_tile_element_count(), elementCount - numElements + 1);
+}
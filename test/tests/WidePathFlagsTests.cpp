@@ -0,0 +1,152 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <gtest/gtest.h>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/ParkImporter.h>
+#include <openrct2/actions/FootpathPlaceAction.h>
+#include <openrct2/actions/FootpathRemoveAction.h>
+#include <openrct2/config/Config.h>
+#include <openrct2/platform/platform.h>
+#include <openrct2/world/Footpath.h>
+#include <openrct2/world/Map.h>
+#include <openrct2/world/Park.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace OpenRCT2;
+
+// A complete sweep takes 512 updates, to make sure one of them started at the first tile.
+constexpr int32_t updatesToSettle = 1024;
+constexpr int32_t editsToTest = 200;
+
+static void SettleWideFlags()
+{
+    for (int32_t i = 0; i < updatesToSettle; i++)
+    {
+        map_update_path_wide_flags();
+    }
+}
+
+static std::vector<CoordsXYZ> FindFlatPaths()
+{
+    std::vector<CoordsXYZ> paths;
+    tile_element_iterator it;
+    tile_element_iterator_begin(&it);
+    do
+    {
+        auto pathElement = it.element->AsPath();
+        if (pathElement != nullptr && !pathElement->IsQueue() && !pathElement->IsSloped() && !pathElement->IsGhost())
+        {
+            paths.emplace_back(TileCoordsXY{ it.x, it.y }.ToCoordsXY(), pathElement->GetBaseZ());
+        }
+    } while (tile_element_iterator_next(&it));
+    return paths;
+}
+
+/**
+ * Removes paths and places new ones next to existing paths, the same edits for the same seed. Returns how many
+ * of the edits succeeded.
+ */
+static int32_t ApplyRandomEdits(uint32_t seed)
+{
+    std::mt19937 random(seed);
+    int32_t succeeded = 0;
+    for (int32_t i = 0; i < editsToTest; i++)
+    {
+        auto paths = FindFlatPaths();
+        if (paths.empty())
+            break;
+
+        const auto& path = paths[random() % paths.size()];
+        GameActions::Result::Ptr result;
+        if (random() % 2 == 0)
+        {
+            auto action = FootpathRemoveAction(path);
+            result = GameActions::Execute(&action);
+        }
+        else
+        {
+            auto pathElement = map_get_footpath_element(path);
+            const CoordsXY pathPos = path;
+            const auto neighbour = CoordsXYZ(pathPos + CoordsDirectionDelta[random() % 4], path.z);
+            auto action = FootpathPlaceAction(neighbour, 0, pathElement->AsPath()->GetSurfaceEntryIndex());
+            result = GameActions::Execute(&action);
+        }
+        if (result->Error == GameActions::Status::Ok)
+        {
+            succeeded++;
+        }
+    }
+    return succeeded;
+}
+
+static std::vector<bool> CollectWideFlags()
+{
+    std::vector<bool> flags;
+    tile_element_iterator it;
+    tile_element_iterator_begin(&it);
+    do
+    {
+        auto pathElement = it.element->AsPath();
+        if (pathElement != nullptr)
+        {
+            flags.push_back(pathElement->IsWide());
+        }
+    } while (tile_element_iterator_next(&it));
+    return flags;
+}
+
+static std::vector<bool> RunEdits(bool incremental, int32_t& succeeded)
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+    core_init();
+
+    auto context = CreateContext();
+    if (!context->Initialise())
+        return {};
+
+    gConfigGeneral.incremental_wide_path_flags = incremental;
+
+    std::string path = TestData::GetParkPath("bpb.sv6");
+    load_from_sv6(path.c_str());
+    game_load_init();
+    gParkFlags |= PARK_FLAGS_NO_MONEY;
+
+    SettleWideFlags();
+    succeeded = ApplyRandomEdits(0x12345678);
+    SettleWideFlags();
+
+    gConfigGeneral.incremental_wide_path_flags = false;
+    return CollectWideFlags();
+}
+
+TEST(WidePathFlagsTests, IncrementalMatchesSweep)
+{
+    int32_t sweepEdits = 0;
+    auto sweep = RunEdits(false, sweepEdits);
+    ASSERT_FALSE(sweep.empty());
+    ASSERT_GT(sweepEdits, 0);
+
+    int32_t incrementalEdits = 0;
+    auto incremental = RunEdits(true, incrementalEdits);
+    ASSERT_EQ(sweepEdits, incrementalEdits);
+    ASSERT_EQ(sweep.size(), incremental.size());
+
+    for (size_t i = 0; i < sweep.size(); i++)
+    {
+        ASSERT_EQ(sweep[i], incremental[i]) << "Wide flag of path element " << i << " differs";
+    }
+}